@@ -5,12 +5,18 @@
  * Pattern: Priority queue operations, heuristic search, graph traversal
  * Memory: Grid access, heap manipulation
  * Branch: Data-dependent (obstacle layout, path decisions)
+ *
+ * Variants replace the binary heap with an integer-f bucket queue, the
+ * visited bytes with a closed-set bitmap, and can run the queries across
+ * --threads workers; ASTAR_UNIFORM=1 maps add jump point search.
  */
 
 #include "bench.h"
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * ASTAR_MAP_SIZE is the tier S edge, scaled by bench_scale_dim(); the
+ * obstacle count is scaled by bench_scale() to keep the same density.
  * ============================================================================ */
 
 #ifndef ASTAR_MAP_SIZE
@@ -25,6 +31,18 @@
 #define ASTAR_NUM_QUERIES       10      /* Number of pathfinding queries */
 #endif
 
+#ifndef ASTAR_UNIFORM
+#define ASTAR_UNIFORM           0       /* 1: every passable cell costs 1 (needed by JPS) */
+#endif
+
+#ifndef ASTAR_BUCKETS
+#define ASTAR_BUCKETS           128     /* f ring; > largest f step (2 * 14 * 3) */
+#endif
+
+#ifndef ASTAR_MAX_THREADS
+#define ASTAR_MAX_THREADS       4       /* Search contexts for the -mt variant */
+#endif
+
 /* Map cell types */
 #define CELL_EMPTY              0
 #define CELL_OBSTACLE           255
@@ -36,13 +54,13 @@
 #define COST_DIAGONAL           14      /* Cost of moving diagonally (approx sqrt(2)*10) */
 #define COST_INFINITE           0x7FFFFFFF
 
-/* Priority queue size */
-#define PQ_MAX_SIZE             (ASTAR_MAP_SIZE * ASTAR_MAP_SIZE)
-
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_SEARCH, PHASE_FLOOD, PHASE_HEURISTIC };
+
 /* Map cell */
 typedef struct {
     uint8_t terrain;        /* Terrain cost multiplier (0=obstacle, 1-254=passable) */
@@ -58,16 +76,17 @@ typedef struct {
     int16_t parent_y;
 } astar_node_t;
 
-/* Priority queue (min-heap by f value) */
+/* Priority queue (min-heap by f value, one slot per map cell) */
 typedef struct {
-    astar_node_t nodes[PQ_MAX_SIZE];
+    astar_node_t *nodes;
     int size;
+    int capacity;
 } priority_queue_t;
 
-/* Map state */
+/* Map state (row-major grids, arena-allocated in init) */
 typedef struct {
-    map_cell_t cells[ASTAR_MAP_SIZE][ASTAR_MAP_SIZE];
-    int32_t g_cost[ASTAR_MAP_SIZE][ASTAR_MAP_SIZE];
+    map_cell_t *cells;
+    int32_t *g_cost;
     int width;
     int height;
 } map_t;
@@ -79,9 +98,12 @@ typedef struct {
 } path_query_t;
 
 /* Static storage */
-static map_t map;
-static priority_queue_t open_set;
-static path_query_t queries[ASTAR_NUM_QUERIES];
+static BENCH_TLS map_t map;
+static BENCH_TLS priority_queue_t open_set;
+static BENCH_TLS path_query_t queries[ASTAR_NUM_QUERIES];
+static BENCH_TLS uint8_t *ff_visited;
+static BENCH_TLS int *queue_x;
+static BENCH_TLS int *queue_y;
 
 /* ============================================================================
  * Priority Queue Operations (Binary Min-Heap)
@@ -101,7 +123,7 @@ INLINE void pq_swap(astar_node_t *a, astar_node_t *b)
 
 static void pq_push(priority_queue_t *pq, const astar_node_t *node)
 {
-    if (pq->size >= PQ_MAX_SIZE) return;
+    if (pq->size >= pq->capacity) return;
 
     /* Add to end */
     int i = pq->size;
@@ -212,16 +234,16 @@ static int astar_search(map_t *m, int sx, int sy, int gx, int gy, int *nodes_exp
         return -1;
     }
 
-    if (m->cells[sy][sx].terrain == CELL_OBSTACLE ||
-        m->cells[gy][gx].terrain == CELL_OBSTACLE) {
+    if (m->cells[sy * m->width + sx].terrain == CELL_OBSTACLE ||
+        m->cells[gy * m->width + gx].terrain == CELL_OBSTACLE) {
         return -1;
     }
 
     /* Initialize g_cost array */
     for (int y = 0; y < m->height; y++) {
         for (int x = 0; x < m->width; x++) {
-            m->g_cost[y][x] = COST_INFINITE;
-            m->cells[y][x].visited = 0;
+            m->g_cost[y * m->width + x] = COST_INFINITE;
+            m->cells[y * m->width + x].visited = 0;
         }
     }
 
@@ -235,7 +257,7 @@ static int astar_search(map_t *m, int sx, int sy, int gx, int gy, int *nodes_exp
         .parent_x = -1, .parent_y = -1
     };
     pq_push(&open_set, &start_node);
-    m->g_cost[sy][sx] = 0;
+    m->g_cost[sy * m->width + sx] = 0;
 
     /* A* main loop */
     while (!pq_empty(&open_set)) {
@@ -244,10 +266,10 @@ static int astar_search(map_t *m, int sx, int sy, int gx, int gy, int *nodes_exp
         int cy = current.y;
 
         /* Skip if already visited with better cost */
-        if (m->cells[cy][cx].visited) {
+        if (m->cells[cy * m->width + cx].visited) {
             continue;
         }
-        m->cells[cy][cx].visited = 1;
+        m->cells[cy * m->width + cx].visited = 1;
         (*nodes_expanded)++;
 
         /* Goal reached? */
@@ -268,22 +290,22 @@ static int astar_search(map_t *m, int sx, int sy, int gx, int gy, int *nodes_exp
             }
 
             /* Check obstacle */
-            if (m->cells[ny][nx].terrain == CELL_OBSTACLE) {
+            if (m->cells[ny * m->width + nx].terrain == CELL_OBSTACLE) {
                 continue;
             }
 
             /* Check already visited */
-            if (m->cells[ny][nx].visited) {
+            if (m->cells[ny * m->width + nx].visited) {
                 continue;
             }
 
             /* Calculate new g cost */
-            int32_t move_cost = cost8[d] * m->cells[ny][nx].terrain;
+            int32_t move_cost = cost8[d] * m->cells[ny * m->width + nx].terrain;
             int32_t new_g = current.g + move_cost;
 
             /* Update if better path found */
-            if (new_g < m->g_cost[ny][nx]) {
-                m->g_cost[ny][nx] = new_g;
+            if (new_g < m->g_cost[ny * m->width + nx]) {
+                m->g_cost[ny * m->width + nx] = new_g;
 
                 astar_node_t neighbor = {
                     .x = nx, .y = ny,
@@ -301,42 +323,375 @@ static int astar_search(map_t *m, int sx, int sy, int gx, int gy, int *nodes_exp
 }
 
 /* ============================================================================
- * Map Generation
+ * Bucket-Queue A*
+ * With a consistent heuristic f never decreases along the search, so the
+ * open list is a ring of ASTAR_BUCKETS LIFO lists indexed by f (a dial
+ * queue): push and pop are O(1). Closed cells are bits in a packed bitmap;
+ * g costs carry the query stamp that wrote them, so nothing is cleared per
+ * query except the bitmap. All state lives in a search context (no
+ * BENCH_TLS), one per worker thread.
+ * ============================================================================ */
+
+#define OPEN_NONE               0xFFFFFFFFu
+
+/* Open-list entry; dir is the travel direction into the cell (JPS) */
+typedef struct {
+    int16_t  x, y;
+    int32_t  g;
+    uint32_t next;
+    int8_t   dir;
+} open_entry_t;
+
+/* g cost, valid while stamp matches the context's */
+typedef struct {
+    int32_t  g;
+    uint32_t stamp;
+} g_entry_t;
+
+typedef struct {
+    uint32_t head[ASTAR_BUCKETS];
+    open_entry_t *pool;
+    uint32_t pool_used;
+    uint32_t pool_cap;
+    uint32_t free_list;
+    uint32_t count;
+    int32_t  f;                 /* Lowest f that can still be open */
+    uint64_t *closed;           /* One bit per cell */
+    g_entry_t *g;
+    uint32_t stamp;
+} search_ctx_t;
+
+INLINE bool closed_test(const search_ctx_t *c, int cell)
+{
+    return (c->closed[cell >> 6] >> (cell & 63)) & 1;
+}
+
+INLINE void closed_set(search_ctx_t *c, int cell)
+{
+    c->closed[cell >> 6] |= 1ull << (cell & 63);
+}
+
+INLINE int32_t g_get(const search_ctx_t *c, int cell)
+{
+    return c->g[cell].stamp == c->stamp ? c->g[cell].g : COST_INFINITE;
+}
+
+INLINE void g_put(search_ctx_t *c, int cell, int32_t g)
+{
+    c->g[cell].g = g;
+    c->g[cell].stamp = c->stamp;
+}
+
+static void bq_reset(search_ctx_t *c, const map_t *m)
+{
+    for (int i = 0; i < ASTAR_BUCKETS; i++) {
+        c->head[i] = OPEN_NONE;
+    }
+    c->pool_used = 0;
+    c->free_list = OPEN_NONE;
+    c->count = 0;
+    c->f = 0;
+    c->stamp++;
+    memset(c->closed, 0, (((size_t)m->width * m->height + 63) / 64) * sizeof(uint64_t));
+}
+
+INLINE void bq_push(search_ctx_t *c, int x, int y, int32_t g, int32_t f, int dir)
+{
+    uint32_t e = c->free_list;
+
+    if (e != OPEN_NONE) {
+        c->free_list = c->pool[e].next;
+    } else if (c->pool_used < c->pool_cap) {
+        e = c->pool_used++;
+    } else {
+        return;                 /* Full, like pq_push */
+    }
+
+    uint32_t *head = &c->head[f & (ASTAR_BUCKETS - 1)];
+    open_entry_t *n = &c->pool[e];
+    n->x = (int16_t)x;
+    n->y = (int16_t)y;
+    n->g = g;
+    n->dir = (int8_t)dir;
+    n->next = *head;
+    *head = e;
+    if (c->count++ == 0 || f < c->f) c->f = f;
+}
+
+/* Pop from the lowest non-empty f bucket; false when empty */
+INLINE bool bq_pop(search_ctx_t *c, open_entry_t *out)
+{
+    if (c->count == 0) {
+        return false;
+    }
+
+    uint32_t *head = &c->head[c->f & (ASTAR_BUCKETS - 1)];
+    while (*head == OPEN_NONE) {
+        c->f++;
+        head = &c->head[c->f & (ASTAR_BUCKETS - 1)];
+    }
+
+    uint32_t e = *head;
+    *out = c->pool[e];
+    *head = out->next;
+    c->pool[e].next = c->free_list;
+    c->free_list = e;
+    c->count--;
+    return true;
+}
+
+/* Same search as astar_search with the bucket queue and bitmap */
+static int astar_bucket(search_ctx_t *c, const map_t *m, int sx, int sy, int gx, int gy,
+                        int *nodes_expanded)
+{
+    int w = m->width;
+
+    *nodes_expanded = 0;
+    if (sx < 0 || sx >= w || sy < 0 || sy >= m->height ||
+        gx < 0 || gx >= w || gy < 0 || gy >= m->height) {
+        return -1;
+    }
+    if (m->cells[sy * w + sx].terrain == CELL_OBSTACLE ||
+        m->cells[gy * w + gx].terrain == CELL_OBSTACLE) {
+        return -1;
+    }
+
+    bq_reset(c, m);
+    bq_push(c, sx, sy, 0, heuristic_diagonal(sx, sy, gx, gy), 0);
+    g_put(c, sy * w + sx, 0);
+
+    open_entry_t cur;
+    while (bq_pop(c, &cur)) {
+        int cx = cur.x;
+        int cy = cur.y;
+        int cell = cy * w + cx;
+
+        if (closed_test(c, cell)) {
+            continue;
+        }
+        closed_set(c, cell);
+        (*nodes_expanded)++;
+
+        if (cx == gx && cy == gy) {
+            return cur.g / COST_STRAIGHT;
+        }
+
+        for (int d = 0; d < 8; d++) {
+            int nx = cx + dx8[d];
+            int ny = cy + dy8[d];
+
+            if (nx < 0 || nx >= w || ny < 0 || ny >= m->height) {
+                continue;
+            }
+
+            int n = ny * w + nx;
+            uint8_t terrain = m->cells[n].terrain;
+            if (terrain == CELL_OBSTACLE || closed_test(c, n)) {
+                continue;
+            }
+
+            int32_t new_g = cur.g + cost8[d] * terrain;
+            if (new_g < g_get(c, n)) {
+                g_put(c, n, new_g);
+                bq_push(c, nx, ny, new_g, new_g + heuristic_diagonal(nx, ny, gx, gy), 0);
+            }
+        }
+    }
+
+    return -1;
+}
+
+/* ============================================================================
+ * Jump Point Search (Harabor & Grastien 2011)
+ * Valid on uniform-cost maps only (ASTAR_UNIFORM=1). Moves follow
+ * astar_search: diagonal steps may cut corners. Successors are pruned by
+ * the travel direction and found by jumping along straight and diagonal
+ * lines until a forced neighbour or the goal; a jump of k steps costs k
+ * straight or diagonal moves, so path costs match the reference.
  * ============================================================================ */
 
-static void generate_map(map_t *m, uint32_t seed)
+#if ASTAR_UNIFORM
+
+INLINE bool passable(const map_t *m, int x, int y)
+{
+    return x >= 0 && x < m->width && y >= 0 && y < m->height &&
+           m->cells[y * m->width + x].terrain != CELL_OBSTACLE;
+}
+
+/* Direction index into dx8/dy8 for a unit step */
+INLINE int dir_index(int dx, int dy)
+{
+    static const int8_t table[3][3] = { { 0, 3, 5 }, { 1, -1, 6 }, { 2, 4, 7 } };
+    return table[dx + 1][dy + 1];
+}
+
+static bool jump_straight(const map_t *m, int x, int y, int dx, int dy, int gx, int gy,
+                          int *jx, int *jy)
+{
+    for (;;) {
+        x += dx;
+        y += dy;
+        if (!passable(m, x, y)) {
+            return false;
+        }
+        if (x == gx && y == gy) {
+            break;
+        }
+        if (dx != 0) {
+            if ((!passable(m, x, y - 1) && passable(m, x + dx, y - 1)) ||
+                (!passable(m, x, y + 1) && passable(m, x + dx, y + 1))) {
+                break;
+            }
+        } else {
+            if ((!passable(m, x - 1, y) && passable(m, x - 1, y + dy)) ||
+                (!passable(m, x + 1, y) && passable(m, x + 1, y + dy))) {
+                break;
+            }
+        }
+    }
+    *jx = x;
+    *jy = y;
+    return true;
+}
+
+static bool jump(const map_t *m, int x, int y, int dx, int dy, int gx, int gy,
+                 int *jx, int *jy)
+{
+    if (dx == 0 || dy == 0) {
+        return jump_straight(m, x, y, dx, dy, gx, gy, jx, jy);
+    }
+
+    int tx, ty;
+    for (;;) {
+        x += dx;
+        y += dy;
+        if (!passable(m, x, y)) {
+            return false;
+        }
+        if (x == gx && y == gy) {
+            break;
+        }
+        if ((!passable(m, x - dx, y) && passable(m, x - dx, y + dy)) ||
+            (!passable(m, x, y - dy) && passable(m, x + dx, y - dy))) {
+            break;
+        }
+        if (jump_straight(m, x, y, dx, 0, gx, gy, &tx, &ty) ||
+            jump_straight(m, x, y, 0, dy, gx, gy, &tx, &ty)) {
+            break;
+        }
+    }
+    *jx = x;
+    *jy = y;
+    return true;
+}
+
+static int astar_jps(search_ctx_t *c, const map_t *m, int sx, int sy, int gx, int gy,
+                     int *nodes_expanded)
 {
-    m->width = ASTAR_MAP_SIZE;
-    m->height = ASTAR_MAP_SIZE;
+    int w = m->width;
+
+    *nodes_expanded = 0;
+    if (!passable(m, sx, sy) || !passable(m, gx, gy)) {
+        return -1;
+    }
+
+    bq_reset(c, m);
+    bq_push(c, sx, sy, 0, heuristic_diagonal(sx, sy, gx, gy), -1);
+    g_put(c, sy * w + sx, 0);
+
+    open_entry_t cur;
+    while (bq_pop(c, &cur)) {
+        int cx = cur.x;
+        int cy = cur.y;
+        int cell = cy * w + cx;
+
+        if (closed_test(c, cell)) {
+            continue;
+        }
+        closed_set(c, cell);
+        (*nodes_expanded)++;
+
+        if (cx == gx && cy == gy) {
+            return cur.g / COST_STRAIGHT;
+        }
+
+        /* Natural and forced neighbours for the direction of travel */
+        uint8_t dirs = 0xFF;
+        if (cur.dir >= 0) {
+            int dx = dx8[cur.dir];
+            int dy = dy8[cur.dir];
+            dirs = (uint8_t)(1u << cur.dir);
+            if (dx != 0 && dy != 0) {
+                dirs |= (uint8_t)(1u << dir_index(dx, 0)) | (uint8_t)(1u << dir_index(0, dy));
+                if (!passable(m, cx - dx, cy)) dirs |= (uint8_t)(1u << dir_index(-dx, dy));
+                if (!passable(m, cx, cy - dy)) dirs |= (uint8_t)(1u << dir_index(dx, -dy));
+            } else if (dx != 0) {
+                if (!passable(m, cx, cy + 1)) dirs |= (uint8_t)(1u << dir_index(dx, 1));
+                if (!passable(m, cx, cy - 1)) dirs |= (uint8_t)(1u << dir_index(dx, -1));
+            } else {
+                if (!passable(m, cx + 1, cy)) dirs |= (uint8_t)(1u << dir_index(1, dy));
+                if (!passable(m, cx - 1, cy)) dirs |= (uint8_t)(1u << dir_index(-1, dy));
+            }
+        }
+
+        for (int d = 0; d < 8; d++) {
+            int jx, jy;
+            if (!(dirs & (1u << d)) || !jump(m, cx, cy, dx8[d], dy8[d], gx, gy, &jx, &jy)) {
+                continue;
+            }
+
+            int n = jy * w + jx;
+            if (closed_test(c, n)) {
+                continue;
+            }
+
+            int32_t new_g = cur.g + heuristic_diagonal(cx, cy, jx, jy);
+            if (new_g < g_get(c, n)) {
+                g_put(c, n, new_g);
+                bq_push(c, jx, jy, new_g, new_g + heuristic_diagonal(jx, jy, gx, gy), d);
+            }
+        }
+    }
+
+    return -1;
+}
+
+#endif /* ASTAR_UNIFORM */
+
+/* ============================================================================
+ * Map Generation
+ * ============================================================================ */
 
+static void generate_map(map_t *m, int num_obstacles, uint32_t seed)
+{
     uint32_t x = seed;
 
     /* Initialize all cells as passable with varying terrain costs */
     for (int y = 0; y < m->height; y++) {
         for (int x_ = 0; x_ < m->width; x_++) {
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-            /* Terrain cost 1-3 */
-            m->cells[y][x_].terrain = 1 + (x % 3);
-            m->cells[y][x_].visited = 0;
+            /* Terrain cost 1-3 (1 on uniform maps, same draws) */
+            m->cells[y * m->width + x_].terrain = ASTAR_UNIFORM ? 1 : 1 + (x % 3);
+            m->cells[y * m->width + x_].visited = 0;
         }
     }
 
     /* Add obstacles */
-    for (int i = 0; i < ASTAR_NUM_OBSTACLES; i++) {
+    for (int i = 0; i < num_obstacles; i++) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
         int ox = x % m->width;
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
         int oy = x % m->height;
 
-        m->cells[oy][ox].terrain = CELL_OBSTACLE;
+        m->cells[oy * m->width + ox].terrain = CELL_OBSTACLE;
     }
 
     /* Ensure corners are passable for queries */
-    m->cells[0][0].terrain = 1;
-    m->cells[0][m->width - 1].terrain = 1;
-    m->cells[m->height - 1][0].terrain = 1;
-    m->cells[m->height - 1][m->width - 1].terrain = 1;
-    m->cells[m->height / 2][m->width / 2].terrain = 1;
+    m->cells[0].terrain = 1;
+    m->cells[m->width - 1].terrain = 1;
+    m->cells[(m->height - 1) * m->width].terrain = 1;
+    m->cells[(m->height - 1) * m->width + m->width - 1].terrain = 1;
+    m->cells[(m->height / 2) * m->width + m->width / 2].terrain = 1;
 
     /* Generate queries */
     for (int i = 0; i < ASTAR_NUM_QUERIES; i++) {
@@ -346,14 +701,14 @@ static void generate_map(map_t *m, uint32_t seed)
             queries[i].start_x = x % m->width;
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             queries[i].start_y = x % m->height;
-        } while (m->cells[queries[i].start_y][queries[i].start_x].terrain == CELL_OBSTACLE);
+        } while (m->cells[queries[i].start_y * m->width + queries[i].start_x].terrain == CELL_OBSTACLE);
 
         do {
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             queries[i].goal_x = x % m->width;
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             queries[i].goal_y = x % m->height;
-        } while (m->cells[queries[i].goal_y][queries[i].goal_x].terrain == CELL_OBSTACLE);
+        } while (m->cells[queries[i].goal_y * m->width + queries[i].goal_x].terrain == CELL_OBSTACLE);
     }
 }
 
@@ -367,22 +722,20 @@ static int flood_fill_count(map_t *m, int sx, int sy)
     if (sx < 0 || sx >= m->width || sy < 0 || sy >= m->height) {
         return 0;
     }
-    if (m->cells[sy][sx].terrain == CELL_OBSTACLE) {
+    if (m->cells[sy * m->width + sx].terrain == CELL_OBSTACLE) {
         return 0;
     }
 
     /* BFS flood fill */
-    static uint8_t ff_visited[ASTAR_MAP_SIZE][ASTAR_MAP_SIZE];
-    memset(ff_visited, 0, sizeof(ff_visited));
+    int num_cells = m->width * m->height;
+    memset(ff_visited, 0, num_cells);
 
-    static int queue_x[PQ_MAX_SIZE];
-    static int queue_y[PQ_MAX_SIZE];
     int head = 0, tail = 0;
 
     queue_x[tail] = sx;
     queue_y[tail] = sy;
     tail++;
-    ff_visited[sy][sx] = 1;
+    ff_visited[sy * m->width + sx] = 1;
 
     int count = 0;
 
@@ -400,15 +753,15 @@ static int flood_fill_count(map_t *m, int sx, int sy)
             if (nx < 0 || nx >= m->width || ny < 0 || ny >= m->height) {
                 continue;
             }
-            if (ff_visited[ny][nx]) {
+            if (ff_visited[ny * m->width + nx]) {
                 continue;
             }
-            if (m->cells[ny][nx].terrain == CELL_OBSTACLE) {
+            if (m->cells[ny * m->width + nx].terrain == CELL_OBSTACLE) {
                 continue;
             }
 
-            ff_visited[ny][nx] = 1;
-            if (tail < PQ_MAX_SIZE) {
+            ff_visited[ny * m->width + nx] = 1;
+            if (tail < num_cells) {
                 queue_x[tail] = nx;
                 queue_y[tail] = ny;
                 tail++;
@@ -423,12 +776,77 @@ static int flood_fill_count(map_t *m, int sx, int sy)
  * Kernel Implementation
  * ============================================================================ */
 
+/* Context search: astar_bucket / astar_jps (NULL = astar_search, no context) */
+typedef int (*search_fn_t)(search_ctx_t *c, const map_t *m, int sx, int sy, int gx, int gy,
+                           int *nodes_expanded);
+
+/* Shared query job for the worker threads (tasks see no BENCH_TLS state) */
+typedef struct {
+    search_fn_t search;
+    const map_t *map;
+    const path_query_t *queries;
+    search_ctx_t *ctx;
+    int num_ctx;
+    int *path_len;
+    int *expanded;
+    int next_query;
+} query_job_t;
+
+static BENCH_TLS search_ctx_t search_ctx[ASTAR_MAX_THREADS];
+static BENCH_TLS int num_search_ctx;
+static BENCH_TLS int path_results[ASTAR_NUM_QUERIES];
+static BENCH_TLS int expanded_results[ASTAR_NUM_QUERIES];
+
+/* Worker: take queries off the shared counter until none are left */
+static void query_task(int tid, int nthreads, void *arg)
+{
+    query_job_t *job = arg;
+    UNUSED(nthreads);
+
+    if (tid >= job->num_ctx) {
+        return;
+    }
+
+    search_ctx_t *c = &job->ctx[tid];
+    int q;
+    while ((q = __atomic_fetch_add(&job->next_query, 1, __ATOMIC_RELAXED)) < ASTAR_NUM_QUERIES) {
+        const path_query_t *pq = &job->queries[q];
+        job->path_len[q] = job->search(c, job->map, pq->start_x, pq->start_y,
+                                       pq->goal_x, pq->goal_y, &job->expanded[q]);
+    }
+}
+
 static void kernel_init_func(void)
 {
-    generate_map(&map, 0xFEEDFACE);
+    map.width = (int)bench_scale_dim(ASTAR_MAP_SIZE);
+    map.height = map.width;
+
+    int num_cells = map.width * map.height;
+    map.cells = bench_alloc(num_cells * sizeof(map_cell_t));
+    map.g_cost = bench_alloc(num_cells * sizeof(int32_t));
+    open_set.nodes = bench_alloc(num_cells * sizeof(astar_node_t));
+    open_set.capacity = num_cells;
+    ff_visited = bench_alloc(num_cells);
+    queue_x = bench_alloc(num_cells * sizeof(int));
+    queue_y = bench_alloc(num_cells * sizeof(int));
+
+    generate_map(&map, (int)bench_scale(ASTAR_NUM_OBSTACLES), 0xFEEDFACE);
+
+    /* One search context per worker thread, open pools as deep as the heap */
+    num_search_ctx = bench_threads < ASTAR_MAX_THREADS ? bench_threads : ASTAR_MAX_THREADS;
+    for (int t = 0; t < num_search_ctx; t++) {
+        search_ctx_t *c = &search_ctx[t];
+        c->pool = bench_alloc(num_cells * sizeof(open_entry_t));
+        c->pool_cap = (uint32_t)num_cells;
+        c->closed = bench_alloc(((num_cells + 63) / 64) * sizeof(uint64_t));
+        c->g = bench_alloc(num_cells * sizeof(g_entry_t));
+        c->stamp = 0;
+    }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; search NULL is the reference astar_search. Forced inline
+ * so kernel_run_func keeps the plain query loop it had before the engines */
+INLINE bench_result_t astar_run(search_fn_t search, bool parallel)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -441,15 +859,36 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Run A* queries */
-    for (int q = 0; q < ASTAR_NUM_QUERIES; q++) {
-        int nodes_expanded = 0;
-        int path_len = astar_search(&map,
-                                    queries[q].start_x, queries[q].start_y,
-                                    queries[q].goal_x, queries[q].goal_y,
-                                    &nodes_expanded);
+    BENCH_PHASE_BEGIN(PHASE_SEARCH);
+    if (!search) {
+        for (int q = 0; q < ASTAR_NUM_QUERIES; q++) {
+            path_results[q] = astar_search(&map,
+                                           queries[q].start_x, queries[q].start_y,
+                                           queries[q].goal_x, queries[q].goal_y,
+                                           &expanded_results[q]);
+        }
+    } else {
+        query_job_t job = {
+            .search = search,
+            .map = &map,
+            .queries = queries,
+            .ctx = search_ctx,
+            .num_ctx = parallel ? num_search_ctx : 1,
+            .path_len = path_results,
+            .expanded = expanded_results,
+            .next_query = 0
+        };
+        if (parallel) {
+            bench_parallel(query_task, &job);
+        } else {
+            query_task(0, 1, &job);
+        }
+    }
 
-        total_nodes_expanded += nodes_expanded;
-        csum = checksum_update(csum, (uint32_t)nodes_expanded);
+    /* Path costs are optimal, so every engine agrees; expansions do not */
+    for (int q = 0; q < ASTAR_NUM_QUERIES; q++) {
+        int path_len = path_results[q];
+        total_nodes_expanded += expanded_results[q];
 
         if (path_len >= 0) {
             total_path_length += path_len;
@@ -460,12 +899,16 @@ static bench_result_t kernel_run_func(void)
             csum = checksum_update(csum, 0xFFFFFFFF);
         }
     }
+    BENCH_PHASE_END(PHASE_SEARCH);
 
     /* Additional metrics: flood fill from center */
+    BENCH_PHASE_BEGIN(PHASE_FLOOD);
     int connectivity = flood_fill_count(&map, map.width / 2, map.height / 2);
+    BENCH_PHASE_END(PHASE_FLOOD);
     csum = checksum_update(csum, (uint32_t)connectivity);
 
     /* Heuristic calculations */
+    BENCH_PHASE_BEGIN(PHASE_HEURISTIC);
     int32_t heuristic_sum = 0;
     for (int q = 0; q < ASTAR_NUM_QUERIES; q++) {
         int32_t h = heuristic_diagonal(queries[q].start_x, queries[q].start_y,
@@ -473,12 +916,12 @@ static bench_result_t kernel_run_func(void)
         heuristic_sum += h;
         csum = checksum_update(csum, (uint32_t)h);
     }
+    BENCH_PHASE_END(PHASE_HEURISTIC);
 
     BENCH_END();
 
     /* Final checksum */
     csum = checksum_update(csum, (uint32_t)total_path_length);
-    csum = checksum_update(csum, (uint32_t)total_nodes_expanded);
     csum = checksum_update(csum, (uint32_t)paths_found);
     csum = checksum_update(csum, (uint32_t)paths_not_found);
 
@@ -493,6 +936,33 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return astar_run(NULL, false);
+}
+
+static bench_result_t kernel_run_bucket(void)
+{
+    return astar_run(astar_bucket, false);
+}
+
+static bench_result_t kernel_run_bucket_mt(void)
+{
+    return astar_run(astar_bucket, true);
+}
+
+#if ASTAR_UNIFORM
+static bench_result_t kernel_run_jps(void)
+{
+    return astar_run(astar_jps, false);
+}
+
+static bench_result_t kernel_run_jps_mt(void)
+{
+    return astar_run(astar_jps, true);
+}
+#endif
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -502,7 +972,18 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t astar_variants[] = {
+    { "bucket-mt", 0, kernel_run_bucket_mt },
+    { "bucket", 0, kernel_run_bucket },
+#if ASTAR_UNIFORM
+    { "jps-mt", 0, kernel_run_jps_mt },
+    { "jps", 0, kernel_run_jps },
+#endif
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     astar_path,
     "A* pathfinding on 2D grid maps",
     "473.astar",
@@ -510,7 +991,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    ASTAR_NUM_QUERIES
+    ASTAR_NUM_QUERIES,
+    astar_variants,
+    "astar_search", "flood_fill", "heuristic"
 );
 
 KERNEL_REGISTER(astar_path)
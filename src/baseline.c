@@ -0,0 +1,196 @@
+/*
+ * SPECInt2006-micro: baseline.c
+ * Reference results for regression comparison, read from MACHINE output
+ *
+ * Native:      --baseline=FILE, a saved "-f machine" run
+ * Any build:   BENCH_BASELINE=FILE at build time links the file in as a blob
+ *              (.incbin), used when no --baseline is given
+ */
+
+#include "bench.h"
+
+#ifndef BASELINE_MAX_FILE
+#define BASELINE_MAX_FILE   (1 << 20)       /* Largest baseline file read natively */
+#endif
+
+static baseline_entry_t entries[MAX_KERNELS];
+static int num_entries = 0;
+
+#ifdef BENCH_BASELINE_FILE
+__asm__ (
+    ".section .rodata\n"
+    ".balign 8\n"
+    "baseline_blob:\n"
+    ".incbin \"" BENCH_BASELINE_FILE "\"\n"
+    ".byte 0\n"
+    ".previous\n"
+);
+extern const char baseline_blob[] __asm__("baseline_blob");
+#endif
+
+/* ============================================================================
+ * MACHINE-format parser
+ * ============================================================================ */
+
+static uint64_t parse_u64(const char *s, const char *end)
+{
+    uint64_t v = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        v = v * 10 + (uint64_t)(*s++ - '0');
+    }
+    return v;
+}
+
+/* Copy [s, end) into a fixed buffer, truncating */
+static void copy_field(char *dst, size_t size, const char *s, const char *end)
+{
+    size_t n = (size_t)(end - s);
+    if (n >= size) n = size - 1;
+    memcpy(dst, s, n);
+    dst[n] = '\0';
+}
+
+static bool key_is(const char *line, const char *eq, const char *key)
+{
+    size_t len = strlen(key);
+    return (size_t)(eq - line) == len && strncmp(line, key, len) == 0;
+}
+
+/*
+ * Collect the per-kernel [BENCH_START]...[BENCH_END] blocks of a MACHINE
+ * run; variant blocks, cold/polluted cache-state blocks and everything
+ * else ([TIMER], [SUMMARY], ...) are skipped.
+ */
+static int parse_machine(const char *text)
+{
+    baseline_entry_t *cur = NULL;
+
+    num_entries = 0;
+
+    while (*text) {
+        const char *line = text;
+        const char *end = strchr(line, '\n');
+        if (!end) end = line + strlen(line);
+        text = *end ? end + 1 : end;
+        if (end > line && end[-1] == '\r') end--;
+
+        if (end - line == 13 && strncmp(line, "[BENCH_START]", 13) == 0) {
+            cur = num_entries < MAX_KERNELS ? &entries[num_entries] : NULL;
+            if (cur) memset(cur, 0, sizeof(*cur));
+            continue;
+        }
+        if (end - line == 11 && strncmp(line, "[BENCH_END]", 11) == 0) {
+            if (cur && cur->kernel[0] && cur->runs_pass > 0) num_entries++;
+            cur = NULL;
+            continue;
+        }
+        if (!cur) continue;
+
+        const char *eq = line;
+        while (eq < end && *eq != '=') eq++;
+        if (eq == end) continue;
+        const char *val = eq + 1;
+
+        if (key_is(line, eq, "variant")) {
+            cur = NULL;         /* Variant rows are not baselines */
+        } else if (key_is(line, eq, "cache")) {
+            cur = NULL;         /* Nor are rows past a flush or pollution */
+        } else if (key_is(line, eq, "kernel")) {
+            copy_field(cur->kernel, sizeof(cur->kernel), val, end);
+        } else if (key_is(line, eq, "tier")) {
+            copy_field(cur->tier, sizeof(cur->tier), val, end);
+        } else if (key_is(line, eq, "cycles_avg")) {
+            cur->cycles_avg = parse_u64(val, end);
+        } else if (key_is(line, eq, "cycles_median")) {
+            cur->cycles_median = parse_u64(val, end);
+        } else if (key_is(line, eq, "cycles_ci95")) {
+            cur->cycles_ci95 = parse_u64(val, end);
+        } else if (key_is(line, eq, "runs_pass")) {
+            cur->runs_pass = (int)parse_u64(val, end);
+        }
+    }
+
+    return num_entries;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+/*
+ * Load a baseline from a file (native) or, with path == NULL, from the
+ * linked-in blob. Returns false when nothing usable was found.
+ */
+bool baseline_load(const char *path)
+{
+    if (!path) {
+#ifdef BENCH_BASELINE_FILE
+        return parse_machine(baseline_blob) > 0;
+#else
+        return false;
+#endif
+    }
+
+#ifdef NATIVE_BUILD
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        printf("Cannot open baseline file: %s\n", path);
+        return false;
+    }
+
+    /* One byte past the limit tells a full file from a too-large one */
+    char *text = malloc(BASELINE_MAX_FILE + 2);
+    size_t len = text ? fread(text, 1, BASELINE_MAX_FILE + 1, f) : 0;
+    bool read_error = ferror(f) != 0;
+    fclose(f);
+    if (!text) {
+        printf("Out of memory reading baseline file: %s\n", path);
+        return false;
+    }
+    if (read_error || len > BASELINE_MAX_FILE) {
+        if (read_error) {
+            printf("Cannot read baseline file: %s\n", path);
+        } else {
+            printf("Baseline file larger than %d bytes: %s\n", BASELINE_MAX_FILE, path);
+        }
+        free(text);
+        return false;
+    }
+    text[len] = '\0';
+
+    int count = parse_machine(text);
+    free(text);
+    if (count == 0) {
+        printf("No kernel results in baseline file: %s\n", path);
+    }
+    return count > 0;
+#else
+    printf("Baseline files need a native build; link one in with BENCH_BASELINE=FILE\n");
+    return false;
+#endif
+}
+
+/* Whether a baseline blob was linked in at build time */
+bool baseline_builtin(void)
+{
+#ifdef BENCH_BASELINE_FILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+int baseline_count(void)
+{
+    return num_entries;
+}
+
+const baseline_entry_t *baseline_find(const char *kernel)
+{
+    for (int i = 0; i < num_entries; i++) {
+        if (strcmp(entries[i].kernel, kernel) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
@@ -55,6 +55,20 @@
     #define ARCH_NAME "unknown"
 #endif
 
+/*
+ * Per-copy storage for kernel and harness state. Rate mode (rate.c) runs
+ * several copies of a kernel at once, so every mutable static is declared
+ * BENCH_TLS. Only rate builds make it thread-local: native builds with
+ * BENCH_RATE (pthread copies) and bare-metal builds with BENCH_MPE, where
+ * rate.c points each hart's tp at its own TLS block. Everywhere else the
+ * statics stay plain, so single-copy codegen is untouched.
+ */
+#if (defined(NATIVE_BUILD) && defined(BENCH_RATE)) || defined(BENCH_MPE)
+    #define BENCH_TLS __thread
+#else
+    #define BENCH_TLS
+#endif
+
 /* ============================================================================
  * Memory Barrier
  * ============================================================================ */
@@ -91,6 +105,33 @@ INLINE uint64_t read_cycles(void)
     return ((uint64_t)hi << 32) | lo;
 }
 
+/* Region start: earlier instructions retire before, later ones issue after */
+INLINE uint64_t read_cycles_start(void)
+{
+    uint32_t lo, hi;
+    __asm__ volatile (
+        "lfence\n\t"
+        "rdtsc\n\t"
+        "lfence"
+        : "=a"(lo), "=d"(hi)
+        :: "memory"
+    );
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* Region end: rdtscp waits for the region to retire */
+INLINE uint64_t read_cycles_end(void)
+{
+    uint32_t lo, hi;
+    __asm__ volatile (
+        "rdtscp\n\t"
+        "lfence"
+        : "=a"(lo), "=d"(hi)
+        :: "rcx", "memory"
+    );
+    return ((uint64_t)hi << 32) | lo;
+}
+
 #elif defined(ARCH_RISCV64)
 
 INLINE uint64_t read_cycles(void)
@@ -113,6 +154,31 @@ INLINE uint64_t read_instret(void)
     return instret;
 }
 
+/* Fenced reads: outstanding memory accesses complete before the counter read */
+INLINE uint64_t read_cycles_start(void)
+{
+    uint64_t cycles;
+    __asm__ volatile (
+        "fence rw, rw\n\t"
+        "rdcycle %0"
+        : "=r"(cycles)
+        :: "memory"
+    );
+    return cycles;
+}
+
+INLINE uint64_t read_cycles_end(void)
+{
+    uint64_t cycles;
+    __asm__ volatile (
+        "fence rw, rw\n\t"
+        "rdcycle %0"
+        : "=r"(cycles)
+        :: "memory"
+    );
+    return cycles;
+}
+
 #elif defined(ARCH_RISCV32)
 
 INLINE uint64_t read_cycles(void)
@@ -129,6 +195,18 @@ INLINE uint64_t read_cycles(void)
     return ((uint64_t)hi << 32) | lo;
 }
 
+INLINE uint64_t read_cycles_start(void)
+{
+    __asm__ volatile ("fence rw, rw" ::: "memory");
+    return read_cycles();
+}
+
+INLINE uint64_t read_cycles_end(void)
+{
+    __asm__ volatile ("fence rw, rw" ::: "memory");
+    return read_cycles();
+}
+
 #else
 
 INLINE uint64_t read_cycles(void)
@@ -137,15 +215,151 @@ INLINE uint64_t read_cycles(void)
     return (uint64_t)uptime() * 1000;  /* Convert ms to rough cycle estimate */
 }
 
+#define read_cycles_start() read_cycles()
+#define read_cycles_end()   read_cycles()
+
 #endif
 
+/*
+ * Timer calibration (main.c), measured at startup from empty
+ * BENCH_START()/BENCH_END() regions:
+ *   overhead    minimum empty-region cycles, subtracted by BENCH_CYCLES()
+ *   jitter      spread of empty regions above the minimum (90th percentile)
+ *   resolution  smallest non-zero step between back-to-back counter reads
+ */
+typedef struct {
+    uint64_t overhead;
+    uint64_t jitter;
+    uint64_t resolution;
+} bench_timer_t;
+
+extern bench_timer_t bench_timer;
+
+void bench_calibrate_timer(void);
+
+/* Region cycles net of the calibrated timer overhead */
+INLINE uint64_t bench_region_cycles(uint64_t raw)
+{
+    return raw > bench_timer.overhead ? raw - bench_timer.overhead : 0;
+}
+
+/* ============================================================================
+ * Hardware Performance Counters (pmu.c)
+ * Captured around the BENCH_START()/BENCH_END() region when pmu_init()
+ * succeeded; disabled capture costs one predictable branch per region.
+ * ============================================================================ */
+
+typedef enum {
+    PMU_INSTRET,            /* Instructions retired */
+    PMU_BRANCH_MISS,        /* Branch mispredictions */
+    PMU_L1D_MISS,           /* L1 data cache misses */
+    PMU_L2_MISS,            /* L2 misses (last-level cache on native) */
+    PMU_NUM_EVENTS
+} pmu_event_t;
+
+extern BENCH_TLS bool pmu_enabled;   /* Set only on the thread that called pmu_init() */
+
+bool pmu_init(void);
+bool pmu_event_available(pmu_event_t event);
+const char *pmu_event_name(pmu_event_t event);
+void pmu_begin(void);
+void pmu_end(void);
+void pmu_read_region(uint64_t *count);
+
+INLINE void pmu_region_begin(void)
+{
+    if (UNLIKELY(pmu_enabled)) pmu_begin();
+}
+
+INLINE void pmu_region_end(void)
+{
+    if (UNLIKELY(pmu_enabled)) pmu_end();
+}
+
+/* ============================================================================
+ * Simulator Region of Interest (roi.c)
+ * Marks the BENCH_START()/BENCH_END() window for NEMU/XiangShan runs so the
+ * simulator can fast-forward init and warmup, checkpoint at ROI entry and
+ * simulate only the measured region in detail. Build with BENCH_ROI=nemu;
+ * the harness arms the markers for the runs picked with --roi.
+ * ============================================================================ */
+
+extern BENCH_TLS bool roi_armed;
+
+bool roi_available(void);
+const char *roi_backend_name(void);
+void roi_begin(void);
+void roi_end(void);
+int roi_regions(void);
+
+INLINE void roi_region_begin(void)
+{
+    if (UNLIKELY(roi_armed)) roi_begin();
+}
+
+INLINE void roi_region_end(void)
+{
+    if (UNLIKELY(roi_armed)) roi_end();
+}
+
 /* ============================================================================
  * Timing Macros
+ * The ROI encloses the PMU window, which encloses the serialized cycle
+ * reads; BENCH_CYCLES() excludes the calibrated cost of the reads. The
+ * --cache state is set up first, outside all three.
  * ============================================================================ */
 
-#define BENCH_START()       uint64_t _bench_start = read_cycles()
-#define BENCH_END()         uint64_t _bench_end = read_cycles()
-#define BENCH_CYCLES()      (_bench_end - _bench_start)
+#define BENCH_START()       cache_region_begin(); roi_region_begin(); pmu_region_begin(); uint64_t _bench_start = read_cycles_start()
+#define BENCH_END()         uint64_t _bench_end = read_cycles_end(); pmu_region_end(); roi_region_end()
+#define BENCH_CYCLES()      bench_region_cycles(_bench_end - _bench_start)
+
+/* ============================================================================
+ * Phase Timers
+ * BENCH_PHASE_BEGIN(id)/BENCH_PHASE_END(id) accumulate cycles for a named
+ * stage of the timed region. Each kernel numbers its phases 0..N-1 and
+ * lists their names in KERNEL_DECLARE; phases may nest, and a phase's
+ * parent is the one open when it began. Phase reads are unserialized and
+ * not overhead-corrected, to keep them cheap. They are compiled in only with
+ * -DBENCH_PHASES (make BENCH_PHASES=1), so scored builds do not pay for them.
+ * ============================================================================ */
+
+#define BENCH_MAX_PHASES    8
+
+typedef struct {
+    uint64_t start;         /* read_cycles() at the open BENCH_PHASE_BEGIN */
+    uint64_t cycles;        /* Inclusive cycles since the last reset */
+    uint32_t count;         /* Completed BEGIN/END pairs since the last reset */
+    int      parent;        /* Enclosing phase, -1 at top level */
+} bench_phase_t;
+
+extern BENCH_TLS bench_phase_t bench_phase_table[BENCH_MAX_PHASES];
+extern BENCH_TLS int bench_phase_current;  /* Innermost open phase, -1 if none */
+
+void bench_phase_reset(void);
+
+INLINE void bench_phase_begin(int id)
+{
+    bench_phase_t *p = &bench_phase_table[id];
+    p->parent = bench_phase_current;
+    bench_phase_current = id;
+    p->start = read_cycles();
+}
+
+INLINE void bench_phase_end(int id)
+{
+    bench_phase_t *p = &bench_phase_table[id];
+    p->cycles += read_cycles() - p->start;
+    p->count++;
+    bench_phase_current = p->parent;
+}
+
+#ifdef BENCH_PHASES
+#define BENCH_PHASE_BEGIN(id)   bench_phase_begin(id)
+#define BENCH_PHASE_END(id)     bench_phase_end(id)
+#else
+#define BENCH_PHASE_BEGIN(id)   ((void)0)
+#define BENCH_PHASE_END(id)     ((void)0)
+#endif
 
 /* Prevent optimization of benchmark code */
 #define BENCH_VOLATILE(x) __asm__ volatile ("" :: "r"(x) : "memory")
@@ -161,6 +375,8 @@ typedef struct {
     uint64_t cycles;        /* Execution cycles */
     uint32_t checksum;      /* Result checksum for verification */
     int      status;        /* 0 = success, non-zero = error */
+    uint64_t work;          /* Kernel-counted work units (search nodes, ...), 0 = none */
+    uint64_t counters[PMU_NUM_EVENTS];  /* Filled in by the harness */
 } bench_result_t;
 
 /* Status codes */
@@ -169,6 +385,105 @@ typedef struct {
 #define BENCH_ERR_TIMEOUT   2
 #define BENCH_ERR_INTERNAL  3
 
+/* ============================================================================
+ * Working-Set Tiers and Kernel Arena
+ *
+ * Kernels size their data from the Makefile base parameters scaled by the
+ * run-time tier, and take storage from a shared arena that is reset before
+ * each kernel's init(). Tier S is the cache-resident default build size.
+ * ============================================================================ */
+
+typedef enum {
+    TIER_S,                 /* x1    : base sizes, L1-resident */
+    TIER_M,                 /* x16   : L2-resident */
+    TIER_L,                 /* x256  : LLC-resident */
+    TIER_XL,                /* x4096 : DRAM-bound */
+    TIER_COUNT
+} bench_tier_t;
+
+extern bench_tier_t bench_tier;
+
+const char *bench_tier_name(bench_tier_t tier);
+
+/* Scaled counts above INT32_MAX cannot fit the arena; fatal like exhaustion */
+void bench_scale_overflow(uint32_t base, unsigned shift);
+
+/* Scale an element count by the current tier (x16 per tier) */
+INLINE uint32_t bench_scale(uint32_t base)
+{
+    uint64_t n = (uint64_t)base << (4 * bench_tier);
+    if (UNLIKELY(n > INT32_MAX)) bench_scale_overflow(base, 4 * bench_tier);
+    return (uint32_t)n;
+}
+
+/* Scale one side of a square 2-D working set (area grows x16 per tier) */
+INLINE uint32_t bench_scale_dim(uint32_t base)
+{
+    uint64_t n = (uint64_t)base << (2 * bench_tier);
+    if (UNLIKELY(n > INT32_MAX)) bench_scale_overflow(base, 2 * bench_tier);
+    return (uint32_t)n;
+}
+
+#ifndef BENCH_ARENA_SIZE
+#define BENCH_ARENA_SIZE    (1ULL << 30)    /* Native arena; nexus-am uses the AM heap */
+#endif
+
+#define BENCH_ARENA_ALIGN   64
+
+void *bench_alloc(size_t size);     /* Zeroed, cache-line aligned; fatal when exhausted */
+void bench_arena_reset(void);
+size_t bench_arena_used(void);
+uint8_t *bench_arena_base(void);    /* Start of kernel storage (harness use) */
+size_t bench_arena_size(void);
+
+/* ============================================================================
+ * Cache State (cache.c)
+ *
+ * --cache picks the state of the caches at the start of each measured
+ * run. Warm leaves them as the previous run did. Cold evicts the kernel's
+ * data: the arena in use plus any static tables its init() registered
+ * with bench_cache_region(). It uses a line flush where the ISA has one
+ * (clflush, Zicbom cbo.flush) and otherwise sweeps a BENCH_FLUSH_SIZE
+ * buffer. Polluted streams --pollute=KB of unrelated lines through the
+ * caches first. The harness arms the state for the measured runs and
+ * BENCH_START() applies it, so set-up a kernel does in run() before its
+ * timed region (resetting a network, restoring a tree) cannot re-warm the
+ * data, and with -i N every invocation starts in the state. Warmup runs
+ * still train code and predictors.
+ * ============================================================================ */
+
+typedef enum {
+    CACHE_WARM,
+    CACHE_COLD,
+    CACHE_POLLUTED,
+    CACHE_NUM_STATES
+} bench_cache_t;
+
+#ifndef BENCH_FLUSH_SIZE
+  #ifdef NATIVE_BUILD
+    #define BENCH_FLUSH_SIZE    (128ULL << 20)  /* Past the LLC of current desktop and server parts */
+  #else
+    #define BENCH_FLUSH_SIZE    (8ULL << 20)
+  #endif
+#endif
+
+#define BENCH_CACHE_LINE        64
+#define BENCH_MAX_CACHE_REGIONS 16
+
+extern BENCH_TLS bool cache_armed;      /* A state other than warm is armed */
+
+void bench_cache_region(const void *ptr, size_t size);  /* From init(): static working set */
+void bench_cache_reset(void);                           /* Forget registered regions */
+void bench_cache_arm(bench_cache_t state, uint32_t pollute_kb);  /* CACHE_WARM disarms */
+void bench_cache_prepare(void);                         /* Set up the armed state now */
+const char *bench_cache_name(bench_cache_t state);
+const char *bench_cache_method(void);                   /* "clflush", "cbo.flush" or "sweep" */
+
+INLINE void cache_region_begin(void)
+{
+    if (UNLIKELY(cache_armed)) bench_cache_prepare();
+}
+
 /* ============================================================================
  * Kernel Function Signature
  * ============================================================================ */
@@ -177,6 +492,36 @@ typedef void (*kernel_init_t)(void);
 typedef bench_result_t (*kernel_func_t)(void);
 typedef void (*kernel_cleanup_t)(void);
 
+/* ============================================================================
+ * Kernel Variants (variant.c)
+ *
+ * A kernel's run function is the SPEC-faithful reference. Kernels may add
+ * a table of alternative implementations (SIMD, RVV, cache-optimized)
+ * selected with --variant; a variant runs only where the host has every
+ * ISA feature it requires, and must reproduce the reference checksum.
+ * Tables are listed best first and end with a NULL name.
+ * ============================================================================ */
+
+typedef enum {
+    ISA_SSE2        = 1 << 0,
+    ISA_SSE41       = 1 << 1,
+    ISA_AVX2        = 1 << 2,
+    ISA_AVX512BW    = 1 << 3,
+    ISA_RVV         = 1 << 4,
+    ISA_ZBB         = 1 << 5,
+    ISA_NUM_FEATURES = 6
+} bench_isa_t;
+
+typedef struct {
+    const char     *name;               /* Variant name ("avx2", "rvv", ...) */
+    uint32_t        isa;                /* Required bench_isa_t features (0 = any) */
+    kernel_func_t   run;                /* Replaces the reference run function */
+} kernel_variant_t;
+
+uint32_t bench_isa(void);                           /* Features of this host */
+const char *bench_isa_name(bench_isa_t feature);
+bool variant_available(const kernel_variant_t *variant);
+
 /* ============================================================================
  * Kernel Descriptor
  * ============================================================================ */
@@ -190,6 +535,8 @@ typedef struct {
     kernel_cleanup_t cleanup;           /* Cleanup (can be NULL) */
     uint32_t        expected_checksum;  /* Expected checksum for verification */
     uint32_t        default_iterations; /* Default iteration count */
+    const char     *phases[BENCH_MAX_PHASES];  /* Phase names by id, unused slots NULL */
+    const kernel_variant_t *variants;   /* Alternative implementations (can be NULL) */
 } kernel_desc_t;
 
 /* ============================================================================
@@ -207,29 +554,81 @@ int kernel_count(void);
  * Benchmark Execution
  * ============================================================================ */
 
+#define MAX_SELECT 32
+#define BENCH_MAX_SAMPLES 64    /* Per-run cycle samples kept in bench_stats_t */
+
 typedef struct {
     int      warmup_runs;
-    int      measure_runs;
-    uint32_t iterations;
+    int      measure_runs;      /* Fixed run count, or the minimum when adaptive */
+    int      max_runs;          /* Adaptive mode: stop here if the CI target is not met */
+    uint32_t ci_target_x100;    /* Adaptive mode: 95% CI half-width target, % of mean x100 (0 = off) */
+    bool     median;            /* Summary scores/geomean from medians instead of averages */
+    uint32_t iterations;        /* Kernel invocations per measured run (0 = 1) */
     bool     verify;
     bool     verbose;
+    bool     list_only;         /* Print registered kernels and exit */
+    bool     pmu;               /* Capture hardware performance counters */
+    int      copies;            /* Concurrent copies per kernel (1 = off) */
+    int      threads;           /* Worker threads for bench_parallel() (1 = off) */
+    const char *roi_kernel;     /* --roi target kernel, "all", or NULL (markers off) */
+    int      roi_run;           /* Measured run to mark, 1-based (0 = every run) */
+    const char *baseline;       /* MACHINE results to compare against (NULL = blob, if any) */
+    uint32_t regress_x100;      /* Regression threshold, % slower x100 */
+    const char *variant;        /* --variant: "auto", "all", a variant name, or NULL (reference only) */
+    uint32_t cache_states;      /* bench_cache_t bits to measure; bench_run() takes the lowest */
+    uint32_t pollute_kb;        /* Interfering traffic for CACHE_POLLUTED */
+    int      num_select;        /* 0 = run every registered kernel */
+    const char *select[MAX_SELECT]; /* Kernel names or source_benchmark groups */
 } bench_config_t;
 
 #define BENCH_CONFIG_DEFAULT { \
     .warmup_runs = 2,         \
     .measure_runs = 5,        \
+    .max_runs = 50,           \
+    .ci_target_x100 = 0,      \
+    .median = false,          \
     .iterations = 0,          \
     .verify = true,           \
-    .verbose = false          \
+    .verbose = false,         \
+    .list_only = false,       \
+    .pmu = false,             \
+    .copies = 1,              \
+    .threads = 1,             \
+    .roi_kernel = NULL,       \
+    .roi_run = 0,             \
+    .baseline = NULL,         \
+    .regress_x100 = 500,      \
+    .variant = NULL,          \
+    .cache_states = 1u << CACHE_WARM, \
+    .pollute_kb = 1024,       \
+    .num_select = 0           \
 }
 
 typedef struct {
     const kernel_desc_t *kernel;
+    const kernel_variant_t *variant;    /* NULL for the reference */
+    bench_cache_t cache_state;
     uint64_t cycles_min;
     uint64_t cycles_max;
     uint64_t cycles_avg;
     uint64_t cycles_total;
+    uint64_t cycles_median;
+    uint64_t cycles_stddev;     /* Sample standard deviation */
+    uint64_t cycles_ci95;       /* 95% confidence interval half-width (Student t) */
+    uint64_t samples[BENCH_MAX_SAMPLES];    /* Per-run cycles of passing runs */
+    int      num_samples;
     uint32_t checksum;
+    uint64_t counters_avg[PMU_NUM_EVENTS];  /* Per-run average (if pmu_enabled) */
+    uint64_t work_avg;          /* Per-run average of bench_result_t.work */
+    uint64_t phase_cycles[BENCH_MAX_PHASES];    /* Per-run average cycles by phase */
+    uint32_t phase_count[BENCH_MAX_PHASES];     /* Per-run average calls by phase */
+    int      phase_parent[BENCH_MAX_PHASES];
+    int      num_phases;
+    size_t   arena_bytes;       /* Arena storage taken by init() */
+    uint64_t rate_cycles_avg;   /* Mean of per-copy cycles_avg (rate mode) */
+    uint64_t rate_cycles_max;   /* Slowest copy's cycles_avg (rate mode) */
+    uint64_t speedup_x100;      /* Reference over variant summary cycles, x100 */
+    uint64_t vs_warm_x100;      /* Summary cycles over the warm row's, x100 (0 = none) */
     int      runs_total;
     int      runs_pass;
     int      runs_fail;
@@ -237,7 +636,116 @@ typedef struct {
 } bench_stats_t;
 
 bench_stats_t bench_run(const kernel_desc_t *kernel, const bench_config_t *config);
-void bench_run_all(const bench_config_t *config);
+int bench_run_all(const bench_config_t *config);    /* Non-zero: baseline regression */
+bool bench_kernel_selected(const kernel_desc_t *kernel, const bench_config_t *config);
+void bench_list_kernels(void);
+
+/* ============================================================================
+ * Rate Mode (rate.c)
+ *
+ * With --copies=N every kernel is measured alone first, then as N copies
+ * running at the same time (pthreads natively, MPE harts on nexus-am).
+ * Copy 0 runs on the main thread / hart 0; each copy has its own arena
+ * and BENCH_TLS state, and copies line up in rate_barrier() before each
+ * measured run.
+ * ============================================================================ */
+
+#ifndef BENCH_MAX_COPIES
+#define BENCH_MAX_COPIES    16
+#endif
+
+extern BENCH_TLS int bench_copy_id;     /* This copy, 0 .. bench_copies-1 */
+extern int bench_copies;                /* Copies started by rate_start() */
+
+void rate_tls_init(void);
+bool rate_start(int copies, int (*entry)(void));
+void rate_run(const kernel_desc_t *kernel, const bench_config_t *config,
+              bench_stats_t *copy_stats);
+void rate_barrier(void);
+
+/* ============================================================================
+ * Intra-kernel Threads (parallel.c)
+ *
+ * With --threads=N a kernel can split one run across N threads:
+ * bench_parallel(fn, arg) runs fn(tid, n, arg) for tid 0..n-1 at once, task
+ * 0 on the calling thread, and returns n. Tasks run on other threads, so
+ * they must not touch BENCH_TLS state; everything goes through arg. Bare
+ * metal and rate mode run a single task (n = 1).
+ * ============================================================================ */
+
+#ifndef BENCH_MAX_THREADS
+#define BENCH_MAX_THREADS   64
+#endif
+
+typedef void (*bench_task_t)(int tid, int nthreads, void *arg);
+
+extern int bench_threads;               /* --threads=N (1 = off) */
+
+int bench_parallel(bench_task_t fn, void *arg);
+
+/* ============================================================================
+ * Baseline Comparison (baseline.c)
+ *
+ * A previous run's MACHINE output is the reference: --baseline=FILE
+ * natively, or a blob linked in with BENCH_BASELINE=FILE. Each kernel is
+ * compared on the summary cycles (average, or median with --median); a
+ * change is significant when it exceeds the combined 95% CIs, and a
+ * significant slowdown past --threshold makes the run exit non-zero.
+ * ============================================================================ */
+
+typedef struct {
+    char     kernel[32];
+    char     tier[4];
+    uint64_t cycles_avg;
+    uint64_t cycles_median;
+    uint64_t cycles_ci95;
+    int      runs_pass;
+} baseline_entry_t;
+
+bool baseline_load(const char *path);       /* NULL = linked-in blob */
+bool baseline_builtin(void);
+int baseline_count(void);
+const baseline_entry_t *baseline_find(const char *kernel);
+
+/* ============================================================================
+ * Run-Time Configuration
+ *
+ * Native builds take options from the command line, nexus-am builds from the
+ * boot-argument string (make mainargs="..."). BENCH_DEFAULT_ARGS, if defined
+ * at compile time, is an embedded argument string applied before either.
+ *
+ *   [options] [kernel|benchmark ...]
+ *   -w, --warmup=N       warmup runs per kernel
+ *   -r, --runs=N         measured runs per kernel (minimum with --ci)
+ *   --ci=PCT             adaptive: run until the 95% CI is within +/-PCT% of the mean
+ *   --max-runs=N         adaptive: upper bound on measured runs
+ *   --median             score and geomean from per-kernel medians
+ *   -i, --iterations=N   kernel invocations per measured run
+ *   -f, --format=FMT     human | csv | machine
+ *   -l, --list           list registered kernels
+ *   -p, --pmu            capture hardware performance counters
+ *   -t, --tier=T         working-set tier: S, M, L, XL
+ *   -c, --copies=N       rate mode: N concurrent copies per kernel
+ *   --threads=N          worker threads for multi-threaded kernel variants
+ *   --roi=KERNEL[:RUN]   simulator ROI markers on one measured run (default 1)
+ *   --roi=all            simulator ROI markers on every measured run
+ *   --baseline=FILE      compare against a saved MACHINE run
+ *   --threshold=PCT      regression limit for --baseline (default 5)
+ *   --variant=V          also run variants: auto (best available), all, or a name
+ *   --cache=S[,S...]     cache state per measured run: warm, cold, polluted, or all
+ *   --pollute=KB         interfering traffic for --cache=polluted (default 1024)
+ *   -v, --verbose        verbose output
+ *   --no-verify          skip checksum verification
+ *
+ * Positional arguments select kernels by name ("bwt_sort") or by source
+ * benchmark ("401.bzip2" or "bzip2").
+ * ============================================================================ */
+
+#define BENCH_ARGS_MAX      512     /* Max length of a boot-argument string */
+#define BENCH_ARGV_MAX      64      /* Max number of arguments */
+
+int bench_parse_args(bench_config_t *config, int argc, char **argv);
+int bench_parse_argstr(bench_config_t *config, const char *args);
 
 /* ============================================================================
  * Result Reporting
@@ -280,8 +788,17 @@ uint32_t checksum_array64(const uint64_t *arr, size_t count);
  * Utility Macros for Kernel Implementation
  * ============================================================================ */
 
-/* KERNEL_DECLARE creates a globally visible kernel descriptor */
-#define KERNEL_DECLARE(kname, kdesc, ksrc, kinit, krun, kcleanup, kchecksum, kiter) \
+/*
+ * KERNEL_DECLARE creates a globally visible kernel descriptor
+ * Trailing arguments name the kernel's phases in id order.
+ * KERNEL_DECLARE_VARIANTS also attaches a kernel_variant_t table.
+ */
+#define KERNEL_DECLARE(kname, kdesc, ksrc, kinit, krun, kcleanup, kchecksum, kiter, ...) \
+    KERNEL_DECLARE_VARIANTS(kname, kdesc, ksrc, kinit, krun, kcleanup, kchecksum, kiter, \
+                            NULL, __VA_ARGS__)
+
+#define KERNEL_DECLARE_VARIANTS(kname, kdesc, ksrc, kinit, krun, kcleanup, kchecksum, kiter, \
+                                kvariants, ...)                                     \
     const kernel_desc_t kernel_##kname = {                                          \
         .name = #kname,                                                             \
         .description = kdesc,                                                       \
@@ -290,7 +807,9 @@ uint32_t checksum_array64(const uint64_t *arr, size_t count);
         .run = krun,                                                                \
         .cleanup = kcleanup,                                                        \
         .expected_checksum = kchecksum,                                             \
-        .default_iterations = kiter                                                 \
+        .default_iterations = kiter,                                                \
+        .phases = { __VA_ARGS__ },                                                  \
+        .variants = kvariants                                                       \
     }
 
 /* KERNEL_REGISTER is now a no-op since we register manually in main */
@@ -318,5 +837,6 @@ extern const kernel_desc_t kernel_intra_predict;
 extern const kernel_desc_t kernel_priority_queue;
 extern const kernel_desc_t kernel_astar_path;
 extern const kernel_desc_t kernel_xpath_eval;
+extern const kernel_desc_t kernel_bzip2_pipeline;
 
 #endif /* BENCH_H */
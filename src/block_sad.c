@@ -9,9 +9,17 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+#if defined(__riscv_vector)
+  #include <riscv_vector.h>
+#endif
 
 /* ============================================================================
  * Configuration
+ * FRAME_WIDTH/FRAME_HEIGHT are the tier S frame, scaled by bench_scale_dim();
+ * both must be multiples of BLOCK_SIZE (1920x1088 for 1080p).
  * ============================================================================ */
 
 #ifndef FRAME_WIDTH
@@ -34,10 +42,23 @@
  * Data Structures
  * ============================================================================ */
 
-static uint8_t current_frame[FRAME_HEIGHT][FRAME_WIDTH];
-static uint8_t reference_frame[FRAME_HEIGHT][FRAME_WIDTH];
-static int16_t mv_x[FRAME_HEIGHT / BLOCK_SIZE][FRAME_WIDTH / BLOCK_SIZE];
-static int16_t mv_y[FRAME_HEIGHT / BLOCK_SIZE][FRAME_WIDTH / BLOCK_SIZE];
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_DIAMOND, PHASE_FULL };
+
+/* Row-major frames and per-macroblock vectors, arena-allocated in init */
+static BENCH_TLS uint8_t *current_frame;
+static BENCH_TLS uint8_t *reference_frame;
+static BENCH_TLS int16_t *mv_x;
+static BENCH_TLS int16_t *mv_y;
+static BENCH_TLS int frame_width;
+static BENCH_TLS int frame_height;
+
+/*
+ * Multi-candidate SAD: one 16x16 current block against four reference
+ * positions, so the current rows are loaded once per four candidates
+ */
+typedef void (*sad_x4_t)(const uint8_t *cur, int stride,
+                         const uint8_t *const ref[4], uint32_t sad[4]);
 
 /* ============================================================================
  * SAD Computation Functions
@@ -99,6 +120,130 @@ static uint32_t sad_4x4(const uint8_t *cur, int cur_stride,
     return sad;
 }
 
+/* ============================================================================
+ * Multi-Candidate SAD Variants
+ * ============================================================================ */
+
+/* Portable batch: the reference SAD per candidate */
+static void sad_16x16_x4_c(const uint8_t *cur, int stride,
+                           const uint8_t *const ref[4], uint32_t sad[4])
+{
+    for (int i = 0; i < 4; i++) {
+        sad[i] = sad_16x16(cur, stride, ref[i], stride);
+    }
+}
+
+#if defined(ARCH_X86_64)
+
+/* psadbw per row: two 8-byte partial sums per candidate */
+static void sad_16x16_x4_sse2(const uint8_t *cur, int stride,
+                              const uint8_t *const ref[4], uint32_t sad[4])
+{
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128();
+    __m128i acc3 = _mm_setzero_si128();
+
+    for (int y = 0; y < 16; y++) {
+        int off = y * stride;
+        __m128i c = _mm_loadu_si128((const __m128i *)(cur + off));
+        acc0 = _mm_add_epi32(acc0, _mm_sad_epu8(c, _mm_loadu_si128((const __m128i *)(ref[0] + off))));
+        acc1 = _mm_add_epi32(acc1, _mm_sad_epu8(c, _mm_loadu_si128((const __m128i *)(ref[1] + off))));
+        acc2 = _mm_add_epi32(acc2, _mm_sad_epu8(c, _mm_loadu_si128((const __m128i *)(ref[2] + off))));
+        acc3 = _mm_add_epi32(acc3, _mm_sad_epu8(c, _mm_loadu_si128((const __m128i *)(ref[3] + off))));
+    }
+
+    sad[0] = (uint32_t)(_mm_cvtsi128_si32(acc0) + _mm_cvtsi128_si32(_mm_srli_si128(acc0, 8)));
+    sad[1] = (uint32_t)(_mm_cvtsi128_si32(acc1) + _mm_cvtsi128_si32(_mm_srli_si128(acc1, 8)));
+    sad[2] = (uint32_t)(_mm_cvtsi128_si32(acc2) + _mm_cvtsi128_si32(_mm_srli_si128(acc2, 8)));
+    sad[3] = (uint32_t)(_mm_cvtsi128_si32(acc3) + _mm_cvtsi128_si32(_mm_srli_si128(acc3, 8)));
+}
+
+/* Two rows per 256-bit register */
+__attribute__((target("avx2")))
+static inline __m256i load_rows_avx2(const uint8_t *p, int stride)
+{
+    __m128i lo = _mm_loadu_si128((const __m128i *)p);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(p + stride));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t hsum_sad_avx2(__m256i acc)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return (uint32_t)(_mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+}
+
+/* vpsadbw on row pairs: 8 iterations instead of 16 */
+__attribute__((target("avx2")))
+static void sad_16x16_x4_avx2(const uint8_t *cur, int stride,
+                              const uint8_t *const ref[4], uint32_t sad[4])
+{
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+
+    for (int y = 0; y < 16; y += 2) {
+        int off = y * stride;
+        __m256i c = load_rows_avx2(cur + off, stride);
+        acc0 = _mm256_add_epi32(acc0, _mm256_sad_epu8(c, load_rows_avx2(ref[0] + off, stride)));
+        acc1 = _mm256_add_epi32(acc1, _mm256_sad_epu8(c, load_rows_avx2(ref[1] + off, stride)));
+        acc2 = _mm256_add_epi32(acc2, _mm256_sad_epu8(c, load_rows_avx2(ref[2] + off, stride)));
+        acc3 = _mm256_add_epi32(acc3, _mm256_sad_epu8(c, load_rows_avx2(ref[3] + off, stride)));
+    }
+
+    sad[0] = hsum_sad_avx2(acc0);
+    sad[1] = hsum_sad_avx2(acc1);
+    sad[2] = hsum_sad_avx2(acc2);
+    sad[3] = hsum_sad_avx2(acc3);
+}
+
+#endif /* ARCH_X86_64 */
+
+#if defined(__riscv_vector)
+
+/* |c - r| as maxu - minu, widened and summed into element 0 of acc */
+static inline vuint16m1_t sad_row_rvv(vuint8m1_t c, const uint8_t *ref,
+                                      vuint16m1_t acc, size_t vl)
+{
+    vuint8m1_t r = __riscv_vle8_v_u8m1(ref, vl);
+    vuint8m1_t d = __riscv_vsub_vv_u8m1(__riscv_vmaxu_vv_u8m1(c, r, vl),
+                                        __riscv_vminu_vv_u8m1(c, r, vl), vl);
+    return __riscv_vwredsumu_vs_u8m1_u16m1(d, acc, vl);
+}
+
+/* Strip-mined over the 16-byte row, so any VLEN works; 16x16x255 fits u16 */
+static void sad_16x16_x4_rvv(const uint8_t *cur, int stride,
+                             const uint8_t *const ref[4], uint32_t sad[4])
+{
+    vuint16m1_t acc0 = __riscv_vmv_s_x_u16m1(0, 1);
+    vuint16m1_t acc1 = acc0;
+    vuint16m1_t acc2 = acc0;
+    vuint16m1_t acc3 = acc0;
+
+    for (int y = 0; y < 16; y++) {
+        int off = y * stride;
+        for (int x = 0; x < 16; ) {
+            size_t vl = __riscv_vsetvl_e8m1(16 - x);
+            vuint8m1_t c = __riscv_vle8_v_u8m1(cur + off + x, vl);
+            acc0 = sad_row_rvv(c, ref[0] + off + x, acc0, vl);
+            acc1 = sad_row_rvv(c, ref[1] + off + x, acc1, vl);
+            acc2 = sad_row_rvv(c, ref[2] + off + x, acc2, vl);
+            acc3 = sad_row_rvv(c, ref[3] + off + x, acc3, vl);
+            x += (int)vl;
+        }
+    }
+
+    sad[0] = __riscv_vmv_x_s_u16m1_u16(acc0);
+    sad[1] = __riscv_vmv_x_s_u16m1_u16(acc1);
+    sad[2] = __riscv_vmv_x_s_u16m1_u16(acc2);
+    sad[3] = __riscv_vmv_x_s_u16m1_u16(acc3);
+}
+
+#endif /* __riscv_vector */
+
 /* ============================================================================
  * Motion Estimation
  * ============================================================================ */
@@ -107,23 +252,23 @@ static uint32_t sad_4x4(const uint8_t *cur, int cur_stride,
 static uint32_t full_search(int block_x, int block_y,
                            int *best_mx, int *best_my)
 {
-    const uint8_t *cur = &current_frame[block_y][block_x];
+    const uint8_t *cur = &current_frame[block_y * frame_width + block_x];
     uint32_t best_sad = UINT32_MAX;
     *best_mx = 0;
     *best_my = 0;
 
     /* Search window */
     int min_y = (block_y >= SEARCH_RANGE) ? -SEARCH_RANGE : -block_y;
-    int max_y = (block_y + BLOCK_SIZE + SEARCH_RANGE <= FRAME_HEIGHT) ?
-                SEARCH_RANGE : FRAME_HEIGHT - block_y - BLOCK_SIZE;
+    int max_y = (block_y + BLOCK_SIZE + SEARCH_RANGE <= frame_height) ?
+                SEARCH_RANGE : frame_height - block_y - BLOCK_SIZE;
     int min_x = (block_x >= SEARCH_RANGE) ? -SEARCH_RANGE : -block_x;
-    int max_x = (block_x + BLOCK_SIZE + SEARCH_RANGE <= FRAME_WIDTH) ?
-                SEARCH_RANGE : FRAME_WIDTH - block_x - BLOCK_SIZE;
+    int max_x = (block_x + BLOCK_SIZE + SEARCH_RANGE <= frame_width) ?
+                SEARCH_RANGE : frame_width - block_x - BLOCK_SIZE;
 
     for (int my = min_y; my <= max_y; my++) {
         for (int mx = min_x; mx <= max_x; mx++) {
-            const uint8_t *ref = &reference_frame[block_y + my][block_x + mx];
-            uint32_t sad = sad_16x16(cur, FRAME_WIDTH, ref, FRAME_WIDTH);
+            const uint8_t *ref = &reference_frame[(block_y + my) * frame_width + block_x + mx];
+            uint32_t sad = sad_16x16(cur, frame_width, ref, frame_width);
 
             if (sad < best_sad) {
                 best_sad = sad;
@@ -146,7 +291,7 @@ static const int diamond_pattern[9][2] = {
 static uint32_t diamond_search(int block_x, int block_y,
                               int *best_mx, int *best_my)
 {
-    const uint8_t *cur = &current_frame[block_y][block_x];
+    const uint8_t *cur = &current_frame[block_y * frame_width + block_x];
     int cx = 0, cy = 0;  /* Center of search */
     uint32_t best_sad = UINT32_MAX;
 
@@ -160,13 +305,13 @@ static uint32_t diamond_search(int block_x, int block_y,
             int my = cy + diamond_pattern[i][1];
 
             /* Check bounds */
-            if (block_x + mx < 0 || block_x + mx + BLOCK_SIZE > FRAME_WIDTH ||
-                block_y + my < 0 || block_y + my + BLOCK_SIZE > FRAME_HEIGHT) {
+            if (block_x + mx < 0 || block_x + mx + BLOCK_SIZE > frame_width ||
+                block_y + my < 0 || block_y + my + BLOCK_SIZE > frame_height) {
                 continue;
             }
 
-            const uint8_t *ref = &reference_frame[block_y + my][block_x + mx];
-            uint32_t sad = sad_16x16(cur, FRAME_WIDTH, ref, FRAME_WIDTH);
+            const uint8_t *ref = &reference_frame[(block_y + my) * frame_width + block_x + mx];
+            uint32_t sad = sad_16x16(cur, frame_width, ref, frame_width);
 
             if (sad < new_best) {
                 new_best = sad;
@@ -189,6 +334,120 @@ static uint32_t diamond_search(int block_x, int block_y,
     return best_sad;
 }
 
+/* ============================================================================
+ * Batched Motion Estimation
+ * Same candidate order and strict '<' selection as the searches above, so
+ * vectors and SADs match the reference; the last batch of each call is
+ * padded by repeating its final candidate.
+ * ============================================================================ */
+
+#define FULL_ROW_CANDIDATES (2 * SEARCH_RANGE + 1)
+
+/* Full search, one row of candidate offsets per batch sequence */
+static uint32_t full_search_x4(int block_x, int block_y,
+                               int *best_mx, int *best_my, sad_x4_t sad_x4)
+{
+    const uint8_t *cur = &current_frame[block_y * frame_width + block_x];
+    const uint8_t *refs[FULL_ROW_CANDIDATES + 3];
+    uint32_t sads[FULL_ROW_CANDIDATES + 3];
+    uint32_t best_sad = UINT32_MAX;
+    *best_mx = 0;
+    *best_my = 0;
+
+    int min_y = (block_y >= SEARCH_RANGE) ? -SEARCH_RANGE : -block_y;
+    int max_y = (block_y + BLOCK_SIZE + SEARCH_RANGE <= frame_height) ?
+                SEARCH_RANGE : frame_height - block_y - BLOCK_SIZE;
+    int min_x = (block_x >= SEARCH_RANGE) ? -SEARCH_RANGE : -block_x;
+    int max_x = (block_x + BLOCK_SIZE + SEARCH_RANGE <= frame_width) ?
+                SEARCH_RANGE : frame_width - block_x - BLOCK_SIZE;
+    int n = max_x - min_x + 1;
+
+    for (int my = min_y; my <= max_y; my++) {
+        const uint8_t *row = &reference_frame[(block_y + my) * frame_width + block_x];
+
+        for (int i = 0; i < n; i++) {
+            refs[i] = row + min_x + i;
+        }
+        for (int i = n; i & 3; i++) {
+            refs[i] = refs[n - 1];
+        }
+        for (int i = 0; i < n; i += 4) {
+            sad_x4(cur, frame_width, &refs[i], &sads[i]);
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (sads[i] < best_sad) {
+                best_sad = sads[i];
+                *best_mx = min_x + i;
+                *best_my = my;
+            }
+        }
+    }
+
+    return best_sad;
+}
+
+/* Diamond search, the in-bounds points of each step in up to three batches */
+static uint32_t diamond_search_x4(int block_x, int block_y,
+                                  int *best_mx, int *best_my, sad_x4_t sad_x4)
+{
+    const uint8_t *cur = &current_frame[block_y * frame_width + block_x];
+    const uint8_t *refs[12];
+    uint32_t sads[12];
+    int cand_x[9], cand_y[9];
+    int cx = 0, cy = 0;
+    uint32_t best_sad = UINT32_MAX;
+
+    for (int iter = 0; iter < 16; iter++) {
+        int new_cx = cx, new_cy = cy;
+        uint32_t new_best = best_sad;
+        int n = 0;
+
+        for (int i = 0; i < 9; i++) {
+            int mx = cx + diamond_pattern[i][0];
+            int my = cy + diamond_pattern[i][1];
+
+            if (block_x + mx < 0 || block_x + mx + BLOCK_SIZE > frame_width ||
+                block_y + my < 0 || block_y + my + BLOCK_SIZE > frame_height) {
+                continue;
+            }
+
+            refs[n] = &reference_frame[(block_y + my) * frame_width + block_x + mx];
+            cand_x[n] = mx;
+            cand_y[n] = my;
+            n++;
+        }
+
+        /* The center is always in bounds, so n >= 1 */
+        for (int i = n; i & 3; i++) {
+            refs[i] = refs[n - 1];
+        }
+        for (int i = 0; i < n; i += 4) {
+            sad_x4(cur, frame_width, &refs[i], &sads[i]);
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (sads[i] < new_best) {
+                new_best = sads[i];
+                new_cx = cand_x[i];
+                new_cy = cand_y[i];
+            }
+        }
+
+        if (new_cx == cx && new_cy == cy) {
+            break;
+        }
+
+        cx = new_cx;
+        cy = new_cy;
+        best_sad = new_best;
+    }
+
+    *best_mx = cx;
+    *best_my = cy;
+    return best_sad;
+}
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -198,11 +457,11 @@ static void generate_frames(uint32_t seed)
     uint32_t x = seed;
 
     /* Generate reference frame with patterns */
-    for (int y = 0; y < FRAME_HEIGHT; y++) {
-        for (int i = 0; i < FRAME_WIDTH; i++) {
+    for (int y = 0; y < frame_height; y++) {
+        for (int i = 0; i < frame_width; i++) {
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             /* Create some spatial correlation */
-            reference_frame[y][i] = (uint8_t)(128 + (y / 4) * 3 + (i / 4) * 2 + (x % 30) - 15);
+            reference_frame[y * frame_width + i] = (uint8_t)(128 + (y / 4) * 3 + (i / 4) * 2 + (x % 30) - 15);
         }
     }
 
@@ -210,19 +469,19 @@ static void generate_frames(uint32_t seed)
     int global_mv_x = 2;  /* Global motion */
     int global_mv_y = 1;
 
-    for (int y = 0; y < FRAME_HEIGHT; y++) {
-        for (int i = 0; i < FRAME_WIDTH; i++) {
+    for (int y = 0; y < frame_height; y++) {
+        for (int i = 0; i < frame_width; i++) {
             int ref_y = y + global_mv_y;
             int ref_x = i + global_mv_x;
 
-            if (ref_y >= 0 && ref_y < FRAME_HEIGHT &&
-                ref_x >= 0 && ref_x < FRAME_WIDTH) {
+            if (ref_y >= 0 && ref_y < frame_height &&
+                ref_x >= 0 && ref_x < frame_width) {
                 x ^= x << 13; x ^= x >> 17; x ^= x << 5;
                 int noise = (x % 10) - 5;
-                current_frame[y][i] = (uint8_t)CLAMP(
-                    (int)reference_frame[ref_y][ref_x] + noise, 0, 255);
+                current_frame[y * frame_width + i] = (uint8_t)CLAMP(
+                    (int)reference_frame[ref_y * frame_width + ref_x] + noise, 0, 255);
             } else {
-                current_frame[y][i] = 128;
+                current_frame[y * frame_width + i] = 128;
             }
         }
     }
@@ -234,10 +493,20 @@ static void generate_frames(uint32_t seed)
 
 static void kernel_init_func(void)
 {
+    frame_width = (int)bench_scale_dim(FRAME_WIDTH);
+    frame_height = (int)bench_scale_dim(FRAME_HEIGHT);
+
+    int num_mbs = (frame_height / BLOCK_SIZE) * (frame_width / BLOCK_SIZE);
+    current_frame = bench_alloc(frame_width * frame_height);
+    reference_frame = bench_alloc(frame_width * frame_height);
+    mv_x = bench_alloc(num_mbs * sizeof(int16_t));
+    mv_y = bench_alloc(num_mbs * sizeof(int16_t));
+
     generate_frames(0x12345678);
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared search loop; NULL sad_x4 runs the reference per-candidate searches */
+static bench_result_t motion_estimate(sad_x4_t sad_x4)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t total_sad = 0;
@@ -247,8 +516,8 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Process each macroblock */
-    int num_blocks_y = FRAME_HEIGHT / BLOCK_SIZE;
-    int num_blocks_x = FRAME_WIDTH / BLOCK_SIZE;
+    int num_blocks_y = frame_height / BLOCK_SIZE;
+    int num_blocks_x = frame_width / BLOCK_SIZE;
 
     for (int by = 0; by < num_blocks_y; by++) {
         for (int bx = 0; bx < num_blocks_x; bx++) {
@@ -258,11 +527,17 @@ static bench_result_t kernel_run_func(void)
             int mx, my;
 
             /* Use diamond search for speed */
-            uint32_t sad = diamond_search(block_x, block_y, &mx, &my);
+            BENCH_PHASE_BEGIN(PHASE_DIAMOND);
+            uint32_t sad = sad_x4 ? diamond_search_x4(block_x, block_y, &mx, &my, sad_x4)
+                                  : diamond_search(block_x, block_y, &mx, &my);
+            BENCH_PHASE_END(PHASE_DIAMOND);
 
             /* Refine with full search in small window */
             int full_mx, full_my;
-            uint32_t full_sad = full_search(block_x, block_y, &full_mx, &full_my);
+            BENCH_PHASE_BEGIN(PHASE_FULL);
+            uint32_t full_sad = sad_x4 ? full_search_x4(block_x, block_y, &full_mx, &full_my, sad_x4)
+                                       : full_search(block_x, block_y, &full_mx, &full_my);
+            BENCH_PHASE_END(PHASE_FULL);
 
             if (full_sad < sad) {
                 mx = full_mx;
@@ -270,8 +545,8 @@ static bench_result_t kernel_run_func(void)
                 sad = full_sad;
             }
 
-            mv_x[by][bx] = mx;
-            mv_y[by][bx] = my;
+            mv_x[by * num_blocks_x + bx] = mx;
+            mv_y[by * num_blocks_x + bx] = my;
             total_sad += sad;
 
             csum = checksum_update(csum, sad);
@@ -293,6 +568,35 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return motion_estimate(NULL);
+}
+
+static bench_result_t kernel_run_batch(void)
+{
+    return motion_estimate(sad_16x16_x4_c);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_sse2(void)
+{
+    return motion_estimate(sad_16x16_x4_sse2);
+}
+
+static bench_result_t kernel_run_avx2(void)
+{
+    return motion_estimate(sad_16x16_x4_avx2);
+}
+#endif
+
+#if defined(__riscv_vector)
+static bench_result_t kernel_run_rvv(void)
+{
+    return motion_estimate(sad_16x16_x4_rvv);
+}
+#endif
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -301,7 +605,20 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t sad_variants[] = {
+#if defined(ARCH_X86_64)
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+    { "sse2", ISA_SSE2, kernel_run_sse2 },
+#endif
+#if defined(__riscv_vector)
+    { "rvv", ISA_RVV, kernel_run_rvv },
+#endif
+    { "batch", 0, kernel_run_batch },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     block_sad,
     "Block SAD motion estimation",
     "464.h264ref",
@@ -309,7 +626,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    (FRAME_HEIGHT / BLOCK_SIZE) * (FRAME_WIDTH / BLOCK_SIZE)
+    (FRAME_HEIGHT / BLOCK_SIZE) * (FRAME_WIDTH / BLOCK_SIZE),
+    sad_variants,
+    "diamond_search", "full_search"
 );
 
 KERNEL_REGISTER(block_sad)
@@ -12,6 +12,7 @@
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * BWT_BLOCK_SIZE is the tier S size, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef BWT_BLOCK_SIZE
@@ -22,29 +23,81 @@
 #define BWT_ALPHABET_SIZE   256     /* Byte alphabet */
 #endif
 
+#ifndef BWT_QSORT_DEPTH
+#define BWT_QSORT_DEPTH     32      /* Deeper partitions switch to the fallback sort */
+#endif
+
+/* Input: 0 text-like, 1 repetitive (long repeats, bzip2's worst case), 2 random bytes */
+#ifndef BWT_INPUT
+#define BWT_INPUT           0
+#endif
+
+#ifndef BWT_REPEAT_PERIOD
+#define BWT_REPEAT_PERIOD   1000    /* Repetitive input: length of the repeated phrase */
+#endif
+
+#ifndef BWT_REPEAT_MUTATE
+#define BWT_REPEAT_MUTATE   4096    /* Repetitive input: about one changed byte per this many */
+#endif
+
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
-/* Static storage */
-static uint8_t block[BWT_BLOCK_SIZE + 4];     /* Input block + sentinel */
-static uint32_t ptr[BWT_BLOCK_SIZE];          /* Suffix pointers */
-static uint32_t ftab[BWT_ALPHABET_SIZE + 1];  /* Frequency table */
-static uint8_t output[BWT_BLOCK_SIZE];        /* BWT output */
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_RADIX, PHASE_QSORT, PHASE_OUTPUT, PHASE_FALLBACK, PHASE_SAIS };
+
+/* Sorter: ptr[0..n) = rotation start positions in sorted order */
+typedef void (*sort_func_t)(const uint8_t *input, uint32_t n, uint32_t *ptr);
+
+/* Static storage (block buffers are arena-allocated in init) */
+static BENCH_TLS uint8_t *block;                        /* Input block + sentinel */
+static BENCH_TLS uint32_t *ptr;                         /* Suffix pointers */
+static BENCH_TLS uint32_t ftab[BWT_ALPHABET_SIZE + 1];  /* Frequency table */
+static BENCH_TLS uint8_t *output;                       /* BWT output */
+static BENCH_TLS uint32_t block_size;
+static BENCH_TLS bool qsort_overflow;                   /* Set past BWT_QSORT_DEPTH */
+
+/* Fallback sort: rotation classes and scratch (n each, arena) */
+static BENCH_TLS uint32_t *fb_class;
+static BENCH_TLS uint32_t *fb_class_next;
+static BENCH_TLS uint32_t *fb_tmp;
+static BENCH_TLS uint32_t *fb_count;                    /* max(n, alphabet) */
+
+/* SA-IS: doubled block text and suffix array (2n + 1 each), level stack */
+static BENCH_TLS int32_t *sais_text;
+static BENCH_TLS int32_t *sais_sa;
+static BENCH_TLS uint8_t *sais_pool;
+static BENCH_TLS size_t sais_pool_used;
 
 /* ============================================================================
  * Sorting Functions (simplified from bzip2)
  * ============================================================================ */
 
+/*
+ * Rotation index (p + d) mod n for p < n. The block size is a run-time
+ * value since the tiers, so "% n" is a division where it used to fold into
+ * a mask; wrap by subtraction instead (d is at most the quicksort depth).
+ */
+INLINE uint32_t rotate_index(uint32_t p, uint32_t d, uint32_t n)
+{
+    p += d;
+    while (p >= n) p -= n;
+    return p;
+}
+
 /* Compare suffixes at positions p1 and p2 */
 static int suffix_compare(const uint8_t *block, uint32_t n, uint32_t p1, uint32_t p2)
 {
-    for (uint32_t i = 0; i < n; i++) {
-        uint32_t idx1 = (p1 + i) % n;
-        uint32_t idx2 = (p2 + i) % n;
+    uint32_t idx1 = p1;
+    uint32_t idx2 = p2;
 
+    for (uint32_t i = 0; i < n; i++) {
         if (block[idx1] < block[idx2]) return -1;
         if (block[idx1] > block[idx2]) return 1;
+
+        if (++idx1 == n) idx1 = 0;
+        if (++idx2 == n) idx2 = 0;
     }
     return 0;
 }
@@ -63,14 +116,14 @@ static void qsort3_partition(uint32_t *ptr, const uint8_t *block, uint32_t n,
     /* Pivot is middle element */
     int mid = lo + (hi - lo) / 2;
     uint32_t pivot_pos = ptr[mid];
-    uint8_t pivot = block[(pivot_pos + depth) % n];
+    uint8_t pivot = block[rotate_index(pivot_pos, depth, n)];
 
     int lt = lo;
     int gt = hi;
     int i = lo;
 
     while (i <= gt) {
-        uint8_t c = block[(ptr[i] + depth) % n];
+        uint8_t c = block[rotate_index(ptr[i], depth, n)];
         if (c < pivot) {
             /* Swap ptr[lt] and ptr[i] */
             uint32_t tmp = ptr[lt];
@@ -97,8 +150,13 @@ static void qsort3_partition(uint32_t *ptr, const uint8_t *block, uint32_t n,
 static void qsort3_suffixes(uint32_t *ptr, const uint8_t *block, uint32_t n,
                            int lo, int hi, int depth)
 {
-    /* Limit recursion depth */
-    if (hi <= lo || depth > 32) {
+    if (hi <= lo) {
+        return;
+    }
+
+    /* Long common prefixes: leave the block to the fallback sort */
+    if (depth > BWT_QSORT_DEPTH) {
+        qsort_overflow = true;
         return;
     }
 
@@ -158,15 +216,84 @@ static void radix_bucket(const uint8_t *block, uint32_t n, uint32_t *ptr, uint32
     }
 }
 
-/* Main BWT function */
-static uint32_t bwt_transform(const uint8_t *input, uint32_t n,
-                             uint32_t *ptr, uint32_t *ftab, uint8_t *output)
+/* ============================================================================
+ * Fallback Sort (prefix doubling)
+ * bzip2 gives up on its quicksort when the work budget runs out on
+ * repetitive blocks and re-sorts the block with fallbackSort. Here the
+ * trigger is a quicksort partition deeper than BWT_QSORT_DEPTH; the
+ * fallback ranks rotations by their first 2^h bytes for h = 0, 1, ...
+ * (O(n log n) whatever the input), so the result is always exact.
+ * Equal rotations (periodic blocks) end in decreasing position order.
+ * ============================================================================ */
+
+static void fallback_sort(const uint8_t *block, uint32_t n, uint32_t *ptr)
+{
+    uint32_t *cls = fb_class, *cls_next = fb_class_next, *tmp = fb_tmp, *cnt = fb_count;
+    uint32_t classes;
+
+    /* Rotations by first byte */
+    memset(cnt, 0, BWT_ALPHABET_SIZE * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) cnt[block[i]]++;
+    for (int c = 1; c < BWT_ALPHABET_SIZE; c++) cnt[c] += cnt[c - 1];
+    for (uint32_t i = n; i-- > 0;) ptr[--cnt[block[i]]] = i;
+
+    classes = 1;
+    cls[ptr[0]] = 0;
+    for (uint32_t i = 1; i < n; i++) {
+        if (block[ptr[i]] != block[ptr[i - 1]]) classes++;
+        cls[ptr[i]] = classes - 1;
+    }
+
+    for (uint32_t k = 1; k < n && classes < n; k <<= 1) {
+        /* Shifting back by k leaves the list sorted by the second half;
+         * a stable counting sort on the first half's class finishes it */
+        for (uint32_t i = 0; i < n; i++) {
+            tmp[i] = ptr[i] >= k ? ptr[i] - k : ptr[i] + n - k;
+        }
+        memset(cnt, 0, classes * sizeof(uint32_t));
+        for (uint32_t i = 0; i < n; i++) cnt[cls[tmp[i]]]++;
+        for (uint32_t c = 1; c < classes; c++) cnt[c] += cnt[c - 1];
+        for (uint32_t i = n; i-- > 0;) ptr[--cnt[cls[tmp[i]]]] = tmp[i];
+
+        classes = 1;
+        cls_next[ptr[0]] = 0;
+        for (uint32_t i = 1; i < n; i++) {
+            uint32_t a = ptr[i], b = ptr[i - 1];
+            uint32_t a2 = a + k < n ? a + k : a + k - n;
+            uint32_t b2 = b + k < n ? b + k : b + k - n;
+            if (cls[a] != cls[b] || cls[a2] != cls[b2]) classes++;
+            cls_next[a] = classes - 1;
+        }
+        uint32_t *swap = cls;
+        cls = cls_next;
+        cls_next = swap;
+    }
+
+    /* Final order from the classes, ties by decreasing position */
+    memset(cnt, 0, classes * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) cnt[cls[i]]++;
+    uint32_t sum = 0;
+    for (uint32_t c = 0; c < classes; c++) {
+        uint32_t count = cnt[c];
+        cnt[c] = sum;
+        sum += count;
+    }
+    for (uint32_t i = n; i-- > 0;) ptr[cnt[cls[i]]++] = i;
+}
+
+/* Reference sorter: radix on the first byte, quicksort per bucket, and the
+ * fallback when a bucket is too repetitive for the quicksort */
+static void bzip2_sort(const uint8_t *input, uint32_t n, uint32_t *ptr)
 {
     /* Radix sort on first character */
+    BENCH_PHASE_BEGIN(PHASE_RADIX);
     radix_bucket(input, n, ptr, ftab);
+    BENCH_PHASE_END(PHASE_RADIX);
 
     /* Quicksort each bucket */
-    for (int c = 0; c < BWT_ALPHABET_SIZE; c++) {
+    BENCH_PHASE_BEGIN(PHASE_QSORT);
+    qsort_overflow = false;
+    for (int c = 0; c < BWT_ALPHABET_SIZE && !qsort_overflow; c++) {
         uint32_t lo = ftab[c];
         uint32_t hi = (c < 255) ? ftab[c + 1] - 1 : n - 1;
 
@@ -174,8 +301,197 @@ static uint32_t bwt_transform(const uint8_t *input, uint32_t n,
             qsort3_suffixes(ptr, input, n, lo, hi, 1);
         }
     }
+    BENCH_PHASE_END(PHASE_QSORT);
+
+    if (qsort_overflow) {
+        BENCH_PHASE_BEGIN(PHASE_FALLBACK);
+        fallback_sort(input, n, ptr);
+        BENCH_PHASE_END(PHASE_FALLBACK);
+    }
+}
+
+/* ============================================================================
+ * SA-IS Suffix Sorting (Nong, Zhang, Chan)
+ * Linear time on any input: suffixes are typed S or L, the LMS substrings
+ * are sorted by two induced passes over the buckets, named, and sorted
+ * recursively when names repeat; a last induction orders every suffix
+ * from the sorted LMS suffixes.
+ *
+ * BWT wants rotations, so the sorted text is the block twice plus a
+ * sentinel: for i < n, suffix i of that text orders like rotation i (equal
+ * rotations by decreasing i, as in the fallback). Bytes are stored as
+ * byte + 1 so the sentinel 0 is unique. Type bits and buckets for each
+ * recursion level come from a preallocated stack (sais_pool).
+ * ============================================================================ */
+
+INLINE bool sais_type(const uint8_t *t, int32_t i)
+{
+    return (t[i >> 3] >> (i & 7)) & 1;
+}
+
+INLINE void sais_set_type(uint8_t *t, int32_t i, bool s_type)
+{
+    if (s_type) {
+        t[i >> 3] |= (uint8_t)(1u << (i & 7));
+    } else {
+        t[i >> 3] &= (uint8_t)~(1u << (i & 7));
+    }
+}
+
+INLINE bool sais_is_lms(const uint8_t *t, int32_t i)
+{
+    return i > 0 && sais_type(t, i) && !sais_type(t, i - 1);
+}
+
+static void *sais_push(size_t size)
+{
+    void *p = sais_pool + sais_pool_used;
+    sais_pool_used += (size + 7) & ~(size_t)7;
+    return p;
+}
+
+/* Bucket starts (end = false) or ends (end = true) for alphabet 0..k */
+static void sais_buckets(const int32_t *s, int32_t *bkt, int32_t n, int32_t k, bool end)
+{
+    int32_t sum = 0;
+
+    for (int32_t i = 0; i <= k; i++) bkt[i] = 0;
+    for (int32_t i = 0; i < n; i++) bkt[s[i]]++;
+    for (int32_t i = 0; i <= k; i++) {
+        sum += bkt[i];
+        bkt[i] = end ? sum : sum - bkt[i];
+    }
+}
+
+static void sais_induce(const int32_t *s, const uint8_t *t, int32_t *sa, int32_t *bkt,
+                        int32_t n, int32_t k)
+{
+    /* L-type suffixes left to right from bucket starts */
+    sais_buckets(s, bkt, n, k, false);
+    for (int32_t i = 0; i < n; i++) {
+        int32_t j = sa[i] - 1;
+        if (j >= 0 && !sais_type(t, j)) sa[bkt[s[j]]++] = j;
+    }
+
+    /* S-type suffixes right to left from bucket ends */
+    sais_buckets(s, bkt, n, k, true);
+    for (int32_t i = n - 1; i >= 0; i--) {
+        int32_t j = sa[i] - 1;
+        if (j >= 0 && sais_type(t, j)) sa[--bkt[s[j]]] = j;
+    }
+}
+
+/* Suffix array of s[0..n), s[n-1] the unique smallest symbol, alphabet 0..k */
+static void sais_core(const int32_t *s, int32_t *sa, int32_t n, int32_t k)
+{
+    size_t mark = sais_pool_used;
+    uint8_t *t = sais_push((size_t)n / 8 + 1);
+    int32_t *bkt = sais_push(((size_t)k + 1) * sizeof(int32_t));
+
+    /* Classify: S if smaller than the next suffix */
+    sais_set_type(t, n - 1, true);
+    if (n > 1) sais_set_type(t, n - 2, false);
+    for (int32_t i = n - 3; i >= 0; i--) {
+        sais_set_type(t, i, s[i] < s[i + 1] || (s[i] == s[i + 1] && sais_type(t, i + 1)));
+    }
+
+    /* Stage 1: sort LMS substrings */
+    sais_buckets(s, bkt, n, k, true);
+    for (int32_t i = 0; i < n; i++) sa[i] = -1;
+    for (int32_t i = 1; i < n; i++) {
+        if (sais_is_lms(t, i)) sa[--bkt[s[i]]] = i;
+    }
+    sais_induce(s, t, sa, bkt, n, k);
+
+    /* Compact the sorted LMS positions into sa[0..n1) */
+    int32_t n1 = 0;
+    for (int32_t i = 0; i < n; i++) {
+        if (sais_is_lms(t, sa[i])) sa[n1++] = sa[i];
+    }
+
+    /* Name LMS substrings; equal ones share a name */
+    for (int32_t i = n1; i < n; i++) sa[i] = -1;
+    int32_t name = 0, prev = -1;
+    for (int32_t i = 0; i < n1; i++) {
+        int32_t pos = sa[i];
+        bool diff = false;
+
+        for (int32_t d = 0; d < n; d++) {
+            if (prev == -1 || s[pos + d] != s[prev + d] ||
+                sais_type(t, pos + d) != sais_type(t, prev + d)) {
+                diff = true;
+                break;
+            }
+            if (d > 0 && (sais_is_lms(t, pos + d) || sais_is_lms(t, prev + d))) break;
+        }
+        if (diff) {
+            name++;
+            prev = pos;
+        }
+        sa[n1 + pos / 2] = name - 1;
+    }
+    for (int32_t i = n - 1, j = n - 1; i >= n1; i--) {
+        if (sa[i] >= 0) sa[j--] = sa[i];
+    }
+
+    /* Stage 2: order the reduced string s1 (in the tail of sa) */
+    int32_t *sa1 = sa, *s1 = sa + n - n1;
+    if (name < n1) {
+        sais_core(s1, sa1, n1, name - 1);
+    } else {
+        for (int32_t i = 0; i < n1; i++) sa1[s1[i]] = i;
+    }
+
+    /* Stage 3: induce the full order from the sorted LMS suffixes */
+    sais_buckets(s, bkt, n, k, true);
+    for (int32_t i = 1, j = 0; i < n; i++) {
+        if (sais_is_lms(t, i)) s1[j++] = i;
+    }
+    for (int32_t i = 0; i < n1; i++) sa1[i] = s1[sa1[i]];
+    for (int32_t i = n1; i < n; i++) sa[i] = -1;
+    for (int32_t i = n1 - 1; i >= 0; i--) {
+        int32_t j = sa[i];
+        sa[i] = -1;
+        sa[--bkt[s[j]]] = j;
+    }
+    sais_induce(s, t, sa, bkt, n, k);
+
+    sais_pool_used = mark;
+}
+
+static void sais_sort(const uint8_t *input, uint32_t n, uint32_t *ptr)
+{
+    int32_t len = (int32_t)(2 * n + 1);
+
+    BENCH_PHASE_BEGIN(PHASE_SAIS);
+    for (uint32_t i = 0; i < n; i++) {
+        sais_text[i] = sais_text[i + n] = (int32_t)input[i] + 1;
+    }
+    sais_text[2 * n] = 0;
+
+    sais_pool_used = 0;
+    sais_core(sais_text, sais_sa, len, BWT_ALPHABET_SIZE);
+
+    /* Rotations are the suffixes starting in the first copy */
+    uint32_t k = 0;
+    for (int32_t i = 0; i < len; i++) {
+        if ((uint32_t)sais_sa[i] < n) ptr[k++] = (uint32_t)sais_sa[i];
+    }
+    BENCH_PHASE_END(PHASE_SAIS);
+}
+
+/* ============================================================================
+ * BWT Output
+ * ============================================================================ */
+
+/* Main BWT function; sort is bzip2_sort or one of the variants */
+static uint32_t bwt_transform(const uint8_t *input, uint32_t n,
+                             uint32_t *ptr, uint8_t *output, sort_func_t sort)
+{
+    sort(input, n, ptr);
 
     /* Generate BWT output and find original position */
+    BENCH_PHASE_BEGIN(PHASE_OUTPUT);
     uint32_t orig_pos = 0;
     for (uint32_t i = 0; i < n; i++) {
         if (ptr[i] == 0) {
@@ -185,6 +501,7 @@ static uint32_t bwt_transform(const uint8_t *input, uint32_t n,
             output[i] = input[ptr[i] - 1];
         }
     }
+    BENCH_PHASE_END(PHASE_OUTPUT);
 
     return orig_pos;
 }
@@ -193,7 +510,7 @@ static uint32_t bwt_transform(const uint8_t *input, uint32_t n,
  * Test Data Generation
  * ============================================================================ */
 
-static void generate_block(uint8_t *block, uint32_t size, uint32_t seed)
+static void generate_text(uint8_t *block, uint32_t size, uint32_t seed)
 {
     /* Generate text-like data with some repetition */
     uint32_t x = seed;
@@ -217,17 +534,75 @@ static void generate_block(uint8_t *block, uint32_t size, uint32_t seed)
     }
 }
 
+/* A text phrase repeated with rare point changes: LCPs in the thousands,
+ * like the logs, tarballs and source trees where bzip2 hits its fallback */
+static void generate_repetitive(uint8_t *block, uint32_t size, uint32_t seed)
+{
+    uint32_t period = BWT_REPEAT_PERIOD < size ? BWT_REPEAT_PERIOD : size;
+    uint32_t x = seed;
+
+    generate_text(block, period, seed);
+    for (uint32_t i = period; i < size; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        block[i] = (x % BWT_REPEAT_MUTATE == 0) ? (uint8_t)('a' + (x >> 8) % 26) : block[i - period];
+    }
+}
+
+/* Uniform bytes: short LCPs, all 256 buckets in use */
+static void generate_random(uint8_t *block, uint32_t size, uint32_t seed)
+{
+    uint32_t x = seed;
+
+    for (uint32_t i = 0; i < size; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        block[i] = (uint8_t)(x >> 24);
+    }
+}
+
+static void generate_block(uint8_t *block, uint32_t size, uint32_t seed)
+{
+#if BWT_INPUT == 1
+    generate_repetitive(block, size, seed);
+#elif BWT_INPUT == 2
+    generate_random(block, size, seed);
+#else
+    generate_text(block, size, seed);
+#endif
+}
+
 /* ============================================================================
  * Kernel Implementation
  * ============================================================================ */
 
 static void kernel_init_func(void)
 {
+    block_size = bench_scale(BWT_BLOCK_SIZE);
+    block = bench_alloc(block_size + 4);
+    ptr = bench_alloc(block_size * sizeof(uint32_t));
+    output = bench_alloc(block_size);
+
+    uint32_t count_size = block_size > BWT_ALPHABET_SIZE ? block_size : BWT_ALPHABET_SIZE;
+    fb_class = bench_alloc(block_size * sizeof(uint32_t));
+    fb_class_next = bench_alloc(block_size * sizeof(uint32_t));
+    fb_tmp = bench_alloc(block_size * sizeof(uint32_t));
+    fb_count = bench_alloc(count_size * sizeof(uint32_t));
+
+    /* SA-IS level stack: type bits and buckets, at most half the length per level */
+    size_t sais_len = 2 * (size_t)block_size + 1;
+    sais_text = bench_alloc(sais_len * sizeof(int32_t));
+    sais_sa = bench_alloc(sais_len * sizeof(int32_t));
+    sais_pool = bench_alloc(5 * sais_len + 8192);
+
     /* Generate test block */
-    generate_block(block, BWT_BLOCK_SIZE, 0xCAFEBABE);
+    generate_block(block, block_size, 0xCAFEBABE);
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; sort is bzip2_sort or one of the variants */
+static bench_result_t bwt_run(sort_func_t sort)
 {
     bench_result_t result = { .status = BENCH_OK };
 
@@ -235,7 +610,7 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Perform BWT */
-    uint32_t orig_pos = bwt_transform(block, BWT_BLOCK_SIZE, ptr, ftab, output);
+    uint32_t orig_pos = bwt_transform(block, block_size, ptr, output, sort);
 
     /* End timing */
     BENCH_END();
@@ -244,7 +619,7 @@ static bench_result_t kernel_run_func(void)
     BENCH_VOLATILE(orig_pos);
 
     /* Compute checksum of output */
-    uint32_t csum = checksum_buffer(output, BWT_BLOCK_SIZE);
+    uint32_t csum = checksum_buffer(output, block_size);
     csum = checksum_update(csum, orig_pos);
 
     result.cycles = BENCH_CYCLES();
@@ -253,6 +628,16 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return bwt_run(bzip2_sort);
+}
+
+static bench_result_t kernel_run_sais(void)
+{
+    return bwt_run(sais_sort);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -262,7 +647,13 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t bwt_variants[] = {
+    { "sais", 0, kernel_run_sais },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     bwt_sort,
     "Burrows-Wheeler Transform",
     "401.bzip2",
@@ -270,7 +661,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,  /* Checksum varies */
-    1
+    1,
+    bwt_variants,
+    "radix_bucket", "qsort3", "output", "fallback", "sais"
 );
 
 KERNEL_REGISTER(bwt_sort)
@@ -0,0 +1,881 @@
+/*
+ * SPECInt2006-micro: bzip2_pipeline kernel
+ * Streams a multi-block input through the whole 401.bzip2 compressor
+ *
+ * Pattern: BWT -> MTF/RLE -> Huffman code lengths -> bit packing, each
+ *          stage consuming the previous stage's output
+ * Memory: Block buffers handed from stage to stage (cache effects between
+ *         stages are part of the measurement)
+ * Branch: Suffix comparisons, MTF list search, heap swaps, bit writer
+ *
+ * The -mt variant runs the stages on different threads: blocks travel
+ * through bounded lock-free queues and a fixed pool of block slots, so
+ * memory stays bounded however long the input is. Blocks compress
+ * independently, so the checksum does not depend on the thread count.
+ */
+
+#include "bench.h"
+
+#if defined(NATIVE_BUILD)
+  #include <sched.h>
+#endif
+
+/* ============================================================================
+ * Configuration
+ * PIPE_INPUT_SIZE is the tier S input, scaled by bench_scale(); the block
+ * size grows by bench_scale_dim() up to bzip2's 900K.
+ * ============================================================================ */
+
+#ifndef PIPE_INPUT_SIZE
+#define PIPE_INPUT_SIZE     8192    /* Input bytes at tier S */
+#endif
+
+#ifndef PIPE_BLOCK_SIZE
+#define PIPE_BLOCK_SIZE     1024    /* Block bytes at tier S */
+#endif
+
+#define PIPE_MAX_BLOCK      900000  /* bzip2 -9 */
+#define PIPE_QSORT_DEPTH    32      /* Deeper partitions switch to the fallback sort */
+#define PIPE_MAX_LEN        20      /* Maximum code length */
+#define PIPE_MAX_THREADS    16      /* Stage threads for the -mt variant */
+#define PIPE_SLOTS_PER_THREAD 2     /* Blocks in flight per thread */
+
+/* MTF/RLE alphabet: RUNA, RUNB, MTF positions 1..255 as 2..256, end of block */
+#define SYM_RUNA            0
+#define SYM_RUNB            1
+#define SYM_EOB             257
+#define PIPE_SYMBOLS        258
+
+/* Stages, in pipeline order */
+enum { STAGE_BWT, STAGE_MTF, STAGE_HUFFMAN, STAGE_PACK, NUM_STAGES };
+
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_BWT, PHASE_MTF, PHASE_HUFFMAN, PHASE_PACK };
+
+/* ============================================================================
+ * Data Structures
+ * ============================================================================ */
+
+/* One block in flight: every stage's output for it */
+typedef struct {
+    uint32_t block;                     /* Block index in the input */
+    uint32_t len;
+    uint32_t orig_ptr;
+    uint8_t *last;                      /* BWT last column (len) */
+    uint16_t *syms;                     /* MTF/RLE symbols (len + 1) */
+    uint32_t num_syms;
+    int32_t freq[PIPE_SYMBOLS];
+    uint8_t lengths[PIPE_SYMBOLS];
+    uint8_t *out;                       /* Packed block */
+    uint32_t out_bytes;
+} block_slot_t;
+
+/* Huffman node */
+typedef struct {
+    int32_t weight;
+    int32_t left;                       /* -1 for leaves */
+    int32_t right;
+    int32_t symbol;
+} huff_node_t;
+
+/* Per-thread scratch (BWT sort and Huffman) */
+typedef struct {
+    uint32_t *ptr;                      /* Sorted rotations */
+    uint32_t *fb_class;                 /* Fallback sort classes and scratch */
+    uint32_t *fb_class_next;
+    uint32_t *fb_tmp;
+    uint32_t *fb_count;                 /* max(block, 256) */
+    uint32_t ftab[257];
+    bool qsort_overflow;
+    huff_node_t nodes[2 * PIPE_SYMBOLS];
+    int32_t heap[PIPE_SYMBOLS + 1];
+    int32_t stack[2 * PIPE_SYMBOLS][2];
+} stage_ctx_t;
+
+/*
+ * Bounded lock-free MPMC queue (Vyukov): each cell carries a sequence
+ * number that says whether it is free for the producer at that position
+ * or holds a value for the consumer. Values are slot indices.
+ */
+typedef struct {
+    uint32_t *seq;
+    uint32_t *value;
+    uint32_t mask;
+    uint32_t head ALIGNED(64);          /* Next position to pop */
+    uint32_t tail ALIGNED(64);          /* Next position to push */
+} slot_queue_t;
+
+/* Shared pipeline job for the stage threads (tasks see no BENCH_TLS state) */
+typedef struct {
+    const uint8_t *input;
+    uint32_t input_size;
+    uint32_t block_size;
+    uint32_t num_blocks;
+    block_slot_t *slots;
+    stage_ctx_t *ctx;
+    int num_ctx;
+    slot_queue_t *free_slots;
+    slot_queue_t *done[NUM_STAGES - 1];  /* Slots finished with stage k */
+    uint32_t *block_csum;               /* Per-block checksum, block order */
+    uint32_t *block_bytes;
+    uint32_t next_block ALIGNED(64);
+} pipe_job_t;
+
+/* Static storage (buffers are arena-allocated in init) */
+static BENCH_TLS uint8_t *input;
+static BENCH_TLS uint32_t input_size;
+static BENCH_TLS uint32_t block_size;
+static BENCH_TLS uint32_t num_blocks;
+static BENCH_TLS block_slot_t *slots;
+static BENCH_TLS int num_slots;
+static BENCH_TLS stage_ctx_t *stage_ctx;
+static BENCH_TLS int num_stage_ctx;
+static BENCH_TLS slot_queue_t queues[NUM_STAGES];
+static BENCH_TLS uint32_t *block_csum;
+static BENCH_TLS uint32_t *block_bytes;
+
+/* ============================================================================
+ * Lock-Free Slot Queues
+ * ============================================================================ */
+
+static void queue_init(slot_queue_t *q, uint32_t capacity)
+{
+    q->seq = bench_alloc(capacity * sizeof(uint32_t));
+    q->value = bench_alloc(capacity * sizeof(uint32_t));
+    q->mask = capacity - 1;
+}
+
+static void queue_reset(slot_queue_t *q)
+{
+    for (uint32_t i = 0; i <= q->mask; i++) q->seq[i] = i;
+    q->head = 0;
+    q->tail = 0;
+}
+
+/* Capacity covers every slot, so a push never finds the queue full */
+static void queue_push(slot_queue_t *q, uint32_t v)
+{
+    uint32_t pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+
+    for (;;) {
+        uint32_t *cell = &q->seq[pos & q->mask];
+        int32_t dif = (int32_t)(__atomic_load_n(cell, __ATOMIC_ACQUIRE) - pos);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->tail, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                q->value[pos & q->mask] = v;
+                __atomic_store_n(cell, pos + 1, __ATOMIC_RELEASE);
+                return;
+            }
+        } else {
+            pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static bool queue_try_pop(slot_queue_t *q, uint32_t *v)
+{
+    uint32_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+
+    for (;;) {
+        uint32_t *cell = &q->seq[pos & q->mask];
+        int32_t dif = (int32_t)(__atomic_load_n(cell, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *v = q->value[pos & q->mask];
+                __atomic_store_n(cell, pos + q->mask + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (dif < 0) {
+            return false;               /* Empty */
+        } else {
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/* Spin until a slot arrives; natively the waiting thread yields its CPU so
+ * that an oversubscribed host still makes progress */
+static uint32_t queue_pop(slot_queue_t *q)
+{
+    uint32_t v;
+    while (!queue_try_pop(q, &v)) {
+#ifdef NATIVE_BUILD
+        sched_yield();
+#else
+        compiler_barrier();
+#endif
+    }
+    return v;
+}
+
+/* ============================================================================
+ * Stage 1: BWT (bzip2 sort: radix, quicksort, fallback)
+ * ============================================================================ */
+
+static int suffix_compare(const uint8_t *block, uint32_t n, uint32_t p1, uint32_t p2)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t idx1 = p1 + i < n ? p1 + i : p1 + i - n;
+        uint32_t idx2 = p2 + i < n ? p2 + i : p2 + i - n;
+
+        if (block[idx1] < block[idx2]) return -1;
+        if (block[idx1] > block[idx2]) return 1;
+    }
+    return 0;
+}
+
+/* 3-way quicksort on the byte at depth; deep partitions set qsort_overflow */
+static void qsort3_suffixes(stage_ctx_t *c, const uint8_t *block, uint32_t n,
+                            int lo, int hi, int depth)
+{
+    uint32_t *ptr = c->ptr;
+
+    if (hi <= lo) {
+        return;
+    }
+    if (depth > PIPE_QSORT_DEPTH) {
+        c->qsort_overflow = true;
+        return;
+    }
+
+    if (hi - lo < 10) {
+        for (int i = lo + 1; i <= hi; i++) {
+            uint32_t v = ptr[i];
+            int j = i;
+            while (j > lo && suffix_compare(block, n, ptr[j - 1], v) > 0) {
+                ptr[j] = ptr[j - 1];
+                j--;
+            }
+            ptr[j] = v;
+        }
+        return;
+    }
+
+    uint8_t pivot = block[(ptr[lo + (hi - lo) / 2] + depth) % n];
+    int lt = lo, gt = hi, i = lo;
+    while (i <= gt) {
+        uint8_t ch = block[(ptr[i] + depth) % n];
+        if (ch < pivot) {
+            uint32_t tmp = ptr[lt];
+            ptr[lt++] = ptr[i];
+            ptr[i++] = tmp;
+        } else if (ch > pivot) {
+            uint32_t tmp = ptr[i];
+            ptr[i] = ptr[gt];
+            ptr[gt--] = tmp;
+        } else {
+            i++;
+        }
+    }
+
+    qsort3_suffixes(c, block, n, lo, lt - 1, depth);
+    qsort3_suffixes(c, block, n, lt, gt, depth + 1);
+    qsort3_suffixes(c, block, n, gt + 1, hi, depth);
+}
+
+/* Prefix doubling: exact on any input, equal rotations by decreasing position */
+static void fallback_sort(stage_ctx_t *c, const uint8_t *block, uint32_t n)
+{
+    uint32_t *ptr = c->ptr, *cls = c->fb_class, *cls_next = c->fb_class_next;
+    uint32_t *tmp = c->fb_tmp, *cnt = c->fb_count;
+    uint32_t classes;
+
+    memset(cnt, 0, 256 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) cnt[block[i]]++;
+    for (int ch = 1; ch < 256; ch++) cnt[ch] += cnt[ch - 1];
+    for (uint32_t i = n; i-- > 0;) ptr[--cnt[block[i]]] = i;
+
+    classes = 1;
+    cls[ptr[0]] = 0;
+    for (uint32_t i = 1; i < n; i++) {
+        if (block[ptr[i]] != block[ptr[i - 1]]) classes++;
+        cls[ptr[i]] = classes - 1;
+    }
+
+    for (uint32_t k = 1; k < n && classes < n; k <<= 1) {
+        for (uint32_t i = 0; i < n; i++) {
+            tmp[i] = ptr[i] >= k ? ptr[i] - k : ptr[i] + n - k;
+        }
+        memset(cnt, 0, classes * sizeof(uint32_t));
+        for (uint32_t i = 0; i < n; i++) cnt[cls[tmp[i]]]++;
+        for (uint32_t cl = 1; cl < classes; cl++) cnt[cl] += cnt[cl - 1];
+        for (uint32_t i = n; i-- > 0;) ptr[--cnt[cls[tmp[i]]]] = tmp[i];
+
+        classes = 1;
+        cls_next[ptr[0]] = 0;
+        for (uint32_t i = 1; i < n; i++) {
+            uint32_t a = ptr[i], b = ptr[i - 1];
+            uint32_t a2 = a + k < n ? a + k : a + k - n;
+            uint32_t b2 = b + k < n ? b + k : b + k - n;
+            if (cls[a] != cls[b] || cls[a2] != cls[b2]) classes++;
+            cls_next[a] = classes - 1;
+        }
+        uint32_t *swap = cls;
+        cls = cls_next;
+        cls_next = swap;
+    }
+
+    memset(cnt, 0, classes * sizeof(uint32_t));
+    for (uint32_t i = 0; i < n; i++) cnt[cls[i]]++;
+    uint32_t sum = 0;
+    for (uint32_t cl = 0; cl < classes; cl++) {
+        uint32_t count = cnt[cl];
+        cnt[cl] = sum;
+        sum += count;
+    }
+    for (uint32_t i = n; i-- > 0;) ptr[cnt[cls[i]]++] = i;
+}
+
+/* ptr sorted by radix and per-bucket quicksort, or the fallback when a
+ * bucket is too repetitive; then the last column and orig_ptr */
+static void stage_bwt(stage_ctx_t *c, block_slot_t *s, const uint8_t *block)
+{
+    uint32_t n = s->len, *ptr = c->ptr, *ftab = c->ftab;
+
+    /* Radix bucket on the first byte */
+    memset(ftab, 0, sizeof(c->ftab));
+    for (uint32_t i = 0; i < n; i++) ftab[block[i] + 1]++;
+    for (int ch = 1; ch <= 256; ch++) ftab[ch] += ftab[ch - 1];
+    for (uint32_t i = 0; i < n; i++) ptr[ftab[block[i]]++] = i;
+    for (int ch = 256; ch > 0; ch--) ftab[ch] = ftab[ch - 1];
+    ftab[0] = 0;
+
+    c->qsort_overflow = false;
+    for (int ch = 0; ch < 256 && !c->qsort_overflow; ch++) {
+        if (ftab[ch + 1] > ftab[ch] + 1) {
+            qsort3_suffixes(c, block, n, (int)ftab[ch], (int)ftab[ch + 1] - 1, 1);
+        }
+    }
+    if (c->qsort_overflow) {
+        fallback_sort(c, block, n);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (ptr[i] == 0) {
+            s->last[i] = block[n - 1];
+            s->orig_ptr = i;
+        } else {
+            s->last[i] = block[ptr[i] - 1];
+        }
+    }
+}
+
+/* ============================================================================
+ * Stage 2: MTF and zero-run coding (bzip2 generateMTFValues)
+ * ============================================================================ */
+
+/* Zero runs in bijective base 2: RUNA = 1, RUNB = 2 at each digit */
+INLINE uint32_t emit_zero_run(uint16_t *syms, uint32_t k, uint32_t run)
+{
+    run--;
+    for (;;) {
+        syms[k++] = (run & 1) ? SYM_RUNB : SYM_RUNA;
+        if (run < 2) break;
+        run = (run - 2) / 2;
+    }
+    return k;
+}
+
+static void stage_mtf(block_slot_t *s)
+{
+    uint8_t list[256];
+    uint32_t k = 0, zero_run = 0;
+
+    for (int i = 0; i < 256; i++) list[i] = (uint8_t)i;
+
+    for (uint32_t i = 0; i < s->len; i++) {
+        uint8_t symbol = s->last[i];
+
+        if (list[0] == symbol) {
+            zero_run++;
+            continue;
+        }
+        if (zero_run > 0) {
+            k = emit_zero_run(s->syms, k, zero_run);
+            zero_run = 0;
+        }
+
+        /* Search and shift in one pass */
+        uint8_t prev = list[0];
+        int pos = 1;
+        list[0] = symbol;
+        while (list[pos] != symbol) {
+            uint8_t tmp = list[pos];
+            list[pos] = prev;
+            prev = tmp;
+            pos++;
+        }
+        list[pos] = prev;
+        s->syms[k++] = (uint16_t)(pos + 1);
+    }
+    if (zero_run > 0) {
+        k = emit_zero_run(s->syms, k, zero_run);
+    }
+    s->syms[k++] = SYM_EOB;
+    s->num_syms = k;
+}
+
+/* ============================================================================
+ * Stage 3: Huffman code lengths
+ * ============================================================================ */
+
+static void heap_push(stage_ctx_t *c, int *size, int32_t node)
+{
+    int32_t weight = c->nodes[node].weight;
+    int pos = ++*size;
+
+    while (pos > 1 && c->nodes[c->heap[pos / 2]].weight > weight) {
+        c->heap[pos] = c->heap[pos / 2];
+        pos /= 2;
+    }
+    c->heap[pos] = node;
+}
+
+static int32_t heap_pop(stage_ctx_t *c, int *size)
+{
+    int32_t min_node = c->heap[1];
+    int32_t last = c->heap[(*size)--];
+    int pos = 1;
+
+    while (pos * 2 <= *size) {
+        int child = pos * 2;
+        if (child < *size &&
+            c->nodes[c->heap[child + 1]].weight < c->nodes[c->heap[child]].weight) {
+            child++;
+        }
+        if (c->nodes[last].weight <= c->nodes[c->heap[child]].weight) break;
+        c->heap[pos] = c->heap[child];
+        pos = child;
+    }
+    c->heap[pos] = last;
+    return min_node;
+}
+
+/* Lengths past PIPE_MAX_LEN are cut, then the shortest codes lengthened
+ * until the Kraft sum fits again */
+static void limit_code_lengths(uint8_t *lengths)
+{
+    const int64_t max_kraft = 1LL << PIPE_MAX_LEN;
+    int64_t kraft = 0;
+
+    for (int i = 0; i < PIPE_SYMBOLS; i++) {
+        if (lengths[i] > PIPE_MAX_LEN) lengths[i] = PIPE_MAX_LEN;
+        if (lengths[i] > 0) kraft += 1LL << (PIPE_MAX_LEN - lengths[i]);
+    }
+    while (kraft > max_kraft) {
+        for (int i = 0; i < PIPE_SYMBOLS && kraft > max_kraft; i++) {
+            if (lengths[i] > 0 && lengths[i] < PIPE_MAX_LEN) {
+                kraft -= 1LL << (PIPE_MAX_LEN - lengths[i] - 1);
+                lengths[i]++;
+            }
+        }
+    }
+}
+
+static void stage_huffman(stage_ctx_t *c, block_slot_t *s)
+{
+    int heap_size = 0, num_nodes = 0;
+
+    memset(s->freq, 0, sizeof(s->freq));
+    memset(s->lengths, 0, sizeof(s->lengths));
+    for (uint32_t i = 0; i < s->num_syms; i++) s->freq[s->syms[i]]++;
+
+    for (int i = 0; i < PIPE_SYMBOLS; i++) {
+        if (s->freq[i] > 0) {
+            c->nodes[num_nodes] = (huff_node_t){ s->freq[i], -1, -1, i };
+            heap_push(c, &heap_size, num_nodes++);
+        }
+    }
+
+    while (heap_size > 1) {
+        int32_t left = heap_pop(c, &heap_size);
+        int32_t right = heap_pop(c, &heap_size);
+        c->nodes[num_nodes] = (huff_node_t){
+            c->nodes[left].weight + c->nodes[right].weight, left, right, -1
+        };
+        heap_push(c, &heap_size, num_nodes++);
+    }
+
+    /* Depths by DFS; a lone symbol (EOB only) still gets one bit */
+    int top = 0;
+    c->stack[top][0] = c->heap[1];
+    c->stack[top++][1] = 0;
+    while (top > 0) {
+        top--;
+        int32_t node = c->stack[top][0], depth = c->stack[top][1];
+        if (c->nodes[node].left < 0) {
+            s->lengths[c->nodes[node].symbol] = (uint8_t)(depth > 0 ? depth : 1);
+        } else {
+            c->stack[top][0] = c->nodes[node].left;
+            c->stack[top++][1] = depth + 1;
+            c->stack[top][0] = c->nodes[node].right;
+            c->stack[top++][1] = depth + 1;
+        }
+    }
+
+    limit_code_lengths(s->lengths);
+}
+
+/* ============================================================================
+ * Stage 4: Bit packing (canonical codes, MSB first)
+ * ============================================================================ */
+
+typedef struct {
+    uint8_t *out;
+    uint32_t pos;
+    uint64_t buf;
+    int live;
+} bit_writer_t;
+
+INLINE void put_bits(bit_writer_t *w, uint32_t value, int bits)
+{
+    w->buf = (w->buf << bits) | value;
+    w->live += bits;
+    while (w->live >= 8) {
+        w->live -= 8;
+        w->out[w->pos++] = (uint8_t)(w->buf >> w->live);
+    }
+}
+
+/* Header: 24-bit orig_ptr, 5 bits per code length; then the symbols */
+static void stage_pack(block_slot_t *s)
+{
+    uint32_t code[PIPE_SYMBOLS];
+    bit_writer_t w = { .out = s->out };
+
+    /* Canonical codes: by length, then symbol */
+    uint32_t next = 0;
+    for (int len = 1; len <= PIPE_MAX_LEN; len++) {
+        for (int i = 0; i < PIPE_SYMBOLS; i++) {
+            if (s->lengths[i] == len) code[i] = next++;
+        }
+        next <<= 1;
+    }
+
+    put_bits(&w, s->orig_ptr, 24);
+    for (int i = 0; i < PIPE_SYMBOLS; i++) {
+        put_bits(&w, s->lengths[i], 5);
+    }
+    for (uint32_t i = 0; i < s->num_syms; i++) {
+        uint16_t sym = s->syms[i];
+        put_bits(&w, code[sym], s->lengths[sym]);
+    }
+    if (w.live > 0) {
+        w.out[w.pos++] = (uint8_t)(w.buf << (8 - w.live));
+    }
+    s->out_bytes = w.pos;
+}
+
+/* Worst case: header plus PIPE_MAX_LEN bits for each of len + 1 symbols */
+static uint32_t packed_bound(uint32_t len)
+{
+    return (24 + 5 * PIPE_SYMBOLS + PIPE_MAX_LEN * (len + 1) + 7) / 8;
+}
+
+/* ============================================================================
+ * Stage Threads
+ * ============================================================================ */
+
+INLINE void finish_block(pipe_job_t *job, const block_slot_t *s)
+{
+    uint32_t csum = checksum_buffer(s->out, s->out_bytes);
+    job->block_csum[s->block] = checksum_update(csum, s->out_bytes);
+    job->block_bytes[s->block] = s->out_bytes;
+}
+
+static void run_stage(stage_ctx_t *c, const pipe_job_t *job, block_slot_t *s, int stage)
+{
+    switch (stage) {
+    case STAGE_BWT:
+        stage_bwt(c, s, job->input + (size_t)s->block * job->block_size);
+        break;
+    case STAGE_MTF:
+        stage_mtf(s);
+        break;
+    case STAGE_HUFFMAN:
+        stage_huffman(c, s);
+        break;
+    default:
+        stage_pack(s);
+        break;
+    }
+}
+
+/*
+ * Stage assignment for n threads: the later stages are light, so up to
+ * three threads take them (one each, or grouped on fewer threads) and
+ * every other thread sorts blocks. BWT threads claim blocks from a shared
+ * counter; later stages take whatever the queue before them holds.
+ */
+static void stage_range(int tid, int n, int *first, int *last)
+{
+    int back = n - 1 < 3 ? n - 1 : 3;
+    int back_first[4][3] = { { 0 }, { 1 }, { 2, 1 }, { 3, 2, 1 } };
+    int back_last[4][3] = { { 0 }, { 3 }, { 3, 1 }, { 3, 2, 1 } };
+
+    if (n == 1) {
+        *first = STAGE_BWT;
+        *last = STAGE_PACK;
+    } else if (tid < back) {
+        *first = back_first[back][tid];
+        *last = back_last[back][tid];
+    } else {
+        *first = STAGE_BWT;
+        *last = STAGE_BWT;
+    }
+}
+
+static void pipe_task(int tid, int nthreads, void *arg)
+{
+    pipe_job_t *job = arg;
+    int n = nthreads < job->num_ctx ? nthreads : job->num_ctx;
+    int first, last;
+
+    if (tid >= n) {
+        return;
+    }
+    stage_range(tid, n, &first, &last);
+    stage_ctx_t *c = &job->ctx[tid];
+
+    for (uint32_t done = 0;; done++) {
+        uint32_t id;
+        if (first == STAGE_BWT) {
+            uint32_t b = __atomic_fetch_add(&job->next_block, 1, __ATOMIC_RELAXED);
+            if (b >= job->num_blocks) break;
+            id = queue_pop(job->free_slots);
+            job->slots[id].block = b;
+            job->slots[id].len = b + 1 < job->num_blocks ?
+                job->block_size : job->input_size - b * job->block_size;
+        } else {
+            if (done == job->num_blocks) break;
+            id = queue_pop(job->done[first - 1]);
+        }
+
+        block_slot_t *s = &job->slots[id];
+        for (int stage = first; stage <= last; stage++) {
+            run_stage(c, job, s, stage);
+        }
+
+        if (last == STAGE_PACK) {
+            finish_block(job, s);
+            queue_push(job->free_slots, id);
+        } else {
+            queue_push(job->done[last], id);
+        }
+    }
+}
+
+/* ============================================================================
+ * Test Data Generation
+ * ============================================================================ */
+
+/* Words from a small Zipf-skewed vocabulary with punctuation and line
+ * breaks: redundancy at word and phrase scale, like text bzip2 sees */
+static void generate_input(uint8_t *buf, uint32_t size, uint32_t seed)
+{
+    char vocab[64][10];
+    uint32_t x = seed;
+
+    for (int w = 0; w < 64; w++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        int len = 2 + (int)(x % 8);
+        for (int i = 0; i < len; i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            vocab[w][i] = (char)('a' + x % 26);
+        }
+        vocab[w][len] = '\0';
+    }
+
+    uint32_t pos = 0, line = 0;
+    while (pos < size) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        uint32_t r = (x >> 8) & 63;
+        const char *word = vocab[(r * ((x >> 16) & 63)) >> 6];
+
+        for (int i = 0; word[i] && pos < size; i++) buf[pos++] = (uint8_t)word[i];
+        line++;
+        if (pos < size) {
+            if (x % 97 == 0) {
+                buf[pos++] = '.';
+            } else if (x % 31 == 0) {
+                buf[pos++] = ',';
+            }
+        }
+        if (pos < size) {
+            if (line >= 12 && x % 5 == 0) {
+                buf[pos++] = '\n';
+                line = 0;
+            } else {
+                buf[pos++] = ' ';
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * Kernel Implementation
+ * ============================================================================ */
+
+static void kernel_init_func(void)
+{
+    input_size = bench_scale(PIPE_INPUT_SIZE);
+    block_size = bench_scale_dim(PIPE_BLOCK_SIZE);
+    if (block_size > PIPE_MAX_BLOCK) block_size = PIPE_MAX_BLOCK;
+    if (block_size > input_size) block_size = input_size;
+    num_blocks = (input_size + block_size - 1) / block_size;
+
+    input = bench_alloc(input_size);
+    generate_input(input, input_size, 0xB21F0001);
+    block_csum = bench_alloc(num_blocks * sizeof(uint32_t));
+    block_bytes = bench_alloc(num_blocks * sizeof(uint32_t));
+
+    /* Scratch per stage thread, a few block slots per thread */
+    num_stage_ctx = bench_threads < PIPE_MAX_THREADS ? bench_threads : PIPE_MAX_THREADS;
+    stage_ctx = bench_alloc(num_stage_ctx * sizeof(stage_ctx_t));
+    uint32_t count_size = block_size > 256 ? block_size : 256;
+    for (int t = 0; t < num_stage_ctx; t++) {
+        stage_ctx_t *c = &stage_ctx[t];
+        c->ptr = bench_alloc(block_size * sizeof(uint32_t));
+        c->fb_class = bench_alloc(block_size * sizeof(uint32_t));
+        c->fb_class_next = bench_alloc(block_size * sizeof(uint32_t));
+        c->fb_tmp = bench_alloc(block_size * sizeof(uint32_t));
+        c->fb_count = bench_alloc(count_size * sizeof(uint32_t));
+    }
+
+    num_slots = num_stage_ctx * PIPE_SLOTS_PER_THREAD;
+    slots = bench_alloc(num_slots * sizeof(block_slot_t));
+    for (int i = 0; i < num_slots; i++) {
+        slots[i].last = bench_alloc(block_size);
+        slots[i].syms = bench_alloc((block_size + 1) * sizeof(uint16_t));
+        slots[i].out = bench_alloc(packed_bound(block_size));
+    }
+
+    uint32_t capacity = 1;
+    while (capacity < (uint32_t)num_slots) capacity <<= 1;
+    for (int q = 0; q < NUM_STAGES; q++) {
+        queue_init(&queues[q], capacity);
+    }
+}
+
+/* Reference: one block at a time through all four stages, one slot */
+static void pipe_serial(void)
+{
+    stage_ctx_t *c = &stage_ctx[0];
+    block_slot_t *s = &slots[0];
+
+    for (uint32_t b = 0; b < num_blocks; b++) {
+        s->block = b;
+        s->len = b + 1 < num_blocks ? block_size : input_size - b * block_size;
+
+        BENCH_PHASE_BEGIN(PHASE_BWT);
+        stage_bwt(c, s, input + (size_t)b * block_size);
+        BENCH_PHASE_END(PHASE_BWT);
+
+        BENCH_PHASE_BEGIN(PHASE_MTF);
+        stage_mtf(s);
+        BENCH_PHASE_END(PHASE_MTF);
+
+        BENCH_PHASE_BEGIN(PHASE_HUFFMAN);
+        stage_huffman(c, s);
+        BENCH_PHASE_END(PHASE_HUFFMAN);
+
+        BENCH_PHASE_BEGIN(PHASE_PACK);
+        stage_pack(s);
+        block_csum[b] = checksum_update(checksum_buffer(s->out, s->out_bytes), s->out_bytes);
+        block_bytes[b] = s->out_bytes;
+        BENCH_PHASE_END(PHASE_PACK);
+    }
+}
+
+/* Shared driver; pipelined runs the stage threads over the slot queues */
+static bench_result_t pipe_run(bool pipelined)
+{
+    bench_result_t result = { .status = BENCH_OK };
+    pipe_job_t job = {
+        .input = input,
+        .input_size = input_size,
+        .block_size = block_size,
+        .num_blocks = num_blocks,
+        .slots = slots,
+        .ctx = stage_ctx,
+        .num_ctx = num_stage_ctx,
+        .free_slots = &queues[NUM_STAGES - 1],
+        .block_csum = block_csum,
+        .block_bytes = block_bytes,
+        .next_block = 0
+    };
+
+    if (pipelined) {
+        for (int q = 0; q < NUM_STAGES; q++) queue_reset(&queues[q]);
+        for (int q = 0; q < NUM_STAGES - 1; q++) job.done[q] = &queues[q];
+        for (int i = 0; i < num_slots; i++) queue_push(job.free_slots, (uint32_t)i);
+    }
+
+    BENCH_START();
+
+    if (pipelined) {
+        bench_parallel(pipe_task, &job);
+    } else {
+        pipe_serial();
+    }
+
+    BENCH_END();
+
+    /* The stream in block order */
+    uint32_t csum = checksum_init();
+    uint64_t total_bytes = 0;
+    for (uint32_t b = 0; b < num_blocks; b++) {
+        csum = checksum_update(csum, block_csum[b]);
+        total_bytes += block_bytes[b];
+    }
+    csum = checksum_update(csum, (uint32_t)total_bytes);
+
+    BENCH_VOLATILE(total_bytes);
+
+    result.cycles = BENCH_CYCLES();
+    result.checksum = csum;
+    result.work = input_size;
+
+    return result;
+}
+
+static bench_result_t kernel_run_func(void)
+{
+    return pipe_run(false);
+}
+
+static bench_result_t kernel_run_mt(void)
+{
+    return pipe_run(true);
+}
+
+static void kernel_cleanup_func(void)
+{
+}
+
+/* ============================================================================
+ * Kernel Registration
+ * ============================================================================ */
+
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t pipe_variants[] = {
+    { "pipeline-mt", 0, kernel_run_mt },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
+    bzip2_pipeline,
+    "bzip2 compressor: BWT, MTF/RLE, Huffman, bit packing",
+    "bzip2-pipeline",
+    kernel_init_func,
+    kernel_run_func,
+    kernel_cleanup_func,
+    0,
+    1,
+    pipe_variants,
+    "bwt", "mtf_rle", "huffman", "pack"
+);
+
+KERNEL_REGISTER(bzip2_pipeline)
@@ -0,0 +1,156 @@
+/*
+ * SPECInt2006-micro: cache.c
+ * Cache state at the start of each timed region (--cache=warm|cold|polluted)
+ *
+ * clflush:     x86-64, every line of the kernel's regions, then mfence
+ * cbo.flush:   RISC-V with Zicbom, the same over each cache block
+ * sweep:       otherwise, read BENCH_FLUSH_SIZE bytes of unrelated memory
+ *
+ * Unrelated memory is the arena past the kernel's storage: bench_alloc()
+ * zeroes whatever it hands out next, so the harness may scribble there.
+ */
+
+#include "bench.h"
+
+#if defined(ARCH_X86_64)
+  #define CACHE_CLFLUSH
+#elif (defined(ARCH_RISCV64) || defined(ARCH_RISCV32)) && defined(__riscv_zicbom)
+  #define CACHE_CBO
+#endif
+
+/* Static tables registered by the kernel's init(), per rate-mode copy */
+typedef struct {
+    const uint8_t *ptr;
+    size_t size;
+} cache_region_t;
+
+static BENCH_TLS cache_region_t regions[BENCH_MAX_CACHE_REGIONS];
+static BENCH_TLS int num_regions = 0;
+
+/* State applied by BENCH_START() during measured runs */
+BENCH_TLS bool cache_armed = false;
+static BENCH_TLS bench_cache_t armed_state = CACHE_WARM;
+static BENCH_TLS uint32_t armed_pollute_kb = 0;
+
+/* Sweep loads land here so they cannot be optimized away */
+static BENCH_TLS volatile uint64_t sweep_sink;
+
+static const char *const state_names[CACHE_NUM_STATES] = { "warm", "cold", "polluted" };
+
+const char *bench_cache_name(bench_cache_t state)
+{
+    return state < CACHE_NUM_STATES ? state_names[state] : "?";
+}
+
+const char *bench_cache_method(void)
+{
+#if defined(CACHE_CLFLUSH)
+    return "clflush";
+#elif defined(CACHE_CBO)
+    return "cbo.flush";
+#else
+    return "sweep";
+#endif
+}
+
+/* Anything past BENCH_MAX_CACHE_REGIONS is only evicted by a sweep */
+void bench_cache_region(const void *ptr, size_t size)
+{
+    if (num_regions < BENCH_MAX_CACHE_REGIONS && ptr && size > 0) {
+        regions[num_regions].ptr = ptr;
+        regions[num_regions].size = size;
+        num_regions++;
+    }
+}
+
+void bench_cache_reset(void)
+{
+    num_regions = 0;
+}
+
+void bench_cache_arm(bench_cache_t state, uint32_t pollute_kb)
+{
+    armed_state = state;
+    armed_pollute_kb = pollute_kb;
+    cache_armed = state == CACHE_COLD || state == CACHE_POLLUTED;
+}
+
+/* ============================================================================
+ * Eviction
+ * ============================================================================ */
+
+/* Arena space past the kernel's storage, at most max bytes */
+static uint8_t *spare_arena(size_t max, size_t *size)
+{
+    uint8_t *base = bench_arena_base();
+    size_t used = (bench_arena_used() + BENCH_CACHE_LINE - 1) & ~(size_t)(BENCH_CACHE_LINE - 1);
+    size_t total = bench_arena_size();
+
+    *size = used < total ? MIN(total - used, max) : 0;
+    return base ? base + used : NULL;
+}
+
+#if defined(CACHE_CLFLUSH) || defined(CACHE_CBO)
+
+static void flush_range(const uint8_t *ptr, size_t size)
+{
+    uintptr_t p = (uintptr_t)ptr & ~(uintptr_t)(BENCH_CACHE_LINE - 1);
+    uintptr_t end = (uintptr_t)ptr + size;
+
+    for (; p < end; p += BENCH_CACHE_LINE) {
+#if defined(CACHE_CLFLUSH)
+        __asm__ volatile ("clflush (%0)" :: "r"(p) : "memory");
+#else
+        __asm__ volatile ("cbo.flush (%0)" :: "r"(p) : "memory");
+#endif
+    }
+}
+
+static void evict(void)
+{
+    flush_range(bench_arena_base(), bench_arena_used());
+    for (int r = 0; r < num_regions; r++) {
+        flush_range(regions[r].ptr, regions[r].size);
+    }
+    memory_barrier();
+}
+
+#else
+
+/* One load per line; the kernel's lines lose their places to these */
+static void evict(void)
+{
+    size_t size;
+    const uint8_t *buf = spare_arena(BENCH_FLUSH_SIZE, &size);
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < size; i += BENCH_CACHE_LINE) {
+        sum += *(const volatile uint8_t *)(buf + i);
+    }
+    sweep_sink = sum;
+    memory_barrier();
+}
+
+#endif
+
+/* Dirty pollute_kb of unrelated lines, as another process sharing the core would */
+static void pollute(uint32_t pollute_kb)
+{
+    size_t size;
+    uint8_t *buf = spare_arena((size_t)pollute_kb << 10, &size);
+
+    for (size_t i = 0; i < size; i += BENCH_CACHE_LINE) {
+        buf[i]++;
+    }
+    sweep_sink = size ? buf[0] : 0;
+    memory_barrier();
+}
+
+void bench_cache_prepare(void)
+{
+    if (armed_state == CACHE_COLD) {
+        evict();
+    } else if (armed_state == CACHE_POLLUTED) {
+        pollute(armed_pollute_kb);
+    }
+}
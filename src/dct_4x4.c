@@ -9,9 +9,17 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+#if defined(__riscv_vector)
+  #include <riscv_vector.h>
+#endif
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * Image dimensions are the tier S size, scaled by bench_scale_dim(); the
+ * block count is scaled by bench_scale() to cover the larger image.
  * ============================================================================ */
 
 #ifndef DCT_NUM_BLOCKS
@@ -35,15 +43,21 @@
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_BLOCKS };
+
 /* 4x4 block type */
 typedef int16_t block_4x4_t[4][4];
 
-/* Static storage */
-static uint8_t original[DCT_IMAGE_HEIGHT][DCT_IMAGE_WIDTH];
-static uint8_t predicted[DCT_IMAGE_HEIGHT][DCT_IMAGE_WIDTH];
-static int16_t residual[DCT_IMAGE_HEIGHT][DCT_IMAGE_WIDTH];
-static block_4x4_t coef_blocks[DCT_NUM_BLOCKS];
-static block_4x4_t reconstructed_blocks[DCT_NUM_BLOCKS];
+/* Static storage (row-major images, arena-allocated in init) */
+static BENCH_TLS uint8_t *original;
+static BENCH_TLS uint8_t *predicted;
+static BENCH_TLS int16_t *residual;
+static BENCH_TLS block_4x4_t *coef_blocks;
+static BENCH_TLS block_4x4_t *reconstructed_blocks;
+static BENCH_TLS int image_width;
+static BENCH_TLS int image_height;
+static BENCH_TLS int num_blocks;
 
 /* ============================================================================
  * H.264 Integer DCT (4x4)
@@ -186,30 +200,498 @@ static void dequant_4x4(int16_t block[4][4], int qp)
     }
 }
 
+/* ============================================================================
+ * Batched SoA Engine
+ *
+ * N blocks are transposed so that each vector holds one coefficient
+ * position across N blocks (lane = block). The butterflies then need no
+ * shuffles, and forward DCT, quant, dequant and inverse DCT run fused in
+ * registers; only the dequantized coefficients and the reconstruction are
+ * stored. 16-bit lanes wrap exactly like the scalar int16_t code. The
+ * inverse's final (x + y + 32) >> 6 needs 17 bits, so it is split into
+ * high parts and a rounded sum of the low 6 bits.
+ * ============================================================================ */
+
+/* First residual sample of each block, in block_idx order */
+static BENCH_TLS int32_t *block_offset;
+static BENCH_TLS int batch_blocks;      /* Blocks the reference loop visits */
+
+#if defined(ARCH_X86_64)
+
+/* Forward butterfly on v[0], v[s], v[2s], v[3s] */
+INLINE void fwd4_sse2(__m128i *v, int s)
+{
+    __m128i p0 = _mm_add_epi16(v[0], v[3 * s]);
+    __m128i p1 = _mm_add_epi16(v[s], v[2 * s]);
+    __m128i p2 = _mm_sub_epi16(v[s], v[2 * s]);
+    __m128i p3 = _mm_sub_epi16(v[0], v[3 * s]);
+
+    v[0]     = _mm_add_epi16(p0, p1);
+    v[s]     = _mm_add_epi16(_mm_slli_epi16(p3, 1), p2);
+    v[2 * s] = _mm_sub_epi16(p0, p1);
+    v[3 * s] = _mm_sub_epi16(p3, _mm_slli_epi16(p2, 1));
+}
+
+/* Inverse butterfly; round6 adds the final (+32) >> 6 of the second pass */
+INLINE void inv4_sse2(__m128i *v, int s, bool round6)
+{
+    __m128i p0 = _mm_add_epi16(v[0], v[2 * s]);
+    __m128i p1 = _mm_sub_epi16(v[0], v[2 * s]);
+    __m128i p2 = _mm_sub_epi16(_mm_srai_epi16(v[s], 1), v[3 * s]);
+    __m128i p3 = _mm_add_epi16(v[s], _mm_srai_epi16(v[3 * s], 1));
+
+    if (!round6) {
+        v[0]     = _mm_add_epi16(p0, p3);
+        v[s]     = _mm_add_epi16(p1, p2);
+        v[2 * s] = _mm_sub_epi16(p1, p2);
+        v[3 * s] = _mm_sub_epi16(p0, p3);
+        return;
+    }
+
+    /* (x +/- y + 32) >> 6 = (x >> 6) +/- (y >> 6) + ((xl +/- yl + 32) >> 6) */
+    __m128i m = _mm_set1_epi16(63), r = _mm_set1_epi16(32);
+    __m128i h0 = _mm_srai_epi16(p0, 6), l0 = _mm_and_si128(p0, m);
+    __m128i h1 = _mm_srai_epi16(p1, 6), l1 = _mm_and_si128(p1, m);
+    __m128i h2 = _mm_srai_epi16(p2, 6), l2 = _mm_and_si128(p2, m);
+    __m128i h3 = _mm_srai_epi16(p3, 6), l3 = _mm_and_si128(p3, m);
+
+    v[0]     = _mm_add_epi16(_mm_add_epi16(h0, h3),
+                             _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(l0, l3), r), 6));
+    v[s]     = _mm_add_epi16(_mm_add_epi16(h1, h2),
+                             _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(l1, l2), r), 6));
+    v[2 * s] = _mm_add_epi16(_mm_sub_epi16(h1, h2),
+                             _mm_srai_epi16(_mm_add_epi16(_mm_sub_epi16(l1, l2), r), 6));
+    v[3 * s] = _mm_add_epi16(_mm_sub_epi16(h0, h3),
+                             _mm_srai_epi16(_mm_add_epi16(_mm_sub_epi16(l0, l3), r), 6));
+}
+
+/* quant_4x4 then dequant_4x4 on one coefficient across the lanes */
+INLINE __m128i quant_dequant_sse2(__m128i x, __m128i mf, __m128i round, __m128i shift,
+                                  __m128i dq)
+{
+    __m128i sign = _mm_srai_epi16(x, 15);
+    __m128i mag = _mm_sub_epi16(_mm_xor_si128(x, sign), sign);   /* |x| as u16 */
+
+    /* 32-bit |x| * mf from the low and high product halves */
+    __m128i lo = _mm_mullo_epi16(mag, mf);
+    __m128i hi = _mm_mulhi_epu16(mag, mf);
+    __m128i q0 = _mm_srl_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), shift);
+    __m128i q1 = _mm_srl_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), shift);
+    __m128i q = _mm_packs_epi32(q0, q1);
+
+    q = _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+    return _mm_mullo_epi16(q, dq);
+}
+
+/* Rows [b, b+1] of four register pairs to one coefficient per register */
+INLINE void transpose_in_sse2(__m128i a, __m128i b, __m128i c, __m128i d, __m128i *v)
+{
+    __m128i t0 = _mm_unpacklo_epi16(a, b), t1 = _mm_unpackhi_epi16(a, b);
+    __m128i t2 = _mm_unpacklo_epi16(c, d), t3 = _mm_unpackhi_epi16(c, d);
+    __m128i u0 = _mm_unpacklo_epi16(t0, t1), u1 = _mm_unpackhi_epi16(t0, t1);
+    __m128i u2 = _mm_unpacklo_epi16(t2, t3), u3 = _mm_unpackhi_epi16(t2, t3);
+
+    v[0] = _mm_unpacklo_epi64(u0, u2);
+    v[1] = _mm_unpackhi_epi64(u0, u2);
+    v[2] = _mm_unpacklo_epi64(u1, u3);
+    v[3] = _mm_unpackhi_epi64(u1, u3);
+}
+
+/* Inverse of transpose_in_sse2: one row per block pair */
+INLINE void transpose_out_sse2(const __m128i *v, __m128i *out)
+{
+    __m128i u0 = _mm_unpacklo_epi16(v[0], v[1]), u1 = _mm_unpacklo_epi16(v[2], v[3]);
+    __m128i u2 = _mm_unpackhi_epi16(v[0], v[1]), u3 = _mm_unpackhi_epi16(v[2], v[3]);
+
+    out[0] = _mm_unpacklo_epi32(u0, u1);
+    out[1] = _mm_unpackhi_epi32(u0, u1);
+    out[2] = _mm_unpacklo_epi32(u2, u3);
+    out[3] = _mm_unpackhi_epi32(u2, u3);
+}
+
+/* Store row `row` of 8 SoA blocks (v = the row's 4 coefficient vectors) */
+INLINE void store_row_sse2(block_4x4_t *dst, int row, const __m128i *v)
+{
+    __m128i out[4];
+
+    transpose_out_sse2(v, out);
+    for (int p = 0; p < 4; p++) {
+        _mm_storel_epi64((__m128i *)dst[2 * p][row], out[p]);
+        _mm_storel_epi64((__m128i *)dst[2 * p + 1][row], _mm_unpackhi_epi64(out[p], out[p]));
+    }
+}
+
+/* Blocks [first, first + 8) through the fused pipeline, 8 lanes */
+static void transform_batch_sse2(int first, int qp)
+{
+    __m128i v[16];
+    int qp_div = qp / 6;
+
+    for (int i = 0; i < 4; i++) {
+        __m128i rows[4];
+        for (int p = 0; p < 4; p++) {
+            const int16_t *b0 = &residual[block_offset[first + 2 * p] + i * image_width];
+            const int16_t *b1 = &residual[block_offset[first + 2 * p + 1] + i * image_width];
+            rows[p] = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)b0),
+                                         _mm_loadl_epi64((const __m128i *)b1));
+        }
+        transpose_in_sse2(rows[0], rows[1], rows[2], rows[3], &v[4 * i]);
+    }
+
+    /* v[4 * i + j] is coefficient (i, j); horizontal then vertical passes */
+    for (int i = 0; i < 4; i++) fwd4_sse2(&v[4 * i], 1);
+    for (int j = 0; j < 4; j++) fwd4_sse2(&v[j], 4);
+
+    __m128i mf = _mm_set1_epi16(quant_scale[qp % 6]);
+    __m128i round = _mm_set1_epi32(1 << (14 + qp_div));
+    __m128i shift = _mm_cvtsi32_si128(15 + qp_div);
+    __m128i dq = _mm_set1_epi16((int16_t)(dequant_scale[qp % 6] << qp_div));
+    for (int k = 0; k < 16; k++) {
+        v[k] = quant_dequant_sse2(v[k], mf, round, shift, dq);
+    }
+    for (int i = 0; i < 4; i++) store_row_sse2(&coef_blocks[first], i, &v[4 * i]);
+
+    for (int i = 0; i < 4; i++) inv4_sse2(&v[4 * i], 1, false);
+    for (int j = 0; j < 4; j++) inv4_sse2(&v[j], 4, true);
+    for (int i = 0; i < 4; i++) store_row_sse2(&reconstructed_blocks[first], i, &v[4 * i]);
+}
+
+/* AVX2: the SSE2 pipeline with blocks first..+7 in the low 128-bit lane
+ * and first+8..+15 in the high lane */
+
+__attribute__((target("avx2"))) INLINE void fwd4_avx2(__m256i *v, int s)
+{
+    __m256i p0 = _mm256_add_epi16(v[0], v[3 * s]);
+    __m256i p1 = _mm256_add_epi16(v[s], v[2 * s]);
+    __m256i p2 = _mm256_sub_epi16(v[s], v[2 * s]);
+    __m256i p3 = _mm256_sub_epi16(v[0], v[3 * s]);
+
+    v[0]     = _mm256_add_epi16(p0, p1);
+    v[s]     = _mm256_add_epi16(_mm256_slli_epi16(p3, 1), p2);
+    v[2 * s] = _mm256_sub_epi16(p0, p1);
+    v[3 * s] = _mm256_sub_epi16(p3, _mm256_slli_epi16(p2, 1));
+}
+
+__attribute__((target("avx2"))) INLINE void inv4_avx2(__m256i *v, int s, bool round6)
+{
+    __m256i p0 = _mm256_add_epi16(v[0], v[2 * s]);
+    __m256i p1 = _mm256_sub_epi16(v[0], v[2 * s]);
+    __m256i p2 = _mm256_sub_epi16(_mm256_srai_epi16(v[s], 1), v[3 * s]);
+    __m256i p3 = _mm256_add_epi16(v[s], _mm256_srai_epi16(v[3 * s], 1));
+
+    if (!round6) {
+        v[0]     = _mm256_add_epi16(p0, p3);
+        v[s]     = _mm256_add_epi16(p1, p2);
+        v[2 * s] = _mm256_sub_epi16(p1, p2);
+        v[3 * s] = _mm256_sub_epi16(p0, p3);
+        return;
+    }
+
+    __m256i m = _mm256_set1_epi16(63), r = _mm256_set1_epi16(32);
+    __m256i h0 = _mm256_srai_epi16(p0, 6), l0 = _mm256_and_si256(p0, m);
+    __m256i h1 = _mm256_srai_epi16(p1, 6), l1 = _mm256_and_si256(p1, m);
+    __m256i h2 = _mm256_srai_epi16(p2, 6), l2 = _mm256_and_si256(p2, m);
+    __m256i h3 = _mm256_srai_epi16(p3, 6), l3 = _mm256_and_si256(p3, m);
+
+    v[0]     = _mm256_add_epi16(_mm256_add_epi16(h0, h3),
+                   _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(l0, l3), r), 6));
+    v[s]     = _mm256_add_epi16(_mm256_add_epi16(h1, h2),
+                   _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(l1, l2), r), 6));
+    v[2 * s] = _mm256_add_epi16(_mm256_sub_epi16(h1, h2),
+                   _mm256_srai_epi16(_mm256_add_epi16(_mm256_sub_epi16(l1, l2), r), 6));
+    v[3 * s] = _mm256_add_epi16(_mm256_sub_epi16(h0, h3),
+                   _mm256_srai_epi16(_mm256_add_epi16(_mm256_sub_epi16(l0, l3), r), 6));
+}
+
+__attribute__((target("avx2"))) INLINE __m256i quant_dequant_avx2(__m256i x, __m256i mf, __m256i round, __m128i shift,
+                                       __m256i dq)
+{
+    __m256i sign = _mm256_srai_epi16(x, 15);
+    __m256i mag = _mm256_sub_epi16(_mm256_xor_si256(x, sign), sign);
+
+    __m256i lo = _mm256_mullo_epi16(mag, mf);
+    __m256i hi = _mm256_mulhi_epu16(mag, mf);
+    __m256i q0 = _mm256_srl_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), round), shift);
+    __m256i q1 = _mm256_srl_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), round), shift);
+    __m256i q = _mm256_packs_epi32(q0, q1);
+
+    q = _mm256_sub_epi16(_mm256_xor_si256(q, sign), sign);
+    return _mm256_mullo_epi16(q, dq);
+}
+
+__attribute__((target("avx2"))) INLINE void transpose_in_avx2(__m256i a, __m256i b, __m256i c, __m256i d, __m256i *v)
+{
+    __m256i t0 = _mm256_unpacklo_epi16(a, b), t1 = _mm256_unpackhi_epi16(a, b);
+    __m256i t2 = _mm256_unpacklo_epi16(c, d), t3 = _mm256_unpackhi_epi16(c, d);
+    __m256i u0 = _mm256_unpacklo_epi16(t0, t1), u1 = _mm256_unpackhi_epi16(t0, t1);
+    __m256i u2 = _mm256_unpacklo_epi16(t2, t3), u3 = _mm256_unpackhi_epi16(t2, t3);
+
+    v[0] = _mm256_unpacklo_epi64(u0, u2);
+    v[1] = _mm256_unpackhi_epi64(u0, u2);
+    v[2] = _mm256_unpacklo_epi64(u1, u3);
+    v[3] = _mm256_unpackhi_epi64(u1, u3);
+}
+
+__attribute__((target("avx2"))) INLINE void store_row_avx2(block_4x4_t *dst, int row, const __m256i *v)
+{
+    __m256i u0 = _mm256_unpacklo_epi16(v[0], v[1]), u1 = _mm256_unpacklo_epi16(v[2], v[3]);
+    __m256i u2 = _mm256_unpackhi_epi16(v[0], v[1]), u3 = _mm256_unpackhi_epi16(v[2], v[3]);
+    __m256i out[4] = {
+        _mm256_unpacklo_epi32(u0, u1), _mm256_unpackhi_epi32(u0, u1),
+        _mm256_unpacklo_epi32(u2, u3), _mm256_unpackhi_epi32(u2, u3)
+    };
+
+    for (int p = 0; p < 4; p++) {
+        __m128i lo = _mm256_castsi256_si128(out[p]);
+        __m128i hi = _mm256_extracti128_si256(out[p], 1);
+        _mm_storel_epi64((__m128i *)dst[2 * p][row], lo);
+        _mm_storel_epi64((__m128i *)dst[2 * p + 1][row], _mm_unpackhi_epi64(lo, lo));
+        _mm_storel_epi64((__m128i *)dst[8 + 2 * p][row], hi);
+        _mm_storel_epi64((__m128i *)dst[8 + 2 * p + 1][row], _mm_unpackhi_epi64(hi, hi));
+    }
+}
+
+/* Row i of a block pair as one 128-bit half */
+__attribute__((target("avx2"))) INLINE __m128i load_pair(int b, int i)
+{
+    const int16_t *b0 = &residual[block_offset[b] + i * image_width];
+    const int16_t *b1 = &residual[block_offset[b + 1] + i * image_width];
+    return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)b0),
+                              _mm_loadl_epi64((const __m128i *)b1));
+}
+
+/* Blocks [first, first + 16) through the fused pipeline, 16 lanes */
+__attribute__((target("avx2")))
+static void transform_batch_avx2(int first, int qp)
+{
+    __m256i v[16];
+    int qp_div = qp / 6;
+
+    for (int i = 0; i < 4; i++) {
+        __m256i rows[4];
+        for (int p = 0; p < 4; p++) {
+            rows[p] = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(load_pair(first + 2 * p, i)),
+                load_pair(first + 8 + 2 * p, i), 1);
+        }
+        transpose_in_avx2(rows[0], rows[1], rows[2], rows[3], &v[4 * i]);
+    }
+
+    for (int i = 0; i < 4; i++) fwd4_avx2(&v[4 * i], 1);
+    for (int j = 0; j < 4; j++) fwd4_avx2(&v[j], 4);
+
+    __m256i mf = _mm256_set1_epi16(quant_scale[qp % 6]);
+    __m256i round = _mm256_set1_epi32(1 << (14 + qp_div));
+    __m128i shift = _mm_cvtsi32_si128(15 + qp_div);
+    __m256i dq = _mm256_set1_epi16((int16_t)(dequant_scale[qp % 6] << qp_div));
+    for (int k = 0; k < 16; k++) {
+        v[k] = quant_dequant_avx2(v[k], mf, round, shift, dq);
+    }
+    for (int i = 0; i < 4; i++) store_row_avx2(&coef_blocks[first], i, &v[4 * i]);
+
+    for (int i = 0; i < 4; i++) inv4_avx2(&v[4 * i], 1, false);
+    for (int j = 0; j < 4; j++) inv4_avx2(&v[j], 4, true);
+    for (int i = 0; i < 4; i++) store_row_avx2(&reconstructed_blocks[first], i, &v[4 * i]);
+}
+
+#endif /* ARCH_X86_64 */
+
+#if defined(__riscv_vector)
+
+/*
+ * RVV: lanes are neighbouring blocks of one block row, so coefficient
+ * (i, j) is a strided load (stride 4 samples) and a strided store into
+ * the block arrays (stride one block); vl covers any VLEN and row tail.
+ * Sizeless vector types cannot form arrays, hence the macros.
+ */
+#define RVV_FWD4(a0, a1, a2, a3) do {                                       \
+        vint16m1_t p0 = __riscv_vadd_vv_i16m1(a0, a3, vl);                  \
+        vint16m1_t p1 = __riscv_vadd_vv_i16m1(a1, a2, vl);                  \
+        vint16m1_t p2 = __riscv_vsub_vv_i16m1(a1, a2, vl);                  \
+        vint16m1_t p3 = __riscv_vsub_vv_i16m1(a0, a3, vl);                  \
+        a0 = __riscv_vadd_vv_i16m1(p0, p1, vl);                             \
+        a1 = __riscv_vadd_vv_i16m1(__riscv_vsll_vx_i16m1(p3, 1, vl), p2, vl); \
+        a2 = __riscv_vsub_vv_i16m1(p0, p1, vl);                             \
+        a3 = __riscv_vsub_vv_i16m1(p3, __riscv_vsll_vx_i16m1(p2, 1, vl), vl); \
+    } while (0)
+
+#define RVV_INV4_P(a0, a1, a2, a3)                                          \
+        vint16m1_t p0 = __riscv_vadd_vv_i16m1(a0, a2, vl);                  \
+        vint16m1_t p1 = __riscv_vsub_vv_i16m1(a0, a2, vl);                  \
+        vint16m1_t p2 = __riscv_vsub_vv_i16m1(__riscv_vsra_vx_i16m1(a1, 1, vl), a3, vl); \
+        vint16m1_t p3 = __riscv_vadd_vv_i16m1(a1, __riscv_vsra_vx_i16m1(a3, 1, vl), vl)
+
+#define RVV_INV4(a0, a1, a2, a3) do {                                       \
+        RVV_INV4_P(a0, a1, a2, a3);                                         \
+        a0 = __riscv_vadd_vv_i16m1(p0, p3, vl);                             \
+        a1 = __riscv_vadd_vv_i16m1(p1, p2, vl);                             \
+        a2 = __riscv_vsub_vv_i16m1(p1, p2, vl);                             \
+        a3 = __riscv_vsub_vv_i16m1(p0, p3, vl);                             \
+    } while (0)
+
+#define RVV_INV4_ROUND(a0, a1, a2, a3) do {                                 \
+        RVV_INV4_P(a0, a1, a2, a3);                                         \
+        a0 = rvv_round6(p0, p3, false, vl);                                 \
+        a1 = rvv_round6(p1, p2, false, vl);                                 \
+        a2 = rvv_round6(p1, p2, true, vl);                                  \
+        a3 = rvv_round6(p0, p3, true, vl);                                  \
+    } while (0)
+
+/* (x +/- y + 32) >> 6 without a 17-bit intermediate */
+static inline vint16m1_t rvv_round6(vint16m1_t x, vint16m1_t y, bool sub, size_t vl)
+{
+    vint16m1_t xh = __riscv_vsra_vx_i16m1(x, 6, vl), xl = __riscv_vand_vx_i16m1(x, 63, vl);
+    vint16m1_t yh = __riscv_vsra_vx_i16m1(y, 6, vl), yl = __riscv_vand_vx_i16m1(y, 63, vl);
+    vint16m1_t h = sub ? __riscv_vsub_vv_i16m1(xh, yh, vl) : __riscv_vadd_vv_i16m1(xh, yh, vl);
+    vint16m1_t l = sub ? __riscv_vsub_vv_i16m1(xl, yl, vl) : __riscv_vadd_vv_i16m1(xl, yl, vl);
+    l = __riscv_vsra_vx_i16m1(__riscv_vadd_vx_i16m1(l, 32, vl), 6, vl);
+    return __riscv_vadd_vv_i16m1(h, l, vl);
+}
+
+static inline vint16m1_t rvv_quant_dequant(vint16m1_t x, uint16_t mf, uint32_t round,
+                                           size_t shift, int16_t dq, size_t vl)
+{
+    vint16m1_t sign = __riscv_vsra_vx_i16m1(x, 15, vl);
+    vuint16m1_t mag = __riscv_vreinterpret_v_i16m1_u16m1(
+        __riscv_vsub_vv_i16m1(__riscv_vxor_vv_i16m1(x, sign, vl), sign, vl));
+
+    vuint32m2_t prod = __riscv_vwmulu_vx_u32m2(mag, mf, vl);
+    prod = __riscv_vadd_vx_u32m2(prod, round, vl);
+    vint16m1_t q = __riscv_vreinterpret_v_u16m1_i16m1(__riscv_vnsrl_wx_u16m1(prod, shift, vl));
+
+    q = __riscv_vsub_vv_i16m1(__riscv_vxor_vv_i16m1(q, sign, vl), sign, vl);
+    return __riscv_vmul_vx_i16m1(q, dq, vl);
+}
+
+#define RVV_LOAD(i, j)   __riscv_vlse16_v_i16m1(src + (i) * image_width + (j), 8, vl)
+#define RVV_STORE(dst, i, j, v) \
+    __riscv_vsse16_v_i16m1(&(dst)[first][i][j], sizeof(block_4x4_t), v, vl)
+#define RVV_ROW(M, dst, i) \
+    M(dst, i, 0, c##i##0); M(dst, i, 1, c##i##1); M(dst, i, 2, c##i##2); M(dst, i, 3, c##i##3)
+#define RVV_QD(v) v = rvv_quant_dequant(v, mf, round, shift, dq, vl)
+
+/* Blocks [first, first + vl) of one block row through the fused pipeline */
+static void transform_strip_rvv(int first, size_t vl, int qp)
+{
+    const int16_t *src = &residual[block_offset[first]];
+    int qp_div = qp / 6;
+    uint16_t mf = (uint16_t)quant_scale[qp % 6];
+    uint32_t round = 1u << (14 + qp_div);
+    size_t shift = (size_t)(15 + qp_div);
+    int16_t dq = (int16_t)(dequant_scale[qp % 6] << qp_div);
+
+    vint16m1_t c00 = RVV_LOAD(0, 0), c01 = RVV_LOAD(0, 1), c02 = RVV_LOAD(0, 2), c03 = RVV_LOAD(0, 3);
+    vint16m1_t c10 = RVV_LOAD(1, 0), c11 = RVV_LOAD(1, 1), c12 = RVV_LOAD(1, 2), c13 = RVV_LOAD(1, 3);
+    vint16m1_t c20 = RVV_LOAD(2, 0), c21 = RVV_LOAD(2, 1), c22 = RVV_LOAD(2, 2), c23 = RVV_LOAD(2, 3);
+    vint16m1_t c30 = RVV_LOAD(3, 0), c31 = RVV_LOAD(3, 1), c32 = RVV_LOAD(3, 2), c33 = RVV_LOAD(3, 3);
+
+    RVV_FWD4(c00, c01, c02, c03);
+    RVV_FWD4(c10, c11, c12, c13);
+    RVV_FWD4(c20, c21, c22, c23);
+    RVV_FWD4(c30, c31, c32, c33);
+    RVV_FWD4(c00, c10, c20, c30);
+    RVV_FWD4(c01, c11, c21, c31);
+    RVV_FWD4(c02, c12, c22, c32);
+    RVV_FWD4(c03, c13, c23, c33);
+
+    RVV_QD(c00); RVV_QD(c01); RVV_QD(c02); RVV_QD(c03);
+    RVV_QD(c10); RVV_QD(c11); RVV_QD(c12); RVV_QD(c13);
+    RVV_QD(c20); RVV_QD(c21); RVV_QD(c22); RVV_QD(c23);
+    RVV_QD(c30); RVV_QD(c31); RVV_QD(c32); RVV_QD(c33);
+
+    RVV_ROW(RVV_STORE, coef_blocks, 0);
+    RVV_ROW(RVV_STORE, coef_blocks, 1);
+    RVV_ROW(RVV_STORE, coef_blocks, 2);
+    RVV_ROW(RVV_STORE, coef_blocks, 3);
+
+    RVV_INV4(c00, c01, c02, c03);
+    RVV_INV4(c10, c11, c12, c13);
+    RVV_INV4(c20, c21, c22, c23);
+    RVV_INV4(c30, c31, c32, c33);
+    RVV_INV4_ROUND(c00, c10, c20, c30);
+    RVV_INV4_ROUND(c01, c11, c21, c31);
+    RVV_INV4_ROUND(c02, c12, c22, c32);
+    RVV_INV4_ROUND(c03, c13, c23, c33);
+
+    RVV_ROW(RVV_STORE, reconstructed_blocks, 0);
+    RVV_ROW(RVV_STORE, reconstructed_blocks, 1);
+    RVV_ROW(RVV_STORE, reconstructed_blocks, 2);
+    RVV_ROW(RVV_STORE, reconstructed_blocks, 3);
+}
+
+#endif /* __riscv_vector */
+
+/* One block through the scalar stages (batch remainders) */
+static void transform_block_scalar(int b)
+{
+    block_4x4_t input_block;
+
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            input_block[i][j] = residual[block_offset[b] + i * image_width + j];
+        }
+    }
+    dct_forward_4x4(input_block, coef_blocks[b]);
+    quant_4x4(coef_blocks[b], DCT_QP);
+    dequant_4x4(coef_blocks[b], DCT_QP);
+    dct_inverse_4x4(coef_blocks[b], reconstructed_blocks[b]);
+}
+
+#if defined(ARCH_X86_64)
+static void transform_all_sse2(void)
+{
+    int b = 0;
+    for (; b + 8 <= batch_blocks; b += 8) transform_batch_sse2(b, DCT_QP);
+    for (; b < batch_blocks; b++) transform_block_scalar(b);
+}
+
+static void transform_all_avx2(void)
+{
+    int b = 0;
+    for (; b + 16 <= batch_blocks; b += 16) transform_batch_avx2(b, DCT_QP);
+    for (; b + 8 <= batch_blocks; b += 8) transform_batch_sse2(b, DCT_QP);
+    for (; b < batch_blocks; b++) transform_block_scalar(b);
+}
+#endif
+
+#if defined(__riscv_vector)
+/* Strips never cross a block row, where the strided layout breaks */
+static void transform_all_rvv(void)
+{
+    int blocks_per_row = image_width / 4;
+
+    for (int b = 0; b < batch_blocks; ) {
+        int row_end = MIN((b / blocks_per_row + 1) * blocks_per_row, batch_blocks);
+        size_t vl = __riscv_vsetvl_e16m1((size_t)(row_end - b));
+        transform_strip_rvv(b, vl, DCT_QP);
+        b += (int)vl;
+    }
+}
+#endif
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
 
-static void generate_test_image(uint8_t orig[][DCT_IMAGE_WIDTH],
-                               uint8_t pred[][DCT_IMAGE_WIDTH],
-                               uint32_t seed)
+static void generate_test_image(uint8_t *orig, uint8_t *pred, uint32_t seed)
 {
     uint32_t x = seed;
 
-    for (int i = 0; i < DCT_IMAGE_HEIGHT; i++) {
-        for (int j = 0; j < DCT_IMAGE_WIDTH; j++) {
+    for (int i = 0; i < image_height; i++) {
+        for (int j = 0; j < image_width; j++) {
             x ^= x << 13;
             x ^= x >> 17;
             x ^= x << 5;
 
             /* Original: smooth with some texture */
-            orig[i][j] = (uint8_t)(128 + (i * 2) + (j * 2) + (x % 20) - 10);
+            uint8_t o = (uint8_t)(128 + (i * 2) + (j * 2) + (x % 20) - 10);
+            orig[i * image_width + j] = o;
 
             /* Predicted: close to original (good prediction) */
             x ^= x << 13;
             x ^= x >> 17;
             x ^= x << 5;
-            pred[i][j] = (uint8_t)(orig[i][j] + (x % 16) - 8);
+            pred[i * image_width + j] = (uint8_t)(o + (x % 16) - 8);
         }
     }
 }
@@ -220,33 +702,46 @@ static void generate_test_image(uint8_t orig[][DCT_IMAGE_WIDTH],
 
 static void kernel_init_func(void)
 {
+    image_width = (int)bench_scale_dim(DCT_IMAGE_WIDTH);
+    image_height = (int)bench_scale_dim(DCT_IMAGE_HEIGHT);
+    num_blocks = (int)bench_scale(DCT_NUM_BLOCKS);
+
+    int pixels = image_width * image_height;
+    original = bench_alloc(pixels);
+    predicted = bench_alloc(pixels);
+    residual = bench_alloc(pixels * sizeof(int16_t));
+    coef_blocks = bench_alloc(num_blocks * sizeof(block_4x4_t));
+    reconstructed_blocks = bench_alloc(num_blocks * sizeof(block_4x4_t));
+    block_offset = bench_alloc(num_blocks * sizeof(int32_t));
+
+    /* Block origins in the reference loop's order */
+    batch_blocks = 0;
+    for (int by = 0; by < image_height && batch_blocks < num_blocks; by += 4) {
+        for (int bx = 0; bx < image_width && batch_blocks < num_blocks; bx += 4) {
+            block_offset[batch_blocks++] = by * image_width + bx;
+        }
+    }
+
     /* Generate test images */
     generate_test_image(original, predicted, 0x12345678);
 
     /* Compute residual */
-    for (int i = 0; i < DCT_IMAGE_HEIGHT; i++) {
-        for (int j = 0; j < DCT_IMAGE_WIDTH; j++) {
-            residual[i][j] = (int16_t)original[i][j] - (int16_t)predicted[i][j];
-        }
+    for (int i = 0; i < pixels; i++) {
+        residual[i] = (int16_t)original[i] - (int16_t)predicted[i];
     }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Reference per-block loop */
+static void transform_all_ref(void)
 {
-    bench_result_t result = { .status = BENCH_OK };
-
-    /* Start timing */
-    BENCH_START();
-
-    /* Process each 4x4 block */
     int block_idx = 0;
-    for (int by = 0; by < DCT_IMAGE_HEIGHT && block_idx < DCT_NUM_BLOCKS; by += 4) {
-        for (int bx = 0; bx < DCT_IMAGE_WIDTH && block_idx < DCT_NUM_BLOCKS; bx += 4) {
+    for (int by = 0; by < image_height && block_idx < num_blocks; by += 4) {
+        for (int bx = 0; bx < image_width && block_idx < num_blocks; bx += 4) {
             /* Extract block from residual */
             block_4x4_t input_block;
             for (int i = 0; i < 4; i++) {
                 for (int j = 0; j < 4; j++) {
-                    input_block[i][j] = residual[by + i][bx + j];
+                    input_block[i][j] = residual[(by + i) * image_width + bx + j];
                 }
             }
 
@@ -265,13 +760,29 @@ static bench_result_t kernel_run_func(void)
             block_idx++;
         }
     }
+}
+
+/*
+ * Transform every block with one of the engines
+ */
+static bench_result_t transform_image(void (*engine)(void))
+{
+    bench_result_t result = { .status = BENCH_OK };
+
+    /* Start timing */
+    BENCH_START();
+
+    /* Process each 4x4 block (per-block stages are too short to time alone) */
+    BENCH_PHASE_BEGIN(PHASE_BLOCKS);
+    engine();
+    BENCH_PHASE_END(PHASE_BLOCKS);
 
     /* End timing */
     BENCH_END();
 
     /* Compute checksum of coefficients and reconstructed blocks */
     uint32_t csum = checksum_init();
-    for (int b = 0; b < DCT_NUM_BLOCKS; b++) {
+    for (int b = 0; b < num_blocks; b++) {
         for (int i = 0; i < 4; i++) {
             for (int j = 0; j < 4; j++) {
                 csum = checksum_update(csum, (uint32_t)(int32_t)coef_blocks[b][i][j]);
@@ -286,6 +797,30 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return transform_image(transform_all_ref);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_sse2(void)
+{
+    return transform_image(transform_all_sse2);
+}
+
+static bench_result_t kernel_run_avx2(void)
+{
+    return transform_image(transform_all_avx2);
+}
+#endif
+
+#if defined(__riscv_vector)
+static bench_result_t kernel_run_rvv(void)
+{
+    return transform_image(transform_all_rvv);
+}
+#endif
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -295,7 +830,19 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t dct_variants[] = {
+#if defined(ARCH_X86_64)
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+    { "sse2", ISA_SSE2, kernel_run_sse2 },
+#endif
+#if defined(__riscv_vector)
+    { "rvv", ISA_RVV, kernel_run_rvv },
+#endif
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     dct_4x4,
     "H.264 4x4 DCT transform",
     "464.h264ref",
@@ -303,7 +850,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    DCT_NUM_BLOCKS
+    DCT_NUM_BLOCKS,
+    dct_variants,
+    "transform_quant"
 );
 
 KERNEL_REGISTER(dct_4x4)
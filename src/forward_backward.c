@@ -9,8 +9,15 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+
 /* ============================================================================
  * Configuration
+ * FB_SEQ_LENGTH is the tier S length, scaled by bench_scale_dim() (x4 per
+ * tier) so that whole-sequence log-likelihoods stay within int32 range.
+ * FB_BATCH sequences run in lock-step in the SIMD variants.
  * ============================================================================ */
 
 #ifndef FB_SEQ_LENGTH
@@ -29,16 +36,30 @@
 #define FB_NUM_SEQS         5
 #endif
 
+#ifndef FB_BATCH
+#define FB_BATCH            4
+#endif
+
+/* Allowed forward/backward total mismatch per position: the log_add
+ * approximation error builds up linearly with the sequence length */
+#ifndef FB_DRIFT_PER_POS
+#define FB_DRIFT_PER_POS    1600
+#endif
+
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_FORWARD, PHASE_BACKWARD, PHASE_POSTERIOR, PHASE_DECODE };
+
 /* Log probability representation (fixed-point for bare-metal) */
 typedef int32_t logprob_t;
 
 #define LOG_ZERO        (-1000000000)
 #define LOG_ONE         0
 #define LOGPROB_SCALE   1000  /* Fixed-point scale factor */
+#define LOG_ADD_CUTOFF  (10 * LOGPROB_SCALE)  /* log_add returns max beyond this gap */
 
 /* HMM model */
 typedef struct {
@@ -48,16 +69,35 @@ typedef struct {
     logprob_t end[FB_NUM_STATES];    /* Terminal state probabilities */
 } hmm_fb_t;
 
-/* DP matrices */
+/* DP matrices (seq_length rows, arena-allocated) */
 typedef struct {
-    logprob_t forward[FB_SEQ_LENGTH][FB_NUM_STATES];
-    logprob_t backward[FB_SEQ_LENGTH][FB_NUM_STATES];
-    logprob_t posterior[FB_SEQ_LENGTH][FB_NUM_STATES];
+    logprob_t (*forward)[FB_NUM_STATES];
+    logprob_t (*backward)[FB_NUM_STATES];
+    logprob_t (*posterior)[FB_NUM_STATES];
 } dp_matrices_t;
 
-static hmm_fb_t model;
-static dp_matrices_t matrices;
-static uint8_t sequence[FB_SEQ_LENGTH];
+/*
+ * Forward/backward pass over sequences[0..count) into matrices[0..count),
+ * scores[c] receiving each total; batch is the largest count it takes
+ */
+typedef struct {
+    int batch;
+    void (*forward)(int count, logprob_t *scores);
+    void (*backward)(int count, logprob_t *scores);
+} fb_engine_t;
+
+static BENCH_TLS hmm_fb_t model;
+static BENCH_TLS dp_matrices_t matrices[FB_BATCH];
+static BENCH_TLS uint8_t *sequences[FB_BATCH];
+static BENCH_TLS int8_t *paths[FB_BATCH];
+static BENCH_TLS int seq_length;
+
+/* State-major copies for vectors across k: trans_t[j][k] = trans[k][j] */
+static BENCH_TLS logprob_t trans_t[FB_NUM_STATES][FB_NUM_STATES];
+static BENCH_TLS logprob_t emit_t[FB_ALPHABET_SIZE][FB_NUM_STATES];
+
+/* log_add correction by gap, 0..LOG_ADD_CUTOFF (arena) */
+static BENCH_TLS int16_t *log_add_table;
 
 /* ============================================================================
  * Log-Space Arithmetic
@@ -74,7 +114,7 @@ static logprob_t log_add(logprob_t a, logprob_t b)
 
     /* Approximate log(1 + exp(min - max)) */
     int32_t diff = max_val - min_val;
-    if (diff > 10 * LOGPROB_SCALE) return max_val;
+    if (diff > LOG_ADD_CUTOFF) return max_val;
 
     /* Lookup table approximation for log(1 + exp(-x)) */
     /* Using simple linear approximation */
@@ -89,8 +129,8 @@ static logprob_t log_add(logprob_t a, logprob_t b)
  * ============================================================================ */
 
 /* Compute forward probabilities */
-static logprob_t forward_algorithm(const hmm_fb_t *hmm, const uint8_t *seq, int seq_len,
-                                   logprob_t fwd[FB_SEQ_LENGTH][FB_NUM_STATES])
+static logprob_t forward_algorithm(const hmm_fb_t *restrict hmm, const uint8_t *restrict seq,
+                                   int seq_len, logprob_t (*restrict fwd)[FB_NUM_STATES])
 {
     /* Initialize first position */
     for (int k = 0; k < FB_NUM_STATES; k++) {
@@ -125,8 +165,8 @@ static logprob_t forward_algorithm(const hmm_fb_t *hmm, const uint8_t *seq, int
  * ============================================================================ */
 
 /* Compute backward probabilities */
-static logprob_t backward_algorithm(const hmm_fb_t *hmm, const uint8_t *seq, int seq_len,
-                                    logprob_t bwd[FB_SEQ_LENGTH][FB_NUM_STATES])
+static logprob_t backward_algorithm(const hmm_fb_t *restrict hmm, const uint8_t *restrict seq,
+                                    int seq_len, logprob_t (*restrict bwd)[FB_NUM_STATES])
 {
     /* Initialize last position */
     for (int k = 0; k < FB_NUM_STATES; k++) {
@@ -161,9 +201,9 @@ static logprob_t backward_algorithm(const hmm_fb_t *hmm, const uint8_t *seq, int
  * ============================================================================ */
 
 /* Compute posterior probabilities P(state k at position i | sequence) */
-static void compute_posteriors(logprob_t fwd[FB_SEQ_LENGTH][FB_NUM_STATES],
-                               logprob_t bwd[FB_SEQ_LENGTH][FB_NUM_STATES],
-                               logprob_t post[FB_SEQ_LENGTH][FB_NUM_STATES],
+static void compute_posteriors(logprob_t (*fwd)[FB_NUM_STATES],
+                               logprob_t (*bwd)[FB_NUM_STATES],
+                               logprob_t (*post)[FB_NUM_STATES],
                                logprob_t total_prob, int seq_len)
 {
     for (int i = 0; i < seq_len; i++) {
@@ -174,7 +214,7 @@ static void compute_posteriors(logprob_t fwd[FB_SEQ_LENGTH][FB_NUM_STATES],
 }
 
 /* Find best state at each position (posterior decoding) */
-static void posterior_decode(logprob_t post[FB_SEQ_LENGTH][FB_NUM_STATES],
+static void posterior_decode(logprob_t (*post)[FB_NUM_STATES],
                             int seq_len, int8_t *path)
 {
     for (int i = 0; i < seq_len; i++) {
@@ -192,6 +232,326 @@ static void posterior_decode(logprob_t post[FB_SEQ_LENGTH][FB_NUM_STATES],
     }
 }
 
+/* ============================================================================
+ * Table-Driven Log-Add (HMMER's p7_FLogsum)
+ * The correction term depends only on the gap max - min, so it is read from
+ * a table filled from log_add() itself in init; results are exact.
+ * ============================================================================ */
+
+static void build_log_add_table(void)
+{
+    log_add_table = bench_alloc((LOG_ADD_CUTOFF + 1) * sizeof(int16_t));
+    for (int d = 0; d <= LOG_ADD_CUTOFF; d++) {
+        log_add_table[d] = (int16_t)log_add(0, -d);
+    }
+}
+
+INLINE logprob_t log_add_lut(logprob_t a, logprob_t b)
+{
+    if (a <= LOG_ZERO) return b;
+    if (b <= LOG_ZERO) return a;
+
+    logprob_t max_val = (a > b) ? a : b;
+    int32_t diff = (a > b) ? a - b : b - a;
+
+    return diff > LOG_ADD_CUTOFF ? max_val : max_val + log_add_table[diff];
+}
+
+static void forward_lut(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        const uint8_t *seq = sequences[c];
+        logprob_t (*fwd)[FB_NUM_STATES] = matrices[c].forward;
+
+        for (int k = 0; k < FB_NUM_STATES; k++) {
+            fwd[0][k] = model.begin[k] + model.emit[k][seq[0]];
+        }
+
+        for (int i = 1; i < seq_length; i++) {
+            for (int k = 0; k < FB_NUM_STATES; k++) {
+                logprob_t sum = LOG_ZERO;
+                for (int j = 0; j < FB_NUM_STATES; j++) {
+                    sum = log_add_lut(sum, fwd[i-1][j] + model.trans[j][k]);
+                }
+                fwd[i][k] = sum + model.emit[k][seq[i]];
+            }
+        }
+
+        logprob_t total = LOG_ZERO;
+        for (int k = 0; k < FB_NUM_STATES; k++) {
+            total = log_add_lut(total, fwd[seq_length-1][k] + model.end[k]);
+        }
+        scores[c] = total;
+    }
+}
+
+static void backward_lut(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        const uint8_t *seq = sequences[c];
+        logprob_t (*bwd)[FB_NUM_STATES] = matrices[c].backward;
+
+        for (int k = 0; k < FB_NUM_STATES; k++) {
+            bwd[seq_length-1][k] = model.end[k];
+        }
+
+        for (int i = seq_length - 2; i >= 0; i--) {
+            for (int k = 0; k < FB_NUM_STATES; k++) {
+                logprob_t sum = LOG_ZERO;
+                for (int j = 0; j < FB_NUM_STATES; j++) {
+                    sum = log_add_lut(sum, model.trans[k][j] + model.emit[j][seq[i+1]] + bwd[i+1][j]);
+                }
+                bwd[i][k] = sum;
+            }
+        }
+
+        logprob_t total = LOG_ZERO;
+        for (int k = 0; k < FB_NUM_STATES; k++) {
+            total = log_add_lut(total, model.begin[k] + model.emit[k][seq[0]] + bwd[0][k]);
+        }
+        scores[c] = total;
+    }
+}
+
+/* ============================================================================
+ * Batched SIMD Passes (x86-64)
+ *
+ * Lanes are target states k; the sum over source states j keeps the
+ * reference order (log_add is not associative), one log_add per j across
+ * all k at once. The FB_BATCH sequences of a batch advance column by column
+ * together, so each transition row is loaded once per column for the batch.
+ * log_add's floor(gap / 15) is (gap * 34953) >> 19, exact for gaps up to
+ * LOG_ADD_CUTOFF + 1 (checked exhaustively).
+ * ============================================================================ */
+
+#if defined(ARCH_X86_64)
+
+#define LOG_ADD_DIV15_MUL   34953
+#define LOG_ADD_DIV15_SHIFT 19
+
+/* Totals fold over k in order, as the reference does */
+static logprob_t forward_total(const logprob_t *last)
+{
+    logprob_t total = LOG_ZERO;
+    for (int k = 0; k < FB_NUM_STATES; k++) {
+        total = log_add(total, last[k] + model.end[k]);
+    }
+    return total;
+}
+
+static logprob_t backward_total(const uint8_t *seq, const logprob_t *first)
+{
+    logprob_t total = LOG_ZERO;
+    for (int k = 0; k < FB_NUM_STATES; k++) {
+        total = log_add(total, model.begin[k] + model.emit[k][seq[0]] + first[k]);
+    }
+    return total;
+}
+
+#define SSE_VECS    (FB_NUM_STATES / 4)
+
+__attribute__((target("sse4.1")))
+static inline __m128i log_add_sse41(__m128i a, __m128i b)
+{
+    const __m128i zero_limit = _mm_set1_epi32(LOG_ZERO + 1);
+    __m128i mx = _mm_max_epi32(a, b);
+    __m128i diff = _mm_sub_epi32(mx, _mm_min_epi32(a, b));
+    __m128i q = _mm_srli_epi32(_mm_mullo_epi32(_mm_min_epi32(diff, _mm_set1_epi32(LOG_ADD_CUTOFF + 1)),
+                                               _mm_set1_epi32(LOG_ADD_DIV15_MUL)), LOG_ADD_DIV15_SHIFT);
+    __m128i add = _mm_andnot_si128(_mm_cmpgt_epi32(diff, _mm_set1_epi32(LOG_ADD_CUTOFF)),
+                                   _mm_sub_epi32(_mm_set1_epi32(LOGPROB_SCALE), q));
+    __m128i r = _mm_add_epi32(mx, add);
+    r = _mm_blendv_epi8(r, a, _mm_cmpgt_epi32(zero_limit, b));
+    return _mm_blendv_epi8(r, b, _mm_cmpgt_epi32(zero_limit, a));
+}
+
+__attribute__((target("sse4.1")))
+static void forward_sse41(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        logprob_t *row = matrices[c].forward[0];
+        for (int v = 0; v < SSE_VECS; v++) {
+            __m128i b = _mm_loadu_si128((const __m128i *)&model.begin[v * 4]);
+            __m128i e = _mm_loadu_si128((const __m128i *)&emit_t[sequences[c][0]][v * 4]);
+            _mm_storeu_si128((__m128i *)&row[v * 4], _mm_add_epi32(b, e));
+        }
+    }
+
+    for (int i = 1; i < seq_length; i++) {
+        __m128i sum[FB_BATCH][SSE_VECS];
+        for (int c = 0; c < count; c++) {
+            for (int v = 0; v < SSE_VECS; v++) sum[c][v] = _mm_set1_epi32(LOG_ZERO);
+        }
+
+        for (int j = 0; j < FB_NUM_STATES; j++) {
+            __m128i t[SSE_VECS];
+            for (int v = 0; v < SSE_VECS; v++) {
+                t[v] = _mm_loadu_si128((const __m128i *)&model.trans[j][v * 4]);
+            }
+            for (int c = 0; c < count; c++) {
+                __m128i f = _mm_set1_epi32(matrices[c].forward[i-1][j]);
+                for (int v = 0; v < SSE_VECS; v++) {
+                    sum[c][v] = log_add_sse41(sum[c][v], _mm_add_epi32(f, t[v]));
+                }
+            }
+        }
+
+        for (int c = 0; c < count; c++) {
+            const logprob_t *e = emit_t[sequences[c][i]];
+            for (int v = 0; v < SSE_VECS; v++) {
+                _mm_storeu_si128((__m128i *)&matrices[c].forward[i][v * 4],
+                                 _mm_add_epi32(sum[c][v], _mm_loadu_si128((const __m128i *)&e[v * 4])));
+            }
+        }
+    }
+
+    for (int c = 0; c < count; c++) {
+        scores[c] = forward_total(matrices[c].forward[seq_length-1]);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void backward_sse41(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        memcpy(matrices[c].backward[seq_length-1], model.end, sizeof(model.end));
+    }
+
+    for (int i = seq_length - 2; i >= 0; i--) {
+        __m128i sum[FB_BATCH][SSE_VECS];
+        for (int c = 0; c < count; c++) {
+            for (int v = 0; v < SSE_VECS; v++) sum[c][v] = _mm_set1_epi32(LOG_ZERO);
+        }
+
+        for (int j = 0; j < FB_NUM_STATES; j++) {
+            __m128i t[SSE_VECS];
+            for (int v = 0; v < SSE_VECS; v++) {
+                t[v] = _mm_loadu_si128((const __m128i *)&trans_t[j][v * 4]);
+            }
+            for (int c = 0; c < count; c++) {
+                __m128i w = _mm_set1_epi32(model.emit[j][sequences[c][i+1]] +
+                                           matrices[c].backward[i+1][j]);
+                for (int v = 0; v < SSE_VECS; v++) {
+                    sum[c][v] = log_add_sse41(sum[c][v], _mm_add_epi32(t[v], w));
+                }
+            }
+        }
+
+        for (int c = 0; c < count; c++) {
+            for (int v = 0; v < SSE_VECS; v++) {
+                _mm_storeu_si128((__m128i *)&matrices[c].backward[i][v * 4], sum[c][v]);
+            }
+        }
+    }
+
+    for (int c = 0; c < count; c++) {
+        scores[c] = backward_total(sequences[c], matrices[c].backward[0]);
+    }
+}
+
+#define AVX2_VECS   (FB_NUM_STATES / 8)
+
+__attribute__((target("avx2")))
+static inline __m256i log_add_avx2(__m256i a, __m256i b)
+{
+    const __m256i zero_limit = _mm256_set1_epi32(LOG_ZERO + 1);
+    __m256i mx = _mm256_max_epi32(a, b);
+    __m256i diff = _mm256_sub_epi32(mx, _mm256_min_epi32(a, b));
+    __m256i q = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_min_epi32(diff, _mm256_set1_epi32(LOG_ADD_CUTOFF + 1)),
+                                                     _mm256_set1_epi32(LOG_ADD_DIV15_MUL)), LOG_ADD_DIV15_SHIFT);
+    __m256i add = _mm256_andnot_si256(_mm256_cmpgt_epi32(diff, _mm256_set1_epi32(LOG_ADD_CUTOFF)),
+                                      _mm256_sub_epi32(_mm256_set1_epi32(LOGPROB_SCALE), q));
+    __m256i r = _mm256_add_epi32(mx, add);
+    r = _mm256_blendv_epi8(r, a, _mm256_cmpgt_epi32(zero_limit, b));
+    return _mm256_blendv_epi8(r, b, _mm256_cmpgt_epi32(zero_limit, a));
+}
+
+__attribute__((target("avx2")))
+static void forward_avx2(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        logprob_t *row = matrices[c].forward[0];
+        for (int v = 0; v < AVX2_VECS; v++) {
+            __m256i b = _mm256_loadu_si256((const __m256i *)&model.begin[v * 8]);
+            __m256i e = _mm256_loadu_si256((const __m256i *)&emit_t[sequences[c][0]][v * 8]);
+            _mm256_storeu_si256((__m256i *)&row[v * 8], _mm256_add_epi32(b, e));
+        }
+    }
+
+    for (int i = 1; i < seq_length; i++) {
+        __m256i sum[FB_BATCH][AVX2_VECS];
+        for (int c = 0; c < count; c++) {
+            for (int v = 0; v < AVX2_VECS; v++) sum[c][v] = _mm256_set1_epi32(LOG_ZERO);
+        }
+
+        for (int j = 0; j < FB_NUM_STATES; j++) {
+            __m256i t[AVX2_VECS];
+            for (int v = 0; v < AVX2_VECS; v++) {
+                t[v] = _mm256_loadu_si256((const __m256i *)&model.trans[j][v * 8]);
+            }
+            for (int c = 0; c < count; c++) {
+                __m256i f = _mm256_set1_epi32(matrices[c].forward[i-1][j]);
+                for (int v = 0; v < AVX2_VECS; v++) {
+                    sum[c][v] = log_add_avx2(sum[c][v], _mm256_add_epi32(f, t[v]));
+                }
+            }
+        }
+
+        for (int c = 0; c < count; c++) {
+            const logprob_t *e = emit_t[sequences[c][i]];
+            for (int v = 0; v < AVX2_VECS; v++) {
+                _mm256_storeu_si256((__m256i *)&matrices[c].forward[i][v * 8],
+                                    _mm256_add_epi32(sum[c][v], _mm256_loadu_si256((const __m256i *)&e[v * 8])));
+            }
+        }
+    }
+
+    for (int c = 0; c < count; c++) {
+        scores[c] = forward_total(matrices[c].forward[seq_length-1]);
+    }
+}
+
+__attribute__((target("avx2")))
+static void backward_avx2(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        memcpy(matrices[c].backward[seq_length-1], model.end, sizeof(model.end));
+    }
+
+    for (int i = seq_length - 2; i >= 0; i--) {
+        __m256i sum[FB_BATCH][AVX2_VECS];
+        for (int c = 0; c < count; c++) {
+            for (int v = 0; v < AVX2_VECS; v++) sum[c][v] = _mm256_set1_epi32(LOG_ZERO);
+        }
+
+        for (int j = 0; j < FB_NUM_STATES; j++) {
+            __m256i t[AVX2_VECS];
+            for (int v = 0; v < AVX2_VECS; v++) {
+                t[v] = _mm256_loadu_si256((const __m256i *)&trans_t[j][v * 8]);
+            }
+            for (int c = 0; c < count; c++) {
+                __m256i w = _mm256_set1_epi32(model.emit[j][sequences[c][i+1]] +
+                                              matrices[c].backward[i+1][j]);
+                for (int v = 0; v < AVX2_VECS; v++) {
+                    sum[c][v] = log_add_avx2(sum[c][v], _mm256_add_epi32(t[v], w));
+                }
+            }
+        }
+
+        for (int c = 0; c < count; c++) {
+            for (int v = 0; v < AVX2_VECS; v++) {
+                _mm256_storeu_si256((__m256i *)&matrices[c].backward[i][v * 8], sum[c][v]);
+            }
+        }
+    }
+
+    for (int c = 0; c < count; c++) {
+        scores[c] = backward_total(sequences[c], matrices[c].backward[0]);
+    }
+}
+
+#endif /* ARCH_X86_64 */
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -243,58 +603,119 @@ static void generate_sequence(uint8_t *seq, int len, uint32_t seed)
  * Kernel Implementation
  * ============================================================================ */
 
+static void forward_ref(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        scores[c] = forward_algorithm(&model, sequences[c], seq_length, matrices[c].forward);
+    }
+}
+
+static void backward_ref(int count, logprob_t *scores)
+{
+    for (int c = 0; c < count; c++) {
+        scores[c] = backward_algorithm(&model, sequences[c], seq_length, matrices[c].backward);
+    }
+}
+
+static const fb_engine_t engine_ref = { 1, forward_ref, backward_ref };
+static const fb_engine_t engine_lut = { 1, forward_lut, backward_lut };
+#if defined(ARCH_X86_64)
+static const fb_engine_t engine_sse41 = { FB_BATCH, forward_sse41, backward_sse41 };
+static const fb_engine_t engine_avx2 = { FB_BATCH, forward_avx2, backward_avx2 };
+#endif
+
 static void kernel_init_func(void)
 {
     generate_model(&model, 0xDEADBEEF);
-    memset(&matrices, 0, sizeof(matrices));
+
+    for (int k = 0; k < FB_NUM_STATES; k++) {
+        for (int j = 0; j < FB_NUM_STATES; j++) trans_t[j][k] = model.trans[k][j];
+        for (int a = 0; a < FB_ALPHABET_SIZE; a++) emit_t[a][k] = model.emit[k][a];
+    }
+    build_log_add_table();
+
+    /* Static model tables for --cache=cold */
+    bench_cache_region(&model, sizeof(model));
+    bench_cache_region(trans_t, sizeof(trans_t));
+    bench_cache_region(emit_t, sizeof(emit_t));
+
+    seq_length = (int)bench_scale_dim(FB_SEQ_LENGTH);
+    for (int c = 0; c < FB_BATCH; c++) {
+        matrices[c].forward = bench_alloc(seq_length * sizeof(*matrices[c].forward));
+        matrices[c].backward = bench_alloc(seq_length * sizeof(*matrices[c].backward));
+        matrices[c].posterior = bench_alloc(seq_length * sizeof(*matrices[c].posterior));
+        sequences[c] = bench_alloc(seq_length);
+        paths[c] = bench_alloc(seq_length);
+    }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver: sequences go through the engine engine->batch at a time */
+static bench_result_t fb_run(const fb_engine_t *engine)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
     logprob_t total_fwd = 0;
     logprob_t total_bwd = 0;
+    logprob_t fwd_scores[FB_BATCH];
+    logprob_t bwd_scores[FB_BATCH];
 
     /* Start timing */
     BENCH_START();
 
-    for (int s = 0; s < FB_NUM_SEQS; s++) {
-        /* Generate sequence */
-        generate_sequence(sequence, FB_SEQ_LENGTH, 0x12345678 + s * 1000);
+    for (int s0 = 0; s0 < FB_NUM_SEQS; s0 += engine->batch) {
+        int count = FB_NUM_SEQS - s0 < engine->batch ? FB_NUM_SEQS - s0 : engine->batch;
+
+        /* Generate sequences */
+        for (int c = 0; c < count; c++) {
+            generate_sequence(sequences[c], seq_length, 0x12345678 + (s0 + c) * 1000);
+        }
 
         /* Forward algorithm */
-        logprob_t fwd_score = forward_algorithm(&model, sequence, FB_SEQ_LENGTH,
-                                                 matrices.forward);
-        total_fwd += fwd_score;
+        BENCH_PHASE_BEGIN(PHASE_FORWARD);
+        engine->forward(count, fwd_scores);
+        BENCH_PHASE_END(PHASE_FORWARD);
 
         /* Backward algorithm */
-        logprob_t bwd_score = backward_algorithm(&model, sequence, FB_SEQ_LENGTH,
-                                                  matrices.backward);
-        total_bwd += bwd_score;
+        BENCH_PHASE_BEGIN(PHASE_BACKWARD);
+        engine->backward(count, bwd_scores);
+        BENCH_PHASE_END(PHASE_BACKWARD);
 
         /* Compute posteriors */
-        compute_posteriors(matrices.forward, matrices.backward,
-                          matrices.posterior, fwd_score, FB_SEQ_LENGTH);
+        BENCH_PHASE_BEGIN(PHASE_POSTERIOR);
+        for (int c = 0; c < count; c++) {
+            compute_posteriors(matrices[c].forward, matrices[c].backward,
+                              matrices[c].posterior, fwd_scores[c], seq_length);
+        }
+        BENCH_PHASE_END(PHASE_POSTERIOR);
 
         /* Posterior decoding */
-        int8_t path[FB_SEQ_LENGTH];
-        posterior_decode(matrices.posterior, FB_SEQ_LENGTH, path);
+        BENCH_PHASE_BEGIN(PHASE_DECODE);
+        for (int c = 0; c < count; c++) {
+            posterior_decode(matrices[c].posterior, seq_length, paths[c]);
+        }
+        BENCH_PHASE_END(PHASE_DECODE);
 
-        /* Update checksum */
-        csum = checksum_update(csum, (uint32_t)(fwd_score & 0xFFFFFFFF));
-        csum = checksum_update(csum, (uint32_t)(bwd_score & 0xFFFFFFFF));
+        for (int c = 0; c < count; c++) {
+            logprob_t fwd_score = fwd_scores[c];
+            logprob_t bwd_score = bwd_scores[c];
+            total_fwd += fwd_score;
+            total_bwd += bwd_score;
 
-        for (int i = 0; i < FB_SEQ_LENGTH; i++) {
-            csum = checksum_update(csum, (uint32_t)path[i]);
-        }
+            /* Update checksum */
+            csum = checksum_update(csum, (uint32_t)(fwd_score & 0xFFFFFFFF));
+            csum = checksum_update(csum, (uint32_t)(bwd_score & 0xFFFFFFFF));
+
+            for (int i = 0; i < seq_length; i++) {
+                csum = checksum_update(csum, (uint32_t)paths[c][i]);
+            }
 
-        /* Verify forward and backward give same total probability */
-        /* Note: In fixed-point log-space, some numerical error is expected */
-        int32_t diff = fwd_score - bwd_score;
-        if (diff < 0) diff = -diff;
-        if (diff > 100000) {  /* Allow larger tolerance for fixed-point arithmetic */
-            result.status = BENCH_ERR_CHECKSUM;
+            /* Verify forward and backward give same total probability */
+            /* Note: In fixed-point log-space, some numerical error is expected */
+            int32_t diff = fwd_score - bwd_score;
+            if (diff < 0) diff = -diff;
+            if (diff > seq_length * FB_DRIFT_PER_POS) {  /* Fixed-point drift grows with length */
+                result.status = BENCH_ERR_CHECKSUM;
+            }
         }
     }
 
@@ -312,6 +733,28 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return fb_run(&engine_ref);
+}
+
+static bench_result_t kernel_run_lut(void)
+{
+    return fb_run(&engine_lut);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_sse41(void)
+{
+    return fb_run(&engine_sse41);
+}
+
+static bench_result_t kernel_run_avx2(void)
+{
+    return fb_run(&engine_avx2);
+}
+#endif
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -320,7 +763,19 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t fb_variants[] = {
+#if defined(ARCH_X86_64) && FB_NUM_STATES % 8 == 0
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+#endif
+#if defined(ARCH_X86_64) && FB_NUM_STATES % 4 == 0
+    { "sse4.1", ISA_SSE41, kernel_run_sse41 },
+#endif
+    { "lut", 0, kernel_run_lut },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     forward_backward,
     "Forward/Backward HMM algorithms",
     "456.hmmer",
@@ -328,7 +783,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    FB_NUM_SEQS
+    FB_NUM_SEQS,
+    fb_variants,
+    "forward", "backward", "posterior", "decode"
 );
 
 KERNEL_REGISTER(forward_backward)
@@ -12,6 +12,8 @@
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * GAME_TT_SIZE is the tier S table size in entries, scaled by bench_scale()
+ * and rounded down to a power of two.
  * ============================================================================ */
 
 #ifndef GAME_SEARCH_DEPTH
@@ -19,25 +21,33 @@
 #endif
 
 #ifndef GAME_BRANCHING
-#define GAME_BRANCHING      8       /* Average branching factor */
+#define GAME_BRANCHING      8       /* Moves searched per node */
 #endif
 
 #ifndef GAME_TT_SIZE
-#define GAME_TT_SIZE        256     /* Transposition table size */
+#define GAME_TT_SIZE        256     /* Transposition table entries (16 bytes each) */
 #endif
 
 #ifndef GAME_BOARD_SIZE
 #define GAME_BOARD_SIZE     64      /* 8x8 board */
 #endif
 
+#ifndef GAME_MAX_THREADS
+#define GAME_MAX_THREADS    16      /* Search threads for the smp-mt variant */
+#endif
+
 /* Score constants */
 #define SCORE_INF           30000
 #define SCORE_MATE          20000
+#define SCORE_MATE_BOUND    (SCORE_MATE - 1000)     /* Scores beyond are mates */
 
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_SEARCH };
+
 /* Move representation */
 typedef struct {
     uint8_t from;
@@ -45,15 +55,25 @@ typedef struct {
     int16_t score;          /* Move ordering score */
 } move_t;
 
-/* Transposition table entry */
+/*
+ * Transposition table entry, shared by all search threads without locks.
+ * key holds hash ^ data, so an entry torn by a concurrent store fails the
+ * hash check instead of returning another position's data.
+ */
 typedef struct {
-    uint64_t hash;
-    int16_t score;
-    uint8_t depth;
-    uint8_t flag;           /* 0=exact, 1=lower, 2=upper */
-    move_t best_move;
+    uint64_t key;
+    uint64_t data;          /* tt_pack() fields */
 } tt_entry_t;
 
+/* Bound types in the data word */
+enum { TT_EXACT, TT_LOWER, TT_UPPER };
+
+/* Zobrist keys */
+typedef struct {
+    uint64_t piece[12][GAME_BOARD_SIZE];
+    uint64_t side;
+} zobrist_t;
+
 /* Game state */
 typedef struct {
     int8_t board[GAME_BOARD_SIZE];
@@ -68,19 +88,37 @@ typedef struct {
     move_t killer2;
 } killer_t;
 
+/* State every search thread sees (tasks see no BENCH_TLS state) */
+typedef struct {
+    tt_entry_t *tt;
+    uint32_t tt_mask;
+    uint16_t generation;    /* Entries stored by earlier runs do not match */
+    const zobrist_t *keys;
+    int stop;               /* Set once thread 0 has finished */
+    int16_t score;          /* Root score of thread 0 */
+} search_shared_t;
+
+/* Per-thread search state, a cache line apart */
+typedef struct {
+    search_shared_t *shared;
+    game_state_t state;
+    killer_t killers[GAME_SEARCH_DEPTH + 1];
+    uint64_t nodes;
+    int id;                 /* 0 always completes; helpers stop with it */
+    bool aborted;
+} ALIGNED(64) search_thread_t;
+
 /* Static storage */
-static game_state_t state;
-static tt_entry_t tt[GAME_TT_SIZE];
-static killer_t killers[GAME_SEARCH_DEPTH + 1];
-static uint64_t zobrist_piece[12][GAME_BOARD_SIZE];
-static uint64_t zobrist_side;
-static int nodes_searched;
+static BENCH_TLS game_state_t root_state;
+static BENCH_TLS zobrist_t zobrist;
+static BENCH_TLS search_shared_t shared;
+static BENCH_TLS search_thread_t threads[GAME_MAX_THREADS];
 
 /* ============================================================================
  * Zobrist Hashing
  * ============================================================================ */
 
-static void init_zobrist(uint32_t seed)
+static void init_zobrist(zobrist_t *z, uint32_t seed)
 {
     uint32_t x = seed;
 
@@ -90,30 +128,35 @@ static void init_zobrist(uint32_t seed)
             uint64_t h = x;
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             h = (h << 32) | x;
-            zobrist_piece[p][sq] = h;
+            z->piece[p][sq] = h;
         }
     }
 
     x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-    zobrist_side = ((uint64_t)x << 32);
+    z->side = ((uint64_t)x << 32);
     x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-    zobrist_side |= x;
+    z->side |= x;
+}
+
+/* Key row of a non-empty square: white 0-5, black 6-11 */
+static inline int piece_index(int piece)
+{
+    return (piece > 0) ? (piece - 1) : (6 - piece - 1);
 }
 
-static uint64_t compute_hash(const game_state_t *gs)
+static uint64_t compute_hash(const zobrist_t *z, const game_state_t *gs)
 {
     uint64_t h = 0;
 
     for (int sq = 0; sq < GAME_BOARD_SIZE; sq++) {
         int piece = gs->board[sq];
         if (piece != 0) {
-            int p_idx = (piece > 0) ? (piece - 1) : (6 - piece - 1);
-            h ^= zobrist_piece[p_idx][sq];
+            h ^= z->piece[piece_index(piece)][sq];
         }
     }
 
     if (gs->side_to_move < 0) {
-        h ^= zobrist_side;
+        h ^= z->side;
     }
 
     return h;
@@ -123,32 +166,68 @@ static uint64_t compute_hash(const game_state_t *gs)
  * Transposition Table
  * ============================================================================ */
 
-static tt_entry_t *tt_probe(uint64_t hash)
+/* data: score 0-15, depth 16-23, flag 24-31, from 32-39, to 40-47, generation 48-63 */
+static inline uint64_t tt_pack(int16_t score, int depth, int flag, const move_t *best, uint16_t gen)
 {
-    int idx = (int)(hash % GAME_TT_SIZE);
-    if (tt[idx].hash == hash) {
-        return &tt[idx];
-    }
-    return NULL;
+    return (uint64_t)(uint16_t)score | ((uint64_t)(uint8_t)depth << 16) |
+           ((uint64_t)(uint8_t)flag << 24) | ((uint64_t)best->from << 32) |
+           ((uint64_t)best->to << 40) | ((uint64_t)gen << 48);
+}
+
+#define TT_SCORE(d)     ((int16_t)(uint16_t)(d))
+#define TT_DEPTH(d)     ((int)(((d) >> 16) & 0xFF))
+#define TT_FLAG(d)      ((int)(((d) >> 24) & 0xFF))
+#define TT_FROM(d)      ((uint8_t)((d) >> 32))
+#define TT_TO(d)        ((uint8_t)((d) >> 40))
+#define TT_GEN(d)       ((uint16_t)((d) >> 48))
+
+/* Mate scores are stored as distance from the node, not from the root */
+static inline int16_t score_to_tt(int16_t score, int ply)
+{
+    if (score > SCORE_MATE_BOUND) return (int16_t)(score + ply);
+    if (score < -SCORE_MATE_BOUND) return (int16_t)(score - ply);
+    return score;
 }
 
-static void tt_store(uint64_t hash, int16_t score, uint8_t depth, uint8_t flag, move_t *best)
+static inline int16_t score_from_tt(int16_t score, int ply)
 {
-    int idx = (int)(hash % GAME_TT_SIZE);
-    tt[idx].hash = hash;
-    tt[idx].score = score;
-    tt[idx].depth = depth;
-    tt[idx].flag = flag;
-    if (best) {
-        tt[idx].best_move = *best;
+    if (score > SCORE_MATE_BOUND) return (int16_t)(score - ply);
+    if (score < -SCORE_MATE_BOUND) return (int16_t)(score + ply);
+    return score;
+}
+
+/* Data word of this run's entry for hash, or 0 */
+static inline uint64_t tt_probe(const search_shared_t *s, uint64_t hash)
+{
+    const tt_entry_t *e = &s->tt[hash & s->tt_mask];
+    uint64_t key = __atomic_load_n(&e->key, __ATOMIC_RELAXED);
+    uint64_t data = __atomic_load_n(&e->data, __ATOMIC_RELAXED);
+
+    if ((key ^ data) != hash || TT_GEN(data) != s->generation) {
+        return 0;
     }
+    return data;
+}
+
+/* Always replace; the two words are written separately */
+static inline void tt_store(search_shared_t *s, uint64_t hash, int16_t score, int depth,
+                            int flag, const move_t *best)
+{
+    tt_entry_t *e = &s->tt[hash & s->tt_mask];
+    uint64_t data = tt_pack(score, depth, flag, best, s->generation);
+
+    __atomic_store_n(&e->key, hash ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->data, data, __ATOMIC_RELAXED);
 }
 
 /* ============================================================================
  * Move Generation and Evaluation
  * ============================================================================ */
 
-/* Generate pseudo-legal moves (simplified) */
+/*
+ * Generate pseudo-legal moves (simplified). Only the first GAME_BRANCHING
+ * are kept, so the searched tree does not depend on move ordering.
+ */
 static int generate_moves(const game_state_t *gs, move_t *moves)
 {
     int num_moves = 0;
@@ -182,7 +261,7 @@ static int generate_moves(const game_state_t *gs, move_t *moves)
                         moves[num_moves].score = 0;
                         num_moves++;
 
-                        if (num_moves >= GAME_BRANCHING * 4) {
+                        if (num_moves >= GAME_BRANCHING) {
                             return num_moves;
                         }
                     }
@@ -226,7 +305,8 @@ static int16_t evaluate(const game_state_t *gs)
 }
 
 /* Move ordering */
-static void order_moves(move_t *moves, int num_moves, int ply, move_t *tt_move)
+static void order_moves(move_t *moves, int num_moves, int ply, const killer_t *killers,
+                        const move_t *tt_move)
 {
     /* Score moves for ordering */
     for (int i = 0; i < num_moves; i++) {
@@ -264,43 +344,75 @@ static void order_moves(move_t *moves, int num_moves, int ply, move_t *tt_move)
  * Alpha-Beta Search
  * ============================================================================ */
 
-static void make_move(game_state_t *gs, const move_t *move)
+static void make_move(game_state_t *gs, const zobrist_t *z, const move_t *move)
 {
     int piece = gs->board[move->from];
+    int captured = gs->board[move->to];
+
+    if (captured != 0) {
+        gs->hash ^= z->piece[piece_index(captured)][move->to];
+    }
+    gs->hash ^= z->piece[piece_index(piece)][move->from] ^ z->piece[piece_index(piece)][move->to];
     gs->board[move->to] = piece;
     gs->board[move->from] = 0;
     gs->side_to_move = -gs->side_to_move;
     gs->ply++;
-    gs->hash ^= zobrist_side;
+    gs->hash ^= z->side;
 }
 
-static void unmake_move(game_state_t *gs, const move_t *move, int8_t captured)
+static void unmake_move(game_state_t *gs, const zobrist_t *z, const move_t *move, int8_t captured)
 {
     int piece = gs->board[move->to];
+
     gs->board[move->from] = piece;
     gs->board[move->to] = captured;
     gs->side_to_move = -gs->side_to_move;
     gs->ply--;
-    gs->hash ^= zobrist_side;
+    gs->hash ^= z->side;
+    gs->hash ^= z->piece[piece_index(piece)][move->from] ^ z->piece[piece_index(piece)][move->to];
+    if (captured != 0) {
+        gs->hash ^= z->piece[piece_index(captured)][move->to];
+    }
 }
 
-static int16_t alpha_beta(game_state_t *gs, int depth, int16_t alpha, int16_t beta)
+/*
+ * Negamax alpha-beta. TT entries are used only at their own depth: with
+ * the tree fixed by generate_moves, a position's value at a given depth is
+ * then the same whichever thread stored it, and so is the root score.
+ * Helper threads (id > 0) return as soon as thread 0 is done, storing
+ * nothing on the way out.
+ */
+static int16_t alpha_beta(search_thread_t *t, int depth, int16_t alpha, int16_t beta)
 {
-    nodes_searched++;
+    search_shared_t *s = t->shared;
+    game_state_t *gs = &t->state;
+
+    if (t->id > 0 && __atomic_load_n(&s->stop, __ATOMIC_RELAXED)) {
+        t->aborted = true;
+        return 0;
+    }
+    t->nodes++;
 
     /* Check TT */
-    tt_entry_t *tt_entry = tt_probe(gs->hash);
-    move_t *tt_move = NULL;
-
-    if (tt_entry && tt_entry->depth >= depth) {
-        if (tt_entry->flag == 0) {
-            return tt_entry->score;
-        } else if (tt_entry->flag == 1 && tt_entry->score >= beta) {
-            return beta;
-        } else if (tt_entry->flag == 2 && tt_entry->score <= alpha) {
-            return alpha;
+    uint64_t entry = tt_probe(s, gs->hash);
+    move_t tt_move;
+    bool have_tt_move = false;
+
+    if (entry) {
+        if (TT_DEPTH(entry) == depth) {
+            int16_t tt_score = score_from_tt(TT_SCORE(entry), gs->ply);
+            int flag = TT_FLAG(entry);
+            if (flag == TT_EXACT) {
+                return tt_score;
+            } else if (flag == TT_LOWER && tt_score >= beta) {
+                return beta;
+            } else if (flag == TT_UPPER && tt_score <= alpha) {
+                return alpha;
+            }
         }
-        tt_move = &tt_entry->best_move;
+        tt_move.from = TT_FROM(entry);
+        tt_move.to = TT_TO(entry);
+        have_tt_move = true;
     }
 
     /* Leaf node */
@@ -309,47 +421,50 @@ static int16_t alpha_beta(game_state_t *gs, int depth, int16_t alpha, int16_t be
     }
 
     /* Generate and order moves */
-    move_t moves[GAME_BRANCHING * 4];
+    move_t moves[GAME_BRANCHING];
     int num_moves = generate_moves(gs, moves);
 
     if (num_moves == 0) {
         return -SCORE_MATE + gs->ply;  /* Checkmate or stalemate */
     }
 
-    order_moves(moves, num_moves, gs->ply, tt_move);
+    order_moves(moves, num_moves, gs->ply, t->killers, have_tt_move ? &tt_move : NULL);
 
-    /* Limit branching factor */
-    if (num_moves > GAME_BRANCHING) {
-        num_moves = GAME_BRANCHING;
-    }
+    /* Lazy SMP: each helper starts the root on a different move */
+    int first = (gs->ply == 0) ? t->id % num_moves : 0;
 
     /* Search moves */
     int16_t best_score = -SCORE_INF;
-    move_t best_move = moves[0];
-    uint8_t flag = 2;  /* Upper bound initially */
+    move_t best_move = moves[first];
+    uint8_t flag = TT_UPPER;  /* Upper bound initially */
 
-    for (int i = 0; i < num_moves; i++) {
-        int8_t captured = gs->board[moves[i].to];
+    for (int n = 0; n < num_moves; n++) {
+        const move_t *move = &moves[(first + n) % num_moves];
+        int8_t captured = gs->board[move->to];
 
-        make_move(gs, &moves[i]);
-        int16_t score = -alpha_beta(gs, depth - 1, -beta, -alpha);
-        unmake_move(gs, &moves[i], captured);
+        make_move(gs, s->keys, move);
+        int16_t score = -alpha_beta(t, depth - 1, -beta, -alpha);
+        unmake_move(gs, s->keys, move, captured);
+
+        if (t->aborted) {
+            return 0;
+        }
 
         if (score > best_score) {
             best_score = score;
-            best_move = moves[i];
+            best_move = *move;
 
             if (score > alpha) {
                 alpha = score;
-                flag = 0;  /* Exact score */
+                flag = TT_EXACT;
 
                 if (score >= beta) {
                     /* Beta cutoff - store killer move */
                     if (gs->ply < GAME_SEARCH_DEPTH && captured == 0) {
-                        killers[gs->ply].killer2 = killers[gs->ply].killer1;
-                        killers[gs->ply].killer1 = moves[i];
+                        t->killers[gs->ply].killer2 = t->killers[gs->ply].killer1;
+                        t->killers[gs->ply].killer1 = *move;
                     }
-                    flag = 1;  /* Lower bound */
+                    flag = TT_LOWER;
                     break;
                 }
             }
@@ -357,11 +472,43 @@ static int16_t alpha_beta(game_state_t *gs, int depth, int16_t alpha, int16_t be
     }
 
     /* Store in TT */
-    tt_store(gs->hash, best_score, depth, flag, &best_move);
+    tt_store(s, gs->hash, score_to_tt(best_score, gs->ply), depth, flag, &best_move);
 
     return best_score;
 }
 
+/* Reset a thread to the root position for a new run */
+static void thread_reset(search_thread_t *t, search_shared_t *s, int id)
+{
+    t->shared = s;
+    t->state = root_state;
+    memset(t->killers, 0, sizeof(t->killers));
+    t->nodes = 0;
+    t->id = id;
+    t->aborted = false;
+}
+
+/* Iterative deepening to GAME_SEARCH_DEPTH; thread 0 then stops the helpers */
+static void smp_task(int tid, int nthreads, void *arg)
+{
+    search_thread_t *t = &((search_thread_t *)arg)[tid];
+    UNUSED(nthreads);
+
+    if (tid >= GAME_MAX_THREADS) {
+        return;
+    }
+
+    for (int depth = 1; depth <= GAME_SEARCH_DEPTH && !t->aborted; depth++) {
+        int16_t score = alpha_beta(t, depth, -SCORE_INF, SCORE_INF);
+        if (tid == 0) {
+            t->shared->score = score;
+        }
+    }
+    if (tid == 0) {
+        __atomic_store_n(&t->shared->stop, 1, __ATOMIC_RELAXED);
+    }
+}
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -407,7 +554,6 @@ static void init_board(game_state_t *gs, uint32_t seed)
 
     gs->side_to_move = 1;
     gs->ply = 0;
-    gs->hash = compute_hash(gs);
 }
 
 /* ============================================================================
@@ -417,49 +563,98 @@ static void init_board(game_state_t *gs, uint32_t seed)
 static void kernel_init_func(void)
 {
     /* Initialize Zobrist keys */
-    init_zobrist(0xCAFEBABE);
-
-    /* Clear TT */
-    memset(tt, 0, sizeof(tt));
+    init_zobrist(&zobrist, 0xCAFEBABE);
 
-    /* Clear killers */
-    memset(killers, 0, sizeof(killers));
+    /* Allocate (zeroed) TT, a power of two entries */
+    uint32_t tt_size = bench_scale(GAME_TT_SIZE);
+    while (tt_size & (tt_size - 1)) {
+        tt_size &= tt_size - 1;
+    }
+    shared.tt = bench_alloc((size_t)tt_size * sizeof(tt_entry_t));
+    shared.tt_mask = tt_size - 1;
+    shared.keys = &zobrist;
+    shared.generation = 0;
 
     /* Initialize board */
-    init_board(&state, 0x12345678);
+    init_board(&root_state, 0x12345678);
+    root_state.hash = compute_hash(&zobrist, &root_state);
 }
 
-static bench_result_t kernel_run_func(void)
+/*
+ * Shared driver. Every run starts from an empty table (a new generation)
+ * and clear killers; nthreads 0 is the reference fixed-depth search,
+ * otherwise iterative deepening on up to nthreads threads.
+ */
+static bench_result_t game_run(int nthreads)
 {
     bench_result_t result = { .status = BENCH_OK };
+    int num_threads = 1;
+
+    if (nthreads > 1) {
+        num_threads = MIN(bench_threads, GAME_MAX_THREADS);
+    }
 
-    nodes_searched = 0;
+    if (++shared.generation == 0) {
+        shared.generation = 1;
+    }
+    shared.stop = 0;
+    for (int t = 0; t < num_threads; t++) {
+        thread_reset(&threads[t], &shared, t);
+    }
 
     /* Start timing */
     BENCH_START();
 
-    /* Run alpha-beta search */
-    int16_t score = alpha_beta(&state, GAME_SEARCH_DEPTH, -SCORE_INF, SCORE_INF);
+    /* Run alpha-beta search (nodes are too short to split further) */
+    BENCH_PHASE_BEGIN(PHASE_SEARCH);
+    if (nthreads == 0) {
+        shared.score = alpha_beta(&threads[0], GAME_SEARCH_DEPTH, -SCORE_INF, SCORE_INF);
+    } else if (nthreads > 1) {
+        bench_parallel(smp_task, threads);
+    } else {
+        smp_task(0, 1, threads);
+    }
+    BENCH_PHASE_END(PHASE_SEARCH);
 
     /* End timing */
     BENCH_END();
 
+    int16_t score = shared.score;
+    uint64_t nodes_searched = 0;
+    for (int t = 0; t < num_threads; t++) {
+        nodes_searched += threads[t].nodes;
+    }
+
     /* Prevent optimization */
     BENCH_VOLATILE(score);
-    BENCH_VOLATILE(nodes_searched);
 
-    /* Checksum */
+    /* Checksum: node counts depend on the thread count, the score does not */
     uint32_t csum = checksum_init();
     csum = checksum_update(csum, (uint32_t)(int32_t)score);
-    csum = checksum_update(csum, (uint32_t)nodes_searched);
     csum = checksum_update(csum, GAME_SEARCH_DEPTH);
 
     result.cycles = BENCH_CYCLES();
     result.checksum = csum;
+    result.work = nodes_searched;
 
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return game_run(0);
+}
+
+static bench_result_t kernel_run_id(void)
+{
+    return game_run(1);
+}
+
+static bench_result_t kernel_run_smp_mt(void)
+{
+    return game_run(GAME_MAX_THREADS);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -469,7 +664,14 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t game_variants[] = {
+    { "smp-mt", 0, kernel_run_smp_mt },
+    { "id", 0, kernel_run_id },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     game_tree,
     "Alpha-beta game tree search",
     "458.sjeng",
@@ -477,7 +679,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    1
+    1,
+    game_variants,
+    "alpha_beta"
 );
 
 KERNEL_REGISTER(game_tree)
@@ -5,6 +5,9 @@
  * Pattern: Graph traversal on Go board, flood-fill, connected components
  * Memory: Irregular access patterns, pointer chasing within groups
  * Branch: Data-dependent (board state)
+ *
+ * Variants keep the board as bitboards (flood fill by shift/mask, liberties
+ * by popcount) or track strings incrementally with union-find.
  */
 
 #include "bench.h"
@@ -31,22 +34,47 @@
 #define GO_WHITE            2
 #define GO_BORDER           3
 
-#define GO_MAX_STRINGS      64      /* Maximum number of string groups */
+#define GO_MAX_STRINGS      (GO_BOARD_SIZE * GO_BOARD_SIZE)  /* Maximum number of string groups */
 #define GO_MAX_LIBERTIES    (GO_BOARD_SIZE * GO_BOARD_SIZE)
 
+/* Bitboard: row y at bits y * GO_BB_STRIDE; one guard column per row
+ * keeps east/west shifts from wrapping (19x19 fits 6 words) */
+#define GO_BB_STRIDE        (GO_BOARD_SIZE + 1)
+#define GO_BB_WORDS         ((GO_BOARD_SIZE * GO_BB_STRIDE + 63) / 64)
+#define GO_BB_POINTS        (GO_BOARD_SIZE * GO_BB_STRIDE)
+
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_PLACE, PHASE_LIBERTIES, PHASE_CAPTURES, PHASE_INFLUENCE, PHASE_STRINGS };
+
 /* String (connected group) representation */
 typedef struct {
     int8_t  color;                          /* GO_BLACK or GO_WHITE */
     int16_t stone_count;                    /* Number of stones in string */
     int16_t liberty_count;                  /* Number of liberties */
-    uint8_t stones[GO_MAX_LIBERTIES];       /* List of stone positions */
-    uint8_t liberties[GO_MAX_LIBERTIES];    /* List of liberty positions */
+    uint16_t stones[GO_MAX_LIBERTIES];      /* List of stone positions */
+    uint16_t liberties[GO_MAX_LIBERTIES];   /* List of liberty positions */
 } go_string_t;
 
+typedef struct {
+    uint64_t w[GO_BB_WORDS];
+} bitboard_t;
+
+/* Bitboard position; with union-find, strings are rooted at a stone */
+typedef struct {
+    bitboard_t stones[3];                   /* Indexed by GO_BLACK / GO_WHITE */
+    int16_t parent[GO_BB_POINTS];
+    bitboard_t string_stones[GO_BB_POINTS]; /* Valid at roots */
+    bitboard_t string_libs[GO_BB_POINTS];
+    int16_t string_size[GO_BB_POINTS];
+} go_bitstate_t;
+
+/* Board representation a run works on */
+typedef enum { GO_MAILBOX, GO_BITBOARD, GO_UNION_FIND } go_mode_t;
+
 /* Board state */
 typedef struct {
     int8_t  board[GO_BOARD_SIZE + 2][GO_BOARD_SIZE + 2];  /* With border */
@@ -56,9 +84,19 @@ typedef struct {
 } go_state_t;
 
 /* Static storage */
-static go_state_t state;
-static uint8_t query_points[GO_NUM_QUERIES];  /* Points to query liberties for */
-static int8_t visited[GO_BOARD_SIZE + 2][GO_BOARD_SIZE + 2];
+static BENCH_TLS go_state_t state;
+static BENCH_TLS uint16_t query_points[GO_NUM_QUERIES]; /* Points to query liberties for */
+static BENCH_TLS int8_t visited[GO_BOARD_SIZE + 2][GO_BOARD_SIZE + 2];
+static BENCH_TLS int8_t string_seen[GO_BOARD_SIZE + 2][GO_BOARD_SIZE + 2];
+
+/* Moves of the generated position, replayed by every run */
+static BENCH_TLS uint16_t move_points[GO_NUM_STONES];
+static BENCH_TLS int8_t move_colors[GO_NUM_STONES];
+static BENCH_TLS int num_moves;
+
+static BENCH_TLS go_bitstate_t *bits;         /* Arena-allocated in init */
+static BENCH_TLS bitboard_t board_mask;
+static BENCH_TLS bitboard_t *influence_rings; /* [point][distance - 1], distance 1..4 */
 
 /* ============================================================================
  * Board Utilities
@@ -102,7 +140,8 @@ static void flood_fill_string(go_state_t *gs, int start_x, int start_y,
     str->stone_count = 0;
     str->liberty_count = 0;
 
-    /* Clear visited array for liberties */
+    /* Clear visited array for liberties; string_seen keeps the stones
+     * of every string found so far */
     memset(visited, 0, sizeof(visited));
 
     /* Push start position */
@@ -110,6 +149,7 @@ static void flood_fill_string(go_state_t *gs, int start_x, int start_y,
     stack_y[stack_ptr] = start_y;
     stack_ptr++;
     visited[start_y][start_x] = 1;
+    string_seen[start_y][start_x] = 1;
 
     while (stack_ptr > 0) {
         /* Pop */
@@ -135,6 +175,7 @@ static void flood_fill_string(go_state_t *gs, int start_x, int start_y,
             if (neighbor == color) {
                 /* Same color - add to stack */
                 visited[ny][nx] = 1;
+                string_seen[ny][nx] = 1;
                 if (stack_ptr < GO_MAX_LIBERTIES) {
                     stack_x[stack_ptr] = nx;
                     stack_y[stack_ptr] = ny;
@@ -274,6 +315,233 @@ static int evaluate_influence(go_state_t *gs, int x, int y)
     return black_influence - white_influence;
 }
 
+/* ============================================================================
+ * Bitboards
+ * ============================================================================ */
+
+INLINE int bb_point(int x, int y)
+{
+    return (y - 1) * GO_BB_STRIDE + (x - 1);
+}
+
+INLINE void bb_set(bitboard_t *b, int p)
+{
+    b->w[p >> 6] |= 1ULL << (p & 63);
+}
+
+INLINE void bb_clear(bitboard_t *b, int p)
+{
+    b->w[p >> 6] &= ~(1ULL << (p & 63));
+}
+
+INLINE bool bb_test(const bitboard_t *b, int p)
+{
+    return (b->w[p >> 6] >> (p & 63)) & 1;
+}
+
+INLINE int bb_popcount(const bitboard_t *b)
+{
+    int n = 0;
+    for (int i = 0; i < GO_BB_WORDS; i++) n += __builtin_popcountll(b->w[i]);
+    return n;
+}
+
+INLINE bool bb_equal(const bitboard_t *a, const bitboard_t *b)
+{
+    uint64_t diff = 0;
+    for (int i = 0; i < GO_BB_WORDS; i++) diff |= a->w[i] ^ b->w[i];
+    return diff == 0;
+}
+
+/* Points adjacent to a (4-neighborhood), on the board */
+static bitboard_t bb_neighbors(const bitboard_t *a)
+{
+    bitboard_t r;
+    for (int i = 0; i < GO_BB_WORDS; i++) {
+        uint64_t lo = i > 0 ? a->w[i - 1] : 0;
+        uint64_t hi = i + 1 < GO_BB_WORDS ? a->w[i + 1] : 0;
+        uint64_t w = a->w[i];
+        uint64_t east = (w << 1) | (lo >> 63);
+        uint64_t west = (w >> 1) | (hi << 63);
+        uint64_t south = (w << GO_BB_STRIDE) | (lo >> (64 - GO_BB_STRIDE));
+        uint64_t north = (w >> GO_BB_STRIDE) | (hi << (64 - GO_BB_STRIDE));
+        r.w[i] = (east | west | south | north) & board_mask.w[i];
+    }
+    return r;
+}
+
+INLINE bitboard_t bb_empty(const go_bitstate_t *bs)
+{
+    bitboard_t r;
+    for (int i = 0; i < GO_BB_WORDS; i++) {
+        r.w[i] = board_mask.w[i] & ~(bs->stones[GO_BLACK].w[i] | bs->stones[GO_WHITE].w[i]);
+    }
+    return r;
+}
+
+/* The string through point p: grow by neighbors within own until stable */
+static bitboard_t bb_string(const bitboard_t *own, int p)
+{
+    bitboard_t s = { { 0 } };
+    bb_set(&s, p);
+
+    for (;;) {
+        bitboard_t grown = bb_neighbors(&s);
+        for (int i = 0; i < GO_BB_WORDS; i++) grown.w[i] = (grown.w[i] & own->w[i]) | s.w[i];
+        if (bb_equal(&grown, &s)) return s;
+        s = grown;
+    }
+}
+
+static int bb_string_liberties(const bitboard_t *string, const bitboard_t *empty)
+{
+    bitboard_t libs = bb_neighbors(string);
+    for (int i = 0; i < GO_BB_WORDS; i++) libs.w[i] &= empty->w[i];
+    return bb_popcount(&libs);
+}
+
+static int bb_count_liberties(const go_bitstate_t *bs, int p)
+{
+    for (int c = GO_BLACK; c <= GO_WHITE; c++) {
+        if (bb_test(&bs->stones[c], p)) {
+            bitboard_t string = bb_string(&bs->stones[c], p);
+            bitboard_t empty = bb_empty(bs);
+            return bb_string_liberties(&string, &empty);
+        }
+    }
+    return 0;
+}
+
+/* Neighbor points of p on the board, as would_capture's dx/dy order */
+static int bb_adjacent(int x, int y, int *out)
+{
+    static const int dx[4] = {-1, 1, 0, 0};
+    static const int dy[4] = {0, 0, -1, 1};
+    int n = 0;
+
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dx[d], ny = y + dy[d];
+        if (nx >= 1 && nx <= GO_BOARD_SIZE && ny >= 1 && ny <= GO_BOARD_SIZE) {
+            out[n++] = bb_point(nx, ny);
+        }
+    }
+    return n;
+}
+
+static int bb_would_capture(const go_bitstate_t *bs, int x, int y, int8_t color)
+{
+    int8_t opponent = (color == GO_BLACK) ? GO_WHITE : GO_BLACK;
+    int p = bb_point(x, y);
+    int adj[4];
+    int n = bb_adjacent(x, y, adj);
+    int captures = 0;
+
+    bitboard_t empty = bb_empty(bs);
+    bb_clear(&empty, p);
+
+    for (int d = 0; d < n; d++) {
+        if (bb_test(&bs->stones[opponent], adj[d])) {
+            bitboard_t string = bb_string(&bs->stones[opponent], adj[d]);
+            if (bb_string_liberties(&string, &empty) == 0) captures++;
+        }
+    }
+    return captures;
+}
+
+/* evaluate_influence: weighted stone counts over precomputed distance rings */
+static int bb_evaluate_influence(const go_bitstate_t *bs, int p)
+{
+    const bitboard_t *rings = &influence_rings[p * 4];
+    int influence = 0;
+
+    for (int d = 0; d < 4; d++) {
+        int black = 0, white = 0;
+        for (int i = 0; i < GO_BB_WORDS; i++) {
+            black += __builtin_popcountll(bs->stones[GO_BLACK].w[i] & rings[d].w[i]);
+            white += __builtin_popcountll(bs->stones[GO_WHITE].w[i] & rings[d].w[i]);
+        }
+        influence += (10 - (d + 1) * 2) * (black - white);
+    }
+    return influence;
+}
+
+/* ============================================================================
+ * Union-Find String Tracking
+ * ============================================================================ */
+
+static int uf_find(go_bitstate_t *bs, int p)
+{
+    while (bs->parent[p] != p) {
+        bs->parent[p] = bs->parent[bs->parent[p]];   /* Path halving */
+        p = bs->parent[p];
+    }
+    return p;
+}
+
+/* Place a stone: merge with friendly strings, take p from adjacent liberties */
+static void uf_place(go_bitstate_t *bs, int x, int y, int8_t color)
+{
+    int p = bb_point(x, y);
+    int adj[4];
+    int n = bb_adjacent(x, y, adj);
+
+    bb_set(&bs->stones[color], p);
+
+    bitboard_t single = { { 0 } };
+    bb_set(&single, p);
+    bitboard_t empty = bb_empty(bs);
+    bitboard_t libs = bb_neighbors(&single);
+    for (int i = 0; i < GO_BB_WORDS; i++) libs.w[i] &= empty.w[i];
+
+    bs->parent[p] = (int16_t)p;
+    bs->string_stones[p] = single;
+    bs->string_libs[p] = libs;
+    bs->string_size[p] = 1;
+
+    int root = p;
+    for (int d = 0; d < n; d++) {
+        int q = adj[d];
+        if (bb_test(&bs->stones[color], q)) {
+            int r = uf_find(bs, q);
+            if (r == root) continue;
+            /* Union by size; the survivor keeps both sets */
+            if (bs->string_size[r] > bs->string_size[root]) {
+                int t = r; r = root; root = t;
+            }
+            bs->parent[r] = (int16_t)root;
+            bs->string_size[root] += bs->string_size[r];
+            for (int i = 0; i < GO_BB_WORDS; i++) {
+                bs->string_stones[root].w[i] |= bs->string_stones[r].w[i];
+                bs->string_libs[root].w[i] |= bs->string_libs[r].w[i];
+            }
+        } else if (!bb_test(&empty, q) && q != p) {
+            bb_clear(&bs->string_libs[uf_find(bs, q)], p);
+        }
+    }
+    bb_clear(&bs->string_libs[root], p);
+}
+
+INLINE int uf_liberties(go_bitstate_t *bs, int p)
+{
+    return bb_popcount(&bs->string_libs[uf_find(bs, p)]);
+}
+
+/* An adjacent opponent string dies iff p is its last liberty */
+static int uf_would_capture(go_bitstate_t *bs, int x, int y, int8_t color)
+{
+    int8_t opponent = (color == GO_BLACK) ? GO_WHITE : GO_BLACK;
+    int adj[4];
+    int n = bb_adjacent(x, y, adj);
+    int captures = 0;
+
+    for (int d = 0; d < n; d++) {
+        if (bb_test(&bs->stones[opponent], adj[d]) && uf_liberties(bs, adj[d]) == 1) {
+            captures++;
+        }
+    }
+    return captures;
+}
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -289,6 +557,7 @@ static void generate_position(go_state_t *gs, uint32_t seed)
     int attempts = 0;
     int8_t color = GO_BLACK;
 
+    num_moves = 0;
     while (placed < GO_NUM_STONES && attempts < GO_NUM_STONES * 10) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
         int px = 1 + (x % GO_BOARD_SIZE);
@@ -297,6 +566,8 @@ static void generate_position(go_state_t *gs, uint32_t seed)
 
         if (gs->board[py][px] == GO_EMPTY) {
             gs->board[py][px] = color;
+            move_points[num_moves] = (uint16_t)pos_to_idx(px, py);
+            move_colors[num_moves++] = color;
             placed++;
             color = (color == GO_BLACK) ? GO_WHITE : GO_BLACK;
         }
@@ -320,9 +591,59 @@ static void generate_position(go_state_t *gs, uint32_t seed)
 static void kernel_init_func(void)
 {
     generate_position(&state, 0xDEADBEEF);
+    bench_cache_region(&state, sizeof(state));      /* Static board for --cache=cold */
+
+    bits = bench_alloc(sizeof(go_bitstate_t));
+    influence_rings = bench_alloc((size_t)GO_BB_POINTS * 4 * sizeof(bitboard_t));
+
+    memset(&board_mask, 0, sizeof(board_mask));
+    for (int y = 1; y <= GO_BOARD_SIZE; y++) {
+        for (int x = 1; x <= GO_BOARD_SIZE; x++) {
+            bb_set(&board_mask, bb_point(x, y));
+        }
+    }
+
+    /* Points at distance 1..4 within evaluate_influence's 7x7 window */
+    for (int y = 1; y <= GO_BOARD_SIZE; y++) {
+        for (int x = 1; x <= GO_BOARD_SIZE; x++) {
+            bitboard_t *rings = &influence_rings[bb_point(x, y) * 4];
+            for (int dy = -3; dy <= 3; dy++) {
+                for (int dx = -3; dx <= 3; dx++) {
+                    int nx = x + dx, ny = y + dy;
+                    int dist = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+                    if (nx < 1 || nx > GO_BOARD_SIZE || ny < 1 || ny > GO_BOARD_SIZE) continue;
+                    if (dist == 0 || dist > 4) continue;
+                    bb_set(&rings[dist - 1], bb_point(nx, ny));
+                }
+            }
+        }
+    }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Replay the position's moves into the run's representation */
+static void place_stones(go_mode_t mode)
+{
+    if (mode == GO_MAILBOX) {
+        init_board(&state);
+    } else {
+        memset(bits->stones, 0, sizeof(bits->stones));
+    }
+
+    for (int i = 0; i < num_moves; i++) {
+        int x = move_points[i] % (GO_BOARD_SIZE + 2);
+        int y = move_points[i] / (GO_BOARD_SIZE + 2);
+        if (mode == GO_MAILBOX) {
+            state.board[y][x] = move_colors[i];
+        } else if (mode == GO_BITBOARD) {
+            bb_set(&bits->stones[move_colors[i]], bb_point(x, y));
+        } else {
+            uf_place(bits, x, y, move_colors[i]);
+        }
+    }
+}
+
+/* Shared driver; every representation answers the same queries */
+static bench_result_t go_run(go_mode_t mode)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -334,46 +655,80 @@ static bench_result_t kernel_run_func(void)
 
     BENCH_START();
 
+    BENCH_PHASE_BEGIN(PHASE_PLACE);
+    place_stones(mode);
+    BENCH_PHASE_END(PHASE_PLACE);
+
     /* Query 1: Count liberties for various points */
+    BENCH_PHASE_BEGIN(PHASE_LIBERTIES);
     for (int i = 0; i < GO_NUM_QUERIES; i++) {
         int idx = query_points[i];
         int x = idx % (GO_BOARD_SIZE + 2);
         int y = idx / (GO_BOARD_SIZE + 2);
-
-        int libs = count_liberties(&state, x, y);
+        int p = bb_point(x, y);
+        int libs;
+
+        if (mode == GO_MAILBOX) {
+            libs = count_liberties(&state, x, y);
+        } else if (mode == GO_BITBOARD) {
+            libs = bb_count_liberties(bits, p);
+        } else {
+            bool stone = bb_test(&bits->stones[GO_BLACK], p) || bb_test(&bits->stones[GO_WHITE], p);
+            libs = stone ? uf_liberties(bits, p) : 0;
+        }
         total_liberties += libs;
         csum = checksum_update(csum, (uint32_t)libs);
     }
+    BENCH_PHASE_END(PHASE_LIBERTIES);
 
     /* Query 2: Check potential captures */
+    BENCH_PHASE_BEGIN(PHASE_CAPTURES);
+    bitboard_t empty = bb_empty(bits);
     for (int y = 1; y <= GO_BOARD_SIZE; y++) {
         for (int x = 1; x <= GO_BOARD_SIZE; x++) {
-            if (state.board[y][x] == GO_EMPTY) {
-                int cap_black = would_capture(&state, x, y, GO_BLACK);
-                int cap_white = would_capture(&state, x, y, GO_WHITE);
-                total_captures += cap_black + cap_white;
-                csum = checksum_update(csum, (uint32_t)(cap_black * 16 + cap_white));
+            int cap_black, cap_white;
+            if (mode == GO_MAILBOX) {
+                if (state.board[y][x] != GO_EMPTY) continue;
+                cap_black = would_capture(&state, x, y, GO_BLACK);
+                cap_white = would_capture(&state, x, y, GO_WHITE);
+            } else {
+                if (!bb_test(&empty, bb_point(x, y))) continue;
+                if (mode == GO_BITBOARD) {
+                    cap_black = bb_would_capture(bits, x, y, GO_BLACK);
+                    cap_white = bb_would_capture(bits, x, y, GO_WHITE);
+                } else {
+                    cap_black = uf_would_capture(bits, x, y, GO_BLACK);
+                    cap_white = uf_would_capture(bits, x, y, GO_WHITE);
+                }
             }
+            total_captures += cap_black + cap_white;
+            csum = checksum_update(csum, (uint32_t)(cap_black * 16 + cap_white));
         }
     }
+    BENCH_PHASE_END(PHASE_CAPTURES);
 
     /* Query 3: Evaluate influence map */
+    BENCH_PHASE_BEGIN(PHASE_INFLUENCE);
     for (int y = 1; y <= GO_BOARD_SIZE; y++) {
         for (int x = 1; x <= GO_BOARD_SIZE; x++) {
-            int inf = evaluate_influence(&state, x, y);
+            int inf = mode == GO_MAILBOX ? evaluate_influence(&state, x, y)
+                                         : bb_evaluate_influence(bits, bb_point(x, y));
             total_influence += inf;
             csum = checksum_update(csum, (uint32_t)(int32_t)inf);
         }
     }
-
-    /* Query 4: Find all strings */
-    memset(visited, 0, sizeof(visited));
-    for (int y = 1; y <= GO_BOARD_SIZE; y++) {
-        for (int x = 1; x <= GO_BOARD_SIZE; x++) {
-            if (state.board[y][x] != GO_EMPTY &&
-                state.board[y][x] != GO_BORDER &&
-                !visited[y][x]) {
-                if (state.num_strings < GO_MAX_STRINGS) {
+    BENCH_PHASE_END(PHASE_INFLUENCE);
+
+    /* Query 4: Find all strings, in raster order of their first stone */
+    BENCH_PHASE_BEGIN(PHASE_STRINGS);
+    if (mode == GO_MAILBOX) {
+        state.num_strings = 0;
+        memset(string_seen, 0, sizeof(string_seen));
+        for (int y = 1; y <= GO_BOARD_SIZE; y++) {
+            for (int x = 1; x <= GO_BOARD_SIZE; x++) {
+                if (state.board[y][x] != GO_EMPTY &&
+                    state.board[y][x] != GO_BORDER &&
+                    !string_seen[y][x]) {
                     go_string_t *str = &state.strings[state.num_strings];
                     flood_fill_string(&state, x, y, str, state.board[y][x]);
                     state.num_strings++;
@@ -384,7 +739,35 @@ static bench_result_t kernel_run_func(void)
                 }
             }
         }
+    } else {
+        bitboard_t seen = { { 0 } };
+        for (int y = 1; y <= GO_BOARD_SIZE; y++) {
+            for (int x = 1; x <= GO_BOARD_SIZE; x++) {
+                int p = bb_point(x, y);
+                int c = bb_test(&bits->stones[GO_BLACK], p) ? GO_BLACK :
+                        bb_test(&bits->stones[GO_WHITE], p) ? GO_WHITE : GO_EMPTY;
+                if (c == GO_EMPTY || bb_test(&seen, p)) continue;
+
+                int stones, libs;
+                if (mode == GO_BITBOARD) {
+                    bitboard_t string = bb_string(&bits->stones[c], p);
+                    stones = bb_popcount(&string);
+                    libs = bb_string_liberties(&string, &empty);
+                    for (int i = 0; i < GO_BB_WORDS; i++) seen.w[i] |= string.w[i];
+                } else {
+                    int r = uf_find(bits, p);
+                    stones = bits->string_size[r];
+                    libs = bb_popcount(&bits->string_libs[r]);
+                    for (int i = 0; i < GO_BB_WORDS; i++) seen.w[i] |= bits->string_stones[r].w[i];
+                }
+                strings_found++;
+
+                csum = checksum_update(csum, (uint32_t)stones);
+                csum = checksum_update(csum, (uint32_t)libs);
+            }
+        }
     }
+    BENCH_PHASE_END(PHASE_STRINGS);
 
     BENCH_END();
 
@@ -405,17 +788,38 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return go_run(GO_MAILBOX);
+}
+
+static bench_result_t kernel_run_bitboard(void)
+{
+    return go_run(GO_BITBOARD);
+}
+
+static bench_result_t kernel_run_union_find(void)
+{
+    return go_run(GO_UNION_FIND);
+}
+
 static void kernel_cleanup_func(void)
 {
-    /* Reset state for next run */
-    state.num_strings = 0;
+    /* Nothing to clean up */
 }
 
 /* ============================================================================
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t go_variants[] = {
+    { "unionfind", 0, kernel_run_union_find },
+    { "bitboard", 0, kernel_run_bitboard },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     go_liberty,
     "Go board liberty counting and string analysis",
     "445.gobmk",
@@ -423,7 +827,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    GO_NUM_QUERIES
+    GO_NUM_QUERIES,
+    go_variants,
+    "place", "liberties", "captures", "influence", "strings"
 );
 
 KERNEL_REGISTER(go_liberty)
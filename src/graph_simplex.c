@@ -12,6 +12,10 @@
 
 /* ============================================================================
  * Configuration
+ * Node and arc counts are tier S sizes, scaled by bench_scale_dim() (x4 per
+ * tier). The reference prices every arc on every pivot and the pivot count
+ * grows with the network, so run time grows about x16-x30 per tier; the x16
+ * of bench_scale() would put a single XL run past several minutes.
  * ============================================================================ */
 
 #ifndef GRAPH_NUM_NODES
@@ -22,8 +26,20 @@
 #define GRAPH_NUM_ARCS      256
 #endif
 
-#ifndef SIMPLEX_ITERATIONS
-#define SIMPLEX_ITERATIONS  50
+#ifndef GRAPH_MAX_COST
+#define GRAPH_MAX_COST      100
+#endif
+
+#ifndef GRAPH_MPP_BASKET
+#define GRAPH_MPP_BASKET    50      /* mcf B: candidates wanted before choosing */
+#endif
+
+#ifndef GRAPH_MPP_GROUP
+#define GRAPH_MPP_GROUP     300     /* mcf K: arcs per pricing group */
+#endif
+
+#ifndef SIMPLEX_PIVOT_LIMIT
+#define SIMPLEX_PIVOT_LIMIT 64      /* Pivots per node + arc before giving up */
 #endif
 
 /* Arc states */
@@ -31,10 +47,19 @@
 #define ARC_AT_UPPER    1
 #define ARC_BASIC       2
 
+/* Direction of a node's basic arc */
+#define DIR_UP          1           /* Node -> pred */
+#define DIR_DOWN        (-1)        /* Pred -> node */
+
+#define ARC_UNBOUNDED   (INT32_MAX / 2)
+
 /* ============================================================================
  * Data Structures (similar to MCF)
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_PRICING, PHASE_RATIO, PHASE_UPDATE, PHASE_POTENTIALS, PHASE_COST };
+
 typedef struct arc arc_t;
 typedef struct node node_t;
 
@@ -44,24 +69,101 @@ struct arc {
     int32_t cost;           /* Arc cost */
     int32_t capacity;       /* Arc capacity */
     int32_t flow;           /* Current flow */
-    uint8_t ident;          /* Arc state */
+    int8_t  ident;          /* Arc state */
 };
 
 struct node {
     arc_t   *basic_arc;     /* Tree arc to parent */
     node_t  *pred;          /* Predecessor in tree */
+    node_t  *child;         /* First child in tree */
+    node_t  *sibling;       /* Next child of pred */
+    node_t  *sibling_prev;  /* Previous child of pred */
     int32_t potential;      /* Node potential */
     int32_t balance;        /* Supply/demand */
     int32_t depth;          /* Tree depth */
-    uint8_t orientation;    /* Arc direction in tree */
+    int8_t  orientation;    /* DIR_UP or DIR_DOWN */
 };
 
-/* Static storage */
-static node_t nodes[GRAPH_NUM_NODES + 1];   /* 1-indexed */
-static arc_t arcs[GRAPH_NUM_ARCS];
+/*
+ * Index layout: arcs split into the fields pricing reads and the ones only
+ * the ratio test and flow update touch; the tree is kept as pred indices
+ * plus a preorder thread, so a subtree is a contiguous run of the thread.
+ */
+typedef struct {
+    int32_t tail;
+    int32_t head;
+    int32_t cost;
+    int32_t ident;
+} arc_hot_t;
+
+typedef struct {
+    int32_t flow;
+    int32_t capacity;
+} arc_cold_t;
+
+typedef struct {
+    int32_t pred;
+    int32_t basic_arc;
+    int32_t depth;
+    int32_t orientation;
+} tree_node_t;
+
+typedef struct {
+    arc_hot_t   *hot;
+    arc_cold_t  *cold;
+    tree_node_t *tree;
+    int32_t     *potential;
+    int32_t     *thread;        /* Preorder successor, circular through the root */
+    int32_t     *rev_thread;
+    int32_t     *path;          /* update_tree scratch, one slot per tree level */
+    int32_t     *path_last;
+    int32_t     *path_before;
+    int32_t     *path_after;
+} index_net_t;
+
+/* Multiple partial pricing basket (mcf primal_bea_mpp) */
+typedef struct {
+    int32_t arc;
+    int32_t abs_rc;
+} candidate_t;
+
+typedef struct {
+    candidate_t *basket;    /* GRAPH_MPP_BASKET + GRAPH_MPP_GROUP slots */
+    int size;
+    int group_pos;          /* Next group to scan */
+    int num_groups;
+} mpp_t;
+
+/*
+ * Generated problem: arcs 0..num_arcs-1 are real, then one artificial arc
+ * per node to the root (node 0), which form the starting basis.
+ */
+typedef struct {
+    int32_t *tail;
+    int32_t *head;
+    int32_t *cost;
+    int32_t *capacity;
+    int32_t *balance;       /* 1-indexed */
+} problem_t;
+
+/* Outcome of one pivot's ratio test */
+typedef struct {
+    int32_t delta;
+    int     side;           /* 0 = entering arc itself, 1 = first path, 2 = second */
+} ratio_t;
+
+/* Static storage (arrays are arena-allocated in init) */
+static BENCH_TLS problem_t problem;
+static BENCH_TLS node_t *nodes;           /* 0 is the root */
+static BENCH_TLS arc_t *arcs;
+static BENCH_TLS index_net_t net;
+static BENCH_TLS mpp_t mpp;
+static BENCH_TLS int num_nodes;
+static BENCH_TLS int num_arcs;            /* Real arcs */
+static BENCH_TLS int total_arcs;          /* Real + artificial */
 
 /* ============================================================================
- * Network Simplex Operations
+ * Network Simplex Operations (pointer layout)
  * ============================================================================ */
 
 /* Compute reduced cost */
@@ -70,13 +172,13 @@ INLINE int32_t reduced_cost(const arc_t *arc)
     return arc->cost - arc->tail->potential + arc->head->potential;
 }
 
-/* Find entering arc (pricing) */
+/* Find entering arc (pricing): most negative reduced cost over every arc */
 static arc_t *primal_bea(void)
 {
     arc_t *best_arc = NULL;
     int32_t best_rc = 0;
 
-    for (int i = 0; i < GRAPH_NUM_ARCS; i++) {
+    for (int i = 0; i < total_arcs; i++) {
         arc_t *arc = &arcs[i];
 
         if (arc->ident == ARC_BASIC) continue;
@@ -95,159 +197,457 @@ static arc_t *primal_bea(void)
     return best_arc;
 }
 
-/* Find leaving arc and compute flow change */
-static arc_t *ratio_test(arc_t *entering, int32_t *delta)
+/* Dual infeasibility of a non-basic arc, 0 if it cannot enter */
+INLINE int32_t arc_violation(int ident, int32_t rc)
 {
-    node_t *i = entering->tail;
-    node_t *j = entering->head;
-    arc_t *leaving = entering;
+    if (ident == ARC_AT_LOWER && rc < 0) return -rc;
+    if (ident == ARC_AT_UPPER && rc > 0) return rc;
+    return 0;
+}
 
-    /* Compute maximum flow change */
-    int32_t max_delta = entering->capacity - entering->flow;
-    if (entering->ident == ARC_AT_UPPER) {
-        max_delta = entering->flow;
-    }
+/* Take the basket's most violated arc out, or -1 */
+static int mpp_take_best(mpp_t *m)
+{
+    if (m->size == 0) return -1;
 
-    /* Trace path from tail to root */
-    node_t *node = i;
-    while (node->pred) {
-        arc_t *arc = node->basic_arc;
-        int32_t cap;
+    int best = 0;
+    for (int i = 1; i < m->size; i++) {
+        if (m->basket[i].abs_rc > m->basket[best].abs_rc) best = i;
+    }
+    int arc = m->basket[best].arc;
+    m->basket[best] = m->basket[--m->size];
+    return arc;
+}
 
-        if (node->orientation) {
-            cap = arc->flow;
-        } else {
-            cap = arc->capacity - arc->flow;
+/*
+ * Multiple partial pricing: re-price the arcs left in the basket, then
+ * scan groups (every num_groups-th arc) until the basket holds
+ * GRAPH_MPP_BASKET candidates or every group was seen once.
+ */
+static arc_t *primal_bea_mpp(void)
+{
+    mpp_t *m = &mpp;
+    int kept = 0;
+
+    for (int i = 0; i < m->size; i++) {
+        arc_t *arc = &arcs[m->basket[i].arc];
+        int32_t v = arc_violation(arc->ident, reduced_cost(arc));
+        if (v) {
+            m->basket[kept].arc = m->basket[i].arc;
+            m->basket[kept++].abs_rc = v;
         }
+    }
+    m->size = kept;
 
-        if (cap < max_delta) {
-            max_delta = cap;
-            leaving = arc;
+    for (int g = 0; g < m->num_groups && m->size < GRAPH_MPP_BASKET; g++) {
+        for (int i = m->group_pos; i < total_arcs; i += m->num_groups) {
+            arc_t *arc = &arcs[i];
+            int32_t v = arc_violation(arc->ident, reduced_cost(arc));
+            if (v) {
+                m->basket[m->size].arc = i;
+                m->basket[m->size++].abs_rc = v;
+            }
         }
-
-        node = node->pred;
+        if (++m->group_pos == m->num_groups) m->group_pos = 0;
     }
 
-    /* Trace path from head to root */
-    node = j;
-    while (node->pred) {
-        arc_t *arc = node->basic_arc;
-        int32_t cap;
+    int best = mpp_take_best(m);
+    return best < 0 ? NULL : &arcs[best];
+}
 
-        if (node->orientation) {
-            cap = arc->capacity - arc->flow;
+/* Common ancestor of the entering arc's ends */
+static node_t *find_join(node_t *u, node_t *v)
+{
+    while (u != v) {
+        if (u->depth > v->depth) {
+            u = u->pred;
+        } else if (v->depth > u->depth) {
+            v = v->pred;
         } else {
-            cap = arc->flow;
+            u = u->pred;
+            v = v->pred;
         }
+    }
+    return u;
+}
 
-        if (cap < max_delta) {
-            max_delta = cap;
-            leaving = arc;
+/*
+ * Find leaving arc and flow change. The cycle runs from the join down to
+ * first, over the entering arc to second and back up; the last blocking
+ * arc in that order leaves, which keeps the tree strongly feasible.
+ */
+static ratio_t ratio_test(arc_t *entering, node_t *first, node_t *second, node_t *join,
+                          node_t **leaving)
+{
+    ratio_t r = { entering->capacity, 0 };
+
+    for (node_t *u = first; u != join; u = u->pred) {
+        arc_t *arc = u->basic_arc;
+        int32_t cap = u->orientation == DIR_UP ? arc->flow : arc->capacity - arc->flow;
+        if (cap < r.delta) {
+            r.delta = cap;
+            r.side = 1;
+            *leaving = u;
         }
+    }
 
-        node = node->pred;
+    for (node_t *u = second; u != join; u = u->pred) {
+        arc_t *arc = u->basic_arc;
+        int32_t cap = u->orientation == DIR_UP ? arc->capacity - arc->flow : arc->flow;
+        if (cap <= r.delta) {
+            r.delta = cap;
+            r.side = 2;
+            *leaving = u;
+        }
     }
 
-    *delta = max_delta;
-    return leaving;
+    return r;
 }
 
-/* Update tree structure */
-static void update_tree(arc_t *entering, arc_t *leaving, int32_t delta)
+/* Push delta around the cycle */
+static void update_flows(arc_t *entering, node_t *join, int32_t delta)
 {
-    /* Update flows on path */
-    node_t *node = entering->tail;
-    while (node->pred) {
-        arc_t *arc = node->basic_arc;
-        if (node->orientation) {
-            arc->flow -= delta;
-        } else {
-            arc->flow += delta;
+    int32_t val = entering->ident == ARC_AT_LOWER ? delta : -delta;
+
+    entering->flow += val;
+    for (node_t *u = entering->tail; u != join; u = u->pred) {
+        u->basic_arc->flow -= u->orientation * val;
+    }
+    for (node_t *u = entering->head; u != join; u = u->pred) {
+        u->basic_arc->flow += u->orientation * val;
+    }
+}
+
+INLINE void unlink_child(node_t *u)
+{
+    if (u->sibling_prev) {
+        u->sibling_prev->sibling = u->sibling;
+    } else {
+        u->pred->child = u->sibling;
+    }
+    if (u->sibling) {
+        u->sibling->sibling_prev = u->sibling_prev;
+    }
+}
+
+INLINE void link_child(node_t *u, node_t *parent)
+{
+    u->sibling = parent->child;
+    u->sibling_prev = NULL;
+    if (parent->child) {
+        parent->child->sibling_prev = u;
+    }
+    parent->child = u;
+    u->pred = parent;
+}
+
+/*
+ * Update tree structure: drop leaving's basic arc, reverse the path from
+ * u_in up to leaving and hang it from v_in by the entering arc.
+ */
+static void update_tree(arc_t *entering, node_t *u_in, node_t *v_in, node_t *leaving)
+{
+    node_t *u = u_in;
+    node_t *new_pred = v_in;
+    arc_t *new_arc = entering;
+    int8_t new_dir = entering->tail == u_in ? DIR_UP : DIR_DOWN;
+
+    leaving->basic_arc->ident = leaving->basic_arc->flow == 0 ? ARC_AT_LOWER : ARC_AT_UPPER;
+    entering->ident = ARC_BASIC;
+
+    for (;;) {
+        node_t *old_pred = u->pred;
+        arc_t *old_arc = u->basic_arc;
+        int8_t old_dir = u->orientation;
+
+        unlink_child(u);
+        link_child(u, new_pred);
+        u->basic_arc = new_arc;
+        u->orientation = new_dir;
+        if (u == leaving) break;
+
+        new_pred = u;
+        new_arc = old_arc;
+        new_dir = (int8_t)-old_dir;
+        u = old_pred;
+    }
+}
+
+/* Update potentials and depths of the subtree now hanging from u_in */
+static void update_potentials(node_t *u_in, int32_t sigma)
+{
+    node_t *u = u_in;
+
+    for (;;) {
+        u->potential += sigma;
+        u->depth = u->pred->depth + 1;
+
+        if (u->child) {
+            u = u->child;
+            continue;
         }
-        node = node->pred;
+        while (u != u_in && !u->sibling) {
+            u = u->pred;
+        }
+        if (u == u_in) break;
+        u = u->sibling;
     }
+}
 
-    node = entering->head;
-    while (node->pred) {
-        arc_t *arc = node->basic_arc;
-        if (node->orientation) {
-            arc->flow += delta;
-        } else {
-            arc->flow -= delta;
+/* Compute total cost */
+static int64_t compute_cost(void)
+{
+    int64_t total = 0;
+    for (int i = 0; i < total_arcs; i++) {
+        total += (int64_t)arcs[i].cost * arcs[i].flow;
+    }
+    return total;
+}
+
+/* Flow left on the artificial arcs (0 when the network is feasible) */
+static int64_t artificial_flow(void)
+{
+    int64_t total = 0;
+    for (int i = num_arcs; i < total_arcs; i++) {
+        total += arcs[i].flow;
+    }
+    return total;
+}
+
+/* ============================================================================
+ * Network Simplex Operations (index layout)
+ * ============================================================================ */
+
+INLINE int32_t reduced_cost_idx(const index_net_t *n, const arc_hot_t *a)
+{
+    return a->cost - n->potential[a->tail] + n->potential[a->head];
+}
+
+static int idx_primal_bea(const index_net_t *n)
+{
+    int best_arc = -1;
+    int32_t best_rc = 0;
+
+    for (int i = 0; i < total_arcs; i++) {
+        const arc_hot_t *a = &n->hot[i];
+
+        if (a->ident == ARC_BASIC) continue;
+
+        int32_t rc = reduced_cost_idx(n, a);
+
+        if (a->ident == ARC_AT_LOWER && rc < best_rc) {
+            best_rc = rc;
+            best_arc = i;
+        } else if (a->ident == ARC_AT_UPPER && rc > -best_rc) {
+            best_rc = -rc;
+            best_arc = i;
         }
-        node = node->pred;
     }
 
-    /* Update entering arc flow */
-    if (entering->ident == ARC_AT_LOWER) {
-        entering->flow += delta;
-    } else {
-        entering->flow -= delta;
+    return best_arc;
+}
+
+static int idx_primal_bea_mpp(const index_net_t *n)
+{
+    mpp_t *m = &mpp;
+    int kept = 0;
+
+    for (int i = 0; i < m->size; i++) {
+        const arc_hot_t *a = &n->hot[m->basket[i].arc];
+        int32_t v = arc_violation(a->ident, reduced_cost_idx(n, a));
+        if (v) {
+            m->basket[kept].arc = m->basket[i].arc;
+            m->basket[kept++].abs_rc = v;
+        }
     }
+    m->size = kept;
+
+    for (int g = 0; g < m->num_groups && m->size < GRAPH_MPP_BASKET; g++) {
+        for (int i = m->group_pos; i < total_arcs; i += m->num_groups) {
+            const arc_hot_t *a = &n->hot[i];
+            int32_t v = arc_violation(a->ident, reduced_cost_idx(n, a));
+            if (v) {
+                m->basket[m->size].arc = i;
+                m->basket[m->size++].abs_rc = v;
+            }
+        }
+        if (++m->group_pos == m->num_groups) m->group_pos = 0;
+    }
+
+    return mpp_take_best(m);
+}
 
-    /* Update tree if entering != leaving */
-    if (entering != leaving) {
-        /* Mark leaving arc as non-basic */
-        if (leaving->flow == 0) {
-            leaving->ident = ARC_AT_LOWER;
+static int idx_find_join(const tree_node_t *t, int u, int v)
+{
+    while (u != v) {
+        if (t[u].depth > t[v].depth) {
+            u = t[u].pred;
+        } else if (t[v].depth > t[u].depth) {
+            v = t[v].pred;
         } else {
-            leaving->ident = ARC_AT_UPPER;
+            u = t[u].pred;
+            v = t[v].pred;
         }
+    }
+    return u;
+}
 
-        /* Mark entering arc as basic */
-        entering->ident = ARC_BASIC;
+static ratio_t idx_ratio_test(const index_net_t *n, int entering, int first, int second,
+                              int join, int *leaving)
+{
+    const tree_node_t *t = n->tree;
+    ratio_t r = { n->cold[entering].capacity, 0 };
+
+    for (int u = first; u != join; u = t[u].pred) {
+        const arc_cold_t *c = &n->cold[t[u].basic_arc];
+        int32_t cap = t[u].orientation == DIR_UP ? c->flow : c->capacity - c->flow;
+        if (cap < r.delta) {
+            r.delta = cap;
+            r.side = 1;
+            *leaving = u;
+        }
+    }
 
-        /* Update tree structure (simplified) */
-        entering->head->basic_arc = entering;
-        entering->head->pred = entering->tail;
-        entering->head->orientation = 0;
+    for (int u = second; u != join; u = t[u].pred) {
+        const arc_cold_t *c = &n->cold[t[u].basic_arc];
+        int32_t cap = t[u].orientation == DIR_UP ? c->capacity - c->flow : c->flow;
+        if (cap <= r.delta) {
+            r.delta = cap;
+            r.side = 2;
+            *leaving = u;
+        }
     }
+
+    return r;
 }
 
-/* Update potentials */
-static void update_potentials(void)
+static void idx_update_flows(index_net_t *n, int entering, int join, int32_t delta)
 {
-    /* BFS to update potentials from root */
-    node_t *queue[GRAPH_NUM_NODES];
-    int front = 0, back = 0;
+    const tree_node_t *t = n->tree;
+    const arc_hot_t *e = &n->hot[entering];
+    int32_t val = e->ident == ARC_AT_LOWER ? delta : -delta;
 
-    /* Root has potential 0 */
-    nodes[1].potential = 0;
-    queue[back++] = &nodes[1];
+    n->cold[entering].flow += val;
+    for (int u = e->tail; u != join; u = t[u].pred) {
+        n->cold[t[u].basic_arc].flow -= t[u].orientation * val;
+    }
+    for (int u = e->head; u != join; u = t[u].pred) {
+        n->cold[t[u].basic_arc].flow += t[u].orientation * val;
+    }
+}
 
-    while (front < back) {
-        node_t *node = queue[front++];
+/*
+ * Same re-hang as update_tree, on the thread. The subtree of leaving is the
+ * thread run [leaving, last(leaving)]; re-rooted at path[0] = u_in it is
+ * path[0]'s subtree, then for each path[i] its own subtree minus
+ * path[i-1]'s: the run before path[i-1] and the run after last(path[i-1]).
+ * One pass over the run finds those boundaries and also shifts potentials
+ * and depths (a node owned by path[i] moves by the same depth as path[i]),
+ * so there is no separate potentials walk; the spliced run is then hung
+ * after v_in.
+ */
+static void idx_update_tree(index_net_t *n, int entering, int u_in, int v_in, int leaving,
+                            int32_t sigma)
+{
+    tree_node_t *t = n->tree;
+    int32_t *thread = n->thread;
+    int32_t *rev = n->rev_thread;
+    int32_t *path = n->path;
+    int32_t *last = n->path_last;
+    int32_t *before = n->path_before;
+    int32_t *after = n->path_after;
+
+    arc_cold_t *out = &n->cold[t[leaving].basic_arc];
+    n->hot[t[leaving].basic_arc].ident = out->flow == 0 ? ARC_AT_LOWER : ARC_AT_UPPER;
+    n->hot[entering].ident = ARC_BASIC;
+
+    /* path[0] = u_in .. path[r] = leaving */
+    int r = 0;
+    path[0] = u_in;
+    while (path[r] != leaving) {
+        path[r + 1] = t[path[r]].pred;
+        r++;
+    }
 
-        /* Update children */
-        for (int i = 0; i < GRAPH_NUM_ARCS; i++) {
-            arc_t *arc = &arcs[i];
-            if (arc->ident != ARC_BASIC) continue;
+    /* path[i] sits at depth_out + r - i now and at depth(v_in) + 1 + i after */
+    int depth_out = t[leaving].depth;
+    int shift = t[v_in].depth + 1 - depth_out - r;
+    int enc = r;            /* Deepest path node reached so far */
+    int top = 0;            /* Shallowest path node not yet closed */
+    int prev = leaving;
+    int x = thread[leaving];
+
+    before[r] = rev[leaving];
+    n->potential[leaving] += sigma;
+    t[leaving].depth += shift + 2 * r;
+    for (;;) {
+        int depth = t[x].depth;
+        while (top <= r && top >= enc && depth_out + r - top >= depth) {
+            last[top] = prev;
+            after[top] = x;
+            top++;
+        }
+        if (depth <= depth_out) break;
+        if (enc > 0 && x == path[enc - 1]) {
+            before[--enc] = prev;
+        }
+        n->potential[x] += sigma;
+        t[x].depth = depth + shift + 2 * MAX(enc, top);
+        prev = x;
+        x = thread[x];
+    }
 
-            node_t *child = NULL;
-            int32_t pot;
+    /* Cut the run out */
+    int outside_before = before[r];
+    int outside_after = after[r];
+    thread[outside_before] = outside_after;
+    rev[outside_after] = outside_before;
+
+    /* Splice the re-rooted order */
+    int tail_node = last[0];
+    for (int i = 1; i <= r; i++) {
+        thread[tail_node] = path[i];
+        rev[path[i]] = tail_node;
+        tail_node = before[i - 1];
+        if (last[i] != last[i - 1]) {
+            thread[tail_node] = after[i - 1];
+            rev[after[i - 1]] = tail_node;
+            tail_node = last[i];
+        }
+    }
 
-            if (arc->tail == node && arc->head->pred == node) {
-                child = arc->head;
-                pot = node->potential + arc->cost;
-            } else if (arc->head == node && arc->tail->pred == node) {
-                child = arc->tail;
-                pot = node->potential - arc->cost;
-            }
+    /* Hang it after v_in */
+    int next = thread[v_in];
+    thread[v_in] = path[0];
+    rev[path[0]] = v_in;
+    thread[tail_node] = next;
+    rev[next] = tail_node;
+
+    /* Reverse the path's tree arcs */
+    for (int i = r; i > 0; i--) {
+        t[path[i]].pred = path[i - 1];
+        t[path[i]].basic_arc = t[path[i - 1]].basic_arc;
+        t[path[i]].orientation = -t[path[i - 1]].orientation;
+    }
+    t[u_in].pred = v_in;
+    t[u_in].basic_arc = entering;
+    t[u_in].orientation = n->hot[entering].tail == u_in ? DIR_UP : DIR_DOWN;
+}
 
-            if (child && child != node) {
-                child->potential = pot;
-                queue[back++] = child;
-            }
-        }
+static int64_t idx_compute_cost(const index_net_t *n)
+{
+    int64_t total = 0;
+    for (int i = 0; i < total_arcs; i++) {
+        total += (int64_t)n->hot[i].cost * n->cold[i].flow;
     }
+    return total;
 }
 
-/* Compute total cost */
-static int64_t compute_cost(void)
+static int64_t idx_artificial_flow(const index_net_t *n)
 {
     int64_t total = 0;
-    for (int i = 0; i < GRAPH_NUM_ARCS; i++) {
-        total += (int64_t)arcs[i].cost * arcs[i].flow;
+    for (int i = num_arcs; i < total_arcs; i++) {
+        total += n->cold[i].flow;
     }
     return total;
 }
@@ -256,58 +656,116 @@ static int64_t compute_cost(void)
  * Test Data Generation
  * ============================================================================ */
 
-static void init_network(uint32_t seed)
+static void init_problem(uint32_t seed)
 {
     uint32_t x = seed;
 
-    /* Initialize nodes */
-    for (int i = 0; i <= GRAPH_NUM_NODES; i++) {
-        nodes[i].basic_arc = NULL;
-        nodes[i].pred = NULL;
-        nodes[i].potential = 0;
-        nodes[i].balance = 0;
-        nodes[i].depth = 0;
-        nodes[i].orientation = 0;
-    }
-
     /* Set supply/demand (balanced) */
     int32_t total_supply = 0;
-    for (int i = 1; i <= GRAPH_NUM_NODES / 2; i++) {
+    for (int i = 1; i <= num_nodes / 2; i++) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        nodes[i].balance = 10 + (x % 90);
-        total_supply += nodes[i].balance;
+        problem.balance[i] = 10 + (x % 90);
+        total_supply += problem.balance[i];
     }
-    for (int i = GRAPH_NUM_NODES / 2 + 1; i <= GRAPH_NUM_NODES; i++) {
+    for (int i = num_nodes / 2 + 1; i <= num_nodes; i++) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
         int32_t demand = 10 + (x % 90);
-        nodes[i].balance = -demand;
+        problem.balance[i] = -demand;
         total_supply -= demand;
     }
     /* Adjust last node for balance */
-    nodes[GRAPH_NUM_NODES].balance -= total_supply;
+    problem.balance[num_nodes] -= total_supply;
 
-    /* Initialize arcs */
-    for (int i = 0; i < GRAPH_NUM_ARCS; i++) {
+    /* Real arcs */
+    for (int i = 0; i < num_arcs; i++) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        int tail = 1 + (x % GRAPH_NUM_NODES);
+        int tail = 1 + (x % num_nodes);
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        int head = 1 + (x % GRAPH_NUM_NODES);
+        int head = 1 + (x % num_nodes);
+
+        if (tail == head) head = (head % num_nodes) + 1;
+
+        problem.tail[i] = tail;
+        problem.head[i] = head;
+        problem.cost[i] = 1 + (x % GRAPH_MAX_COST);
+        problem.capacity[i] = 50 + (x % 200);
+    }
 
-        if (tail == head) head = (head % GRAPH_NUM_NODES) + 1;
+    /* Artificial arcs: supply nodes to the root, the root to demand nodes */
+    int32_t big_m = (num_nodes + 1) * GRAPH_MAX_COST;
+    for (int v = 1; v <= num_nodes; v++) {
+        int i = num_arcs + v - 1;
+        bool up = problem.balance[v] >= 0;
+        problem.tail[i] = up ? v : 0;
+        problem.head[i] = up ? 0 : v;
+        problem.cost[i] = big_m;
+        problem.capacity[i] = ARC_UNBOUNDED;
+    }
+}
+
+/*
+ * Starting basis: every node hangs from the root by its artificial arc,
+ * which carries the node's supply or demand.
+ */
+static void reset_pointer_network(void)
+{
+    node_t *root = &nodes[0];
 
-        arcs[i].tail = &nodes[tail];
-        arcs[i].head = &nodes[head];
-        arcs[i].cost = 1 + (x % 100);
-        arcs[i].capacity = 50 + (x % 200);
+    for (int i = 0; i < total_arcs; i++) {
+        arcs[i].tail = &nodes[problem.tail[i]];
+        arcs[i].head = &nodes[problem.head[i]];
+        arcs[i].cost = problem.cost[i];
+        arcs[i].capacity = problem.capacity[i];
         arcs[i].flow = 0;
         arcs[i].ident = ARC_AT_LOWER;
     }
 
-    /* Build initial tree (simple star from node 1) */
-    for (int i = 2; i <= GRAPH_NUM_NODES; i++) {
-        nodes[i].pred = &nodes[1];
-        nodes[i].basic_arc = &arcs[i - 2];
-        arcs[i - 2].ident = ARC_BASIC;
+    memset(root, 0, sizeof(*root));
+    for (int v = num_nodes; v >= 1; v--) {
+        node_t *node = &nodes[v];
+        arc_t *arc = &arcs[num_arcs + v - 1];
+        int32_t b = problem.balance[v];
+
+        arc->ident = ARC_BASIC;
+        arc->flow = b >= 0 ? b : -b;
+        node->basic_arc = arc;
+        node->orientation = b >= 0 ? DIR_UP : DIR_DOWN;
+        node->potential = b >= 0 ? arc->cost : -arc->cost;
+        node->balance = b;
+        node->depth = 1;
+        node->child = NULL;
+        link_child(node, root);
+    }
+}
+
+static void reset_index_network(void)
+{
+    for (int i = 0; i < total_arcs; i++) {
+        net.hot[i].tail = problem.tail[i];
+        net.hot[i].head = problem.head[i];
+        net.hot[i].cost = problem.cost[i];
+        net.hot[i].ident = ARC_AT_LOWER;
+        net.cold[i].flow = 0;
+        net.cold[i].capacity = problem.capacity[i];
+    }
+
+    memset(&net.tree[0], 0, sizeof(net.tree[0]));
+    net.potential[0] = 0;
+    for (int v = 1; v <= num_nodes; v++) {
+        int arc = num_arcs + v - 1;
+        int32_t b = problem.balance[v];
+
+        net.hot[arc].ident = ARC_BASIC;
+        net.cold[arc].flow = b >= 0 ? b : -b;
+        net.tree[v].pred = 0;
+        net.tree[v].basic_arc = arc;
+        net.tree[v].depth = 1;
+        net.tree[v].orientation = b >= 0 ? DIR_UP : DIR_DOWN;
+        net.potential[v] = b >= 0 ? net.hot[arc].cost : -net.hot[arc].cost;
+    }
+    for (int v = 0; v <= num_nodes; v++) {
+        net.thread[v] = v < num_nodes ? v + 1 : 0;
+        net.rev_thread[v] = v > 0 ? v - 1 : num_nodes;
     }
 }
 
@@ -317,56 +775,208 @@ static void init_network(uint32_t seed)
 
 static void kernel_init_func(void)
 {
-    init_network(0xCAFEBABE);
+    num_nodes = (int)bench_scale_dim(GRAPH_NUM_NODES);
+    num_arcs = (int)bench_scale_dim(GRAPH_NUM_ARCS);
+    total_arcs = num_arcs + num_nodes;
+
+    problem.tail = bench_alloc(total_arcs * sizeof(int32_t));
+    problem.head = bench_alloc(total_arcs * sizeof(int32_t));
+    problem.cost = bench_alloc(total_arcs * sizeof(int32_t));
+    problem.capacity = bench_alloc(total_arcs * sizeof(int32_t));
+    problem.balance = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+
+    nodes = bench_alloc((num_nodes + 1) * sizeof(node_t));
+    arcs = bench_alloc(total_arcs * sizeof(arc_t));
+
+    net.hot = bench_alloc(total_arcs * sizeof(arc_hot_t));
+    net.cold = bench_alloc(total_arcs * sizeof(arc_cold_t));
+    net.tree = bench_alloc((num_nodes + 1) * sizeof(tree_node_t));
+    net.potential = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+    net.thread = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+    net.rev_thread = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+    net.path = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+    net.path_last = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+    net.path_before = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+    net.path_after = bench_alloc((num_nodes + 1) * sizeof(int32_t));
+
+    mpp.basket = bench_alloc((GRAPH_MPP_BASKET + GRAPH_MPP_GROUP) * sizeof(candidate_t));
+    mpp.num_groups = (total_arcs + GRAPH_MPP_GROUP - 1) / GRAPH_MPP_GROUP;
+
+    init_problem(0xCAFEBABE);
 }
 
-static bench_result_t kernel_run_func(void)
+static void mpp_reset(void)
+{
+    mpp.size = 0;
+    mpp.group_pos = 0;
+}
+
+/* Checksum and result shared by both layouts */
+static bench_result_t simplex_result(uint64_t cycles, int64_t final_cost, int64_t artificial,
+                                     int32_t pivots, uint64_t pivot_limit)
 {
     bench_result_t result = { .status = BENCH_OK };
-    int iterations = 0;
+
+    /* Pivot counts depend on the pricing rule; the optimum does not */
+    uint32_t csum = checksum_init();
+    csum = checksum_update(csum, (uint32_t)final_cost);
+    csum = checksum_update(csum, (uint32_t)(final_cost >> 32));
+    csum = checksum_update(csum, (uint32_t)artificial);
+
+    if ((uint64_t)pivots >= pivot_limit) {
+        result.status = BENCH_ERR_INTERNAL;
+    }
+
+    result.cycles = cycles;
+    result.checksum = csum;
+    result.work = (uint64_t)pivots;
+
+    return result;
+}
+
+/* Pointer layout to optimality; mpp selects primal_bea_mpp pricing */
+static bench_result_t simplex_pointer(bool use_mpp)
+{
+    uint64_t pivot_limit = (uint64_t)SIMPLEX_PIVOT_LIMIT * (num_nodes + total_arcs);
+    int32_t pivots = 0;
+
+    reset_pointer_network();
+    mpp_reset();
 
     /* Start timing */
     BENCH_START();
 
-    /* Run simplex iterations */
-    for (int i = 0; i < SIMPLEX_ITERATIONS; i++) {
+    for (;;) {
         /* Find entering arc */
-        arc_t *entering = primal_bea();
-        if (!entering) break;  /* Optimal */
+        BENCH_PHASE_BEGIN(PHASE_PRICING);
+        arc_t *entering = use_mpp ? primal_bea_mpp() : primal_bea();
+        BENCH_PHASE_END(PHASE_PRICING);
+        if (!entering || (uint64_t)pivots >= pivot_limit) break;  /* Optimal */
 
         /* Find leaving arc */
-        int32_t delta;
-        arc_t *leaving = ratio_test(entering, &delta);
+        BENCH_PHASE_BEGIN(PHASE_RATIO);
+        bool at_lower = entering->ident == ARC_AT_LOWER;
+        node_t *first = at_lower ? entering->tail : entering->head;
+        node_t *second = at_lower ? entering->head : entering->tail;
+        node_t *join = find_join(first, second);
+        node_t *leaving = NULL;
+        ratio_t r = ratio_test(entering, first, second, join, &leaving);
+        BENCH_PHASE_END(PHASE_RATIO);
 
         /* Update tree and flows */
-        update_tree(entering, leaving, delta);
-
-        /* Update potentials periodically */
-        if (i % 10 == 0) {
-            update_potentials();
+        BENCH_PHASE_BEGIN(PHASE_UPDATE);
+        int32_t rc = reduced_cost(entering);
+        if (r.delta > 0) {
+            update_flows(entering, join, r.delta);
+        }
+        if (r.side == 0) {
+            entering->ident = at_lower ? ARC_AT_UPPER : ARC_AT_LOWER;
+            BENCH_PHASE_END(PHASE_UPDATE);
+        } else {
+            node_t *u_in = r.side == 1 ? first : second;
+            node_t *v_in = r.side == 1 ? second : first;
+            update_tree(entering, u_in, v_in, leaving);
+            BENCH_PHASE_END(PHASE_UPDATE);
+
+            /* Shift the moved subtree so the entering arc prices to zero */
+            BENCH_PHASE_BEGIN(PHASE_POTENTIALS);
+            update_potentials(u_in, u_in == entering->tail ? rc : -rc);
+            BENCH_PHASE_END(PHASE_POTENTIALS);
         }
 
-        iterations++;
+        pivots++;
     }
 
+    BENCH_PHASE_BEGIN(PHASE_COST);
     int64_t final_cost = compute_cost();
+    int64_t artificial = artificial_flow();
+    BENCH_PHASE_END(PHASE_COST);
 
     /* End timing */
     BENCH_END();
 
-    /* Checksum */
-    uint32_t csum = checksum_init();
-    csum = checksum_update(csum, (uint32_t)final_cost);
-    csum = checksum_update(csum, (uint32_t)(final_cost >> 32));
-    csum = checksum_update(csum, (uint32_t)iterations);
-
     /* Prevent optimization */
     BENCH_VOLATILE(final_cost);
 
-    result.cycles = BENCH_CYCLES();
-    result.checksum = csum;
+    return simplex_result(BENCH_CYCLES(), final_cost, artificial, pivots, pivot_limit);
+}
 
-    return result;
+/* Hot/cold index layout with the thread tree */
+static bench_result_t simplex_index(bool use_mpp)
+{
+    index_net_t *n = &net;
+    uint64_t pivot_limit = (uint64_t)SIMPLEX_PIVOT_LIMIT * (num_nodes + total_arcs);
+    int32_t pivots = 0;
+
+    reset_index_network();
+    mpp_reset();
+
+    BENCH_START();
+
+    for (;;) {
+        BENCH_PHASE_BEGIN(PHASE_PRICING);
+        int entering = use_mpp ? idx_primal_bea_mpp(n) : idx_primal_bea(n);
+        BENCH_PHASE_END(PHASE_PRICING);
+        if (entering < 0 || (uint64_t)pivots >= pivot_limit) break;
+
+        BENCH_PHASE_BEGIN(PHASE_RATIO);
+        const arc_hot_t *e = &n->hot[entering];
+        bool at_lower = e->ident == ARC_AT_LOWER;
+        int first = at_lower ? e->tail : e->head;
+        int second = at_lower ? e->head : e->tail;
+        int join = idx_find_join(n->tree, first, second);
+        int leaving = -1;
+        ratio_t r = idx_ratio_test(n, entering, first, second, join, &leaving);
+        BENCH_PHASE_END(PHASE_RATIO);
+
+        BENCH_PHASE_BEGIN(PHASE_UPDATE);
+        int32_t rc = reduced_cost_idx(n, e);
+        if (r.delta > 0) {
+            idx_update_flows(n, entering, join, r.delta);
+        }
+        if (r.side == 0) {
+            n->hot[entering].ident = at_lower ? ARC_AT_UPPER : ARC_AT_LOWER;
+            BENCH_PHASE_END(PHASE_UPDATE);
+        } else {
+            int u_in = r.side == 1 ? first : second;
+            int v_in = r.side == 1 ? second : first;
+            idx_update_tree(n, entering, u_in, v_in, leaving, u_in == e->tail ? rc : -rc);
+            BENCH_PHASE_END(PHASE_UPDATE);
+        }
+
+        pivots++;
+    }
+
+    BENCH_PHASE_BEGIN(PHASE_COST);
+    int64_t final_cost = idx_compute_cost(n);
+    int64_t artificial = idx_artificial_flow(n);
+    BENCH_PHASE_END(PHASE_COST);
+
+    BENCH_END();
+
+    BENCH_VOLATILE(final_cost);
+
+    return simplex_result(BENCH_CYCLES(), final_cost, artificial, pivots, pivot_limit);
+}
+
+static bench_result_t kernel_run_func(void)
+{
+    return simplex_pointer(false);
+}
+
+static bench_result_t kernel_run_mpp(void)
+{
+    return simplex_pointer(true);
+}
+
+static bench_result_t kernel_run_soa(void)
+{
+    return simplex_index(false);
+}
+
+static bench_result_t kernel_run_soa_mpp(void)
+{
+    return simplex_index(true);
 }
 
 static void kernel_cleanup_func(void)
@@ -377,7 +987,15 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t simplex_variants[] = {
+    { "soa-mpp", 0, kernel_run_soa_mpp },
+    { "mpp", 0, kernel_run_mpp },
+    { "soa", 0, kernel_run_soa },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     graph_simplex,
     "Network simplex algorithm",
     "429.mcf",
@@ -385,7 +1003,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    SIMPLEX_ITERATIONS
+    1,
+    simplex_variants,
+    "pricing", "ratio_test", "update_tree", "potentials", "cost"
 );
 
 KERNEL_REGISTER(graph_simplex)
@@ -9,9 +9,13 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+#include <immintrin.h>
+#endif
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * Bucket and entry counts are tier S sizes, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef HASH_NUM_BUCKETS
@@ -30,10 +34,21 @@
 #define HASH_KEY_LEN        16      /* Average key length */
 #endif
 
+#ifndef HASH_HIT_PERCENT
+#define HASH_HIT_PERCENT    75      /* Lookups for keys in the table */
+#endif
+
+#ifndef HASH_REHASH_STEP
+#define HASH_REHASH_STEP    16      /* Swiss slots moved per insert while growing */
+#endif
+
 /* ============================================================================
  * Data Structures (similar to Perl's hash implementation)
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_LOOKUP };
+
 /* Hash entry (like Perl's HE) */
 typedef struct hash_entry {
     struct hash_entry *next;    /* Next in chain */
@@ -52,11 +67,46 @@ typedef struct {
     uint32_t num_entries;       /* Number of entries */
 } hash_table_t;
 
-/* Static storage */
-static hash_table_t table;
-static hash_entry_t *buckets[HASH_NUM_BUCKETS];
-static hash_entry_t entries[HASH_NUM_ENTRIES];
-static char lookup_keys[HASH_NUM_LOOKUPS][HASH_KEY_LEN];
+/* Swiss table */
+#define SWISS_GROUP         16      /* Control bytes probed at once */
+#define SWISS_MIN_CAPACITY  SWISS_GROUP
+#define SWISS_EMPTY         0x80
+#define SWISS_PTR_MASK      ((1ULL << 48) - 1)
+
+/* Inline slot; tagged slots are a uint64_t entry pointer | hash bits << 48 */
+typedef struct {
+    char key[HASH_KEY_LEN];
+    uint32_t hash;
+    int32_t value;
+} swiss_slot_t;
+
+typedef struct {
+    uint8_t *ctrl;              /* capacity control bytes, group-aligned */
+    void *slots;
+    uint32_t capacity;          /* Power of 2, multiple of SWISS_GROUP */
+    uint32_t group_mask;
+    uint32_t count;
+} swiss_part_t;
+
+/* While growing, old holds the part being drained (old.ctrl NULL otherwise) */
+typedef struct {
+    swiss_part_t cur;
+    swiss_part_t old;
+    uint32_t migrate_pos;
+} swiss_table_t;
+
+/* Lookup engine: true and *value on a hit */
+typedef bool (*lookup_func_t)(const char *key, int32_t *value);
+
+/* Static storage (arrays are arena-allocated in init) */
+static BENCH_TLS hash_table_t table;
+static BENCH_TLS swiss_table_t swiss_inline;
+static BENCH_TLS swiss_table_t swiss_tagged;
+static BENCH_TLS hash_entry_t **buckets;
+static BENCH_TLS hash_entry_t *entries;
+static BENCH_TLS char lookup_keys[HASH_NUM_LOOKUPS][HASH_KEY_LEN];
+static BENCH_TLS uint32_t num_buckets;
+static BENCH_TLS uint32_t num_entries;
 
 /* ============================================================================
  * Hash Function (DJB2 - used in many hash table implementations)
@@ -135,6 +185,287 @@ static hash_entry_t *hash_lookup(hash_table_t *ht, const char *key, size_t key_l
     return NULL;
 }
 
+/* ============================================================================
+ * Swiss Table (open addressing, SIMD-probed control bytes)
+ * One control byte per slot: SWISS_EMPTY or the top 7 bits of the hash
+ * (h2). A probe reads a whole 16-slot group of control bytes, matches h2
+ * against all of them at once and compares keys only for the hits, so a
+ * lookup touches one control line and usually one slot line instead of a
+ * chain of entries. Groups are probed triangularly until a group with an
+ * empty slot; the table grows at 7/8 load, so one always exists.
+ *
+ * Slots store keys inline (key, hash, value) or as tagged pointers to the
+ * chained table's entries, 16 more hash bits in the unused top of the
+ * pointer, checked before the entry is dereferenced.
+ *
+ * Growing allocates a table twice the size and moves HASH_REHASH_STEP old
+ * slots per insert (incremental rehash, so no insert pays for a full
+ * rehash); meanwhile lookups probe the new table, then the old one.
+ * ============================================================================ */
+
+INLINE uint64_t swiss_mix(uint32_t hash)
+{
+    return (uint64_t)hash * 0x9E3779B97F4A7C15ULL;
+}
+
+INLINE uint8_t swiss_h2(uint64_t mixed)
+{
+    return (uint8_t)((mixed >> 25) & 0x7F);
+}
+
+INLINE uint32_t swiss_group(const swiss_part_t *p, uint64_t mixed)
+{
+    return (uint32_t)(mixed >> 32) & p->group_mask;
+}
+
+/* Bit i*8+7 set for each control byte i of a 64-bit word equal to h2
+ * (may also flag the byte after a true match; keys are compared anyway) */
+INLINE uint64_t swar_match(uint64_t word, uint8_t h2)
+{
+    const uint64_t lsbs = 0x0101010101010101ULL;
+    uint64_t x = word ^ (lsbs * h2);
+    return (x - lsbs) & ~x & (lsbs << 7);
+}
+
+/* Slot positions in a group: mask of matches and whether it has an empty */
+INLINE uint32_t group_match_swar(const uint8_t *ctrl, uint8_t h2, bool *has_empty)
+{
+    uint64_t lo, hi;
+    memcpy(&lo, ctrl, 8);
+    memcpy(&hi, ctrl + 8, 8);
+
+    /* h2 < 0x80, so the high bit marks exactly the empty bytes */
+    *has_empty = ((lo | hi) & 0x8080808080808080ULL) != 0;
+
+    uint64_t m_lo = swar_match(lo, h2), m_hi = swar_match(hi, h2);
+    uint32_t mask = 0;
+    while (m_lo) {
+        mask |= 1u << (__builtin_ctzll(m_lo) >> 3);
+        m_lo &= m_lo - 1;
+    }
+    while (m_hi) {
+        mask |= 1u << (8 + (__builtin_ctzll(m_hi) >> 3));
+        m_hi &= m_hi - 1;
+    }
+    return mask;
+}
+
+#if defined(ARCH_X86_64)
+INLINE uint32_t group_match_sse2(const uint8_t *ctrl, uint8_t h2, bool *has_empty)
+{
+    __m128i g = _mm_load_si128((const __m128i *)ctrl);
+    *has_empty = _mm_movemask_epi8(g) != 0;
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2)));
+}
+#endif
+
+INLINE uint32_t group_match(const uint8_t *ctrl, uint8_t h2, bool *has_empty, bool simd)
+{
+#if defined(ARCH_X86_64)
+    if (simd) return group_match_sse2(ctrl, h2, has_empty);
+#endif
+    UNUSED(simd);
+    return group_match_swar(ctrl, h2, has_empty);
+}
+
+INLINE const hash_entry_t *tagged_entry(uint64_t slot)
+{
+    return (const hash_entry_t *)(uintptr_t)(slot & SWISS_PTR_MASK);
+}
+
+INLINE uint64_t tagged_make(const hash_entry_t *entry)
+{
+    return (uint64_t)(uintptr_t)entry | ((uint64_t)(entry->hash >> 16) << 48);
+}
+
+INLINE bool slot_matches(const swiss_part_t *p, uint32_t i, uint32_t hash,
+                         const char *key, bool tagged)
+{
+    if (tagged) {
+        uint64_t s = ((const uint64_t *)p->slots)[i];
+        return (uint32_t)(s >> 48) == (hash >> 16) &&
+               memcmp(tagged_entry(s)->key, key, HASH_KEY_LEN) == 0;
+    }
+    const swiss_slot_t *s = &((const swiss_slot_t *)p->slots)[i];
+    return s->hash == hash && memcmp(s->key, key, HASH_KEY_LEN) == 0;
+}
+
+/* Slot index holding key in one part, or -1 */
+INLINE int64_t swiss_find_part(const swiss_part_t *p, uint32_t hash, const char *key,
+                               bool tagged, bool simd)
+{
+    uint64_t mixed = swiss_mix(hash);
+    uint8_t h2 = swiss_h2(mixed);
+    uint32_t group = swiss_group(p, mixed);
+
+    for (uint32_t step = 1;; step++) {
+        const uint8_t *ctrl = p->ctrl + group * SWISS_GROUP;
+        bool has_empty;
+        uint32_t mask = group_match(ctrl, h2, &has_empty, simd);
+
+        while (mask) {
+            uint32_t i = group * SWISS_GROUP + __builtin_ctz(mask);
+            mask &= mask - 1;
+            if (slot_matches(p, i, hash, key, tagged)) return i;
+        }
+        if (has_empty) return -1;
+        group = (group + step) & p->group_mask;
+    }
+}
+
+/* Write a slot for a key known to be absent */
+static void swiss_place(swiss_part_t *p, uint32_t hash, const void *slot, bool tagged)
+{
+    uint64_t mixed = swiss_mix(hash);
+    uint32_t group = swiss_group(p, mixed);
+
+    for (uint32_t step = 1;; step++) {
+        uint8_t *ctrl = p->ctrl + group * SWISS_GROUP;
+        for (int k = 0; k < SWISS_GROUP; k++) {
+            if (ctrl[k] != SWISS_EMPTY) continue;
+
+            uint32_t i = group * SWISS_GROUP + k;
+            ctrl[k] = swiss_h2(mixed);
+            if (tagged) {
+                ((uint64_t *)p->slots)[i] = *(const uint64_t *)slot;
+            } else {
+                ((swiss_slot_t *)p->slots)[i] = *(const swiss_slot_t *)slot;
+            }
+            p->count++;
+            return;
+        }
+        group = (group + step) & p->group_mask;
+    }
+}
+
+static void swiss_part_alloc(swiss_part_t *p, uint32_t capacity, bool tagged)
+{
+    p->capacity = capacity;
+    p->group_mask = capacity / SWISS_GROUP - 1;
+    p->count = 0;
+    p->ctrl = bench_alloc(capacity);
+    p->slots = bench_alloc((size_t)capacity * (tagged ? sizeof(uint64_t) : sizeof(swiss_slot_t)));
+    memset(p->ctrl, SWISS_EMPTY, capacity);
+}
+
+static void swiss_create(swiss_table_t *t, bool tagged)
+{
+    memset(t, 0, sizeof(*t));
+    swiss_part_alloc(&t->cur, SWISS_MIN_CAPACITY, tagged);
+}
+
+/* Move up to `count` old slots into the current part */
+static void swiss_migrate(swiss_table_t *t, uint32_t count, bool tagged)
+{
+    if (!t->old.ctrl) return;
+
+    while (count-- > 0 && t->migrate_pos < t->old.capacity) {
+        uint32_t i = t->migrate_pos++;
+        if (t->old.ctrl[i] == SWISS_EMPTY) continue;
+
+        const void *slot;
+        uint32_t hash;
+        const char *key;
+        if (tagged) {
+            slot = &((const uint64_t *)t->old.slots)[i];
+            hash = tagged_entry(*(const uint64_t *)slot)->hash;
+            key = tagged_entry(*(const uint64_t *)slot)->key;
+        } else {
+            slot = &((const swiss_slot_t *)t->old.slots)[i];
+            hash = ((const swiss_slot_t *)slot)->hash;
+            key = ((const swiss_slot_t *)slot)->key;
+        }
+
+        /* A newer insert of the same key may already be in the new part */
+        if (swiss_find_part(&t->cur, hash, key, tagged, false) < 0) {
+            swiss_place(&t->cur, hash, slot, tagged);
+        }
+    }
+    if (t->migrate_pos >= t->old.capacity) t->old.ctrl = NULL;
+}
+
+/* Insert or update; a later insert of a key wins, as with chain heads */
+static void swiss_insert(swiss_table_t *t, const hash_entry_t *entry, bool tagged)
+{
+    swiss_migrate(t, HASH_REHASH_STEP, tagged);
+    if ((t->cur.count + 1) * 8 > t->cur.capacity * 7) {
+        swiss_migrate(t, UINT32_MAX, tagged);
+        t->old = t->cur;
+        t->migrate_pos = 0;
+        swiss_part_alloc(&t->cur, t->old.capacity * 2, tagged);
+    }
+
+    swiss_slot_t inline_slot;
+    uint64_t tagged_slot = tagged_make(entry);
+    const void *slot = &tagged_slot;
+    if (!tagged) {
+        memcpy(inline_slot.key, entry->key, HASH_KEY_LEN);
+        inline_slot.hash = entry->hash;
+        inline_slot.value = entry->value;
+        slot = &inline_slot;
+    }
+
+    int64_t i = swiss_find_part(&t->cur, entry->hash, entry->key, tagged, false);
+    if (i < 0) {
+        swiss_place(&t->cur, entry->hash, slot, tagged);
+    } else if (tagged) {
+        ((uint64_t *)t->cur.slots)[i] = tagged_slot;
+    } else {
+        ((swiss_slot_t *)t->cur.slots)[i].value = entry->value;
+    }
+}
+
+/* Lookup: value of key in *value, false on a miss */
+INLINE bool swiss_lookup(const swiss_table_t *t, const char *key, int32_t *value,
+                         bool tagged, bool simd)
+{
+    uint32_t hash = djb2_hash(key, HASH_KEY_LEN);
+    const swiss_part_t *p = &t->cur;
+    int64_t i = swiss_find_part(p, hash, key, tagged, simd);
+
+    if (i < 0 && t->old.ctrl) {
+        p = &t->old;
+        i = swiss_find_part(p, hash, key, tagged, simd);
+    }
+    if (i < 0) return false;
+
+    *value = tagged ? tagged_entry(((const uint64_t *)p->slots)[i])->value
+                    : ((const swiss_slot_t *)p->slots)[i].value;
+    return true;
+}
+
+/* ============================================================================
+ * Lookup Engines
+ * ============================================================================ */
+
+static bool lookup_chained(const char *key, int32_t *value)
+{
+    hash_entry_t *entry = hash_lookup(&table, key, HASH_KEY_LEN);
+
+    /* Prevent optimization */
+    BENCH_VOLATILE(entry);
+
+    if (entry) *value = entry->value;
+    return entry != NULL;
+}
+
+#if defined(ARCH_X86_64)
+static bool lookup_swiss_sse2(const char *key, int32_t *value)
+{
+    return swiss_lookup(&swiss_inline, key, value, false, true);
+}
+#endif
+
+static bool lookup_swiss(const char *key, int32_t *value)
+{
+    return swiss_lookup(&swiss_inline, key, value, false, false);
+}
+
+static bool lookup_swiss_tagged(const char *key, int32_t *value)
+{
+    return swiss_lookup(&swiss_tagged, key, value, true, false);
+}
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -162,30 +493,45 @@ static void kernel_init_func(void)
     /* Initialize random seed */
     srand(12345);
 
+    /* Size the table for the current tier */
+    num_buckets = bench_scale(HASH_NUM_BUCKETS);
+    num_entries = bench_scale(HASH_NUM_ENTRIES);
+    buckets = bench_alloc(num_buckets * sizeof(hash_entry_t *));
+    entries = bench_alloc(num_entries * sizeof(hash_entry_t));
+
     /* Initialize hash table */
-    hash_init(&table, buckets, HASH_NUM_BUCKETS);
+    hash_init(&table, buckets, num_buckets);
 
     /* Insert entries with generated keys */
-    for (uint32_t i = 0; i < HASH_NUM_ENTRIES; i++) {
+    for (uint32_t i = 0; i < num_entries; i++) {
         char key[HASH_KEY_LEN];
         generate_key(key, i * 7 + 13);
         hash_insert(&table, &entries[i], key, HASH_KEY_LEN, (int32_t)(i * 100));
     }
 
+    /* Swiss tables over the same entries, grown insert by insert */
+    swiss_create(&swiss_inline, false);
+    swiss_create(&swiss_tagged, true);
+    for (uint32_t i = 0; i < num_entries; i++) {
+        swiss_insert(&swiss_inline, &entries[i], false);
+        swiss_insert(&swiss_tagged, &entries[i], true);
+    }
+
     /* Generate lookup keys (mix of existing and non-existing) */
     for (uint32_t i = 0; i < HASH_NUM_LOOKUPS; i++) {
-        if (i < HASH_NUM_LOOKUPS * 3 / 4) {
-            /* Existing key (75% hit rate) */
-            uint32_t idx = (i * 5) % HASH_NUM_ENTRIES;
+        if (i < HASH_NUM_LOOKUPS * HASH_HIT_PERCENT / 100) {
+            /* Existing key, spread across the scaled table */
+            uint32_t idx = bench_scale(i * 5) % num_entries;
             generate_key(lookup_keys[i], idx * 7 + 13);
         } else {
-            /* Non-existing key (25% miss rate) */
-            generate_key(lookup_keys[i], i * 1000 + 999999);
+            /* Non-existing key: table seeds are all 6 mod 7, these are 3 */
+            generate_key(lookup_keys[i], i * 7 + 10);
         }
     }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; lookup is lookup_chained or one of the variants */
+static bench_result_t hash_run(lookup_func_t lookup)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -195,21 +541,20 @@ static bench_result_t kernel_run_func(void)
     /* Start timing */
     BENCH_START();
 
-    /* Perform lookups */
+    /* Perform lookups (one phase: a lookup is too short to time alone) */
+    BENCH_PHASE_BEGIN(PHASE_LOOKUP);
     for (uint32_t i = 0; i < HASH_NUM_LOOKUPS; i++) {
-        hash_entry_t *entry = hash_lookup(&table, lookup_keys[i], HASH_KEY_LEN);
+        int32_t value;
 
-        if (entry) {
+        if (lookup(lookup_keys[i], &value)) {
             found_count++;
-            value_sum += entry->value;
-            csum = checksum_update(csum, (uint32_t)entry->value);
+            value_sum += value;
+            csum = checksum_update(csum, (uint32_t)value);
         } else {
             csum = checksum_update(csum, 0xFFFFFFFF);
         }
-
-        /* Prevent optimization */
-        BENCH_VOLATILE(entry);
     }
+    BENCH_PHASE_END(PHASE_LOOKUP);
 
     /* End timing */
     BENCH_END();
@@ -224,6 +569,28 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return hash_run(lookup_chained);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_sse2(void)
+{
+    return hash_run(lookup_swiss_sse2);
+}
+#endif
+
+static bench_result_t kernel_run_swiss(void)
+{
+    return hash_run(lookup_swiss);
+}
+
+static bench_result_t kernel_run_swiss_tagged(void)
+{
+    return hash_run(lookup_swiss_tagged);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up (static storage) */
@@ -233,7 +600,17 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t hash_variants[] = {
+#if defined(ARCH_X86_64)
+    { "sse2", ISA_SSE2, kernel_run_sse2 },
+#endif
+    { "swiss", 0, kernel_run_swiss },
+    { "swiss-tagged", 0, kernel_run_swiss_tagged },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     hash_lookup,
     "Hash table lookup (chained)",
     "400.perlbench",
@@ -241,7 +618,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,  /* Checksum computed at runtime */
-    HASH_NUM_LOOKUPS
+    HASH_NUM_LOOKUPS,
+    hash_variants,
+    "lookup"
 );
 
 KERNEL_REGISTER(hash_lookup)
@@ -12,6 +12,7 @@
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * HUFFMAN_SYMBOLS is the tier S alphabet, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef HUFFMAN_SYMBOLS
@@ -26,6 +27,9 @@
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_BUILD, PHASE_LENGTHS, PHASE_LIMIT };
+
 /* Huffman node */
 typedef struct {
     int32_t weight;         /* Symbol frequency or combined weight */
@@ -35,15 +39,28 @@ typedef struct {
     int32_t symbol;         /* Symbol value (for leaves) */
 } huffman_node_t;
 
-/* Static storage */
-static int32_t frequencies[HUFFMAN_SYMBOLS];
-static huffman_node_t nodes[2 * HUFFMAN_SYMBOLS];
-static uint8_t code_lengths[HUFFMAN_SYMBOLS];
-static int32_t heap[HUFFMAN_SYMBOLS + 1];
-static int heap_size;
+/* DFS stack entry for code length computation */
+typedef struct {
+    int32_t node;
+    uint8_t depth;
+} dfs_entry_t;
+
+/* Static storage (arrays are arena-allocated in init) */
+static BENCH_TLS int32_t *frequencies;
+static BENCH_TLS huffman_node_t *nodes;
+static BENCH_TLS uint8_t *code_lengths;
+static BENCH_TLS int32_t *heap;
+static BENCH_TLS dfs_entry_t *dfs_stack;
+static BENCH_TLS int heap_size;
+static BENCH_TLS int alphabet_size;
 
 /* ============================================================================
  * Min-Heap Operations
+ * The heap and node arrays live in the arena, so the loops work on local
+ * copies of the pointers and heap_size: int32_t stores through the arrays
+ * would otherwise force heap_size to be reloaded at every step, which the
+ * fixed static arrays never did. heap_push is forced inline because the
+ * longer preamble otherwise tips GCC into an out-of-line call.
  * ============================================================================ */
 
 static void huffman_heap_init(void)
@@ -51,53 +68,61 @@ static void huffman_heap_init(void)
     heap_size = 0;
 }
 
-static void heap_push(int32_t node_idx, int32_t weight)
+INLINE void heap_push(int32_t node_idx, int32_t weight)
 {
+    int32_t *restrict h = heap;
+    const huffman_node_t *restrict tree = nodes;
+
     /* Insert at end */
     int pos = ++heap_size;
 
     /* Bubble up */
     while (pos > 1) {
         int parent = pos / 2;
-        if (nodes[heap[parent]].weight <= weight) {
+        if (tree[h[parent]].weight <= weight) {
             break;
         }
-        heap[pos] = heap[parent];
+        h[pos] = h[parent];
         pos = parent;
     }
 
-    heap[pos] = node_idx;
+    h[pos] = node_idx;
 }
 
 static int32_t heap_pop(void)
 {
-    if (heap_size == 0) {
+    int32_t *restrict h = heap;
+    const huffman_node_t *restrict tree = nodes;
+    int size = heap_size;
+
+    if (size == 0) {
         return -1;
     }
 
-    int32_t min_node = heap[1];
-    int32_t last = heap[heap_size--];
+    int32_t min_node = h[1];
+    int32_t last = h[size--];
+    heap_size = size;
 
     /* Bubble down */
     int pos = 1;
-    while (pos * 2 <= heap_size) {
+    while (pos * 2 <= size) {
         int child = pos * 2;
 
         /* Find smaller child */
-        if (child < heap_size &&
-            nodes[heap[child + 1]].weight < nodes[heap[child]].weight) {
+        if (child < size &&
+            tree[h[child + 1]].weight < tree[h[child]].weight) {
             child++;
         }
 
-        if (nodes[last].weight <= nodes[heap[child]].weight) {
+        if (tree[last].weight <= tree[h[child]].weight) {
             break;
         }
 
-        heap[pos] = heap[child];
+        h[pos] = h[child];
         pos = child;
     }
 
-    heap[pos] = last;
+    h[pos] = last;
     return min_node;
 }
 
@@ -108,6 +133,7 @@ static int32_t heap_pop(void)
 /* Build Huffman tree and return root index */
 static int32_t huffman_build_tree(const int32_t *freq, int num_symbols)
 {
+    huffman_node_t *tree = nodes;
     int32_t num_nodes = 0;
 
     /* Initialize heap */
@@ -116,11 +142,11 @@ static int32_t huffman_build_tree(const int32_t *freq, int num_symbols)
     /* Create leaf nodes for non-zero frequencies */
     for (int i = 0; i < num_symbols; i++) {
         if (freq[i] > 0) {
-            nodes[num_nodes].weight = freq[i];
-            nodes[num_nodes].parent = -1;
-            nodes[num_nodes].left = -1;
-            nodes[num_nodes].right = -1;
-            nodes[num_nodes].symbol = i;
+            tree[num_nodes].weight = freq[i];
+            tree[num_nodes].parent = -1;
+            tree[num_nodes].left = -1;
+            tree[num_nodes].right = -1;
+            tree[num_nodes].symbol = i;
             heap_push(num_nodes, freq[i]);
             num_nodes++;
         }
@@ -138,16 +164,16 @@ static int32_t huffman_build_tree(const int32_t *freq, int num_symbols)
         int32_t right = heap_pop();
 
         /* Create combined node */
-        int32_t combined_weight = nodes[left].weight + nodes[right].weight;
-        nodes[num_nodes].weight = combined_weight;
-        nodes[num_nodes].parent = -1;
-        nodes[num_nodes].left = left;
-        nodes[num_nodes].right = right;
-        nodes[num_nodes].symbol = -1;
+        int32_t combined_weight = tree[left].weight + tree[right].weight;
+        tree[num_nodes].weight = combined_weight;
+        tree[num_nodes].parent = -1;
+        tree[num_nodes].left = left;
+        tree[num_nodes].right = right;
+        tree[num_nodes].symbol = -1;
 
         /* Set parent pointers */
-        nodes[left].parent = num_nodes;
-        nodes[right].parent = num_nodes;
+        tree[left].parent = num_nodes;
+        tree[right].parent = num_nodes;
 
         /* Insert combined node */
         heap_push(num_nodes, combined_weight);
@@ -158,16 +184,15 @@ static int32_t huffman_build_tree(const int32_t *freq, int num_symbols)
 }
 
 /* Compute code lengths from tree */
-static void compute_code_lengths(int32_t root, uint8_t *lengths, int num_symbols)
+static void compute_code_lengths(int32_t root, uint8_t *restrict lengths, int num_symbols)
 {
     /* Clear lengths */
     memset(lengths, 0, num_symbols);
 
-    /* DFS traversal using stack */
-    struct {
-        int32_t node;
-        uint8_t depth;
-    } stack[HUFFMAN_SYMBOLS * 2];
+    /* DFS traversal using stack; stores to the stack and lengths may alias
+     * the tree and the pointer globals, so use restrict local copies */
+    dfs_entry_t *restrict stack = dfs_stack;
+    const huffman_node_t *restrict tree = nodes;
     int stack_top = 0;
 
     stack[stack_top].node = root;
@@ -179,19 +204,19 @@ static void compute_code_lengths(int32_t root, uint8_t *lengths, int num_symbols
         int32_t node = stack[stack_top].node;
         uint8_t depth = stack[stack_top].depth;
 
-        if (nodes[node].left == -1) {
+        if (tree[node].left == -1) {
             /* Leaf node */
-            int32_t symbol = nodes[node].symbol;
+            int32_t symbol = tree[node].symbol;
             if (symbol >= 0 && symbol < num_symbols) {
                 lengths[symbol] = depth > 0 ? depth : 1;
             }
         } else {
             /* Internal node - push children */
-            stack[stack_top].node = nodes[node].left;
+            stack[stack_top].node = tree[node].left;
             stack[stack_top].depth = depth + 1;
             stack_top++;
 
-            stack[stack_top].node = nodes[node].right;
+            stack[stack_top].node = tree[node].right;
             stack[stack_top].depth = depth + 1;
             stack_top++;
         }
@@ -274,8 +299,15 @@ static void generate_frequencies(int32_t *freq, int num_symbols, uint32_t seed)
 
 static void kernel_init_func(void)
 {
+    alphabet_size = (int)bench_scale(HUFFMAN_SYMBOLS);
+    frequencies = bench_alloc(alphabet_size * sizeof(int32_t));
+    nodes = bench_alloc(2 * alphabet_size * sizeof(huffman_node_t));
+    code_lengths = bench_alloc(alphabet_size);
+    heap = bench_alloc((alphabet_size + 1) * sizeof(int32_t));
+    dfs_stack = bench_alloc(2 * alphabet_size * sizeof(dfs_entry_t));
+
     /* Generate test frequencies */
-    generate_frequencies(frequencies, HUFFMAN_SYMBOLS, 0x12345678);
+    generate_frequencies(frequencies, alphabet_size, 0x12345678);
 }
 
 static bench_result_t kernel_run_func(void)
@@ -286,13 +318,19 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Build Huffman tree */
-    int32_t root = huffman_build_tree(frequencies, HUFFMAN_SYMBOLS);
+    BENCH_PHASE_BEGIN(PHASE_BUILD);
+    int32_t root = huffman_build_tree(frequencies, alphabet_size);
+    BENCH_PHASE_END(PHASE_BUILD);
 
     /* Compute code lengths */
-    compute_code_lengths(root, code_lengths, HUFFMAN_SYMBOLS);
+    BENCH_PHASE_BEGIN(PHASE_LENGTHS);
+    compute_code_lengths(root, code_lengths, alphabet_size);
+    BENCH_PHASE_END(PHASE_LENGTHS);
 
     /* Limit code lengths */
-    limit_code_lengths(code_lengths, HUFFMAN_SYMBOLS, HUFFMAN_MAX_LEN);
+    BENCH_PHASE_BEGIN(PHASE_LIMIT);
+    limit_code_lengths(code_lengths, alphabet_size, HUFFMAN_MAX_LEN);
+    BENCH_PHASE_END(PHASE_LIMIT);
 
     /* End timing */
     BENCH_END();
@@ -301,7 +339,7 @@ static bench_result_t kernel_run_func(void)
     BENCH_VOLATILE(root);
 
     /* Compute checksum of code lengths */
-    uint32_t csum = checksum_buffer(code_lengths, HUFFMAN_SYMBOLS);
+    uint32_t csum = checksum_buffer(code_lengths, alphabet_size);
     csum = checksum_update(csum, (uint32_t)root);
 
     result.cycles = BENCH_CYCLES();
@@ -327,7 +365,8 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    1
+    1,
+    "build_tree", "code_lengths", "limit_lengths"
 );
 
 KERNEL_REGISTER(huffman_tree)
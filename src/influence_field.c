@@ -5,6 +5,10 @@
  * Pattern: Board influence propagation (like Bouzy's algorithm)
  * Memory: 2D grid updates, distance transforms
  * Branch: Territory classification
+ *
+ * The bitboard variant keeps the field bit-sliced: plane k holds bit k of
+ * every point's 8-bit value, so dilation and erosion become shift, mask
+ * and ripple-add operations on whole boards.
  */
 
 #include "bench.h"
@@ -33,6 +37,9 @@
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_GENERATE, PHASE_INFLUENCE, PHASE_TERRITORY, PHASE_MOYO };
+
 #define EMPTY   0
 #define BLACK   1
 #define WHITE   2
@@ -43,7 +50,25 @@ typedef struct {
     int16_t territory[INFLUENCE_BOARD_SIZE][INFLUENCE_BOARD_SIZE];
 } influence_board_t;
 
-static influence_board_t board;
+static BENCH_TLS influence_board_t board;
+
+/* Bitboard: row y at bits y * IF_BB_STRIDE, a guard column per row */
+#define IF_BB_STRIDE    (INFLUENCE_BOARD_SIZE + 1)
+#define IF_BB_WORDS     ((INFLUENCE_BOARD_SIZE * IF_BB_STRIDE + 63) / 64)
+#define IF_PLANES       8       /* Two's complement, values stay in [-127, 127] */
+#define IF_SUM_PLANES   10      /* Dilation sums reach +-(127 + 4 * 63) */
+
+typedef struct {
+    uint64_t w[IF_BB_WORDS];
+} field_bb_t;
+
+typedef struct {
+    field_bb_t black, white;
+    field_bb_t plane[IF_PLANES];
+} field_bits_t;
+
+static BENCH_TLS field_bits_t field;
+static BENCH_TLS field_bb_t field_mask;
 
 /* Direction offsets */
 static const int dx[4] = {0, 1, 0, -1};
@@ -167,6 +192,210 @@ static void compute_influence(influence_board_t *b)
     }
 }
 
+/* ============================================================================
+ * Bit-Sliced Influence Field
+ * ============================================================================ */
+
+INLINE int field_point(int x, int y)
+{
+    return y * IF_BB_STRIDE + x;
+}
+
+/* dst = src moved one point in direction d (dx/dy order), off-board lanes 0 */
+static void field_shift(field_bb_t *dst, const field_bb_t *src, int d)
+{
+    int shift = dx[d] + dy[d] * IF_BB_STRIDE;   /* Point p takes p - shift */
+
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        uint64_t lo = i > 0 ? src->w[i - 1] : 0;
+        uint64_t hi = i + 1 < IF_BB_WORDS ? src->w[i + 1] : 0;
+        uint64_t w;
+        if (shift > 0) {
+            w = (src->w[i] << shift) | (lo >> (64 - shift));
+        } else {
+            w = (src->w[i] >> -shift) | (hi << (64 + shift));
+        }
+        dst->w[i] = w & field_mask.w[i];
+    }
+}
+
+/* Lanes whose unsigned 8-bit value exceeds c */
+static uint64_t field_gt(const field_bb_t *pl, int i, unsigned c)
+{
+    uint64_t gt = 0, eq = ~0ULL;
+    for (int k = IF_PLANES - 1; k >= 0; k--) {
+        if ((c >> k) & 1) {
+            eq &= pl[k].w[i];
+        } else {
+            gt |= eq & pl[k].w[i];
+            eq &= ~pl[k].w[i];
+        }
+    }
+    return gt;
+}
+
+static void field_init(field_bits_t *f, const influence_board_t *b)
+{
+    memset(f, 0, sizeof(*f));
+    for (int y = 0; y < INFLUENCE_BOARD_SIZE; y++) {
+        for (int x = 0; x < INFLUENCE_BOARD_SIZE; x++) {
+            int p = field_point(x, y);
+            if (b->stones[y][x] == BLACK) f->black.w[p >> 6] |= 1ULL << (p & 63);
+            if (b->stones[y][x] == WHITE) f->white.w[p >> 6] |= 1ULL << (p & 63);
+        }
+    }
+
+    /* +64 = 0b01000000, -64 = 0b11000000 */
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        f->plane[6].w[i] = f->black.w[i] | f->white.w[i];
+        f->plane[7].w[i] = f->white.w[i];
+    }
+}
+
+/* dilate_influence: add half of each sign-compatible neighbor, clamp */
+static void field_dilate(field_bits_t *f)
+{
+    field_bb_t n[4][IF_PLANES];
+    for (int d = 0; d < 4; d++) {
+        for (int k = 0; k < IF_PLANES; k++) field_shift(&n[d][k], &f->plane[k], d);
+    }
+
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        uint64_t acc[IF_SUM_PLANES];
+        uint64_t sv = f->plane[IF_PLANES - 1].w[i], nz = 0;
+        for (int k = 0; k < IF_PLANES; k++) {
+            acc[k] = f->plane[k].w[i];
+            nz |= acc[k];
+        }
+        acc[8] = acc[9] = sv;
+        uint64_t nonneg = ~sv, nonpos = sv | ~nz;
+
+        for (int d = 0; d < 4; d++) {
+            uint64_t t[IF_PLANES];
+            uint64_t sn = n[d][IF_PLANES - 1].w[i], nzn = 0;
+            for (int k = 0; k < IF_PLANES; k++) nzn |= n[d][k].w[i];
+            uint64_t compat = (nonneg & ~sn) | (nonpos & (sn | ~nzn));
+
+            /* nval / 2 truncates toward zero: add 1 to negatives, then shift */
+            uint64_t carry = sn;
+            for (int k = 0; k < IF_PLANES; k++) {
+                uint64_t b = n[d][k].w[i];
+                t[k] = b ^ carry;
+                carry &= b;
+            }
+
+            carry = 0;
+            for (int k = 0; k < IF_SUM_PLANES; k++) {
+                uint64_t b = (k + 1 < IF_PLANES ? t[k + 1] : t[IF_PLANES - 1]) & compat;
+                uint64_t a = acc[k];
+                acc[k] = a ^ b ^ carry;
+                carry = (a & b) | (carry & (a ^ b));
+            }
+        }
+
+        /* Clamp to [-127, 127] */
+        uint64_t low7 = 0;
+        for (int k = 0; k < 7; k++) low7 |= acc[k];
+        uint64_t hi = ~acc[9] & (acc[7] | acc[8]);
+        uint64_t lo = acc[9] & ~(acc[8] & acc[7] & low7);
+        uint64_t keep = ~(hi | lo);
+
+        for (int k = 0; k < IF_PLANES; k++) {
+            uint64_t c127 = k < 7 ? hi : 0;                 /* 0b01111111 */
+            uint64_t cm127 = (k == 0 || k == 7) ? lo : 0;   /* 0b10000001 */
+            f->plane[k].w[i] = (acc[k] & keep) | c127 | cm127;
+        }
+    }
+}
+
+/* erode_influence: step toward zero where fewer than 2 neighbors share the sign */
+static void field_erode(field_bits_t *f)
+{
+    field_bb_t pos, neg, np[4], nn[4];
+
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        uint64_t nz = 0;
+        for (int k = 0; k < IF_PLANES; k++) nz |= f->plane[k].w[i];
+        neg.w[i] = f->plane[IF_PLANES - 1].w[i];
+        pos.w[i] = nz & ~neg.w[i];
+    }
+    for (int d = 0; d < 4; d++) {
+        field_shift(&np[d], &pos, d);
+        field_shift(&nn[d], &neg, d);
+    }
+
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        uint64_t a = np[0].w[i], b = np[1].w[i], c = np[2].w[i], d = np[3].w[i];
+        uint64_t pos2 = (a & b) | (c & d) | ((a | b) & (c | d));
+        a = nn[0].w[i]; b = nn[1].w[i]; c = nn[2].w[i]; d = nn[3].w[i];
+        uint64_t neg2 = (a & b) | (c & d) | ((a | b) & (c | d));
+
+        uint64_t dec = pos.w[i] & ~pos2;                /* Add -1 = 0b11111111 */
+        uint64_t inc = neg.w[i] & ~neg2;                /* Add +1 */
+        uint64_t carry = 0;
+        for (int k = 0; k < IF_PLANES; k++) {
+            uint64_t x = f->plane[k].w[i];
+            uint64_t y = k == 0 ? (dec | inc) : dec;
+            f->plane[k].w[i] = x ^ y ^ carry;
+            carry = (x & y) | (carry & (x ^ y));
+        }
+    }
+}
+
+/* Bouzy on the planes, unpacked into b->influence for the checksum */
+static void field_compute(field_bits_t *f, influence_board_t *b)
+{
+    field_init(f, b);
+
+    for (int i = 0; i < INFLUENCE_DILATION; i++) {
+        field_dilate(f);
+    }
+    for (int i = 0; i < INFLUENCE_EROSION; i++) {
+        field_erode(f);
+    }
+
+    for (int y = 0; y < INFLUENCE_BOARD_SIZE; y++) {
+        for (int x = 0; x < INFLUENCE_BOARD_SIZE; x++) {
+            int p = field_point(x, y);
+            int v = 0;
+            for (int k = 0; k < IF_PLANES; k++) {
+                v |= (int)((f->plane[k].w[p >> 6] >> (p & 63)) & 1) << k;
+            }
+            b->influence[y][x] = (int8_t)v;
+        }
+    }
+}
+
+/* estimate_territory's counts: empty points beyond +-10 */
+static void field_territory(const field_bits_t *f, int *black_territory, int *white_territory)
+{
+    *black_territory = 0;
+    *white_territory = 0;
+
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        uint64_t sv = f->plane[IF_PLANES - 1].w[i];
+        uint64_t empty = field_mask.w[i] & ~(f->black.w[i] | f->white.w[i]);
+        *black_territory += __builtin_popcountll(empty & ~sv & field_gt(f->plane, i, 10));
+        *white_territory += __builtin_popcountll(empty & sv & ~field_gt(f->plane, i, 255 - 10));
+    }
+}
+
+/* compute_moyo's regions partition the points beyond the threshold */
+static int field_moyo(const field_bits_t *f, int color)
+{
+    int size = 0;
+
+    for (int i = 0; i < IF_BB_WORDS; i++) {
+        uint64_t sv = f->plane[IF_PLANES - 1].w[i];
+        if (color == BLACK) {
+            size += __builtin_popcountll(~sv & field_gt(f->plane, i, 5));
+        } else {
+            size += __builtin_popcountll(sv & ~field_gt(f->plane, i, 255 - 5));
+        }
+    }
+    return size;
+}
+
 /* ============================================================================
  * Territory Estimation
  * ============================================================================ */
@@ -310,9 +539,20 @@ static void generate_board(influence_board_t *b, uint32_t seed)
 static void kernel_init_func(void)
 {
     memset(&board, 0, sizeof(board));
+    bench_cache_region(&board, sizeof(board));      /* Static boards for --cache=cold */
+    bench_cache_region(&field, sizeof(field));
+
+    memset(&field_mask, 0, sizeof(field_mask));
+    for (int y = 0; y < INFLUENCE_BOARD_SIZE; y++) {
+        for (int x = 0; x < INFLUENCE_BOARD_SIZE; x++) {
+            int p = field_point(x, y);
+            field_mask.w[p >> 6] |= 1ULL << (p & 63);
+        }
+    }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver for the scalar grid and the bit-sliced planes */
+static bench_result_t influence_run(bool bitboard)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -324,20 +564,36 @@ static bench_result_t kernel_run_func(void)
 
     for (int e = 0; e < INFLUENCE_NUM_EVALS; e++) {
         /* Generate board position */
+        BENCH_PHASE_BEGIN(PHASE_GENERATE);
         generate_board(&board, 0x12345678 + e * 1000);
+        BENCH_PHASE_END(PHASE_GENERATE);
 
         /* Compute influence */
-        compute_influence(&board);
+        BENCH_PHASE_BEGIN(PHASE_INFLUENCE);
+        if (bitboard) {
+            field_compute(&field, &board);
+        } else {
+            compute_influence(&board);
+        }
+        BENCH_PHASE_END(PHASE_INFLUENCE);
 
         /* Estimate territory */
         int black_terr, white_terr;
-        estimate_territory(&board, &black_terr, &white_terr);
+        BENCH_PHASE_BEGIN(PHASE_TERRITORY);
+        if (bitboard) {
+            field_territory(&field, &black_terr, &white_terr);
+        } else {
+            estimate_territory(&board, &black_terr, &white_terr);
+        }
+        BENCH_PHASE_END(PHASE_TERRITORY);
         total_black += black_terr;
         total_white += white_terr;
 
         /* Compute moyo */
-        int black_moyo = compute_moyo(&board, BLACK);
-        int white_moyo = compute_moyo(&board, WHITE);
+        BENCH_PHASE_BEGIN(PHASE_MOYO);
+        int black_moyo = bitboard ? field_moyo(&field, BLACK) : compute_moyo(&board, BLACK);
+        int white_moyo = bitboard ? field_moyo(&field, WHITE) : compute_moyo(&board, WHITE);
+        BENCH_PHASE_END(PHASE_MOYO);
 
         /* Update checksum */
         csum = checksum_update(csum, (uint32_t)black_terr);
@@ -367,6 +623,16 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return influence_run(false);
+}
+
+static bench_result_t kernel_run_bitboard(void)
+{
+    return influence_run(true);
+}
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -375,7 +641,13 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t influence_variants[] = {
+    { "bitboard", 0, kernel_run_bitboard },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     influence_field,
     "Territory influence computation",
     "445.gobmk",
@@ -383,7 +655,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    INFLUENCE_NUM_EVALS
+    INFLUENCE_NUM_EVALS,
+    influence_variants,
+    "generate", "influence", "territory", "moyo"
 );
 
 KERNEL_REGISTER(influence_field)
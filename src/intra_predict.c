@@ -9,8 +9,16 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+
 /* ============================================================================
  * Configuration
+ * INTRA_FRAME=1 switches from independent synthetic macroblocks to a
+ * raster scan over one INTRA_FRAME_WIDTH x INTRA_FRAME_HEIGHT frame (tier S,
+ * scaled by bench_scale_dim(); multiples of 16), where every block predicts
+ * from its reconstructed neighbours.
  * ============================================================================ */
 
 #ifndef INTRA_BLOCK_SIZE
@@ -29,10 +37,35 @@
 #define INTRA_NUM_BLOCKS    20
 #endif
 
+#ifndef INTRA_FRAME
+#define INTRA_FRAME         0
+#endif
+
+#ifndef INTRA_FRAME_WIDTH
+#define INTRA_FRAME_WIDTH   64
+#endif
+
+#ifndef INTRA_FRAME_HEIGHT
+#define INTRA_FRAME_HEIGHT  64
+#endif
+
+#ifndef INTRA_RECON_QSTEP
+#define INTRA_RECON_QSTEP   8       /* Residual quantizer step for reconstruction */
+#endif
+
+#if INTRA_FRAME
+  #define INTRA_ITERATIONS  ((INTRA_FRAME_WIDTH / 16) * (INTRA_FRAME_HEIGHT / 16))
+#else
+  #define INTRA_ITERATIONS  INTRA_NUM_BLOCKS
+#endif
+
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_GENERATE, PHASE_16X16, PHASE_4X4 };
+
 /* Prediction modes for 4x4 blocks */
 #define INTRA_4x4_VERTICAL      0
 #define INTRA_4x4_HORIZONTAL    1
@@ -62,9 +95,27 @@ typedef struct {
     uint8_t pixels[INTRA_BLOCK_SIZE][INTRA_BLOCK_SIZE];
 } intra_block_t;
 
-static intra_ref_t ref;
-static intra_block_t pred_block;
-static intra_block_t orig_block;
+/*
+ * Mode search engine: returns the mode with the lowest SAD, ties going to
+ * the lower mode number. 4x4 edges are above[0..5] (above[5] is
+ * above_right[0]), left[0..5] (left[5] repeats left[4]) and above_right[0..3].
+ */
+typedef struct {
+    int (*best_4x4)(const uint8_t orig[4][4], const uint8_t *above,
+                    const uint8_t *left, const uint8_t *above_right);
+    int (*best_16x16)(const intra_block_t *orig, const intra_ref_t *r);
+} intra_engine_t;
+
+static BENCH_TLS intra_ref_t ref;
+static BENCH_TLS intra_block_t pred_block;
+static BENCH_TLS intra_block_t orig_block;
+
+/* Frame mode: source and reconstructed frames, arena-allocated in init */
+static BENCH_TLS intra_block_t recon_block;
+static BENCH_TLS uint8_t *frame_orig;
+static BENCH_TLS uint8_t *frame_recon;
+static BENCH_TLS int frame_width;
+static BENCH_TLS int frame_height;
 
 /* ============================================================================
  * 4x4 Intra Prediction Modes
@@ -151,10 +202,13 @@ static void intra_4x4_diag_down_right(uint8_t pred[4][4], const uint8_t *above,
 static void intra_4x4_vert_right(uint8_t pred[4][4], const uint8_t *above,
                                   const uint8_t *left)
 {
-    uint8_t ref_pixels[10] = {0};  /* Initialize to avoid uninitialized access */
-    for (int i = 0; i < 3; i++) ref_pixels[i] = left[3 - i];
-    ref_pixels[3] = above[0];
-    for (int i = 0; i < 5; i++) ref_pixels[4 + i] = above[i + 1];
+    /* r[-1] = left[4] feeds the 3-tap filter of pixel (0, 3) */
+    uint8_t ref_pixels[11] = {0};  /* Initialize to avoid uninitialized access */
+    uint8_t *r = ref_pixels + 1;
+    r[-1] = left[4];
+    for (int i = 0; i < 3; i++) r[i] = left[3 - i];
+    r[3] = above[0];
+    for (int i = 0; i < 5; i++) r[4 + i] = above[i + 1];
 
     for (int y = 0; y < 4; y++) {
         for (int x = 0; x < 4; x++) {
@@ -162,13 +216,12 @@ static void intra_4x4_vert_right(uint8_t pred[4][4], const uint8_t *above,
             int idx = zy + 3;
             if (idx >= 0 && idx < 9) {
                 if (y == 0 || y == 2) {
-                    pred[y][x] = (ref_pixels[idx] + ref_pixels[idx + 1] + 1) >> 1;
+                    pred[y][x] = (r[idx] + r[idx + 1] + 1) >> 1;
                 } else {
-                    pred[y][x] = (ref_pixels[idx - 1] + 2 * ref_pixels[idx] +
-                                 ref_pixels[idx + 1] + 2) >> 2;
+                    pred[y][x] = (r[idx - 1] + 2 * r[idx] + r[idx + 1] + 2) >> 2;
                 }
             } else {
-                pred[y][x] = ref_pixels[3];
+                pred[y][x] = r[3];
             }
         }
     }
@@ -427,6 +480,361 @@ static int find_best_16x16_mode(const intra_block_t *orig, const intra_ref_t *r)
     return best_mode;
 }
 
+/* Apply one 4x4 mode */
+static void predict_4x4(int mode, uint8_t pred[4][4], const uint8_t *above,
+                        const uint8_t *left, const uint8_t *above_right)
+{
+    switch (mode) {
+    case INTRA_4x4_VERTICAL:
+        intra_4x4_vertical(pred, above);
+        break;
+    case INTRA_4x4_HORIZONTAL:
+        intra_4x4_horizontal(pred, left);
+        break;
+    case INTRA_4x4_DC:
+        intra_4x4_dc(pred, above, left);
+        break;
+    case INTRA_4x4_DIAG_DOWN_LEFT:
+        intra_4x4_diag_down_left(pred, above, above_right);
+        break;
+    case INTRA_4x4_DIAG_DOWN_RIGHT:
+        intra_4x4_diag_down_right(pred, above, left);
+        break;
+    case INTRA_4x4_VERT_RIGHT:
+        intra_4x4_vert_right(pred, above, left);
+        break;
+    case INTRA_4x4_HORIZ_DOWN:
+        intra_4x4_horiz_down(pred, above, left);
+        break;
+    case INTRA_4x4_VERT_LEFT:
+        intra_4x4_vert_left(pred, above, above_right);
+        break;
+    case INTRA_4x4_HORIZ_UP:
+        intra_4x4_horiz_up(pred, left);
+        break;
+    }
+}
+
+/* Apply one 16x16 mode */
+static void predict_16x16(int mode, intra_block_t *pred, const intra_ref_t *r)
+{
+    switch (mode) {
+    case INTRA_16x16_VERTICAL:
+        intra_16x16_vertical(pred, r);
+        break;
+    case INTRA_16x16_HORIZONTAL:
+        intra_16x16_horizontal(pred, r);
+        break;
+    case INTRA_16x16_DC:
+        intra_16x16_dc(pred, r);
+        break;
+    case INTRA_16x16_PLANE:
+        intra_16x16_plane(pred, r);
+        break;
+    }
+}
+
+/* ============================================================================
+ * Early-Termination Search
+ * Modes are tried in order, so a later mode only wins with a strictly lower
+ * SAD: a running SAD that reaches the best so far is abandoned, and a best
+ * SAD of 0 ends the search.
+ * ============================================================================ */
+
+static int sad_4x4_bounded(const uint8_t pred[4][4], const uint8_t orig[4][4], int bound)
+{
+    int sad = 0;
+    for (int y = 0; y < 4 && sad < bound; y++) {
+        for (int x = 0; x < 4; x++) {
+            int diff = pred[y][x] - orig[y][x];
+            sad += (diff < 0) ? -diff : diff;
+        }
+    }
+    return sad;
+}
+
+static int sad_16x16_bounded(const intra_block_t *pred, const intra_block_t *orig, int bound)
+{
+    int sad = 0;
+    for (int y = 0; y < 16 && sad < bound; y++) {
+        for (int x = 0; x < 16; x++) {
+            int diff = pred->pixels[y][x] - orig->pixels[y][x];
+            sad += (diff < 0) ? -diff : diff;
+        }
+    }
+    return sad;
+}
+
+static int find_best_4x4_early(const uint8_t orig[4][4], const uint8_t *above,
+                               const uint8_t *left, const uint8_t *above_right)
+{
+    uint8_t pred[4][4];
+    int best_mode = 0;
+    int best_sad = 0x7FFFFFFF;
+
+    for (int mode = 0; mode < 9 && best_sad > 0; mode++) {
+        predict_4x4(mode, pred, above, left, above_right);
+        int sad = sad_4x4_bounded(pred, orig, best_sad);
+        if (sad < best_sad) {
+            best_sad = sad;
+            best_mode = mode;
+        }
+    }
+
+    return best_mode;
+}
+
+static int find_best_16x16_early(const intra_block_t *orig, const intra_ref_t *r)
+{
+    int best_mode = 0;
+    int best_sad = 0x7FFFFFFF;
+
+    for (int mode = 0; mode < 4 && best_sad > 0; mode++) {
+        predict_16x16(mode, &pred_block, r);
+        int sad = sad_16x16_bounded(&pred_block, orig, best_sad);
+        if (sad < best_sad) {
+            best_sad = sad;
+            best_mode = mode;
+        }
+    }
+
+    return best_mode;
+}
+
+/* ============================================================================
+ * All-Modes SIMD Search (x86-64 SSE4.1)
+ *
+ * Every 4x4 predictor pixel is a copy, 2-tap average or 3-tap filter of one
+ * edge vector X, held in a single register:
+ *
+ *   X = L4 L4 L3 L2 L1 TL A1 A2 A3 A4 A5 AR1 AR2 AR3 AR3 AR3
+ *
+ * (A5 = AR0). The three filtered vectors are built once per block and each
+ * mode is an OR of three pshufb gathers from taps tables built in init;
+ * the 16 pixels of a 4x4 block fit one register, so each SAD is one psadbw.
+ * Horizontal-down and vertical-right read a zero past the edge, reproduced
+ * by two masked copies of X.
+ * ============================================================================ */
+
+#if defined(ARCH_X86_64)
+
+#define TAP_NONE    0x80            /* pshufb index that yields 0 */
+
+/* Per mode, per pixel: index into X, avg2(X) or low3(X) (TAP_NONE elsewhere) */
+typedef struct {
+    uint8_t copy[16];
+    uint8_t avg2[16];               /* (X[i] + X[i+1] + 1) >> 1 */
+    uint8_t low3[16];               /* (X[i-1] + 2 X[i] + X[i+1] + 2) >> 2 */
+} intra_taps_t;
+
+static BENCH_TLS intra_taps_t mode_taps[INTRA_NUM_MODES_4x4] ALIGNED(16);
+
+/* Mirrors the index arithmetic of the intra_4x4_* predictors, rebased onto X */
+static void build_mode_taps(void)
+{
+    memset(mode_taps, TAP_NONE, sizeof(mode_taps));
+
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int p = y * 4 + x;
+            int idx;
+
+            mode_taps[INTRA_4x4_VERTICAL].copy[p] = (uint8_t)(6 + x);
+            mode_taps[INTRA_4x4_HORIZONTAL].copy[p] = (uint8_t)(4 - y);
+
+            if (x + y < 6) {
+                mode_taps[INTRA_4x4_DIAG_DOWN_LEFT].low3[p] = (uint8_t)(7 + x + y);
+            } else {
+                mode_taps[INTRA_4x4_DIAG_DOWN_LEFT].copy[p] = 13;
+            }
+
+            mode_taps[INTRA_4x4_DIAG_DOWN_RIGHT].low3[p] = (uint8_t)(5 + x - y);
+
+            idx = 2 * x - y + 3;
+            if (idx < 9) {
+                if (y & 1) mode_taps[INTRA_4x4_VERT_RIGHT].low3[p] = (uint8_t)(idx + 2);
+                else       mode_taps[INTRA_4x4_VERT_RIGHT].avg2[p] = (uint8_t)(idx + 2);
+            } else {
+                mode_taps[INTRA_4x4_VERT_RIGHT].copy[p] = 5;
+            }
+
+            idx = 2 * y - x + 4;
+            if (idx < 9) {
+                if (x & 1) mode_taps[INTRA_4x4_HORIZ_DOWN].low3[p] = (uint8_t)(idx + 1);
+                else       mode_taps[INTRA_4x4_HORIZ_DOWN].avg2[p] = (uint8_t)(idx + 1);
+            } else {
+                mode_taps[INTRA_4x4_HORIZ_DOWN].copy[p] = 5;
+            }
+
+            idx = x + (y >> 1);
+            if (y & 1) mode_taps[INTRA_4x4_VERT_LEFT].low3[p] = (uint8_t)(7 + idx);
+            else       mode_taps[INTRA_4x4_VERT_LEFT].avg2[p] = (uint8_t)(6 + idx);
+
+            idx = y + (x >> 1);
+            if (idx < 3) {
+                if (x & 1) mode_taps[INTRA_4x4_HORIZ_UP].low3[p] = (uint8_t)(3 - idx);
+                else       mode_taps[INTRA_4x4_HORIZ_UP].avg2[p] = (uint8_t)(3 - idx);
+            } else {
+                mode_taps[INTRA_4x4_HORIZ_UP].copy[p] = 1;
+            }
+        }
+    }
+}
+
+__attribute__((target("sse4.1")))
+static inline int sad_16b(__m128i a, __m128i b)
+{
+    __m128i s = _mm_sad_epu8(a, b);
+    return _mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i avg2_16b(__m128i x)
+{
+    return _mm_avg_epu8(x, _mm_srli_si128(x, 1));
+}
+
+/* Exact (a + 2b + c + 2) >> 2 from two rounding averages */
+__attribute__((target("sse4.1")))
+static inline __m128i low3_16b(__m128i x)
+{
+    __m128i prev = _mm_slli_si128(x, 1);
+    __m128i next = _mm_srli_si128(x, 1);
+    __m128i ac = _mm_sub_epi8(_mm_avg_epu8(prev, next),
+                              _mm_and_si128(_mm_xor_si128(prev, next), _mm_set1_epi8(1)));
+    return _mm_avg_epu8(ac, x);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i taps_predict(const intra_taps_t *t, __m128i x, __m128i f2, __m128i f3)
+{
+    __m128i p = _mm_shuffle_epi8(x, _mm_load_si128((const __m128i *)t->copy));
+    p = _mm_or_si128(p, _mm_shuffle_epi8(f2, _mm_load_si128((const __m128i *)t->avg2)));
+    return _mm_or_si128(p, _mm_shuffle_epi8(f3, _mm_load_si128((const __m128i *)t->low3)));
+}
+
+__attribute__((target("sse4.1")))
+static int find_best_4x4_sse41(const uint8_t orig[4][4], const uint8_t *above,
+                               const uint8_t *left, const uint8_t *above_right)
+{
+    __m128i o = _mm_loadu_si128((const __m128i *)orig);
+    __m128i x = _mm_setr_epi8(
+        (char)left[4], (char)left[4], (char)left[3], (char)left[2], (char)left[1],
+        (char)above[0], (char)above[1], (char)above[2], (char)above[3], (char)above[4],
+        (char)above_right[0], (char)above_right[1], (char)above_right[2],
+        (char)above_right[3], (char)above_right[3], (char)above_right[3]);
+    int sad[INTRA_NUM_MODES_4x4];
+
+    /* Copy modes and DC need no filtering */
+    sad[INTRA_4x4_VERTICAL] = sad_16b(_mm_shuffle_epi8(x,
+        _mm_load_si128((const __m128i *)mode_taps[INTRA_4x4_VERTICAL].copy)), o);
+    sad[INTRA_4x4_HORIZONTAL] = sad_16b(_mm_shuffle_epi8(x,
+        _mm_load_si128((const __m128i *)mode_taps[INTRA_4x4_HORIZONTAL].copy)), o);
+
+    /* DC: sum L4..L1 (lanes 1-4) and A1..A4 (lanes 6-9) */
+    __m128i dc_lanes = _mm_and_si128(x, _mm_setr_epi8(0, -1, -1, -1, -1, 0, -1, -1,
+                                                      -1, -1, 0, 0, 0, 0, 0, 0));
+    __m128i dc_sum = _mm_sad_epu8(dc_lanes, _mm_setzero_si128());
+    int dc = (_mm_cvtsi128_si32(dc_sum) + _mm_extract_epi16(dc_sum, 4) + 4) >> 3;
+    sad[INTRA_4x4_DC] = sad_16b(_mm_set1_epi8((char)dc), o);
+
+    int best_mode = 0;
+    for (int mode = 1; mode <= INTRA_4x4_DC; mode++) {
+        if (sad[mode] < sad[best_mode]) best_mode = mode;
+    }
+    if (sad[best_mode] == 0) return best_mode;
+
+    /* Directional modes */
+    __m128i f2 = avg2_16b(x);
+    __m128i f3 = low3_16b(x);
+    __m128i f2_hd = avg2_16b(_mm_and_si128(x, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                                            -1, -1, 0, 0, 0, 0, 0, 0)));
+    __m128i f3_vr = low3_16b(_mm_and_si128(x, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                                            -1, -1, -1, 0, 0, 0, 0, 0)));
+
+    sad[INTRA_4x4_DIAG_DOWN_LEFT]  = sad_16b(taps_predict(&mode_taps[INTRA_4x4_DIAG_DOWN_LEFT], x, f2, f3), o);
+    sad[INTRA_4x4_DIAG_DOWN_RIGHT] = sad_16b(taps_predict(&mode_taps[INTRA_4x4_DIAG_DOWN_RIGHT], x, f2, f3), o);
+    sad[INTRA_4x4_VERT_RIGHT]      = sad_16b(taps_predict(&mode_taps[INTRA_4x4_VERT_RIGHT], x, f2, f3_vr), o);
+    sad[INTRA_4x4_HORIZ_DOWN]      = sad_16b(taps_predict(&mode_taps[INTRA_4x4_HORIZ_DOWN], x, f2_hd, f3), o);
+    sad[INTRA_4x4_VERT_LEFT]       = sad_16b(taps_predict(&mode_taps[INTRA_4x4_VERT_LEFT], x, f2, f3), o);
+    sad[INTRA_4x4_HORIZ_UP]        = sad_16b(taps_predict(&mode_taps[INTRA_4x4_HORIZ_UP], x, f2, f3), o);
+
+    for (int mode = INTRA_4x4_DC + 1; mode < INTRA_NUM_MODES_4x4; mode++) {
+        if (sad[mode] < sad[best_mode]) best_mode = mode;
+    }
+    return best_mode;
+}
+
+/*
+ * 16x16: one psadbw per row, predictions generated a row at a time; the
+ * running SAD is checked against the best every four rows. Plane values
+ * stay within int16 (|a + b(x-7) + c(y-7)| < 2^15), and packus does the clamp.
+ */
+__attribute__((target("sse4.1")))
+static int find_best_16x16_sse41(const intra_block_t *orig, const intra_ref_t *r)
+{
+    __m128i rows[16];
+    for (int y = 0; y < 16; y++) {
+        rows[y] = _mm_loadu_si128((const __m128i *)orig->pixels[y]);
+    }
+
+    int sum = 0;
+    int H = 0, V = 0;
+    for (int i = 1; i <= 16; i++) sum += r->above[i] + r->left[i];
+    for (int i = 1; i <= 8; i++) {
+        H += i * (r->above[8 + i] - r->above[8 - i]);
+        V += i * (r->left[8 + i] - r->left[8 - i]);
+    }
+    int a = 16 * (r->above[16] + r->left[16]);
+    int b = (5 * H + 32) >> 6;
+    int c = (5 * V + 32) >> 6;
+
+    __m128i vert = _mm_loadu_si128((const __m128i *)&r->above[1]);
+    __m128i dc = _mm_set1_epi8((char)((sum + 16) >> 5));
+    __m128i ramp = _mm_setr_epi16(-7, -6, -5, -4, -3, -2, -1, 0);
+    __m128i plane_lo = _mm_add_epi16(_mm_set1_epi16((short)(a + 16)),
+                                     _mm_mullo_epi16(ramp, _mm_set1_epi16((short)b)));
+    __m128i plane_hi = _mm_add_epi16(plane_lo, _mm_set1_epi16((short)(8 * b)));
+
+    int best_mode = 0;
+    int best_sad = 0x7FFFFFFF;
+
+    for (int mode = 0; mode < 4 && best_sad > 0; mode++) {
+        int sad = 0;
+        for (int y = 0; y < 16 && sad < best_sad; y += 4) {
+            for (int k = y; k < y + 4; k++) {
+                __m128i p;
+                switch (mode) {
+                case INTRA_16x16_VERTICAL:
+                    p = vert;
+                    break;
+                case INTRA_16x16_HORIZONTAL:
+                    p = _mm_set1_epi8((char)r->left[k + 1]);
+                    break;
+                case INTRA_16x16_DC:
+                    p = dc;
+                    break;
+                default: {
+                    __m128i cy = _mm_set1_epi16((short)(c * (k - 7)));
+                    p = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(plane_lo, cy), 5),
+                                         _mm_srai_epi16(_mm_add_epi16(plane_hi, cy), 5));
+                    break;
+                }
+                }
+                sad += sad_16b(p, rows[k]);
+            }
+        }
+        if (sad < best_sad) {
+            best_sad = sad;
+            best_mode = mode;
+        }
+    }
+
+    return best_mode;
+}
+
+#endif /* ARCH_X86_64 */
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -467,54 +875,151 @@ static void generate_test_block(intra_block_t *block, intra_ref_t *r, uint32_t s
     }
 }
 
+/* ============================================================================
+ * Frame Mode
+ * Macroblocks are coded in raster order; each one takes its orig pixels from
+ * frame_orig and its edges from already reconstructed pixels in frame_recon
+ * (128 outside the frame), and its 4x4 sub-blocks predict from each other's
+ * reconstruction, as in the encoder.
+ * ============================================================================ */
+
+static void generate_frame(uint32_t seed)
+{
+    uint32_t x = seed;
+
+    /* Gradients with diagonal texture, plus noise */
+    for (int y = 0; y < frame_height; y++) {
+        for (int i = 0; i < frame_width; i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            int base = 64 + ((i * 3 + y * 2) & 127);
+            int stripe = (((i + y) >> 2) & 1) ? 24 : 0;
+            int val = base + stripe + (int)(x % 16) - 8;
+            if (val < 0) val = 0;
+            if (val > 255) val = 255;
+            frame_orig[y * frame_width + i] = (uint8_t)val;
+        }
+    }
+}
+
+static void load_macroblock(int mb, intra_block_t *block, intra_ref_t *r)
+{
+    int mbs_x = frame_width / 16;
+    int x0 = (mb % mbs_x) * 16;
+    int y0 = (mb / mbs_x) * 16;
+    const uint8_t *recon = frame_recon;
+
+    for (int y = 0; y < 16; y++) {
+        memcpy(block->pixels[y], &frame_orig[(y0 + y) * frame_width + x0], 16);
+    }
+
+    for (int i = 1; i <= 16; i++) {
+        r->above[i] = y0 > 0 ? recon[(y0 - 1) * frame_width + x0 + i - 1] : 128;
+        r->left[i] = x0 > 0 ? recon[(y0 + i - 1) * frame_width + x0 - 1] : 128;
+    }
+    if (y0 > 0 && x0 > 0) {
+        r->above[0] = recon[(y0 - 1) * frame_width + x0 - 1];
+    } else {
+        r->above[0] = y0 > 0 ? r->above[1] : r->left[1];
+    }
+    r->left[0] = r->above[0];
+}
+
+static void store_macroblock(int mb, const intra_block_t *block)
+{
+    int mbs_x = frame_width / 16;
+    int x0 = (mb % mbs_x) * 16;
+    int y0 = (mb / mbs_x) * 16;
+
+    for (int y = 0; y < 16; y++) {
+        memcpy(&frame_recon[(y0 + y) * frame_width + x0], block->pixels[y], 16);
+    }
+}
+
+/* Prediction plus the residual rounded to INTRA_RECON_QSTEP */
+static void reconstruct_4x4(intra_block_t *recon, int by, int bx,
+                            const uint8_t pred[4][4], const uint8_t orig[4][4])
+{
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int diff = orig[y][x] - pred[y][x];
+            int q = (diff < 0 ? diff - INTRA_RECON_QSTEP / 2 : diff + INTRA_RECON_QSTEP / 2) /
+                    INTRA_RECON_QSTEP;
+            int val = pred[y][x] + q * INTRA_RECON_QSTEP;
+            if (val < 0) val = 0;
+            if (val > 255) val = 255;
+            recon->pixels[by * 4 + y][bx * 4 + x] = (uint8_t)val;
+        }
+    }
+}
+
 /* ============================================================================
  * Kernel Implementation
  * ============================================================================ */
 
+static const intra_engine_t engine_ref = { find_best_4x4_mode, find_best_16x16_mode };
+static const intra_engine_t engine_early = { find_best_4x4_early, find_best_16x16_early };
+#if defined(ARCH_X86_64)
+static const intra_engine_t engine_sse41 = { find_best_4x4_sse41, find_best_16x16_sse41 };
+#endif
+
 static void kernel_init_func(void)
 {
     memset(&ref, 0, sizeof(ref));
     memset(&pred_block, 0, sizeof(pred_block));
     memset(&orig_block, 0, sizeof(orig_block));
+    memset(&recon_block, 0, sizeof(recon_block));
+
+#if defined(ARCH_X86_64)
+    build_mode_taps();
+#endif
+
+    if (INTRA_FRAME) {
+        frame_width = (int)bench_scale_dim(INTRA_FRAME_WIDTH);
+        frame_height = (int)bench_scale_dim(INTRA_FRAME_HEIGHT);
+        frame_orig = bench_alloc(frame_width * frame_height);
+        frame_recon = bench_alloc(frame_width * frame_height);
+        generate_frame(0x12345678);
+    }
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared macroblock loop; engines differ only in how they pick modes */
+static bench_result_t intra_search(const intra_engine_t *engine)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
     int total_sad_4x4 = 0;
     int total_sad_16x16 = 0;
     int mode_counts[13] = {0};  /* 9 for 4x4, 4 for 16x16 */
+    int num_blocks = INTRA_FRAME ? (frame_width / 16) * (frame_height / 16) : INTRA_NUM_BLOCKS;
+
+    /* 4x4 edges come from what the decoder would see */
+    const intra_block_t *edges = INTRA_FRAME ? &recon_block : &orig_block;
 
     /* Start timing */
     BENCH_START();
 
-    for (int b = 0; b < INTRA_NUM_BLOCKS; b++) {
+    for (int b = 0; b < num_blocks; b++) {
         /* Generate test block */
-        generate_test_block(&orig_block, &ref, 0x12345678 + b * 1000);
+        BENCH_PHASE_BEGIN(PHASE_GENERATE);
+        if (INTRA_FRAME) {
+            load_macroblock(b, &orig_block, &ref);
+        } else {
+            generate_test_block(&orig_block, &ref, 0x12345678 + b * 1000);
+        }
+        BENCH_PHASE_END(PHASE_GENERATE);
 
         /* 16x16 mode selection */
-        int best_16x16 = find_best_16x16_mode(&orig_block, &ref);
+        BENCH_PHASE_BEGIN(PHASE_16X16);
+        int best_16x16 = engine->best_16x16(&orig_block, &ref);
         mode_counts[9 + best_16x16]++;
 
         /* Apply best 16x16 prediction */
-        switch (best_16x16) {
-        case INTRA_16x16_VERTICAL:
-            intra_16x16_vertical(&pred_block, &ref);
-            break;
-        case INTRA_16x16_HORIZONTAL:
-            intra_16x16_horizontal(&pred_block, &ref);
-            break;
-        case INTRA_16x16_DC:
-            intra_16x16_dc(&pred_block, &ref);
-            break;
-        case INTRA_16x16_PLANE:
-            intra_16x16_plane(&pred_block, &ref);
-            break;
-        }
+        predict_16x16(best_16x16, &pred_block, &ref);
         total_sad_16x16 += calc_sad_16x16(&pred_block, &orig_block);
+        BENCH_PHASE_END(PHASE_16X16);
 
         /* 4x4 mode selection for each sub-block */
+        BENCH_PHASE_BEGIN(PHASE_4X4);
         for (int by = 0; by < 4; by++) {
             for (int bx = 0; bx < 4; bx++) {
                 /* Extract 4x4 sub-block */
@@ -526,7 +1031,7 @@ static bench_result_t kernel_run_func(void)
                 }
 
                 /* Build local reference */
-                uint8_t local_above[5], local_left[5], local_above_right[4];
+                uint8_t local_above[6], local_left[6], local_above_right[4];
 
                 if (by == 0) {
                     for (int i = 0; i < 5; i++) {
@@ -534,9 +1039,9 @@ static bench_result_t kernel_run_func(void)
                     }
                 } else {
                     local_above[0] = (bx == 0) ? ref.left[by * 4] :
-                                     orig_block.pixels[by * 4 - 1][bx * 4 - 1];
+                                     edges->pixels[by * 4 - 1][bx * 4 - 1];
                     for (int i = 0; i < 4; i++) {
-                        local_above[i + 1] = orig_block.pixels[by * 4 - 1][bx * 4 + i];
+                        local_above[i + 1] = edges->pixels[by * 4 - 1][bx * 4 + i];
                     }
                 }
 
@@ -546,9 +1051,9 @@ static bench_result_t kernel_run_func(void)
                     }
                 } else {
                     local_left[0] = (by == 0) ? ref.above[bx * 4] :
-                                    orig_block.pixels[by * 4 - 1][bx * 4 - 1];
+                                    edges->pixels[by * 4 - 1][bx * 4 - 1];
                     for (int i = 0; i < 4; i++) {
-                        local_left[i + 1] = orig_block.pixels[by * 4 + i][bx * 4 - 1];
+                        local_left[i + 1] = edges->pixels[by * 4 + i][bx * 4 - 1];
                     }
                 }
 
@@ -559,7 +1064,7 @@ static bench_result_t kernel_run_func(void)
                     }
                 } else if (by > 0 && bx < 3) {
                     for (int i = 0; i < 4; i++) {
-                        local_above_right[i] = orig_block.pixels[by * 4 - 1][(bx + 1) * 4 + i];
+                        local_above_right[i] = edges->pixels[by * 4 - 1][(bx + 1) * 4 + i];
                     }
                 } else {
                     for (int i = 0; i < 4; i++) {
@@ -567,46 +1072,30 @@ static bench_result_t kernel_run_func(void)
                     }
                 }
 
-                int best_4x4 = find_best_4x4_mode(sub_orig, local_above,
-                                                  local_left, local_above_right);
+                /* Edge extensions read by vertical-right and horizontal-up */
+                local_above[5] = local_above_right[0];
+                local_left[5] = local_left[4];
+
+                int best_4x4 = engine->best_4x4(sub_orig, local_above,
+                                                local_left, local_above_right);
                 mode_counts[best_4x4]++;
 
                 /* Calculate SAD for best 4x4 mode */
                 uint8_t pred_4x4[4][4];
-                switch (best_4x4) {
-                case INTRA_4x4_VERTICAL:
-                    intra_4x4_vertical(pred_4x4, local_above);
-                    break;
-                case INTRA_4x4_HORIZONTAL:
-                    intra_4x4_horizontal(pred_4x4, local_left);
-                    break;
-                case INTRA_4x4_DC:
-                    intra_4x4_dc(pred_4x4, local_above, local_left);
-                    break;
-                case INTRA_4x4_DIAG_DOWN_LEFT:
-                    intra_4x4_diag_down_left(pred_4x4, local_above, local_above_right);
-                    break;
-                case INTRA_4x4_DIAG_DOWN_RIGHT:
-                    intra_4x4_diag_down_right(pred_4x4, local_above, local_left);
-                    break;
-                case INTRA_4x4_VERT_RIGHT:
-                    intra_4x4_vert_right(pred_4x4, local_above, local_left);
-                    break;
-                case INTRA_4x4_HORIZ_DOWN:
-                    intra_4x4_horiz_down(pred_4x4, local_above, local_left);
-                    break;
-                case INTRA_4x4_VERT_LEFT:
-                    intra_4x4_vert_left(pred_4x4, local_above, local_above_right);
-                    break;
-                case INTRA_4x4_HORIZ_UP:
-                    intra_4x4_horiz_up(pred_4x4, local_left);
-                    break;
-                }
+                predict_4x4(best_4x4, pred_4x4, local_above, local_left, local_above_right);
                 total_sad_4x4 += calc_sad_4x4(pred_4x4, sub_orig);
 
+                if (INTRA_FRAME) {
+                    reconstruct_4x4(&recon_block, by, bx, pred_4x4, sub_orig);
+                }
+
                 csum = checksum_update(csum, (uint32_t)best_4x4);
             }
         }
+        if (INTRA_FRAME) {
+            store_macroblock(b, &recon_block);
+        }
+        BENCH_PHASE_END(PHASE_4X4);
 
         csum = checksum_update(csum, (uint32_t)best_16x16);
     }
@@ -620,6 +1109,9 @@ static bench_result_t kernel_run_func(void)
     for (int i = 0; i < 13; i++) {
         csum = checksum_update(csum, (uint32_t)mode_counts[i]);
     }
+    if (INTRA_FRAME) {
+        csum = checksum_update(csum, checksum_buffer(frame_recon, frame_width * frame_height));
+    }
 
     BENCH_VOLATILE(total_sad_4x4);
 
@@ -629,6 +1121,23 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return intra_search(&engine_ref);
+}
+
+static bench_result_t kernel_run_early(void)
+{
+    return intra_search(&engine_early);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_sse41(void)
+{
+    return intra_search(&engine_sse41);
+}
+#endif
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -637,7 +1146,16 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t intra_variants[] = {
+#if defined(ARCH_X86_64)
+    { "sse4.1", ISA_SSE41, kernel_run_sse41 },
+#endif
+    { "early", 0, kernel_run_early },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     intra_predict,
     "H.264 intra prediction",
     "464.h264ref",
@@ -645,7 +1163,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    INTRA_NUM_BLOCKS
+    INTRA_ITERATIONS,
+    intra_variants,
+    "generate", "mode_16x16", "mode_4x4"
 );
 
 KERNEL_REGISTER(intra_predict)
@@ -15,11 +15,26 @@ static output_format_t output_format = OUTPUT_HUMAN;
 /* Summary statistics */
 static bench_stats_t all_stats[MAX_KERNELS];
 static int stats_count = 0;
+static bool summary_median = false;     /* Score from medians (--median) */
+
+/* Working-set tier */
+bench_tier_t bench_tier = TIER_S;
+
+/* Phase timers (bench.h), per rate-mode copy */
+BENCH_TLS bench_phase_t bench_phase_table[BENCH_MAX_PHASES];
+BENCH_TLS int bench_phase_current = -1;
+
+/* Kernel arena (one per rate-mode copy) */
+static BENCH_TLS uint8_t *arena_base = NULL;
+static BENCH_TLS size_t arena_size = 0;
+static BENCH_TLS size_t arena_used = 0;
 
 /* ============================================================================
  * Base Cycle Counts for SPECInt2006 Score Calculation
  * Score = BASE_CYCLE / actual_cycles (score of 1.0 when cycles == BASE_CYCLE)
  * Values from BASE_CYCLE.txt, stored as integer * 100 for precision
+ * Groups whose reference workload changed are rescaled by the measured
+ * new/old group cycles (x86-64, tier S), keeping their score comparable
  * ============================================================================ */
 typedef struct {
     const char *benchmark;
@@ -29,16 +44,16 @@ typedef struct {
 static const benchmark_base_t base_cycles[] = {
     { "400.perlbench",    76896437 },  /* 768964.37 */
     { "401.bzip2",       250882020 },  /* 2508820.2 */
-    { "403.gcc",         375198808 },  /* 3751988.08 */
-    { "429.mcf",           7163965 },  /* 71639.65 */
-    { "445.gobmk",       752228100 },  /* 7522281 */
-    { "456.hmmer",       755623794 },  /* 7556237.94 */
-    { "458.sjeng",          103360 },  /* 1033.6 */
+    { "403.gcc",         176532697 },  /* 1765326.97 = 3751988.08 x 1.0041 x 0.4686 (tree_walk, ssa_dataflow) */
+    { "429.mcf",         824417994 },  /* 8244179.94 = 71639.65 x 115.0785 (graph_simplex) */
+    { "445.gobmk",       752447523 },  /* 7524475.23 = 7522281 x 1.0003 (go_liberty) */
+    { "456.hmmer",       874066626 },  /* 8740666.26 = 7556237.94 x 1.1567 (viterbi_hmm) */
+    { "458.sjeng",       489202880 },  /* 4892028.80 = 1033.6 x 4733 (game_tree) */
     { "462.libquantum",  331920736 },  /* 3319207.36 */
     { "464.h264ref",     448875792 },  /* 4488757.92 */
-    { "471.omnetpp",     172806876 },  /* 1728068.76 */
+    { "471.omnetpp",     233257897 },  /* 2332578.97 = 1728068.76 x 1.3498 (priority_queue) */
     { "473.astar",      2553353913 },  /* 25533539.13 */
-    { "483.xalancbmk",    29604689 },  /* 296046.89 */
+    { "483.xalancbmk",   237004770 },  /* 2370047.70 = 296046.89 x 8.0056 (xpath_eval) */
     { NULL, 0 }
 };
 #define NUM_BENCHMARKS 12
@@ -85,6 +100,103 @@ int kernel_count(void)
     return num_kernels;
 }
 
+/* ============================================================================
+ * Working-Set Tiers and Kernel Arena
+ * ============================================================================ */
+
+static const char *const tier_names[TIER_COUNT] = { "S", "M", "L", "XL" };
+
+const char *bench_tier_name(bench_tier_t tier)
+{
+    return tier < TIER_COUNT ? tier_names[tier] : "?";
+}
+
+static void arena_setup(void)
+{
+#ifdef NATIVE_BUILD
+    /* Pages are only committed when a tier actually touches them */
+    arena_base = malloc(BENCH_ARENA_SIZE);
+    arena_size = arena_base ? BENCH_ARENA_SIZE : 0;
+#else
+    /* Rate-mode copies split the AM heap evenly */
+    size_t heap_size = (size_t)((uint8_t *)heap.end - (uint8_t *)heap.start);
+    arena_size = (heap_size / bench_copies) & ~(size_t)(BENCH_ARENA_ALIGN - 1);
+    arena_base = (uint8_t *)heap.start + bench_copy_id * arena_size;
+#endif
+}
+
+/*
+ * Allocate zeroed, cache-line aligned kernel storage
+ * Kernels cannot recover from a short arena, so exhaustion is fatal.
+ */
+void *bench_alloc(size_t size)
+{
+    if (!arena_base) {
+        arena_setup();
+    }
+
+    uintptr_t base = (uintptr_t)arena_base;
+    size_t offset = ((base + arena_used + BENCH_ARENA_ALIGN - 1) & ~(uintptr_t)(BENCH_ARENA_ALIGN - 1)) - base;
+
+    if (!arena_base || size > arena_size || offset > arena_size - size) {
+        printf("Kernel arena exhausted: %lu bytes requested, %lu of %lu used (tier %s)\n",
+               (unsigned long)size, (unsigned long)arena_used, (unsigned long)arena_size,
+               bench_tier_name(bench_tier));
+#ifdef NATIVE_BUILD
+        exit(1);
+#else
+        halt(1);
+#endif
+    }
+
+    void *ptr = arena_base + offset;
+    memset(ptr, 0, size);
+    arena_used = offset + size;
+
+    return ptr;
+}
+
+/*
+ * A tier-scaled count that does not fit an int can never be allocated, so
+ * report it the way bench_alloc reports exhaustion instead of wrapping
+ */
+void bench_scale_overflow(uint32_t base, unsigned shift)
+{
+    printf("Kernel arena exhausted: %lu << %u elements requested (tier %s)\n",
+           (unsigned long)base, shift, bench_tier_name(bench_tier));
+#ifdef NATIVE_BUILD
+    exit(1);
+#else
+    halt(1);
+#endif
+}
+
+/*
+ * Release all kernel storage (called before each kernel's init)
+ */
+void bench_arena_reset(void)
+{
+    arena_used = 0;
+}
+
+size_t bench_arena_used(void)
+{
+    return arena_used;
+}
+
+uint8_t *bench_arena_base(void)
+{
+    if (!arena_base) {
+        arena_setup();
+    }
+    return arena_base;
+}
+
+size_t bench_arena_size(void)
+{
+    return arena_size;
+}
+
 /*
  * Set output format
  */
@@ -93,6 +205,352 @@ void bench_set_output_format(output_format_t format)
     output_format = format;
 }
 
+/* ============================================================================
+ * Run Statistics
+ * ============================================================================ */
+
+/* Two-sided 95% Student t critical values x1000 for df = 1..30 */
+static const uint16_t t95_x1000[30] = {
+    12706, 4303, 3182, 2776, 2571, 2447, 2365, 2306, 2262, 2228,
+     2201, 2179, 2160, 2145, 2131, 2120, 2110, 2101, 2093, 2086,
+     2080, 2074, 2069, 2064, 2060, 2056, 2052, 2048, 2045, 2042
+};
+
+static uint32_t t95(int df)
+{
+    if (df < 1) return 0;
+    if (df <= 30) return t95_x1000[df - 1];
+    if (df <= 40) return 2021;
+    if (df <= 60) return 2000;
+    return 1980;
+}
+
+static uint64_t isqrt64(uint64_t x)
+{
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= r + bit) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+/*
+ * Fill in median, stddev and 95% CI half-width from the kept samples
+ * (integer-only so it runs the same on bare metal)
+ */
+static void calc_sample_stats(bench_stats_t *stats)
+{
+    int n = stats->num_samples;
+    uint64_t sorted[BENCH_MAX_SAMPLES];
+    uint64_t sum = 0;
+
+    stats->cycles_median = 0;
+    stats->cycles_stddev = 0;
+    stats->cycles_ci95 = 0;
+    if (n == 0) return;
+
+    /* Insertion sort, n <= BENCH_MAX_SAMPLES */
+    for (int i = 0; i < n; i++) {
+        uint64_t v = stats->samples[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+        sum += v;
+    }
+
+    stats->cycles_median = (n & 1) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+    uint64_t mean = sum / n;
+    if (n >= 2) {
+        /* Each term is divided before summing so the total stays below max(d)^2 */
+        uint64_t var = 0;
+        for (int i = 0; i < n; i++) {
+            uint64_t d = sorted[i] > mean ? sorted[i] - mean : mean - sorted[i];
+            var += d * d / (n - 1);
+        }
+        stats->cycles_stddev = isqrt64(var);
+        /* t * s / sqrt(n), with t and sqrt(n) both scaled by 1000 */
+        stats->cycles_ci95 = t95(n - 1) * stats->cycles_stddev / isqrt64((uint64_t)n * 1000000);
+    }
+}
+
+/*
+ * CI half-width relative to the mean, in percent x100
+ */
+static uint64_t ci95_percent_x100(const bench_stats_t *stats)
+{
+    uint64_t sum = 0;
+
+    for (int i = 0; i < stats->num_samples; i++) {
+        sum += stats->samples[i];
+    }
+    if (sum == 0) return 0;
+
+    return stats->cycles_ci95 * 10000 * stats->num_samples / sum;
+}
+
+/*
+ * Adaptive sampling stop condition
+ */
+static bool ci_target_met(bench_stats_t *stats, uint32_t target_x100)
+{
+    if (stats->num_samples < 2) return false;
+
+    calc_sample_stats(stats);
+    return ci95_percent_x100(stats) <= target_x100;
+}
+
+/*
+ * Per-kernel cycles used for scoring: average, or median with --median
+ */
+static uint64_t summary_cycles(const bench_stats_t *stats)
+{
+    return summary_median ? stats->cycles_median : stats->cycles_avg;
+}
+
+/* ============================================================================
+ * Phase Timers
+ * ============================================================================ */
+
+static bool print_phases = false;      /* HUMAN: breakdown under each row (-v) */
+
+void bench_phase_reset(void)
+{
+    memset(bench_phase_table, 0, sizeof(bench_phase_table));
+    bench_phase_current = -1;
+}
+
+/* Fold the phase table of `runs` invocations into per-invocation averages */
+static void collect_phases(bench_stats_t *stats, uint32_t runs)
+{
+    const kernel_desc_t *kernel = stats->kernel;
+
+    stats->num_phases = 0;
+#ifndef BENCH_PHASES
+    UNUSED(kernel);
+    UNUSED(runs);
+    return;
+#endif
+    while (stats->num_phases < BENCH_MAX_PHASES && kernel->phases[stats->num_phases]) {
+        stats->num_phases++;
+    }
+    if (runs == 0) return;
+
+    for (int p = 0; p < stats->num_phases; p++) {
+        stats->phase_cycles[p] = bench_phase_table[p].cycles / runs;
+        stats->phase_count[p] = bench_phase_table[p].count / runs;
+        stats->phase_parent[p] = bench_phase_table[p].count ? bench_phase_table[p].parent : -1;
+    }
+}
+
+/* Indented per-phase cycles and share of the kernel's average */
+static void print_phase_breakdown(const bench_stats_t *stats)
+{
+    for (int p = 0; p < stats->num_phases; p++) {
+        uint64_t pct_x10 = stats->cycles_avg ? stats->phase_cycles[p] * 1000 / stats->cycles_avg : 0;
+        int depth = 0;
+        for (int q = stats->phase_parent[p]; q >= 0 && depth < BENCH_MAX_PHASES; q = stats->phase_parent[q]) {
+            depth++;
+        }
+        printf("  %*s%-*s %12lu %4lu.%lu%% %8u calls\n", 2 * depth, "", 18 - 2 * depth,
+               stats->kernel->phases[p], (unsigned long)stats->phase_cycles[p],
+               (unsigned long)(pct_x10 / 10), (unsigned long)(pct_x10 % 10), stats->phase_count[p]);
+    }
+}
+
+/* Kernel-counted work per million cycles (nodes/Mcycle for game_tree) */
+static uint64_t work_per_mcycle(const bench_stats_t *stats)
+{
+    return stats->cycles_avg ? stats->work_avg * 1000000 / stats->cycles_avg : 0;
+}
+
+/* ============================================================================
+ * Timer Calibration
+ * ============================================================================ */
+
+#define CALIBRATE_SAMPLES   256
+
+bench_timer_t bench_timer = { 0, 0, 1 };
+
+/*
+ * Measure empty BENCH_START()/BENCH_END() regions and back-to-back counter
+ * reads; runs once at startup, before any region is corrected.
+ */
+void bench_calibrate_timer(void)
+{
+    uint64_t samples[CALIBRATE_SAMPLES];
+    uint64_t resolution = UINT64_MAX;
+
+    bench_timer.overhead = 0;
+
+    for (int i = -16; i < CALIBRATE_SAMPLES; i++) {
+        BENCH_START();
+        BENCH_END();
+        if (i >= 0) samples[i] = BENCH_CYCLES();
+    }
+
+    for (int i = 0; i < CALIBRATE_SAMPLES; i++) {
+        uint64_t t0 = read_cycles();
+        uint64_t t1 = read_cycles();
+        while (t1 == t0) t1 = read_cycles();
+        if (t1 - t0 < resolution) resolution = t1 - t0;
+    }
+
+    /* Insertion sort; the array is small */
+    for (int i = 1; i < CALIBRATE_SAMPLES; i++) {
+        uint64_t v = samples[i];
+        int j = i;
+        while (j > 0 && samples[j - 1] > v) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = v;
+    }
+
+    bench_timer.overhead = samples[0];
+    bench_timer.jitter = samples[CALIBRATE_SAMPLES * 9 / 10] - samples[0];
+    bench_timer.resolution = resolution;
+}
+
+/*
+ * Smallest runtime the timer resolves: the counter step or, when larger,
+ * the run-to-run jitter of an empty region
+ */
+static uint64_t timer_resolution(void)
+{
+    return MAX(bench_timer.resolution, bench_timer.jitter);
+}
+
+/* Kernel runs within 10x of timer resolution, so its cycles are mostly noise */
+static bool timer_limited(const bench_stats_t *stats)
+{
+    return stats->runs_pass > 0 && stats->cycles_min < 10 * timer_resolution();
+}
+
+/* ============================================================================
+ * Variant Reporting
+ * ============================================================================ */
+
+static bool show_variants = false;      /* --variant given: speedup column and variant rows */
+static bool show_cache = false;         /* --cache other than warm: cache column, vs-warm ratio */
+static uint32_t cache_states = 1u << CACHE_WARM;    /* --cache selection */
+static uint32_t cache_pollute_kb = 0;
+
+/* Selected cache states, sep-separated */
+static void print_cache_states(const char *sep)
+{
+    bool first = true;
+
+    for (int c = 0; c < CACHE_NUM_STATES; c++) {
+        if (cache_states & (1u << c)) {
+            printf("%s%s", first ? "" : sep, bench_cache_name((bench_cache_t)c));
+            first = false;
+        }
+    }
+}
+
+/* Row name: "kernel", "kernel/variant" for a variant run, "@state" for a
+ * cache state other than warm */
+static const char *stats_name(const bench_stats_t *stats, char *buf, size_t size)
+{
+    if (!stats->variant && stats->cache_state == CACHE_WARM) return stats->kernel->name;
+    snprintf(buf, size, "%s%s%s%s%s", stats->kernel->name,
+             stats->variant ? "/" : "", stats->variant ? stats->variant->name : "",
+             stats->cache_state != CACHE_WARM ? "@" : "",
+             stats->cache_state != CACHE_WARM ? bench_cache_name(stats->cache_state) : "");
+    return buf;
+}
+
+/* Host ISA features, sep-separated, "-" when there are none */
+static void print_isa_features(const char *sep)
+{
+    uint32_t isa = bench_isa();
+    bool first = true;
+
+    for (int i = 0; i < ISA_NUM_FEATURES; i++) {
+        if (isa & (1u << i)) {
+            printf("%s%s", first ? "" : sep, bench_isa_name((bench_isa_t)(1u << i)));
+            first = false;
+        }
+    }
+    if (first) printf("-");
+}
+
+/*
+ * Print a variant's speedup over the reference (x100 fixed point) as "i.ff",
+ * or "-" for reference rows and failed variants
+ */
+static void print_speedup(const bench_stats_t *stats, const char *fmt_num, const char *fmt_na)
+{
+    if (stats->speedup_x100 > 0) {
+        printf(fmt_num, (unsigned long)(stats->speedup_x100 / 100),
+               (unsigned long)(stats->speedup_x100 % 100));
+    } else {
+        printf(fmt_na, "-");
+    }
+}
+
+/*
+ * Print a row's cycles over its warm row's (x100 fixed point) as "i.ff",
+ * or "-" for warm rows and when warm was not measured
+ */
+static void print_vs_warm(const bench_stats_t *stats, const char *fmt_num, const char *fmt_na)
+{
+    if (stats->vs_warm_x100 > 0) {
+        printf(fmt_num, (unsigned long)(stats->vs_warm_x100 / 100),
+               (unsigned long)(stats->vs_warm_x100 % 100));
+    } else {
+        printf(fmt_na, "-");
+    }
+}
+
+/*
+ * Print IPC (x100 fixed point) as "i.ff", or "-" without an instruction count
+ */
+static void print_ipc(const bench_stats_t *stats, const char *fmt_num, const char *fmt_na)
+{
+    if (pmu_event_available(PMU_INSTRET) && stats->cycles_avg > 0) {
+        uint64_t ipc_x100 = stats->counters_avg[PMU_INSTRET] * 100 / stats->cycles_avg;
+        printf(fmt_num, (unsigned long)(ipc_x100 / 100), (unsigned long)(ipc_x100 % 100));
+    } else {
+        printf(fmt_na, "-");
+    }
+}
+
+/*
+ * Print the per-event counter columns in HUMAN or CSV layout
+ */
+static void print_counter_columns(const bench_stats_t *stats)
+{
+    bool csv = output_format == OUTPUT_CSV;
+
+    if (csv) {
+        print_ipc(stats, ",%lu.%02lu", ",%s");
+    } else {
+        print_ipc(stats, " %3lu.%02lu", " %6s");
+    }
+
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        if (!pmu_event_available(e)) {
+            printf(csv ? ",%s" : " %12s", "-");
+        } else {
+            printf(csv ? ",%lu" : " %12lu", (unsigned long)stats->counters_avg[e]);
+        }
+    }
+}
+
 /*
  * Print benchmark header
  */
@@ -103,12 +561,86 @@ void bench_print_header(void)
         printf("SPECInt2006-micro Benchmark Results\n");
         printf("Architecture: %s\n", ARCH_NAME);
         printf("Platform: %s\n", PLATFORM_NAME);
+        printf("Tier: %s\n", bench_tier_name(bench_tier));
+        if (bench_copies > 1) {
+            printf("Copies: %d\n", bench_copies);
+        }
+        if (bench_threads > 1) {
+            printf("Threads: %d\n", bench_threads);
+        }
+        if (show_cache) {
+            printf("Cache: ");
+            print_cache_states(", ");
+            printf(" (evict: %s)\n", bench_cache_method());
+        }
+        printf("Timer: %lu cycles overhead (subtracted), %lu jitter, %lu resolution\n",
+               (unsigned long)bench_timer.overhead, (unsigned long)bench_timer.jitter,
+               (unsigned long)bench_timer.resolution);
+        if (show_variants) {
+            printf("ISA: ");
+            print_isa_features(" ");
+            printf("\n");
+        }
         printf("================================================================================\n\n");
-        printf("%-20s %12s %12s %12s %10s %s\n",
-               "Kernel", "Min Cycles", "Avg Cycles", "Max Cycles", "Checksum", "Status");
+        printf("%-20s %12s %12s %12s %10s %s %12s %9s",
+               "Kernel", "Min Cycles", "Avg Cycles", "Max Cycles", "Checksum", "Status",
+               "Median", "+/-CI95");
+        if (show_variants) {
+            printf(" %7s", "Speedup");
+        }
+        if (show_cache) {
+            printf(" %7s", "vs Warm");
+        }
+        if (bench_copies > 1) {
+            printf(" %12s %12s", "Rate Avg", "Rate Max");
+        }
+        if (pmu_enabled) {
+            printf(" %6s %12s %12s %12s %12s", "IPC", "Instrs", "Br Miss", "L1D Miss", "L2 Miss");
+        }
+        printf("\n");
         printf("--------------------------------------------------------------------------------\n");
     } else if (output_format == OUTPUT_CSV) {
-        printf("kernel,min_cycles,avg_cycles,max_cycles,checksum,status\n");
+        printf("# timer_overhead=%lu,timer_jitter=%lu,timer_resolution=%lu\n",
+               (unsigned long)bench_timer.overhead, (unsigned long)bench_timer.jitter,
+               (unsigned long)bench_timer.resolution);
+        printf("kernel,min_cycles,avg_cycles,max_cycles,checksum,status,"
+               "median_cycles,stddev_cycles,ci95_cycles,runs");
+        if (show_variants) {
+            printf(",speedup");
+        }
+        if (show_cache) {
+            printf(",cache,vs_warm");
+        }
+        if (bench_copies > 1) {
+            printf(",rate_avg_cycles,rate_max_cycles");
+        }
+        if (pmu_enabled) {
+            printf(",ipc");
+            for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+                printf(",%s", pmu_event_name(e));
+            }
+        }
+        printf(",phases\n");
+    } else {  /* OUTPUT_MACHINE */
+        printf("[TIMER]\n");
+        printf("timer_overhead=%lu\n", (unsigned long)bench_timer.overhead);
+        printf("timer_jitter=%lu\n", (unsigned long)bench_timer.jitter);
+        printf("timer_resolution=%lu\n", (unsigned long)bench_timer.resolution);
+        printf("[TIMER_END]\n\n");
+        if (show_cache) {
+            printf("[CACHE]\n");
+            printf("cache=");
+            print_cache_states(",");
+            printf("\nevict=%s\n", bench_cache_method());
+            printf("pollute_kb=%lu\n", (unsigned long)cache_pollute_kb);
+            printf("[CACHE_END]\n\n");
+        }
+        if (show_variants) {
+            printf("[ISA]\n");
+            printf("isa=");
+            print_isa_features(",");
+            printf("\n[ISA_END]\n\n");
+        }
     }
 }
 
@@ -118,37 +650,146 @@ void bench_print_header(void)
 void bench_print_stats(const bench_stats_t *stats)
 {
     const char *status_str = stats->status == BENCH_OK ? "PASS" : "FAIL";
+    uint64_t ci_x100 = ci95_percent_x100(stats);
+    char name_buf[48];
+    const char *name = stats_name(stats, name_buf, sizeof(name_buf));
 
     if (output_format == OUTPUT_HUMAN) {
-        printf("%-20s %12lu %12lu %12lu 0x%08x %s\n",
-               stats->kernel->name,
+        printf("%-20s %12lu %12lu %12lu 0x%08x %s %12lu %5lu.%02lu%%",
+               name,
                (unsigned long)stats->cycles_min,
                (unsigned long)stats->cycles_avg,
                (unsigned long)stats->cycles_max,
                stats->checksum,
-               status_str);
+               status_str,
+               (unsigned long)stats->cycles_median,
+               (unsigned long)(ci_x100 / 100),
+               (unsigned long)(ci_x100 % 100));
+        if (show_variants) {
+            print_speedup(stats, " %4lu.%02lu", " %7s");
+        }
+        if (show_cache) {
+            print_vs_warm(stats, " %4lu.%02lu", " %7s");
+        }
+        if (bench_copies > 1) {
+            printf(" %12lu %12lu",
+                   (unsigned long)stats->rate_cycles_avg,
+                   (unsigned long)stats->rate_cycles_max);
+        }
+        if (pmu_enabled) {
+            print_counter_columns(stats);
+        }
+        printf("\n");
+        if (timer_limited(stats)) {
+            printf("  warning: %s runs in under 10 times the timer resolution (%lu cycles)\n",
+                   name, (unsigned long)timer_resolution());
+        }
+        if (print_phases) {
+            print_phase_breakdown(stats);
+            if (stats->work_avg) {
+                printf("  work: %lu per run, %lu per Mcycle\n",
+                       (unsigned long)stats->work_avg, (unsigned long)work_per_mcycle(stats));
+            }
+        }
     } else if (output_format == OUTPUT_CSV) {
-        printf("%s,%lu,%lu,%lu,0x%08x,%s\n",
-               stats->kernel->name,
+        printf("%s,%lu,%lu,%lu,0x%08x,%s,%lu,%lu,%lu,%d",
+               name,
                (unsigned long)stats->cycles_min,
                (unsigned long)stats->cycles_avg,
                (unsigned long)stats->cycles_max,
                stats->checksum,
-               status_str);
+               status_str,
+               (unsigned long)stats->cycles_median,
+               (unsigned long)stats->cycles_stddev,
+               (unsigned long)stats->cycles_ci95,
+               stats->runs_total);
+        if (show_variants) {
+            print_speedup(stats, ",%lu.%02lu", ",%s");
+        }
+        if (show_cache) {
+            printf(",%s", bench_cache_name(stats->cache_state));
+            print_vs_warm(stats, ",%lu.%02lu", ",%s");
+        }
+        if (bench_copies > 1) {
+            printf(",%lu,%lu",
+                   (unsigned long)stats->rate_cycles_avg,
+                   (unsigned long)stats->rate_cycles_max);
+        }
+        if (pmu_enabled) {
+            print_counter_columns(stats);
+        }
+        /* name:cycles:calls per phase, ';'-separated */
+        printf(",");
+        for (int p = 0; p < stats->num_phases; p++) {
+            printf("%s%s:%lu:%u", p ? ";" : "", stats->kernel->phases[p],
+                   (unsigned long)stats->phase_cycles[p], stats->phase_count[p]);
+        }
+        printf("\n");
     } else {  /* OUTPUT_MACHINE */
         printf("[BENCH_START]\n");
         printf("kernel=%s\n", stats->kernel->name);
+        if (stats->variant) {
+            printf("variant=%s\n", stats->variant->name);
+        }
+        if (stats->cache_state != CACHE_WARM) {
+            printf("cache=%s\n", bench_cache_name(stats->cache_state));
+        }
         printf("arch=%s\n", ARCH_NAME);
         printf("source=%s\n", stats->kernel->source_benchmark ? stats->kernel->source_benchmark : "unknown");
+        printf("tier=%s\n", bench_tier_name(bench_tier));
+        printf("arena_bytes=%lu\n", (unsigned long)stats->arena_bytes);
         printf("[RESULT]\n");
         printf("cycles_min=%lu\n", (unsigned long)stats->cycles_min);
         printf("cycles_avg=%lu\n", (unsigned long)stats->cycles_avg);
         printf("cycles_max=%lu\n", (unsigned long)stats->cycles_max);
+        printf("cycles_median=%lu\n", (unsigned long)stats->cycles_median);
+        printf("cycles_stddev=%lu\n", (unsigned long)stats->cycles_stddev);
+        printf("cycles_ci95=%lu\n", (unsigned long)stats->cycles_ci95);
+        printf("samples=");
+        for (int i = 0; i < stats->num_samples; i++) {
+            printf(i ? ",%lu" : "%lu", (unsigned long)stats->samples[i]);
+        }
+        printf("\n");
         printf("checksum=0x%08x\n", stats->checksum);
         printf("expected=0x%08x\n", stats->kernel->expected_checksum);
         printf("runs_total=%d\n", stats->runs_total);
         printf("runs_pass=%d\n", stats->runs_pass);
         printf("runs_fail=%d\n", stats->runs_fail);
+        if (bench_threads > 1) {
+            printf("threads=%d\n", bench_threads);
+        }
+        if (stats->work_avg) {
+            printf("work=%lu\n", (unsigned long)stats->work_avg);
+            printf("work_per_mcycle=%lu\n", (unsigned long)work_per_mcycle(stats));
+        }
+        if (bench_copies > 1) {
+            printf("copies=%d\n", bench_copies);
+            printf("rate_cycles_avg=%lu\n", (unsigned long)stats->rate_cycles_avg);
+            printf("rate_cycles_max=%lu\n", (unsigned long)stats->rate_cycles_max);
+        }
+        if (stats->variant) {
+            print_speedup(stats, "speedup=%lu.%02lu\n", "speedup=%s\n");
+        }
+        if (stats->vs_warm_x100 > 0) {
+            print_vs_warm(stats, "vs_warm=%lu.%02lu\n", "vs_warm=%s\n");
+        }
+        if (pmu_enabled) {
+            print_ipc(stats, "ipc=%lu.%02lu\n", "ipc=%s\n");
+            for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+                if (pmu_event_available(e)) {
+                    printf("%s=%lu\n", pmu_event_name(e), (unsigned long)stats->counters_avg[e]);
+                }
+            }
+        }
+        for (int p = 0; p < stats->num_phases; p++) {
+            int parent = stats->phase_parent[p];
+            printf("phase.%s=%lu,%u,%s\n", stats->kernel->phases[p],
+                   (unsigned long)stats->phase_cycles[p], stats->phase_count[p],
+                   parent >= 0 ? stats->kernel->phases[parent] : "-");
+        }
+        if (timer_limited(stats)) {
+            printf("timer_limited=1\n");
+        }
         printf("status=%s\n", status_str);
         printf("[BENCH_END]\n\n");
     }
@@ -176,13 +817,13 @@ static int clz64(uint64_t x)
 static uint64_t calc_geomean(const bench_stats_t *stats, int count)
 {
     if (count == 0) return 0;
-    if (count == 1) return stats[0].cycles_avg;
+    if (count == 1) return summary_cycles(&stats[0]);
 
     uint64_t log_sum = 0;
     const int FRAC_BITS = 20;
 
     for (int i = 0; i < count; i++) {
-        uint64_t val = stats[i].cycles_avg;
+        uint64_t val = summary_cycles(&stats[i]);
         if (val == 0) val = 1;
 
         int msb = 63 - clz64(val);
@@ -209,6 +850,39 @@ static uint64_t calc_geomean(const bench_stats_t *stats, int count)
     return result;
 }
 
+/*
+ * Geometric mean of x100 fixed-point values (scores, ratios)
+ */
+static uint64_t calc_geomean_values(const uint64_t *values, int count)
+{
+    uint64_t log_sum = 0;
+    const int FRAC_BITS = 20;
+
+    if (count == 0) return 0;
+
+    for (int i = 0; i < count; i++) {
+        uint64_t val = values[i];
+        if (val == 0) val = 1;
+        int msb = 63 - clz64(val);
+        uint64_t log2_val = ((uint64_t)msb << FRAC_BITS);
+        if (msb > 0 && msb < 44) {
+            uint64_t base = 1ULL << msb;
+            uint64_t frac = ((val - base) << FRAC_BITS) / base;
+            log2_val += frac;
+        }
+        log_sum += log2_val;
+    }
+
+    uint64_t log_avg = log_sum / count;
+    int int_part = (int)(log_avg >> FRAC_BITS);
+    uint64_t frac_part = log_avg & ((1ULL << FRAC_BITS) - 1);
+    if (int_part >= 63) return 0;
+
+    uint64_t result = 1ULL << int_part;
+    result += (result * frac_part) >> FRAC_BITS;
+    return result;
+}
+
 /*
  * Per-benchmark statistics for BASE_CYCLE scoring
  */
@@ -217,19 +891,23 @@ typedef struct {
     uint64_t cycles_sum;
     uint64_t base_cycle_x100;
     uint64_t score_x100;  /* Score * 100 = base_cycle_x100 / cycles */
+    uint64_t rate_sum;    /* Per-copy cycles in rate mode */
+    uint64_t rate_x100;   /* Rate * 100 = copies * base_cycle_x100 / rate_sum */
+    uint64_t slowdown_x100;  /* Slowdown * 100 = rate_sum / cycles_sum */
 } benchmark_score_t;
 
 /*
- * Calculate per-benchmark sum of cycles
+ * Calculate per-benchmark sum of cycles (rate: per-copy cycles in rate mode)
  */
-static uint64_t calc_benchmark_sum(const bench_stats_t *stats, int count, const char *benchmark)
+static uint64_t calc_benchmark_sum(const bench_stats_t *stats, int count, const char *benchmark,
+                                   bool rate)
 {
     uint64_t sum = 0;
 
     for (int i = 0; i < count; i++) {
         if (stats[i].kernel->source_benchmark &&
             strcmp(stats[i].kernel->source_benchmark, benchmark) == 0) {
-            sum += stats[i].cycles_avg;
+            sum += rate ? stats[i].rate_cycles_avg : summary_cycles(&stats[i]);
         }
     }
 
@@ -246,6 +924,7 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
 
     int passed = 0, failed = 0;
     uint64_t total_cycles = 0;
+    bool rate = bench_copies > 1;
 
     for (int i = 0; i < count; i++) {
         if (stats[i].status == BENCH_OK) {
@@ -253,7 +932,7 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
         } else {
             failed++;
         }
-        total_cycles += stats[i].cycles_avg;
+        total_cycles += summary_cycles(&stats[i]);
     }
 
     /* Calculate per-benchmark statistics */
@@ -262,44 +941,39 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
 
     for (int b = 0; base_cycles[b].benchmark != NULL; b++) {
         const char *bench_name = base_cycles[b].benchmark;
-        uint64_t sum = calc_benchmark_sum(stats, count, bench_name);
+        uint64_t sum = calc_benchmark_sum(stats, count, bench_name, false);
 
         if (sum > 0) {
-            bench_scores[bench_count].benchmark = bench_name;
-            bench_scores[bench_count].cycles_sum = sum;
-            bench_scores[bench_count].base_cycle_x100 = base_cycles[b].base_cycle_x100;
+            benchmark_score_t *bs = &bench_scores[bench_count];
+            bs->benchmark = bench_name;
+            bs->cycles_sum = sum;
+            bs->base_cycle_x100 = base_cycles[b].base_cycle_x100;
             /* Score = BASE_CYCLE / cycles, stored as score * 100 */
-            bench_scores[bench_count].score_x100 = base_cycles[b].base_cycle_x100 / sum;
+            bs->score_x100 = base_cycles[b].base_cycle_x100 / sum;
+
+            /* Rate = copies * BASE_CYCLE / per-copy cycles (SPECrate style) */
+            bs->rate_sum = calc_benchmark_sum(stats, count, bench_name, true);
+            if (rate && bs->rate_sum > 0) {
+                bs->rate_x100 = (uint64_t)bench_copies * bs->base_cycle_x100 / bs->rate_sum;
+                bs->slowdown_x100 = bs->rate_sum * 100 / sum;
+            }
             bench_count++;
         }
     }
 
     /* Calculate overall geomean score (geometric mean of all benchmark scores) */
-    uint64_t score_log_sum = 0;
-    const int FRAC_BITS = 20;
+    uint64_t score_values[NUM_BENCHMARKS];
+    uint64_t rate_values[NUM_BENCHMARKS];
+    uint64_t slowdown_values[NUM_BENCHMARKS];
     for (int i = 0; i < bench_count; i++) {
-        uint64_t val = bench_scores[i].score_x100;
-        if (val == 0) val = 1;
-        int msb = 63 - clz64(val);
-        uint64_t log2_val = ((uint64_t)msb << FRAC_BITS);
-        if (msb > 0 && msb < 44) {
-            uint64_t base = 1ULL << msb;
-            uint64_t frac = ((val - base) << FRAC_BITS) / base;
-            log2_val += frac;
-        }
-        score_log_sum += log2_val;
+        score_values[i] = bench_scores[i].score_x100;
+        rate_values[i] = bench_scores[i].rate_x100;
+        slowdown_values[i] = bench_scores[i].slowdown_x100;
     }
 
-    uint64_t geomean_score_x100 = 0;
-    if (bench_count > 0) {
-        uint64_t log_avg = score_log_sum / bench_count;
-        int int_part = (int)(log_avg >> FRAC_BITS);
-        uint64_t frac_part = log_avg & ((1ULL << FRAC_BITS) - 1);
-        if (int_part < 63) {
-            geomean_score_x100 = 1ULL << int_part;
-            geomean_score_x100 += (geomean_score_x100 * frac_part) >> FRAC_BITS;
-        }
-    }
+    uint64_t geomean_score_x100 = calc_geomean_values(score_values, bench_count);
+    uint64_t geomean_rate_x100 = rate ? calc_geomean_values(rate_values, bench_count) : 0;
+    uint64_t geomean_slowdown_x100 = rate ? calc_geomean_values(slowdown_values, bench_count) : 0;
 
     /* Calculate raw geomean cycles */
     uint64_t raw_geomean = calc_geomean(stats, count);
@@ -307,22 +981,43 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
     if (output_format == OUTPUT_HUMAN) {
         printf("--------------------------------------------------------------------------------\n");
         printf("\n");
-        printf("Per-Benchmark Scores (BASE_CYCLE / Cycles):\n");
-        printf("%-16s %12s %14s %8s\n", "Benchmark", "Cycles", "Base Cycle", "Score");
+        printf("Per-Benchmark Scores (BASE_CYCLE / %s):\n", summary_median ? "Median Cycles" : "Cycles");
+        printf("%-16s %12s %14s %8s", "Benchmark", "Cycles", "Base Cycle", "Score");
+        if (rate) {
+            printf(" %12s %8s %8s", "Rate Cycles", "Rate", "Slowdown");
+        }
+        printf("\n");
         printf("--------------------------------------------------------------------------------\n");
         for (int i = 0; i < bench_count; i++) {
-            printf("%-16s %12lu %14lu %5lu.%02lu\n",
+            printf("%-16s %12lu %14lu %5lu.%02lu",
                    bench_scores[i].benchmark,
                    (unsigned long)bench_scores[i].cycles_sum,
                    (unsigned long)(bench_scores[i].base_cycle_x100 / 100),
                    (unsigned long)(bench_scores[i].score_x100 / 100),
                    (unsigned long)(bench_scores[i].score_x100 % 100));
+            if (rate) {
+                printf(" %12lu %5lu.%02lu %5lu.%02lu",
+                       (unsigned long)bench_scores[i].rate_sum,
+                       (unsigned long)(bench_scores[i].rate_x100 / 100),
+                       (unsigned long)(bench_scores[i].rate_x100 % 100),
+                       (unsigned long)(bench_scores[i].slowdown_x100 / 100),
+                       (unsigned long)(bench_scores[i].slowdown_x100 % 100));
+            }
+            printf("\n");
         }
         printf("--------------------------------------------------------------------------------\n");
-        printf("%-16s %12s %14s %5lu.%02lu\n",
+        printf("%-16s %12s %14s %5lu.%02lu",
                "GEOMEAN", "-", "-",
                (unsigned long)(geomean_score_x100 / 100),
                (unsigned long)(geomean_score_x100 % 100));
+        if (rate) {
+            printf(" %12s %5lu.%02lu %5lu.%02lu", "-",
+                   (unsigned long)(geomean_rate_x100 / 100),
+                   (unsigned long)(geomean_rate_x100 % 100),
+                   (unsigned long)(geomean_slowdown_x100 / 100),
+                   (unsigned long)(geomean_slowdown_x100 % 100));
+        }
+        printf("\n");
         printf("\n");
         printf("Summary:\n");
         printf("  Kernels:        %d total, %d passed, %d failed\n", count, passed, failed);
@@ -331,19 +1026,39 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
         printf("  Final Score:    %lu.%02lu\n",
                (unsigned long)(geomean_score_x100 / 100),
                (unsigned long)(geomean_score_x100 % 100));
+        if (rate) {
+            printf("  Copies:         %d\n", bench_copies);
+            printf("  Rate Score:     %lu.%02lu\n",
+                   (unsigned long)(geomean_rate_x100 / 100),
+                   (unsigned long)(geomean_rate_x100 % 100));
+            printf("  Slowdown:       %lu.%02lux per copy\n",
+                   (unsigned long)(geomean_slowdown_x100 / 100),
+                   (unsigned long)(geomean_slowdown_x100 % 100));
+        }
         printf("\n");
     } else if (output_format == OUTPUT_CSV) {
         printf("\n");
-        printf("# Per-Benchmark Scores (BASE_CYCLE / Cycles)\n");
-        printf("benchmark,cycles_sum,base_cycle,score\n");
+        printf("# Per-Benchmark Scores (BASE_CYCLE / %s)\n", summary_median ? "Median Cycles" : "Cycles");
+        printf("benchmark,cycles_sum,base_cycle,score%s\n", rate ? ",rate_cycles_sum,rate,slowdown" : "");
         for (int i = 0; i < bench_count; i++) {
-            printf("%s,%lu,%lu,%.2f\n",
+            printf("%s,%lu,%lu,%.2f",
                    bench_scores[i].benchmark,
                    (unsigned long)bench_scores[i].cycles_sum,
                    (unsigned long)(bench_scores[i].base_cycle_x100 / 100),
                    bench_scores[i].score_x100 / 100.0);
+            if (rate) {
+                printf(",%lu,%.2f,%.2f",
+                       (unsigned long)bench_scores[i].rate_sum,
+                       bench_scores[i].rate_x100 / 100.0,
+                       bench_scores[i].slowdown_x100 / 100.0);
+            }
+            printf("\n");
         }
-        printf("GEOMEAN,-,-,%.2f\n", geomean_score_x100 / 100.0);
+        printf("GEOMEAN,-,-,%.2f", geomean_score_x100 / 100.0);
+        if (rate) {
+            printf(",-,%.2f,%.2f", geomean_rate_x100 / 100.0, geomean_slowdown_x100 / 100.0);
+        }
+        printf("\n");
         printf("\n");
         printf("# Summary\n");
         printf("kernels_total,%d\n", count);
@@ -352,13 +1067,25 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
         printf("total_cycles,%lu\n", (unsigned long)total_cycles);
         printf("raw_geomean_cycles,%lu\n", (unsigned long)raw_geomean);
         printf("final_score,%.2f\n", geomean_score_x100 / 100.0);
+        if (rate) {
+            printf("copies,%d\n", bench_copies);
+            printf("rate_score,%.2f\n", geomean_rate_x100 / 100.0);
+            printf("slowdown,%.2f\n", geomean_slowdown_x100 / 100.0);
+        }
     } else {
         printf("[PER_BENCHMARK]\n");
         for (int i = 0; i < bench_count; i++) {
-            printf("%s=%lu,%.2f\n",
+            printf("%s=%lu,%.2f",
                    bench_scores[i].benchmark,
                    (unsigned long)bench_scores[i].cycles_sum,
                    bench_scores[i].score_x100 / 100.0);
+            if (rate) {
+                printf(",%lu,%.2f,%.2f",
+                       (unsigned long)bench_scores[i].rate_sum,
+                       bench_scores[i].rate_x100 / 100.0,
+                       bench_scores[i].slowdown_x100 / 100.0);
+            }
+            printf("\n");
         }
         printf("[SUMMARY]\n");
         printf("kernels_total=%d\n", count);
@@ -367,6 +1094,15 @@ static void bench_print_summary(const bench_stats_t *stats, int count)
         printf("total_cycles=%lu\n", (unsigned long)total_cycles);
         printf("raw_geomean_cycles=%lu\n", (unsigned long)raw_geomean);
         printf("final_score=%.2f\n", geomean_score_x100 / 100.0);
+        if (rate) {
+            printf("copies=%d\n", bench_copies);
+            printf("rate_score=%.2f\n", geomean_rate_x100 / 100.0);
+            printf("slowdown=%.2f\n", geomean_slowdown_x100 / 100.0);
+        }
+        if (roi_regions() > 0) {
+            printf("roi_backend=%s\n", roi_backend_name());
+            printf("roi_regions=%d\n", roi_regions());
+        }
         printf("[END]\n");
     }
 }
@@ -384,6 +1120,52 @@ void bench_print_footer(void)
     }
 }
 
+/*
+ * Whether measured run `run` (1-based) of kernel carries simulator ROI markers
+ * Rate-mode copies other than copy 0 never do.
+ */
+static bool roi_selected(const kernel_desc_t *kernel, const bench_config_t *config, int run)
+{
+    if (!config->roi_kernel || !roi_available() || bench_copy_id != 0) return false;
+    if (config->roi_run != 0 && config->roi_run != run) return false;
+    return strcmp(config->roi_kernel, "all") == 0 || strcmp(config->roi_kernel, kernel->name) == 0;
+}
+
+/*
+ * Invoke a kernel back-to-back and report the per-invocation average.
+ * The first failing invocation ends the run and is returned as-is.
+ */
+static bench_result_t run_iterations(const kernel_desc_t *kernel, uint32_t iterations)
+{
+    bench_result_t result;
+    uint64_t cycles_total = 0;
+    uint64_t work_total = 0;
+    uint64_t counters_total[PMU_NUM_EVENTS] = { 0 };
+    uint64_t region[PMU_NUM_EVENTS];
+
+    for (uint32_t n = 0; n < iterations; n++) {
+        result = kernel->run();
+        if (result.status != BENCH_OK) return result;
+
+        cycles_total += result.cycles;
+        work_total += result.work;
+        if (pmu_enabled) {
+            pmu_read_region(region);
+            for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+                counters_total[e] += region[e];
+            }
+        }
+    }
+
+    result.cycles = cycles_total / iterations;
+    result.work = work_total / iterations;
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        result.counters[e] = counters_total[e] / iterations;
+    }
+
+    return result;
+}
+
 /*
  * Run a single kernel
  */
@@ -396,32 +1178,70 @@ bench_stats_t bench_run(const kernel_desc_t *kernel, const bench_config_t *confi
         .cycles_avg = 0,
         .cycles_total = 0,
         .checksum = 0,
+        .counters_avg = { 0 },
         .runs_total = 0,
         .runs_pass = 0,
         .runs_fail = 0,
         .status = BENCH_OK
     };
 
-    /* Initialize kernel if needed */
+    /* Lowest selected state; bench_run_all() passes one at a time */
+    bench_cache_t cache_state = CACHE_WARM;
+    while (cache_state < CACHE_NUM_STATES - 1 && !(config->cache_states & (1u << cache_state))) {
+        cache_state++;
+    }
+    stats.cache_state = cache_state;
+
+    /* Initialize kernel with a fresh arena */
+    bench_arena_reset();
+    bench_cache_reset();
     if (kernel->init) {
         kernel->init();
     }
+    stats.arena_bytes = bench_arena_used();
 
-    /* Warmup runs */
+    /* Warmup runs (rate-mode copies start together) */
+    rate_barrier();
     for (int i = 0; i < config->warmup_runs; i++) {
         bench_result_t result = kernel->run();
         (void)result;
     }
 
-    /* Measured runs */
-    for (int i = 0; i < config->measure_runs; i++) {
-        bench_result_t result = kernel->run();
+    /* Phase totals cover the measured runs only */
+    bench_phase_reset();
+
+    /* Measured runs: a fixed count, or adaptive until the CI target is met */
+    uint32_t iterations = config->iterations ? config->iterations : 1;
+    uint64_t counters_total[PMU_NUM_EVENTS] = { 0 };
+    uint64_t work_total = 0;
+    bool adaptive = config->ci_target_x100 > 0;
+    int min_runs = adaptive ? MAX(config->measure_runs, 2) : config->measure_runs;
+    int max_runs = adaptive ? MAX(config->max_runs, min_runs) : min_runs;
+
+    /* Each timed region of the measured runs starts in the cache state */
+    bench_cache_arm(cache_state, config->pollute_kb);
+    for (int i = 0; i < max_runs; i++) {
+        if (adaptive && i >= min_runs && ci_target_met(&stats, config->ci_target_x100)) {
+            break;
+        }
+
+        rate_barrier();
+        roi_armed = roi_selected(kernel, config, i + 1);
+        bench_result_t result = run_iterations(kernel, iterations);
+        roi_armed = false;
         stats.runs_total++;
 
         if (result.status == BENCH_OK) {
             stats.runs_pass++;
             stats.cycles_total += result.cycles;
             stats.checksum = result.checksum;
+            work_total += result.work;
+            if (stats.num_samples < BENCH_MAX_SAMPLES) {
+                stats.samples[stats.num_samples++] = result.cycles;
+            }
+            for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+                counters_total[e] += result.counters[e];
+            }
 
             if (result.cycles < stats.cycles_min) {
                 stats.cycles_min = result.cycles;
@@ -448,9 +1268,20 @@ bench_stats_t bench_run(const kernel_desc_t *kernel, const bench_config_t *confi
         }
     }
 
-    /* Calculate average */
+    /* Calculate average, median and spread */
     if (stats.runs_pass > 0) {
         stats.cycles_avg = stats.cycles_total / stats.runs_pass;
+        stats.work_avg = work_total / stats.runs_pass;
+        for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+            stats.counters_avg[e] = counters_total[e] / stats.runs_pass;
+        }
+    }
+    bench_cache_arm(CACHE_WARM, 0);
+    calc_sample_stats(&stats);
+    collect_phases(&stats, (uint32_t)stats.runs_total * iterations);
+
+    if (adaptive && config->verbose && !ci_target_met(&stats, config->ci_target_x100)) {
+        printf("  %s: CI target not met after %d runs\n", kernel->name, stats.runs_total);
     }
 
     /* Cleanup kernel if needed */
@@ -461,6 +1292,246 @@ bench_stats_t bench_run(const kernel_desc_t *kernel, const bench_config_t *confi
     return stats;
 }
 
+/*
+ * Rate mode: rerun the kernel as bench_copies concurrent copies and fold
+ * the per-copy averages (medians with --median) into stats. A copy that
+ * fails or disagrees with the single-copy checksum fails the kernel.
+ */
+static void run_rate_copies(bench_stats_t *stats, const bench_config_t *config)
+{
+    bench_stats_t copy_stats[BENCH_MAX_COPIES];
+    uint64_t cycles_total = 0;
+
+    /* Copies meet at a barrier per run, so they all need the same run count */
+    bench_config_t copy_config = *config;
+    copy_config.measure_runs = stats->runs_total;
+    copy_config.ci_target_x100 = 0;
+
+    rate_run(stats->kernel, &copy_config, copy_stats);
+
+    for (int c = 0; c < bench_copies; c++) {
+        uint64_t cycles = summary_cycles(&copy_stats[c]);
+        cycles_total += cycles;
+        if (cycles > stats->rate_cycles_max) {
+            stats->rate_cycles_max = cycles;
+        }
+
+        if (copy_stats[c].status != BENCH_OK) {
+            stats->status = copy_stats[c].status;
+        } else if (copy_stats[c].checksum != stats->checksum) {
+            stats->status = BENCH_ERR_CHECKSUM;
+            if (config->verbose) {
+                printf("  Copy %d checksum 0x%08x differs from single-copy 0x%08x\n",
+                       c, copy_stats[c].checksum, stats->checksum);
+            }
+        }
+    }
+    stats->rate_cycles_avg = cycles_total / bench_copies;
+}
+
+/* ============================================================================
+ * Kernel Variants
+ * ============================================================================ */
+
+/*
+ * Whether --variant picks this variant: every available one ("all"), the
+ * first available in the table ("auto"), or those with the given name
+ */
+static bool variant_selected(const kernel_desc_t *kernel, const kernel_variant_t *variant,
+                             const bench_config_t *config)
+{
+    if (!config->variant || !variant_available(variant)) return false;
+    if (strcmp(config->variant, "all") == 0) return true;
+
+    if (strcmp(config->variant, "auto") == 0) {
+        for (const kernel_variant_t *v = kernel->variants; v != variant; v++) {
+            if (variant_available(v)) return false;
+        }
+        return true;
+    }
+
+    return strcmp(config->variant, variant->name) == 0;
+}
+
+/* Whether any registered kernel has a variant with this name */
+static bool variant_known(const char *name)
+{
+    for (int k = 0; k < num_kernels; k++) {
+        for (const kernel_variant_t *v = kernels[k]->variants; v && v->name; v++) {
+            if (strcmp(v->name, name) == 0) return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Measure a variant in place of the reference run function. It must
+ * reproduce the reference checksum; its speedup is reference over variant
+ * summary cycles.
+ */
+static bench_stats_t run_variant(const bench_stats_t *ref, const kernel_variant_t *variant,
+                                 const bench_config_t *config)
+{
+    kernel_desc_t desc = *ref->kernel;
+    desc.run = variant->run;
+
+    bench_stats_t stats = bench_run(&desc, config);
+    if (bench_copies > 1) {
+        run_rate_copies(&stats, config);
+    }
+    stats.kernel = ref->kernel;
+    stats.variant = variant;
+
+    if (stats.status == BENCH_OK && config->verify && ref->runs_pass > 0 &&
+        stats.checksum != ref->checksum) {
+        stats.status = BENCH_ERR_CHECKSUM;
+        if (config->verbose) {
+            printf("  Variant %s checksum 0x%08x differs from reference 0x%08x\n",
+                   variant->name, stats.checksum, ref->checksum);
+        }
+    }
+
+    uint64_t cycles = summary_cycles(&stats);
+    if (stats.status == BENCH_OK && ref->status == BENCH_OK && cycles > 0) {
+        stats.speedup_x100 = summary_cycles(ref) * 100 / cycles;
+    }
+
+    return stats;
+}
+
+/* ============================================================================
+ * Baseline Comparison
+ * ============================================================================ */
+
+typedef enum {
+    CMP_SAME,               /* Within the combined 95% CIs */
+    CMP_FASTER,
+    CMP_SLOWER,             /* Significant, below the threshold */
+    CMP_REGRESSED,          /* Significant and past the threshold */
+    CMP_NEW,                /* Not in the baseline */
+    CMP_MISMATCH,           /* Baseline ran another tier */
+    CMP_CACHE_STATE,        /* Baselines are warm, this row is not */
+    CMP_FAILED              /* Kernel failed, no cycles to compare */
+} cmp_result_t;
+
+static const char *const cmp_names[] = {
+    "same", "faster", "slower", "REGRESSED", "new", "tier-mismatch", "cache-mismatch", "failed"
+};
+
+typedef struct {
+    uint64_t base;
+    uint64_t cycles;
+    uint64_t noise;         /* Combined 95% CI half-width */
+    int64_t  delta_x100;    /* % change x100, positive = slower */
+    cmp_result_t result;
+} kernel_cmp_t;
+
+static kernel_cmp_t compare_kernel(const bench_stats_t *stats, uint32_t regress_x100)
+{
+    kernel_cmp_t cmp = { 0, summary_cycles(stats), 0, 0, CMP_SAME };
+    const baseline_entry_t *base = baseline_find(stats->kernel->name);
+
+    if (!base) {
+        cmp.result = CMP_NEW;
+        return cmp;
+    }
+    cmp.base = summary_median && base->cycles_median ? base->cycles_median : base->cycles_avg;
+
+    if (base->tier[0] && strcmp(base->tier, bench_tier_name(bench_tier)) != 0) {
+        cmp.result = CMP_MISMATCH;
+    } else if (stats->cache_state != CACHE_WARM) {
+        cmp.result = CMP_CACHE_STATE;
+    } else if (stats->runs_pass == 0 || cmp.base == 0) {
+        cmp.result = CMP_FAILED;
+    } else {
+        uint64_t diff = cmp.cycles > cmp.base ? cmp.cycles - cmp.base : cmp.base - cmp.cycles;
+        cmp.noise = isqrt64(stats->cycles_ci95 * stats->cycles_ci95 +
+                            base->cycles_ci95 * base->cycles_ci95);
+        cmp.delta_x100 = (int64_t)(diff * 10000 / cmp.base);
+        if (cmp.cycles < cmp.base) cmp.delta_x100 = -cmp.delta_x100;
+
+        if (diff > cmp.noise) {
+            if (cmp.delta_x100 < 0) {
+                cmp.result = CMP_FASTER;
+            } else {
+                cmp.result = cmp.delta_x100 > (int64_t)regress_x100 ? CMP_REGRESSED : CMP_SLOWER;
+            }
+        }
+    }
+
+    return cmp;
+}
+
+/* Signed percentage from x100 fixed point, e.g. "+3.25%" */
+static void print_delta(const char *fmt, int64_t delta_x100)
+{
+    uint64_t mag = (uint64_t)(delta_x100 < 0 ? -delta_x100 : delta_x100);
+    char buf[24];
+
+    snprintf(buf, sizeof(buf), "%c%lu.%02lu%%", delta_x100 < 0 ? '-' : '+',
+             (unsigned long)(mag / 100), (unsigned long)(mag % 100));
+    printf(fmt, buf);
+}
+
+/*
+ * Compare every measured kernel against the loaded baseline
+ * Returns the number of regressions past the threshold.
+ */
+static int print_baseline_comparison(const bench_stats_t *stats, int count, uint32_t regress_x100)
+{
+    int regressions = 0;
+
+    if (output_format == OUTPUT_HUMAN) {
+        printf("\nBaseline Comparison (%s cycles, regression > %lu.%02lu%%):\n",
+               summary_median ? "median" : "average",
+               (unsigned long)(regress_x100 / 100), (unsigned long)(regress_x100 % 100));
+        printf("%-20s %12s %12s %10s %10s  %s\n",
+               "Kernel", "Base Cycles", "Cycles", "Delta", "+/-Noise", "Result");
+        printf("--------------------------------------------------------------------------------\n");
+    } else if (output_format == OUTPUT_CSV) {
+        printf("\n# Baseline Comparison\n");
+        printf("kernel,base_cycles,cycles,delta_pct,noise_cycles,result\n");
+    } else {
+        printf("[BASELINE]\n");
+        printf("baseline_kernels=%d\n", baseline_count());
+        printf("threshold_pct=%lu.%02lu\n",
+               (unsigned long)(regress_x100 / 100), (unsigned long)(regress_x100 % 100));
+    }
+
+    for (int i = 0; i < count; i++) {
+        kernel_cmp_t cmp = compare_kernel(&stats[i], regress_x100);
+        const char *name = stats[i].kernel->name;
+
+        if (cmp.result == CMP_REGRESSED) regressions++;
+
+        if (output_format == OUTPUT_HUMAN) {
+            printf("%-20s %12lu %12lu", name, (unsigned long)cmp.base, (unsigned long)cmp.cycles);
+            print_delta(" %10s", cmp.delta_x100);
+            printf(" %10lu  %s\n", (unsigned long)cmp.noise, cmp_names[cmp.result]);
+        } else if (output_format == OUTPUT_CSV) {
+            printf("%s,%lu,%lu", name, (unsigned long)cmp.base, (unsigned long)cmp.cycles);
+            print_delta(",%s", cmp.delta_x100);
+            printf(",%lu,%s\n", (unsigned long)cmp.noise, cmp_names[cmp.result]);
+        } else {
+            printf("compare.%s=%lu,%lu", name, (unsigned long)cmp.base, (unsigned long)cmp.cycles);
+            print_delta(",%s", cmp.delta_x100);
+            printf(",%lu,%s\n", (unsigned long)cmp.noise, cmp_names[cmp.result]);
+        }
+    }
+
+    if (output_format == OUTPUT_HUMAN) {
+        printf("--------------------------------------------------------------------------------\n");
+        printf("Regressions: %d\n", regressions);
+    } else if (output_format == OUTPUT_CSV) {
+        printf("regressions,%d\n", regressions);
+    } else {
+        printf("regressions=%d\n", regressions);
+        printf("[BASELINE_END]\n\n");
+    }
+
+    return regressions;
+}
+
 /*
  * Print benchmark group header
  */
@@ -473,17 +1544,137 @@ static void print_group_header(const char *benchmark)
     }
 }
 
+/*
+ * Match a selector against a source benchmark, either the full
+ * name ("401.bzip2") or the part after the number ("bzip2")
+ */
+static bool benchmark_matches(const char *benchmark, const char *selector)
+{
+    if (!benchmark) return false;
+    if (strcmp(benchmark, selector) == 0) return true;
+
+    const char *dot = strchr(benchmark, '.');
+    return dot && strcmp(dot + 1, selector) == 0;
+}
+
+/*
+ * Check whether a kernel is chosen by the configuration
+ */
+bool bench_kernel_selected(const kernel_desc_t *kernel, const bench_config_t *config)
+{
+    if (config->num_select == 0) return true;
+
+    for (int i = 0; i < config->num_select; i++) {
+        if (strcmp(kernel->name, config->select[i]) == 0 ||
+            benchmark_matches(kernel->source_benchmark, config->select[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Print registered kernels
+ */
+void bench_list_kernels(void)
+{
+    printf("%-20s %-16s %s\n", "Kernel", "Benchmark", "Description");
+    printf("--------------------------------------------------------------------------------\n");
+    for (int i = 0; i < num_kernels; i++) {
+        printf("%-20s %-16s %s\n",
+               kernels[i]->name,
+               kernels[i]->source_benchmark ? kernels[i]->source_benchmark : "-",
+               kernels[i]->description ? kernels[i]->description : "");
+
+        /* Variants this host cannot run are marked with '*' */
+        if (kernels[i]->variants && kernels[i]->variants->name) {
+            printf("%-20s %-16s variants:", "", "");
+            for (const kernel_variant_t *v = kernels[i]->variants; v->name; v++) {
+                printf(" %s%s", v->name, variant_available(v) ? "" : "*");
+            }
+            printf("\n");
+        }
+    }
+    printf("\nISA: ");
+    print_isa_features(" ");
+    printf("\n");
+}
+
+/*
+ * Measure the reference (variant NULL) or a variant once per selected
+ * cache state and print the rows; ref holds the reference rows by state.
+ * Returns the first state measured.
+ */
+static int run_cache_states(const kernel_desc_t *kernel, const kernel_variant_t *variant,
+                            const bench_stats_t *ref, bench_stats_t *rows,
+                            const bench_config_t *config)
+{
+    int first = -1;
+
+    for (int c = 0; c < CACHE_NUM_STATES; c++) {
+        if (!(config->cache_states & (1u << c))) continue;
+
+        bench_config_t state_config = *config;
+        state_config.cache_states = 1u << c;
+
+        if (variant) {
+            rows[c] = run_variant(&ref[c], variant, &state_config);
+        } else {
+            rows[c] = bench_run(kernel, &state_config);
+            if (bench_copies > 1) {
+                run_rate_copies(&rows[c], &state_config);
+            }
+        }
+
+        uint64_t cycles = summary_cycles(&rows[c]);
+        if (first == CACHE_WARM && c != CACHE_WARM && rows[c].status == BENCH_OK &&
+            rows[CACHE_WARM].status == BENCH_OK && summary_cycles(&rows[CACHE_WARM]) > 0) {
+            rows[c].vs_warm_x100 = cycles * 100 / summary_cycles(&rows[CACHE_WARM]);
+        }
+        if (first < 0) first = c;
+
+        bench_print_stats(&rows[c]);
+    }
+
+    return first;
+}
+
+/* Rows of the selected cache states that did not pass */
+static int failed_states(const bench_stats_t *rows, const bench_config_t *config)
+{
+    int failed = 0;
+
+    for (int c = 0; c < CACHE_NUM_STATES; c++) {
+        if ((config->cache_states & (1u << c)) && rows[c].status != BENCH_OK) {
+            failed++;
+        }
+    }
+    return failed;
+}
+
 /*
  * Run all registered kernels
  */
-void bench_run_all(const bench_config_t *config)
+int bench_run_all(const bench_config_t *config)
 {
+    int regressions = 0;
+    int failures = 0;
     stats_count = 0;
+    summary_median = config->median;
+    print_phases = config->verbose;
+    show_variants = config->variant != NULL;
+    cache_states = config->cache_states;
+    cache_pollute_kb = config->pollute_kb;
+    show_cache = cache_states != (1u << CACHE_WARM);
     const char *current_benchmark = NULL;
 
     bench_print_header();
 
     for (int i = 0; i < num_kernels; i++) {
+        if (!bench_kernel_selected(kernels[i], config)) {
+            continue;
+        }
+
         /* Print group header when benchmark changes */
         const char *bench = kernels[i]->source_benchmark;
         if (bench && (!current_benchmark || strcmp(bench, current_benchmark) != 0)) {
@@ -491,15 +1682,336 @@ void bench_run_all(const bench_config_t *config)
             current_benchmark = bench;
         }
 
-        bench_stats_t stats = bench_run(kernels[i], config);
-        bench_print_stats(&stats);
+        /* Cache-state rows side by side; scores take the first state measured */
+        bench_stats_t ref[CACHE_NUM_STATES];
+        int first = run_cache_states(kernels[i], NULL, NULL, ref, config);
+        failures += failed_states(ref, config);
 
         if (stats_count < MAX_KERNELS) {
-            all_stats[stats_count++] = stats;
+            all_stats[stats_count++] = ref[first];
+        }
+
+        /* Variant rows follow the reference; scores stay reference-only */
+        for (const kernel_variant_t *v = kernels[i]->variants; v && v->name; v++) {
+            if (variant_selected(kernels[i], v, config)) {
+                bench_stats_t vstats[CACHE_NUM_STATES];
+                run_cache_states(kernels[i], v, ref, vstats, config);
+                failures += failed_states(vstats, config);
+            }
         }
     }
 
+    if (baseline_count() > 0 && stats_count > 0) {
+        regressions = print_baseline_comparison(all_stats, stats_count, config->regress_x100);
+    }
+
     bench_print_footer();
+
+    /* Non-zero for nightly gating: any regression or any failed row */
+    return (regressions > 0 || failures > 0) ? 1 : 0;
+}
+
+/* ============================================================================
+ * Run-Time Configuration Parsing
+ * ============================================================================ */
+
+/* Token storage for parsed argument strings (selectors point into it) */
+static char argstr_pool[BENCH_ARGS_MAX * 2];
+static size_t argstr_used = 0;
+
+static void print_usage(void)
+{
+    printf("Usage: specint2006-micro [options] [kernel|benchmark ...]\n");
+    printf("  -w, --warmup=N       warmup runs per kernel (default 2)\n");
+    printf("  -r, --runs=N         measured runs per kernel (default 5)\n");
+    printf("  -i, --iterations=N   kernel invocations per measured run (default 1)\n");
+    printf("  -f, --format=FMT     output format: human, csv, machine\n");
+    printf("  -l, --list           list registered kernels\n");
+    printf("  -p, --pmu            capture hardware performance counters\n");
+    printf("  -t, --tier=T         working-set tier: S (default), M, L, XL\n");
+    printf("  -c, --copies=N       rate mode: run N copies of each kernel at once\n");
+    printf("  --threads=N          worker threads for multi-threaded variants (max %d)\n", BENCH_MAX_THREADS);
+    printf("  --ci=PCT             add runs until the 95%% CI is within PCT%% of the mean\n");
+    printf("  --max-runs=N         run limit for --ci (default 50, max %d)\n", BENCH_MAX_SAMPLES);
+    printf("  --median             score with median instead of average cycles\n");
+    printf("  --roi=KERNEL[:RUN]   simulator ROI markers on one measured run (default 1)\n");
+    printf("  --roi=all            simulator ROI markers on every measured run\n");
+    printf("  --baseline=FILE      compare against a saved '-f machine' run\n");
+    printf("  --threshold=PCT      fail when a kernel is this much slower (default 5)\n");
+    printf("  --variant=V          also run variants: auto (best available), all, or a name\n");
+    printf("  --cache=S[,S...]     cache state per measured run: warm (default), cold, polluted, all\n");
+    printf("  --pollute=KB         interfering traffic for --cache=polluted (default 1024)\n");
+    printf("  -v, --verbose        verbose output\n");
+    printf("  --no-verify          skip checksum verification\n");
+    printf("Kernels are selected by name (bwt_sort) or benchmark (401.bzip2, bzip2).\n");
+}
+
+/* Parse a decimal integer, returning false on malformed input or overflow */
+static bool parse_uint(const char *str, uint32_t *out)
+{
+    uint64_t value = 0;
+
+    if (!str || *str == '\0') return false;
+    for (; *str; str++) {
+        if (*str < '0' || *str > '9') return false;
+        value = value * 10 + (uint64_t)(*str - '0');
+        if (value > UINT32_MAX) return false;
+    }
+    *out = (uint32_t)value;
+    return true;
+}
+
+/* Parse a decimal with up to two fraction digits ("1", "0.5") as value x100 */
+static bool parse_fixed2(const char *str, uint32_t *out_x100)
+{
+    uint64_t value = 0;
+    int frac_digits = -1;
+
+    if (!str || *str == '\0') return false;
+    for (; *str; str++) {
+        if (*str == '.' && frac_digits < 0) {
+            frac_digits = 0;
+            continue;
+        }
+        if (*str < '0' || *str > '9' || frac_digits >= 2) return false;
+        value = value * 10 + (uint64_t)(*str - '0');
+        if (value > UINT32_MAX) return false;
+        if (frac_digits >= 0) frac_digits++;
+    }
+    if (frac_digits < 0) frac_digits = 0;
+    for (; frac_digits < 2; frac_digits++) value *= 10;
+    if (value > UINT32_MAX) return false;
+    *out_x100 = (uint32_t)value;
+    return true;
+}
+
+/* Parse "all" or a comma-separated list of cache state names into a bitmask */
+static bool parse_cache_states(const char *str, uint32_t *out)
+{
+    uint32_t mask = 0;
+
+    if (!str || *str == '\0') return false;
+    if (strcmp(str, "all") == 0) {
+        *out = (1u << CACHE_NUM_STATES) - 1;
+        return true;
+    }
+
+    while (*str) {
+        const char *end = strchr(str, ',');
+        size_t len = end ? (size_t)(end - str) : strlen(str);
+        int c = 0;
+        while (c < CACHE_NUM_STATES &&
+               (strlen(bench_cache_name((bench_cache_t)c)) != len ||
+                strncmp(str, bench_cache_name((bench_cache_t)c), len) != 0)) {
+            c++;
+        }
+        if (c == CACHE_NUM_STATES) return false;
+        mask |= 1u << c;
+        str += len;
+        if (*str == ',') str++;
+    }
+    *out = mask;
+    return mask != 0;
+}
+
+/*
+ * Split "--name=value" into name and value, or take the value from the
+ * next argument for "--name value" / "-n value" forms
+ */
+static const char *option_value(const char *arg, int argc, char **argv, int *i)
+{
+    const char *eq = strchr(arg, '=');
+    if (eq) return eq + 1;
+    if (*i + 1 < argc) return argv[++(*i)];
+    return NULL;
+}
+
+static bool option_is(const char *arg, const char *short_name, const char *long_name)
+{
+    if (short_name && strcmp(arg, short_name) == 0) return true;
+
+    size_t len = strlen(long_name);
+    return strncmp(arg, long_name, len) == 0 && (arg[len] == '\0' || arg[len] == '=');
+}
+
+/*
+ * Parse options and kernel selectors into config
+ * Returns 0 on success, -1 on error (usage already printed)
+ */
+int bench_parse_args(bench_config_t *config, int argc, char **argv)
+{
+    for (int i = 0; i < argc; i++) {
+        const char *arg = argv[i];
+        uint32_t value;
+
+        if (option_is(arg, "-w", "--warmup")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value)) goto bad_value;
+            config->warmup_runs = (int)value;
+        } else if (option_is(arg, "-r", "--runs")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value) ||
+                value == 0 || value > BENCH_MAX_SAMPLES) goto bad_value;
+            config->measure_runs = (int)value;
+        } else if (option_is(arg, "-i", "--iterations")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value)) goto bad_value;
+            config->iterations = value;
+        } else if (option_is(arg, "-f", "--format")) {
+            const char *fmt = option_value(arg, argc, argv, &i);
+            if (!fmt) goto bad_value;
+            if (strcmp(fmt, "human") == 0) {
+                bench_set_output_format(OUTPUT_HUMAN);
+            } else if (strcmp(fmt, "csv") == 0) {
+                bench_set_output_format(OUTPUT_CSV);
+            } else if (strcmp(fmt, "machine") == 0) {
+                bench_set_output_format(OUTPUT_MACHINE);
+            } else {
+                goto bad_value;
+            }
+        } else if (option_is(arg, "-l", "--list")) {
+            config->list_only = true;
+        } else if (option_is(arg, "-p", "--pmu")) {
+            config->pmu = true;
+        } else if (option_is(arg, "-t", "--tier")) {
+            const char *tier = option_value(arg, argc, argv, &i);
+            int t = 0;
+            while (tier && t < TIER_COUNT && strcmp(tier, tier_names[t]) != 0) t++;
+            if (!tier || t == TIER_COUNT) goto bad_value;
+            bench_tier = (bench_tier_t)t;
+        } else if (option_is(arg, "-c", "--copies")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value) ||
+                value == 0 || value > BENCH_MAX_COPIES) goto bad_value;
+            config->copies = (int)value;
+        } else if (option_is(arg, NULL, "--threads")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value) ||
+                value == 0 || value > BENCH_MAX_THREADS) goto bad_value;
+            config->threads = (int)value;
+        } else if (option_is(arg, NULL, "--ci")) {
+            if (!parse_fixed2(option_value(arg, argc, argv, &i), &value) || value == 0) goto bad_value;
+            config->ci_target_x100 = value;
+        } else if (option_is(arg, NULL, "--max-runs")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value) ||
+                value == 0 || value > BENCH_MAX_SAMPLES) goto bad_value;
+            config->max_runs = (int)value;
+        } else if (option_is(arg, NULL, "--median")) {
+            config->median = true;
+        } else if (option_is(arg, NULL, "--baseline")) {
+            config->baseline = option_value(arg, argc, argv, &i);
+            if (!config->baseline) goto bad_value;
+        } else if (option_is(arg, NULL, "--threshold")) {
+            if (!parse_fixed2(option_value(arg, argc, argv, &i), &value)) goto bad_value;
+            config->regress_x100 = value;
+        } else if (option_is(arg, NULL, "--variant")) {
+            config->variant = option_value(arg, argc, argv, &i);
+            if (!config->variant || *config->variant == '\0') goto bad_value;
+        } else if (option_is(arg, NULL, "--cache")) {
+            if (!parse_cache_states(option_value(arg, argc, argv, &i), &config->cache_states)) goto bad_value;
+        } else if (option_is(arg, NULL, "--pollute")) {
+            if (!parse_uint(option_value(arg, argc, argv, &i), &value) || value == 0) goto bad_value;
+            config->pollute_kb = value;
+        } else if (option_is(arg, NULL, "--roi")) {
+            char *target = (char *)option_value(arg, argc, argv, &i);
+            if (!target || *target == '\0') goto bad_value;
+            char *colon = strchr(target, ':');
+            config->roi_run = 0;
+            if (colon) {
+                *colon = '\0';
+                if (!parse_uint(colon + 1, &value) || value == 0) goto bad_value;
+                config->roi_run = (int)value;
+            } else if (strcmp(target, "all") != 0) {
+                config->roi_run = 1;
+            }
+            config->roi_kernel = target;
+        } else if (option_is(arg, "-v", "--verbose")) {
+            config->verbose = true;
+        } else if (option_is(arg, NULL, "--no-verify")) {
+            config->verify = false;
+        } else if (option_is(arg, "-h", "--help")) {
+            print_usage();
+            return -1;
+        } else if (arg[0] == '-') {
+            printf("Unknown option: %s\n", arg);
+            print_usage();
+            return -1;
+        } else {
+            if (config->num_select >= MAX_SELECT) {
+                printf("Too many kernel selectors (max %d)\n", MAX_SELECT);
+                return -1;
+            }
+            config->select[config->num_select++] = arg;
+        }
+        continue;
+
+    bad_value:
+        printf("Invalid value for option: %s\n", arg);
+        print_usage();
+        return -1;
+    }
+
+    /* Every selector must name at least one registered kernel */
+    for (int s = 0; s < config->num_select; s++) {
+        bool found = false;
+        for (int k = 0; k < num_kernels && !found; k++) {
+            found = strcmp(kernels[k]->name, config->select[s]) == 0 ||
+                    benchmark_matches(kernels[k]->source_benchmark, config->select[s]);
+        }
+        if (!found) {
+            printf("Unknown kernel or benchmark: %s\n", config->select[s]);
+            return -1;
+        }
+    }
+
+    if (config->variant && strcmp(config->variant, "auto") != 0 &&
+        strcmp(config->variant, "all") != 0 && !variant_known(config->variant)) {
+        printf("Unknown kernel variant: %s\n", config->variant);
+        return -1;
+    }
+
+    /* A checkpoint target names one kernel, and is all that runs by default */
+    if (config->roi_kernel && strcmp(config->roi_kernel, "all") != 0) {
+        if (!kernel_get(config->roi_kernel)) {
+            printf("Unknown ROI kernel: %s\n", config->roi_kernel);
+            return -1;
+        }
+        if (config->num_select == 0) {
+            config->select[config->num_select++] = config->roi_kernel;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Parse a whitespace-separated argument string (nexus-am mainargs or an
+ * embedded BENCH_DEFAULT_ARGS blob)
+ */
+int bench_parse_argstr(bench_config_t *config, const char *args)
+{
+    char *argv[BENCH_ARGV_MAX];
+    int argc = 0;
+
+    if (!args) return 0;
+
+    size_t len = strlen(args);
+    if (len >= BENCH_ARGS_MAX || argstr_used + len + 1 > sizeof(argstr_pool)) {
+        printf("Argument string too long\n");
+        return -1;
+    }
+
+    char *p = &argstr_pool[argstr_used];
+    memcpy(p, args, len + 1);
+    argstr_used += len + 1;
+
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == '\n') *p++ = '\0';
+        if (*p == '\0') break;
+        if (argc >= BENCH_ARGV_MAX) {
+            printf("Too many arguments (max %d)\n", BENCH_ARGV_MAX);
+            return -1;
+        }
+        argv[argc++] = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\n') p++;
+    }
+
+    return bench_parse_args(config, argc, argv);
 }
 
 /*
@@ -604,20 +2116,86 @@ static void register_all_kernels(void)
 
     /* 483.xalancbmk */
     kernel_register(&kernel_xpath_eval);
+
+    /* Composite kernels: own groups with no BASE_CYCLE, so not scored */
+    kernel_register(&kernel_bzip2_pipeline);
+}
+
+/* Parsed configuration, shared with run_benchmarks() */
+static bench_config_t config = BENCH_CONFIG_DEFAULT;
+
+static int run_status = 0;
+
+static int run_benchmarks(void)
+{
+    run_status = bench_run_all(&config);
+    return run_status;
 }
 
 /*
- * Main entry point for nexus-am
+ * Main entry point
+ * (nexus-am passes the mainargs string, native builds get argc/argv)
  */
-int main(void)
+#ifdef NATIVE_BUILD
+int main(int argc, char *argv[])
+#else
+int main(const char *args)
+#endif
 {
-    bench_config_t config = BENCH_CONFIG_DEFAULT;
+    /* Per-hart TLS must exist before any BENCH_TLS access */
+    rate_tls_init();
 
     /* Register all kernels */
     register_all_kernels();
 
-    /* Run all benchmarks */
-    bench_run_all(&config);
+    /* Apply embedded configuration, then run-time arguments */
+#ifdef BENCH_DEFAULT_ARGS
+    if (bench_parse_argstr(&config, BENCH_DEFAULT_ARGS) != 0) {
+        return 1;
+    }
+#endif
+#ifdef NATIVE_BUILD
+    if (bench_parse_args(&config, argc - 1, argv + 1) != 0) {
+        return 1;
+    }
+#else
+    if (bench_parse_argstr(&config, args) != 0) {
+        return 1;
+    }
+#endif
+
+    if (config.list_only) {
+        bench_list_kernels();
+        return 0;
+    }
 
-    return 0;
+    /* Reference results: --baseline file, else a linked-in blob */
+    if (config.baseline || baseline_builtin()) {
+        if (!baseline_load(config.baseline)) {
+            return 1;
+        }
+    }
+
+    /* Before PMU capture is enabled, so the empty regions stay empty */
+    bench_calibrate_timer();
+
+    if (config.pmu && !pmu_init()) {
+        printf("Warning: no hardware performance counters available, --pmu ignored\n");
+    }
+    if (config.roi_kernel && !roi_available()) {
+        printf("Warning: no simulator ROI backend in this build (BENCH_ROI=nemu), --roi ignored\n");
+    }
+
+    bench_threads = config.threads;
+
+    /* Run selected benchmarks, as concurrent copies in rate mode */
+    if (config.copies > 1) {
+        if (!rate_start(config.copies, run_benchmarks)) {
+            return 1;
+        }
+    } else {
+        run_benchmarks();
+    }
+
+    return run_status;
 }
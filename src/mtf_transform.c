@@ -11,6 +11,7 @@
 
 /* ============================================================================
  * Configuration
+ * MTF_BLOCK_SIZE is the tier S size, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef MTF_BLOCK_SIZE
@@ -29,10 +30,16 @@
  * Data Structures
  * ============================================================================ */
 
-static uint8_t input_block[MTF_BLOCK_SIZE];
-static uint8_t output_block[MTF_BLOCK_SIZE];
-static uint8_t mtf_list[MTF_ALPHABET_SIZE];
-static uint8_t inverse_list[MTF_ALPHABET_SIZE];
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_GENERATE, PHASE_ENCODE, PHASE_RUNS, PHASE_DECODE, PHASE_VERIFY };
+
+/* Block buffers are arena-allocated in init */
+static BENCH_TLS uint8_t *input_block;
+static BENCH_TLS uint8_t *output_block;
+static BENCH_TLS uint8_t *decoded_block;
+static BENCH_TLS int block_size;
+static BENCH_TLS uint8_t mtf_list[MTF_ALPHABET_SIZE];
+static BENCH_TLS uint8_t inverse_list[MTF_ALPHABET_SIZE];
 
 /* ============================================================================
  * Move-To-Front Transform
@@ -176,8 +183,10 @@ static void generate_block(uint8_t *block, int size, uint32_t seed)
 
 static void kernel_init_func(void)
 {
-    memset(input_block, 0, sizeof(input_block));
-    memset(output_block, 0, sizeof(output_block));
+    block_size = (int)bench_scale(MTF_BLOCK_SIZE);
+    input_block = bench_alloc(block_size);
+    output_block = bench_alloc(block_size);
+    decoded_block = bench_alloc(block_size);
 }
 
 static bench_result_t kernel_run_func(void)
@@ -192,18 +201,23 @@ static bench_result_t kernel_run_func(void)
 
     for (int b = 0; b < MTF_NUM_BLOCKS; b++) {
         /* Generate input block */
-        generate_block(input_block, MTF_BLOCK_SIZE, 0x12345678 + b * 1000);
+        BENCH_PHASE_BEGIN(PHASE_GENERATE);
+        generate_block(input_block, block_size, 0x12345678 + b * 1000);
+        BENCH_PHASE_END(PHASE_GENERATE);
 
         /* MTF encode */
-        mtf_encode(input_block, output_block, MTF_BLOCK_SIZE);
+        BENCH_PHASE_BEGIN(PHASE_ENCODE);
+        mtf_encode(input_block, output_block, block_size);
+        BENCH_PHASE_END(PHASE_ENCODE);
 
         /* Count zeros and runs */
+        BENCH_PHASE_BEGIN(PHASE_RUNS);
         int run_counts[256];
-        int num_runs = count_zero_runs(output_block, MTF_BLOCK_SIZE, run_counts);
+        int num_runs = count_zero_runs(output_block, block_size, run_counts);
         total_runs += num_runs;
 
         /* Count total zeros */
-        for (int i = 0; i < MTF_BLOCK_SIZE; i++) {
+        for (int i = 0; i < block_size; i++) {
             if (output_block[i] == 0) total_zeros++;
         }
 
@@ -215,21 +229,25 @@ static bench_result_t kernel_run_func(void)
                 csum = checksum_update(csum, run_encoded[i]);
             }
         }
+        BENCH_PHASE_END(PHASE_RUNS);
 
         /* MTF decode (for verification) */
-        uint8_t decoded[MTF_BLOCK_SIZE];
-        mtf_decode(output_block, decoded, MTF_BLOCK_SIZE);
+        BENCH_PHASE_BEGIN(PHASE_DECODE);
+        mtf_decode(output_block, decoded_block, block_size);
+        BENCH_PHASE_END(PHASE_DECODE);
 
         /* Verify roundtrip */
-        for (int i = 0; i < MTF_BLOCK_SIZE; i++) {
-            if (decoded[i] != input_block[i]) {
+        BENCH_PHASE_BEGIN(PHASE_VERIFY);
+        for (int i = 0; i < block_size; i++) {
+            if (decoded_block[i] != input_block[i]) {
                 result.status = BENCH_ERR_CHECKSUM;
             }
         }
 
         /* Update checksum with output statistics */
         csum = checksum_update(csum, (uint32_t)num_runs);
-        csum = checksum_update(csum, checksum_buffer(output_block, MTF_BLOCK_SIZE));
+        csum = checksum_update(csum, checksum_buffer(output_block, block_size));
+        BENCH_PHASE_END(PHASE_VERIFY);
     }
 
     /* End timing */
@@ -262,7 +280,8 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    MTF_NUM_BLOCKS
+    MTF_NUM_BLOCKS,
+    "generate", "mtf_encode", "zero_runs", "mtf_decode", "verify"
 );
 
 KERNEL_REGISTER(mtf_transform)
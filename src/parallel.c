@@ -0,0 +1,127 @@
+/*
+ * SPECInt2006-micro: parallel.c
+ * Intra-kernel worker threads for kernels that split one run across cores
+ *
+ * Native:      a pool of bench_threads-1 pthreads, started on first use;
+ *              the calling thread runs task 0
+ * Otherwise:   one task on the calling thread
+ *
+ * In rate mode (--copies) the copies already occupy the cores, so there
+ * is a single task there too. Checksums must not depend on the thread count.
+ */
+
+#include "bench.h"
+
+#if defined(NATIVE_BUILD)
+  #include <pthread.h>
+#endif
+
+int bench_threads = 1;
+
+/* ============================================================================
+ * Native: persistent pthread pool
+ * ============================================================================ */
+
+#if defined(NATIVE_BUILD)
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+static int pool_workers = 0;            /* Started workers, thread ids 1.. */
+static int worker_start_gen[BENCH_MAX_THREADS];    /* Generation current at creation */
+
+/* Current job, published by bumping job_generation under pool_lock */
+static bench_task_t job_fn;
+static void *job_arg;
+static int job_threads;
+static int job_generation = 0;
+static int job_pending = 0;
+
+static void *pool_worker(void *arg)
+{
+    int tid = (int)(intptr_t)arg;
+    int seen;
+
+    /* Jobs published after creation only, even if the thread starts late */
+    pthread_mutex_lock(&pool_lock);
+    seen = worker_start_gen[tid];
+    for (;;) {
+        while (job_generation == seen) {
+            pthread_cond_wait(&pool_start, &pool_lock);
+        }
+        seen = job_generation;
+        if (tid >= job_threads) continue;
+
+        bench_task_t fn = job_fn;
+        void *fn_arg = job_arg;
+        int n = job_threads;
+        pthread_mutex_unlock(&pool_lock);
+
+        fn(tid, n, fn_arg);
+
+        pthread_mutex_lock(&pool_lock);
+        if (--job_pending == 0) {
+            pthread_cond_signal(&pool_done);
+        }
+    }
+    return NULL;
+}
+
+/* Grow the pool to n-1 workers; returns the thread count available */
+static int pool_grow(int n)
+{
+    while (pool_workers < n - 1) {
+        pthread_t thread;
+        worker_start_gen[pool_workers + 1] = job_generation;
+        if (pthread_create(&thread, NULL, pool_worker, (void *)(intptr_t)(pool_workers + 1)) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        pool_workers++;
+    }
+    return pool_workers + 1;
+}
+
+int bench_parallel(bench_task_t fn, void *arg)
+{
+    int n = bench_threads;
+
+    if (n <= 1 || bench_copies > 1) {
+        fn(0, 1, arg);
+        return 1;
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    n = pool_grow(n);
+    job_fn = fn;
+    job_arg = arg;
+    job_threads = n;
+    job_pending = n - 1;
+    job_generation++;
+    pthread_cond_broadcast(&pool_start);
+    pthread_mutex_unlock(&pool_lock);
+
+    fn(0, n, arg);
+
+    pthread_mutex_lock(&pool_lock);
+    while (job_pending > 0) {
+        pthread_cond_wait(&pool_done, &pool_lock);
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    return n;
+}
+
+/* ============================================================================
+ * Bare metal: serial
+ * ============================================================================ */
+
+#else
+
+int bench_parallel(bench_task_t fn, void *arg)
+{
+    fn(0, 1, arg);
+    return 1;
+}
+
+#endif
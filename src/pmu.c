@@ -0,0 +1,232 @@
+/*
+ * SPECInt2006-micro: pmu.c
+ * Hardware performance counter capture around BENCH_START()/BENCH_END()
+ *
+ * Native:      Linux perf_event_open (user-space counts only)
+ * riscv64-xs:  minstret + mhpmcounter3..5, event selectors from PMU_XS_EVENT_*
+ */
+
+#include "bench.h"
+
+#if defined(NATIVE_BUILD) && defined(__linux__)
+  #include <unistd.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <linux/perf_event.h>
+  #define PMU_PERF_EVENT
+#elif defined(ARCH_RISCV64) && !defined(NATIVE_BUILD)
+  #define PMU_RISCV_HPM
+#endif
+
+/*
+ * Counters are opened for the calling thread only, so in rate mode the
+ * figures describe copy 0 (the main thread) running alongside the others.
+ */
+BENCH_TLS bool pmu_enabled = false;
+
+static uint32_t event_mask = 0;          /* Bit per pmu_event_t that can be counted */
+static BENCH_TLS uint64_t begin_count[PMU_NUM_EVENTS];
+static BENCH_TLS uint64_t region_count[PMU_NUM_EVENTS];
+
+static const char *const event_names[PMU_NUM_EVENTS] = {
+    "instructions",
+    "branch_misses",
+    "l1d_misses",
+    "l2_misses",
+};
+
+/* ============================================================================
+ * Linux perf_event backend
+ * ============================================================================ */
+
+#ifdef PMU_PERF_EVENT
+
+#define PERF_CACHE_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/*
+ * There is no generic L2 event, so PMU_L2_MISS counts last-level cache
+ * read misses on native hosts.
+ */
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} perf_events[PMU_NUM_EVENTS] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_LL) },
+};
+
+static int group_fd = -1;
+static int group_size = 0;                  /* Events opened in the group */
+static int group_event[PMU_NUM_EVENTS];     /* Group slot -> pmu_event_t */
+
+static int perf_open(uint32_t type, uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static void backend_init(void)
+{
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        int fd = perf_open(perf_events[e].type, perf_events[e].config, group_fd);
+        if (fd < 0) continue;
+
+        if (group_fd < 0) group_fd = fd;
+        group_event[group_size++] = e;
+        event_mask |= 1u << e;
+    }
+}
+
+static void backend_read(uint64_t *count)
+{
+    uint64_t buf[1 + PMU_NUM_EVENTS];
+
+    /* Group read layout: nr, value[nr] */
+    if (read(group_fd, buf, sizeof(buf)) < (ssize_t)sizeof(uint64_t)) return;
+
+    for (int i = 0; i < group_size && i < (int)buf[0]; i++) {
+        count[group_event[i]] = buf[1 + i];
+    }
+}
+
+/* ============================================================================
+ * XiangShan mhpmcounter backend
+ * ============================================================================ */
+
+#elif defined(PMU_RISCV_HPM)
+
+/*
+ * XiangShan event encodings depend on the core configuration, so the
+ * mhpmevent selectors are build options. An event left at 0 is not counted.
+ */
+#ifndef PMU_XS_EVENT_BR_MISS
+#define PMU_XS_EVENT_BR_MISS    0
+#endif
+
+#ifndef PMU_XS_EVENT_L1D_MISS
+#define PMU_XS_EVENT_L1D_MISS   0
+#endif
+
+#ifndef PMU_XS_EVENT_L2_MISS
+#define PMU_XS_EVENT_L2_MISS    0
+#endif
+
+static void backend_init(void)
+{
+    /* Un-inhibit all counters */
+    __asm__ volatile ("csrw mcountinhibit, zero");
+
+    event_mask |= 1u << PMU_INSTRET;
+
+    if (PMU_XS_EVENT_BR_MISS) {
+        __asm__ volatile ("csrw mhpmevent3, %0" :: "r"((uint64_t)PMU_XS_EVENT_BR_MISS));
+        event_mask |= 1u << PMU_BRANCH_MISS;
+    }
+    if (PMU_XS_EVENT_L1D_MISS) {
+        __asm__ volatile ("csrw mhpmevent4, %0" :: "r"((uint64_t)PMU_XS_EVENT_L1D_MISS));
+        event_mask |= 1u << PMU_L1D_MISS;
+    }
+    if (PMU_XS_EVENT_L2_MISS) {
+        __asm__ volatile ("csrw mhpmevent5, %0" :: "r"((uint64_t)PMU_XS_EVENT_L2_MISS));
+        event_mask |= 1u << PMU_L2_MISS;
+    }
+}
+
+static void backend_read(uint64_t *count)
+{
+    uint64_t v;
+
+    __asm__ volatile ("csrr %0, minstret" : "=r"(v));
+    count[PMU_INSTRET] = v;
+    __asm__ volatile ("csrr %0, mhpmcounter3" : "=r"(v));
+    count[PMU_BRANCH_MISS] = v;
+    __asm__ volatile ("csrr %0, mhpmcounter4" : "=r"(v));
+    count[PMU_L1D_MISS] = v;
+    __asm__ volatile ("csrr %0, mhpmcounter5" : "=r"(v));
+    count[PMU_L2_MISS] = v;
+}
+
+/* ============================================================================
+ * No backend available
+ * ============================================================================ */
+
+#else
+
+static void backend_init(void)
+{
+}
+
+static void backend_read(uint64_t *count)
+{
+    UNUSED(count);
+}
+
+#endif
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+/*
+ * Open/program counters and enable capture
+ * Returns false if no event can be counted on this platform
+ */
+bool pmu_init(void)
+{
+    static bool initialized = false;
+
+    if (!initialized) {
+        backend_init();
+        initialized = true;
+    }
+
+    pmu_enabled = event_mask != 0;
+    return pmu_enabled;
+}
+
+bool pmu_event_available(pmu_event_t event)
+{
+    return (event_mask >> event) & 1;
+}
+
+const char *pmu_event_name(pmu_event_t event)
+{
+    return event_names[event];
+}
+
+void pmu_begin(void)
+{
+    backend_read(begin_count);
+}
+
+void pmu_end(void)
+{
+    uint64_t end_count[PMU_NUM_EVENTS];
+
+    memcpy(end_count, begin_count, sizeof(end_count));
+    backend_read(end_count);
+
+    for (int e = 0; e < PMU_NUM_EVENTS; e++) {
+        region_count[e] = end_count[e] - begin_count[e];
+    }
+}
+
+/*
+ * Copy the counts of the most recent BENCH_START()/BENCH_END() region
+ */
+void pmu_read_region(uint64_t *count)
+{
+    memcpy(count, region_count, sizeof(region_count));
+}
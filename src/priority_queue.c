@@ -5,6 +5,9 @@
  * Pattern: Binary heap insert/extract operations
  * Memory: Array-based heap with bubble up/down
  * Branch: Data-dependent comparisons
+ *
+ * Variants swap the event set: cache-line-aligned 4-ary/8-ary heaps, a
+ * calendar queue and a pairing heap, all cancelling by event handle.
  */
 
 #include "bench.h"
@@ -12,39 +15,114 @@
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * PQ_POPULATION and PQ_OPERATIONS are the tier S sizes, scaled by bench_scale().
  * ============================================================================ */
 
-#ifndef PQ_CAPACITY
-#define PQ_CAPACITY         512     /* Maximum queue size */
-#endif
-
 #ifndef PQ_OPERATIONS
 #define PQ_OPERATIONS       256     /* Number of insert+extract operations */
 #endif
 
+#ifndef PQ_POPULATION
+#define PQ_POPULATION       (PQ_OPERATIONS / 2)     /* Events scheduled before the run */
+#endif
+
+#ifndef PQ_HORIZON
+#define PQ_HORIZON          8       /* Initial events spread over POPULATION * HORIZON ticks */
+#endif
+
+#ifndef PQ_CAL_MIN_BUCKETS
+#define PQ_CAL_MIN_BUCKETS  16      /* Smallest calendar (power of two) */
+#endif
+
+#define PQ_NONE             0xFFFFFFFFu
+
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_FILL, PHASE_SIMULATE, PHASE_DRAIN };
+
 /* Event structure (similar to OMNeT++ cMessage) */
 typedef struct {
     uint64_t timestamp;         /* Event time (priority key) */
-    uint32_t event_id;          /* Event identifier */
+    uint32_t event_id;          /* Event identifier (unique, so the order is total) */
     uint32_t module_id;         /* Target module */
     int32_t  priority;          /* Secondary priority */
+    uint32_t handle;            /* Pool slot, the event's identity for cancellation */
     void    *data;              /* Event data pointer */
 } event_t;
 
 /* Priority queue (binary min-heap) */
 typedef struct {
-    event_t *heap;              /* Heap array */
-    int     size;               /* Current number of elements */
-    int     capacity;           /* Maximum capacity */
+    event_t  *heap;             /* Heap array */
+    uint32_t *pos;              /* Heap index per handle */
+    int      size;              /* Current number of elements */
+    int      capacity;          /* Maximum capacity */
 } pqueue_t;
 
-/* Static storage */
-static event_t heap_storage[PQ_CAPACITY + 1];   /* 1-indexed heap */
-static pqueue_t pq;
+/*
+ * Event set interface; events live in the pool and are named by handle,
+ * so every engine cancels the same event the simulation picked
+ */
+typedef struct {
+    void     (*reset)(void);
+    void     (*insert)(uint32_t h);
+    uint32_t (*extract)(void);      /* Handle of the earliest event, PQ_NONE when empty */
+    void     (*cancel)(uint32_t h);
+} pq_engine_t;
+
+/* Event pool: handles come from a free stack */
+static BENCH_TLS event_t *events;
+static BENCH_TLS uint32_t *free_stack;
+static BENCH_TLS uint32_t free_top;
+static BENCH_TLS uint32_t pool_size;
+
+/* Pending handles (swap-removed), for picking cancellations */
+static BENCH_TLS uint32_t *pending;
+static BENCH_TLS uint32_t *pending_pos;
+static BENCH_TLS uint32_t num_pending;
+
+static BENCH_TLS int num_operations;
+static BENCH_TLS int population;
+
+/* Reference heap storage */
+static BENCH_TLS event_t *heap_storage;   /* 1-indexed heap, arena-allocated in init */
+static BENCH_TLS pqueue_t pq;
+
+/* ============================================================================
+ * Event Pool
+ * ============================================================================ */
+
+static void pool_reset(void)
+{
+    for (uint32_t i = 0; i < pool_size; i++) {
+        free_stack[i] = pool_size - 1 - i;
+    }
+    free_top = pool_size;
+    num_pending = 0;
+}
+
+INLINE bool pool_empty(void)
+{
+    return free_top == 0;
+}
+
+INLINE uint32_t pool_get(void)
+{
+    uint32_t h = free_stack[--free_top];
+    pending_pos[h] = num_pending;
+    pending[num_pending++] = h;
+    return h;
+}
+
+INLINE void pool_put(uint32_t h)
+{
+    uint32_t last = pending[--num_pending];
+    pending[pending_pos[h]] = last;
+    pending_pos[last] = pending_pos[h];
+    free_stack[free_top++] = h;
+}
 
 /* ============================================================================
  * Priority Queue Operations
@@ -62,10 +140,16 @@ INLINE bool event_less(const event_t *a, const event_t *b)
     return a->event_id < b->event_id;
 }
 
+INLINE bool handle_less(uint32_t a, uint32_t b)
+{
+    return event_less(&events[a], &events[b]);
+}
+
 /* Initialize priority queue */
-static void pq_init(pqueue_t *q, event_t *storage, int capacity)
+static void pq_init(pqueue_t *q, event_t *storage, uint32_t *pos, int capacity)
 {
     q->heap = storage;
+    q->pos = pos;
     q->size = 0;
     q->capacity = capacity;
 }
@@ -93,10 +177,12 @@ static void pq_bubble_up(pqueue_t *q, int pos)
             break;
         }
         q->heap[pos] = q->heap[parent];
+        q->pos[q->heap[pos].handle] = pos;
         pos = parent;
     }
 
     q->heap[pos] = temp;
+    q->pos[temp.handle] = pos;
 }
 
 /* Bubble down (after extract) */
@@ -120,10 +206,12 @@ static void pq_bubble_down(pqueue_t *q, int pos)
 
         /* Move child up */
         q->heap[pos] = q->heap[child];
+        q->pos[q->heap[pos].handle] = pos;
         pos = child;
     }
 
     q->heap[pos] = temp;
+    q->pos[temp.handle] = pos;
 }
 
 /* Insert event into queue */
@@ -183,7 +271,6 @@ static bool pq_remove_at(pqueue_t *q, int pos)
     }
 
     /* Replace with last element */
-    event_t removed = q->heap[pos];
     q->heap[pos] = q->heap[q->size];
     q->size--;
 
@@ -196,42 +283,572 @@ static bool pq_remove_at(pqueue_t *q, int pos)
         }
     }
 
-    (void)removed;  /* Avoid unused warning */
     return true;
 }
 
+/* Reference engine: the binary heap holds event copies, like cMessageHeap */
+static void binary_reset(void)
+{
+    pq.size = 0;
+}
+
+static void binary_insert(uint32_t h)
+{
+    pq_insert(&pq, &events[h]);
+}
+
+static uint32_t binary_extract(void)
+{
+    event_t e;
+    return pq_extract(&pq, &e) ? e.handle : PQ_NONE;
+}
+
+static void binary_cancel(uint32_t h)
+{
+    pq_remove_at(&pq, (int)pq.pos[h]);
+}
+
+static const pq_engine_t binary_engine = {
+    binary_reset, binary_insert, binary_extract, binary_cancel
+};
+
+/* ============================================================================
+ * D-ary Heaps (4-ary, 8-ary)
+ * 16-byte entries carry the key inline; node k lives at slot k + D - 1, so
+ * the D children of a node start on a D * 16 byte boundary (one cache line
+ * at D = 4, an adjacent pair at D = 8).
+ * ============================================================================ */
+
+typedef struct {
+    uint64_t time;
+    uint32_t tie;               /* priority << 28 | event_id */
+    uint32_t handle;
+} pq_entry_t;
+
+static BENCH_TLS pq_entry_t *dary_slots;
+static BENCH_TLS pq_entry_t *dary_heap;   /* dary_slots + D - 1 for the running engine */
+static BENCH_TLS uint32_t *dary_pos;
+static BENCH_TLS uint32_t dary_size;
+
+INLINE bool entry_less(const pq_entry_t *a, const pq_entry_t *b)
+{
+    return a->time < b->time || (a->time == b->time && a->tie < b->tie);
+}
+
+INLINE void dary_sift_up(uint32_t k, pq_entry_t e, uint32_t d)
+{
+    pq_entry_t *heap = dary_heap;
+
+    while (k > 0) {
+        uint32_t parent = (k - 1) / d;
+        if (!entry_less(&e, &heap[parent])) {
+            break;
+        }
+        heap[k] = heap[parent];
+        dary_pos[heap[k].handle] = k;
+        k = parent;
+    }
+
+    heap[k] = e;
+    dary_pos[e.handle] = k;
+}
+
+INLINE void dary_sift_down(uint32_t k, pq_entry_t e, uint32_t d)
+{
+    pq_entry_t *heap = dary_heap;
+    uint32_t size = dary_size;
+
+    for (;;) {
+        uint32_t first = d * k + 1;
+        if (first >= size) {
+            break;
+        }
+
+        /* Smallest of up to d children, all in one line pair */
+        uint32_t last = first + d < size ? first + d : size;
+        uint32_t best = first;
+        for (uint32_t c = first + 1; c < last; c++) {
+            if (entry_less(&heap[c], &heap[best])) {
+                best = c;
+            }
+        }
+
+        if (!entry_less(&heap[best], &e)) {
+            break;
+        }
+        heap[k] = heap[best];
+        dary_pos[heap[k].handle] = k;
+        k = best;
+    }
+
+    heap[k] = e;
+    dary_pos[e.handle] = k;
+}
+
+INLINE void dary_insert(uint32_t h, uint32_t d)
+{
+    const event_t *ev = &events[h];
+    pq_entry_t e = {
+        .time = ev->timestamp,
+        .tie = ((uint32_t)ev->priority << 28) | ev->event_id,
+        .handle = h
+    };
+    dary_sift_up(dary_size++, e, d);
+}
+
+INLINE uint32_t dary_extract(uint32_t d)
+{
+    if (dary_size == 0) {
+        return PQ_NONE;
+    }
+
+    uint32_t h = dary_heap[0].handle;
+    pq_entry_t last = dary_heap[--dary_size];
+    if (dary_size > 0) {
+        dary_sift_down(0, last, d);
+    }
+    return h;
+}
+
+INLINE void dary_cancel(uint32_t h, uint32_t d)
+{
+    uint32_t k = dary_pos[h];
+    pq_entry_t last = dary_heap[--dary_size];
+
+    if (k < dary_size) {
+        if (k > 0 && entry_less(&last, &dary_heap[(k - 1) / d])) {
+            dary_sift_up(k, last, d);
+        } else {
+            dary_sift_down(k, last, d);
+        }
+    }
+}
+
+static void dary4_reset(void)
+{
+    dary_heap = dary_slots + 3;
+    dary_size = 0;
+}
+
+static void dary4_insert(uint32_t h)  { dary_insert(h, 4); }
+static uint32_t dary4_extract(void)   { return dary_extract(4); }
+static void dary4_cancel(uint32_t h)  { dary_cancel(h, 4); }
+
+static void dary8_reset(void)
+{
+    dary_heap = dary_slots + 7;
+    dary_size = 0;
+}
+
+static void dary8_insert(uint32_t h)  { dary_insert(h, 8); }
+static uint32_t dary8_extract(void)   { return dary_extract(8); }
+static void dary8_cancel(uint32_t h)  { dary_cancel(h, 8); }
+
+static const pq_engine_t dary4_engine = {
+    dary4_reset, dary4_insert, dary4_extract, dary4_cancel
+};
+
+static const pq_engine_t dary8_engine = {
+    dary8_reset, dary8_insert, dary8_extract, dary8_cancel
+};
+
+/* ============================================================================
+ * Calendar Queue (Brown 1988)
+ * A power-of-two ring of day buckets of width 2^shift ticks; each bucket is
+ * a sorted doubly-linked list threaded through the handle arrays. Dequeue
+ * walks the days of the current year from the last event's day, falling
+ * back to a direct search when a whole year is empty. The calendar doubles
+ * above two events per bucket and halves below one per two buckets; the
+ * day width comes from the gaps between recent dequeues (the pending
+ * events' mean spacing before the first one) and is re-checked after
+ * every year of dequeues.
+ * ============================================================================ */
+
+typedef struct {
+    uint32_t *bucket;           /* Head handle per day */
+    uint32_t *spare;            /* Other bucket array, target of a resize */
+    uint32_t nbuckets;
+    uint32_t max_buckets;
+    uint32_t shift;             /* Day width is 1 << shift ticks */
+    uint32_t size;
+    uint32_t cur;               /* Day of the last dequeued event */
+    uint64_t top;               /* End of that day in the current year */
+    uint64_t last_time;
+    uint64_t gap_sum;           /* Dequeue gaps since the last resize */
+    uint32_t gap_count;
+} calendar_t;
+
+static BENCH_TLS calendar_t cal;
+static BENCH_TLS uint32_t *cal_next;
+static BENCH_TLS uint32_t *cal_prev;
+
+INLINE uint32_t cal_day(uint64_t t)
+{
+    return (uint32_t)(t >> cal.shift) & (cal.nbuckets - 1);
+}
+
+/* Sorted insert into h's day */
+INLINE void cal_link(uint32_t h)
+{
+    uint32_t *head = &cal.bucket[cal_day(events[h].timestamp)];
+    uint32_t prev = PQ_NONE;
+    uint32_t cur = *head;
+
+    while (cur != PQ_NONE && handle_less(cur, h)) {
+        prev = cur;
+        cur = cal_next[cur];
+    }
+
+    cal_next[h] = cur;
+    cal_prev[h] = prev;
+    if (cur != PQ_NONE) cal_prev[cur] = h;
+    if (prev != PQ_NONE) {
+        cal_next[prev] = h;
+    } else {
+        *head = h;
+    }
+}
+
+INLINE void cal_unlink(uint32_t h)
+{
+    uint32_t next = cal_next[h];
+    uint32_t prev = cal_prev[h];
+
+    if (next != PQ_NONE) cal_prev[next] = prev;
+    if (prev != PQ_NONE) {
+        cal_next[prev] = next;
+    } else {
+        cal.bucket[cal_day(events[h].timestamp)] = next;
+    }
+}
+
+/* Place the current day and year after a resize */
+static void cal_seek(uint64_t t)
+{
+    cal.cur = cal_day(t);
+    cal.top = ((t >> cal.shift) + 1) << cal.shift;
+}
+
+/*
+ * Day width ~ 2x the event spacing at the head of the queue, from the
+ * dequeue gaps once there are enough; pending events cluster just after
+ * the current time, so the span of the whole set underestimates the
+ * density where dequeues happen
+ */
+static uint32_t cal_estimate_shift(void)
+{
+    uint64_t width;
+
+    if (cal.gap_count >= PQ_CAL_MIN_BUCKETS) {
+        width = 2 * cal.gap_sum / cal.gap_count;
+    } else {
+        uint64_t lo = ~0ull, hi = 0;
+        for (uint32_t i = 0; i < cal.nbuckets; i++) {
+            for (uint32_t h = cal.bucket[i]; h != PQ_NONE; h = cal_next[h]) {
+                uint64_t t = events[h].timestamp;
+                if (t < lo) lo = t;
+                if (t > hi) hi = t;
+            }
+        }
+        width = cal.size > 1 ? 2 * (hi - lo) / cal.size : 1;
+    }
+
+    uint32_t shift = 0;
+    while ((1ull << shift) < width && shift < 40) shift++;
+    return shift;
+}
+
+/* Rehash every event into a calendar of nbuckets days of 2^shift ticks */
+static void cal_rebuild(uint32_t nbuckets, uint32_t shift)
+{
+    uint32_t *old = cal.bucket;
+    uint32_t old_n = cal.nbuckets;
+
+    cal.bucket = cal.spare;
+    cal.spare = old;
+    cal.nbuckets = nbuckets;
+    cal.shift = shift;
+    cal.gap_sum = 0;
+    cal.gap_count = 0;
+    for (uint32_t i = 0; i < nbuckets; i++) {
+        cal.bucket[i] = PQ_NONE;
+    }
+
+    for (uint32_t i = 0; i < old_n; i++) {
+        uint32_t h = old[i];
+        while (h != PQ_NONE) {
+            uint32_t next = cal_next[h];
+            cal_link(h);
+            h = next;
+        }
+    }
+
+    cal_seek(cal.last_time);
+}
+
+static void cal_resize(uint32_t nbuckets)
+{
+    cal_rebuild(nbuckets, cal_estimate_shift());
+}
+
+static void calendar_reset(void)
+{
+    cal.nbuckets = PQ_CAL_MIN_BUCKETS;
+    cal.shift = 0;
+    cal.size = 0;
+    cal.last_time = 0;
+    cal.gap_sum = 0;
+    cal.gap_count = 0;
+    for (uint32_t i = 0; i < cal.nbuckets; i++) {
+        cal.bucket[i] = PQ_NONE;
+    }
+    cal_seek(0);
+}
+
+static void calendar_insert(uint32_t h)
+{
+    cal_link(h);
+    cal.size++;
+    if (cal.size > 2 * cal.nbuckets && cal.nbuckets < cal.max_buckets) {
+        cal_resize(cal.nbuckets * 2);
+    }
+}
+
+INLINE void cal_shrink(void)
+{
+    if (cal.size < cal.nbuckets / 2 && cal.nbuckets > PQ_CAL_MIN_BUCKETS) {
+        cal_resize(cal.nbuckets / 2);
+    }
+}
+
+static uint32_t calendar_extract(void)
+{
+    if (cal.size == 0) {
+        return PQ_NONE;
+    }
+
+    /* Walk one year of days; each head is its day's earliest event */
+    uint32_t mask = cal.nbuckets - 1;
+    uint32_t i = cal.cur;
+    uint64_t top = cal.top;
+    uint32_t h = PQ_NONE;
+
+    for (uint32_t n = 0; n < cal.nbuckets; n++) {
+        uint32_t head = cal.bucket[i];
+        if (head != PQ_NONE && events[head].timestamp < top) {
+            h = head;
+            break;
+        }
+        i = (i + 1) & mask;
+        top += 1ull << cal.shift;
+    }
+
+    /* Sparse year: direct search over the day heads */
+    if (h == PQ_NONE) {
+        for (uint32_t j = 0; j < cal.nbuckets; j++) {
+            uint32_t head = cal.bucket[j];
+            if (head != PQ_NONE && (h == PQ_NONE || handle_less(head, h))) {
+                h = head;
+            }
+        }
+        cal_seek(events[h].timestamp);
+    } else {
+        cal.cur = i;
+        cal.top = top;
+    }
+
+    cal.bucket[cal.cur] = cal_next[h];
+    if (cal_next[h] != PQ_NONE) cal_prev[cal_next[h]] = PQ_NONE;
+    cal.gap_sum += events[h].timestamp - cal.last_time;
+    cal.gap_count++;
+    cal.last_time = events[h].timestamp;
+    cal.size--;
+    cal_shrink();
+
+    /* Recalibrate after a year of dequeues if the width is off by 4x */
+    if (cal.gap_count >= cal.nbuckets) {
+        uint32_t shift = cal_estimate_shift();
+        if (shift + 2 <= cal.shift || shift >= cal.shift + 2) {
+            cal_rebuild(cal.nbuckets, shift);
+        } else {
+            cal.gap_sum = 0;
+            cal.gap_count = 0;
+        }
+    }
+    return h;
+}
+
+static void calendar_cancel(uint32_t h)
+{
+    cal_unlink(h);
+    cal.size--;
+    cal_shrink();
+}
+
+static const pq_engine_t calendar_engine = {
+    calendar_reset, calendar_insert, calendar_extract, calendar_cancel
+};
+
+/* ============================================================================
+ * Pairing Heap
+ * Nodes are handles; child / sibling / prev (parent for a leftmost child)
+ * are handle arrays. Cancel cuts the node's subtree, pairs its children
+ * and melds the result back into the root.
+ * ============================================================================ */
+
+static BENCH_TLS uint32_t *ph_child;
+static BENCH_TLS uint32_t *ph_sibling;
+static BENCH_TLS uint32_t *ph_prev;
+static BENCH_TLS uint32_t ph_root;
+
+/* Link two roots; the loser becomes the winner's leftmost child */
+INLINE uint32_t ph_meld(uint32_t a, uint32_t b)
+{
+    if (handle_less(b, a)) {
+        uint32_t t = a; a = b; b = t;
+    }
+
+    uint32_t first = ph_child[a];
+    ph_sibling[b] = first;
+    if (first != PQ_NONE) ph_prev[first] = b;
+    ph_prev[b] = a;
+    ph_child[a] = b;
+    return a;
+}
+
+/* Two-pass pairing of a sibling list: pair left to right, meld right to left */
+static uint32_t ph_merge_pairs(uint32_t first)
+{
+    if (first == PQ_NONE) {
+        return PQ_NONE;
+    }
+
+    uint32_t stack = PQ_NONE;       /* Paired trees, linked right to left */
+    while (first != PQ_NONE) {
+        uint32_t a = first;
+        uint32_t b = ph_sibling[a];
+        if (b == PQ_NONE) {
+            ph_sibling[a] = stack;
+            stack = a;
+            break;
+        }
+        first = ph_sibling[b];
+        uint32_t m = ph_meld(a, b);
+        ph_sibling[m] = stack;
+        stack = m;
+    }
+
+    uint32_t root = stack;
+    stack = ph_sibling[root];
+    while (stack != PQ_NONE) {
+        uint32_t next = ph_sibling[stack];
+        root = ph_meld(root, stack);
+        stack = next;
+    }
+
+    ph_sibling[root] = PQ_NONE;
+    ph_prev[root] = PQ_NONE;
+    return root;
+}
+
+static void pairing_reset(void)
+{
+    ph_root = PQ_NONE;
+}
+
+static void pairing_insert(uint32_t h)
+{
+    ph_child[h] = PQ_NONE;
+    ph_sibling[h] = PQ_NONE;
+    ph_prev[h] = PQ_NONE;
+    ph_root = ph_root == PQ_NONE ? h : ph_meld(ph_root, h);
+}
+
+static uint32_t pairing_extract(void)
+{
+    uint32_t h = ph_root;
+    if (h != PQ_NONE) {
+        ph_root = ph_merge_pairs(ph_child[h]);
+    }
+    return h;
+}
+
+static void pairing_cancel(uint32_t h)
+{
+    if (h == ph_root) {
+        pairing_extract();
+        return;
+    }
+
+    /* Cut h out of its parent's child list */
+    uint32_t prev = ph_prev[h];
+    uint32_t next = ph_sibling[h];
+    if (ph_child[prev] == h) {
+        ph_child[prev] = next;
+    } else {
+        ph_sibling[prev] = next;
+    }
+    if (next != PQ_NONE) ph_prev[next] = prev;
+
+    uint32_t sub = ph_merge_pairs(ph_child[h]);
+    if (sub != PQ_NONE) {
+        ph_root = ph_meld(ph_root, sub);
+    }
+}
+
+static const pq_engine_t pairing_engine = {
+    pairing_reset, pairing_insert, pairing_extract, pairing_cancel
+};
+
 /* ============================================================================
  * Simulation Workload
  * ============================================================================ */
 
+/* Schedule a pool event on the engine */
+INLINE void schedule(const pq_engine_t *eng, uint32_t *next_id, uint64_t t,
+                     uint32_t module_id, int32_t priority)
+{
+    uint32_t h = pool_get();
+    event_t *e = &events[h];
+
+    e->timestamp = t;
+    e->event_id = (*next_id)++;
+    e->module_id = module_id;
+    e->priority = priority;
+    e->handle = h;
+    e->data = NULL;
+    eng->insert(h);
+}
+
 /* Simulate discrete event processing */
-static uint32_t simulate_events(pqueue_t *q, uint32_t seed)
+static uint32_t simulate_events(const pq_engine_t *eng, uint32_t seed)
 {
     uint32_t x = seed;
     uint64_t current_time = 0;
     uint32_t events_processed = 0;
+    uint32_t next_id = 0;
+    uint32_t horizon = (uint32_t)population * PQ_HORIZON;
     uint32_t checksum = checksum_init();
 
+    pool_reset();
+    eng->reset();
+
     /* Initial events */
-    for (int i = 0; i < PQ_OPERATIONS / 2; i++) {
+    BENCH_PHASE_BEGIN(PHASE_FILL);
+    for (int i = 0; i < population; i++) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-
-        event_t e = {
-            .timestamp = current_time + (x % 1000),
-            .event_id = i,
-            .module_id = x % 16,
-            .priority = (x >> 16) % 10,
-            .data = NULL
-        };
-
-        pq_insert(q, &e);
+        schedule(eng, &next_id, current_time + (x % horizon), x % 16, (x >> 16) % 10);
     }
+    BENCH_PHASE_END(PHASE_FILL);
 
     /* Process events and generate new ones */
-    for (int i = 0; i < PQ_OPERATIONS; i++) {
-        event_t e;
+    BENCH_PHASE_BEGIN(PHASE_SIMULATE);
+    for (int i = 0; i < num_operations; i++) {
+        uint32_t h = eng->extract();
 
-        if (pq_extract(q, &e)) {
+        if (h != PQ_NONE) {
+            event_t e = events[h];
+            pool_put(h);
             events_processed++;
             current_time = e.timestamp;
 
@@ -244,36 +861,31 @@ static uint32_t simulate_events(pqueue_t *q, uint32_t seed)
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             int new_events = x % 3;
 
-            for (int j = 0; j < new_events && !pq_full(q); j++) {
+            for (int j = 0; j < new_events && !pool_empty(); j++) {
                 x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-
-                event_t new_e = {
-                    .timestamp = current_time + 1 + (x % 500),
-                    .event_id = events_processed * 10 + j,
-                    .module_id = (e.module_id + (x % 4)) % 16,
-                    .priority = (x >> 8) % 10,
-                    .data = NULL
-                };
-
-                pq_insert(q, &new_e);
+                schedule(eng, &next_id, current_time + 1 + (x % 500),
+                         (e.module_id + (x % 4)) % 16, (x >> 8) % 10);
             }
 
-            /* Occasionally cancel a random event */
+            /* Occasionally cancel a random pending event */
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-            if ((x % 10) == 0 && q->size > 5) {
-                int cancel_pos = 1 + (x % q->size);
-                pq_remove_at(q, cancel_pos);
+            if ((x % 10) == 0 && num_pending > 5) {
+                uint32_t victim = pending[x % num_pending];
+                eng->cancel(victim);
+                pool_put(victim);
             }
         }
     }
+    BENCH_PHASE_END(PHASE_SIMULATE);
 
     /* Drain remaining events */
-    while (!pq_empty(q)) {
-        event_t e;
-        pq_extract(q, &e);
+    BENCH_PHASE_BEGIN(PHASE_DRAIN);
+    for (uint32_t h; (h = eng->extract()) != PQ_NONE; ) {
         events_processed++;
-        checksum = checksum_update(checksum, (uint32_t)e.timestamp);
+        checksum = checksum_update(checksum, (uint32_t)events[h].timestamp);
+        pool_put(h);
     }
+    BENCH_PHASE_END(PHASE_DRAIN);
 
     checksum = checksum_update(checksum, events_processed);
     return checksum;
@@ -285,22 +897,47 @@ static uint32_t simulate_events(pqueue_t *q, uint32_t seed)
 
 static void kernel_init_func(void)
 {
+    num_operations = (int)bench_scale(PQ_OPERATIONS);
+    population = (int)bench_scale(PQ_POPULATION);
+
+    /* Each extract schedules at most two events, so the pool never runs dry */
+    pool_size = (uint32_t)population + 2 * (uint32_t)num_operations;
+    events = bench_alloc(pool_size * sizeof(event_t));
+    free_stack = bench_alloc(pool_size * sizeof(uint32_t));
+    pending = bench_alloc(pool_size * sizeof(uint32_t));
+    pending_pos = bench_alloc(pool_size * sizeof(uint32_t));
+
     /* Initialize priority queue */
-    pq_init(&pq, heap_storage, PQ_CAPACITY);
+    heap_storage = bench_alloc((pool_size + 1) * sizeof(event_t));
+    pq_init(&pq, heap_storage, bench_alloc(pool_size * sizeof(uint32_t)), (int)pool_size);
+
+    /* D-ary heaps: room for the D - 1 slot offset of the 8-ary layout */
+    dary_slots = bench_alloc((pool_size + 8) * sizeof(pq_entry_t));
+    dary_pos = bench_alloc(pool_size * sizeof(uint32_t));
+
+    /* Calendar: growth stops at the first power of two >= pool_size / 2 */
+    cal.max_buckets = PQ_CAL_MIN_BUCKETS;
+    while (cal.max_buckets < pool_size / 2) cal.max_buckets *= 2;
+    cal.bucket = bench_alloc(cal.max_buckets * sizeof(uint32_t));
+    cal.spare = bench_alloc(cal.max_buckets * sizeof(uint32_t));
+    cal_next = bench_alloc(pool_size * sizeof(uint32_t));
+    cal_prev = bench_alloc(pool_size * sizeof(uint32_t));
+
+    ph_child = bench_alloc(pool_size * sizeof(uint32_t));
+    ph_sibling = bench_alloc(pool_size * sizeof(uint32_t));
+    ph_prev = bench_alloc(pool_size * sizeof(uint32_t));
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; eng is the reference binary heap or one of the variants */
+static bench_result_t pq_run(const pq_engine_t *eng)
 {
     bench_result_t result = { .status = BENCH_OK };
 
-    /* Reset queue */
-    pq.size = 0;
-
     /* Start timing */
     BENCH_START();
 
     /* Run simulation */
-    uint32_t csum = simulate_events(&pq, 0xDEADBEEF);
+    uint32_t csum = simulate_events(eng, 0xDEADBEEF);
 
     /* End timing */
     BENCH_END();
@@ -314,6 +951,31 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return pq_run(&binary_engine);
+}
+
+static bench_result_t kernel_run_dary4(void)
+{
+    return pq_run(&dary4_engine);
+}
+
+static bench_result_t kernel_run_dary8(void)
+{
+    return pq_run(&dary8_engine);
+}
+
+static bench_result_t kernel_run_calendar(void)
+{
+    return pq_run(&calendar_engine);
+}
+
+static bench_result_t kernel_run_pairing(void)
+{
+    return pq_run(&pairing_engine);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -323,7 +985,16 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t pq_variants[] = {
+    { "calendar", 0, kernel_run_calendar },
+    { "dary4", 0, kernel_run_dary4 },
+    { "dary8", 0, kernel_run_dary8 },
+    { "pairing", 0, kernel_run_pairing },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     priority_queue,
     "Priority queue operations",
     "471.omnetpp",
@@ -331,7 +1002,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    PQ_OPERATIONS
+    PQ_OPERATIONS,
+    pq_variants,
+    "fill", "simulate", "drain"
 );
 
 KERNEL_REGISTER(priority_queue)
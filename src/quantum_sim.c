@@ -9,8 +9,16 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+#include <immintrin.h>
+#endif
+
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * QUANTUM_NUM_QUBITS is the tier S register; each tier adds 4 qubits so the
+ * state vector grows with bench_scale(), up to QUANTUM_MAX_QUBITS. The
+ * default keeps every tier cache-resident or close to it; 20+ qubits
+ * (make QUANTUM_NUM_QUBITS=20, 8 MB per layout) make it bandwidth-bound.
  * ============================================================================ */
 
 #ifndef QUANTUM_NUM_QUBITS
@@ -21,13 +29,20 @@
 #define QUANTUM_NUM_GATES       20      /* Number of gate operations */
 #endif
 
+#ifndef QUANTUM_MAX_QUBITS
+#define QUANTUM_MAX_QUBITS      24      /* 2^24 states, 128 MB per layout */
+#endif
+
+#ifndef QUANTUM_FUSE_QUBITS
+#define QUANTUM_FUSE_QUBITS     4       /* Qubits per fused gate run (blocks of 16) */
+#endif
+
+#define QUANTUM_MAX_RUN         32      /* Gates per fused run */
+
 #ifndef QUANTUM_FACTOR_N
 #define QUANTUM_FACTOR_N        15      /* Number to factor (small for micro) */
 #endif
 
-/* Derived constants */
-#define QUANTUM_NUM_STATES      (1 << QUANTUM_NUM_QUBITS)
-
 /* Fixed-point arithmetic for complex numbers (avoid FP on bare-metal) */
 #define QFIXED_SHIFT            16
 #define QFIXED_ONE              (1 << QFIXED_SHIFT)
@@ -38,22 +53,78 @@
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_GATES, PHASE_QFT, PHASE_SHOR, PHASE_PROB };
+
 /* Complex number in fixed-point */
 typedef struct {
     int32_t real;       /* Fixed-point real part */
     int32_t imag;       /* Fixed-point imaginary part */
 } qcomplex_t;
 
-/* Quantum register */
+/* Quantum register (amplitudes are arena-allocated in init) */
 typedef struct {
-    qcomplex_t amplitude[QUANTUM_NUM_STATES];
+    qcomplex_t *amplitude;
     int num_qubits;
     int num_states;
 } qreg_t;
 
+/* Gate types, numbered as the random circuit draws them */
+typedef enum { GATE_H, GATE_X, GATE_Z, GATE_S, GATE_CNOT, GATE_TOFFOLI } gate_type_t;
+
+/* Gate on num_q qubits: controls first, target last */
+typedef struct {
+    uint8_t type;
+    uint8_t num_q;
+    int8_t q[3];
+} gate_t;
+
+/* Fused run: gates[first..first+count) acting only on the qubits in qmask */
+typedef struct {
+    int first;
+    int count;
+    uint32_t qmask;
+} gate_run_t;
+
+/* Block op of a compiled run: H on slot pairs (a, b), Z or S on slots a */
+typedef struct {
+    uint8_t type;
+    uint8_t num;
+    uint8_t a[1 << (QUANTUM_FUSE_QUBITS - 1)];
+    uint8_t b[1 << (QUANTUM_FUSE_QUBITS - 1)];
+} block_op_t;
+
+/* Run compiled for one block of 2^|Q| amplitudes */
+typedef struct {
+    int size;
+    int num_ops;
+    uint32_t off[1 << QUANTUM_FUSE_QUBITS];     /* Member offsets from the block base */
+    uint8_t perm[1 << QUANTUM_FUSE_QUBITS];     /* Slot holding each member once done */
+    uint8_t after[QUANTUM_MAX_RUN];             /* Ops applied when gate g is done */
+    block_op_t ops[QUANTUM_MAX_RUN];
+} run_plan_t;
+
+/* SoA engine: how one compiled run is swept over re[]/im[], and whether to fuse */
+typedef struct {
+    void (*sweep)(const run_plan_t *plan, uint32_t qmask, int count, uint32_t *sums);
+    bool fuse;
+} soa_engine_t;
+
+/* QFT: n Hadamards plus three gates per qubit pair */
+#define QFT_MAX_GATES   (QUANTUM_MAX_QUBITS * (3 * QUANTUM_MAX_QUBITS - 1) / 2 + 2)
+
 /* Static storage */
-static qreg_t qreg;
-static uint32_t measurement_results[QUANTUM_NUM_GATES];
+static BENCH_TLS qreg_t qreg;
+static BENCH_TLS int32_t *soa_re;             /* SoA state, arena-allocated in init */
+static BENCH_TLS int32_t *soa_im;
+static BENCH_TLS gate_t circuit[QUANTUM_NUM_GATES];
+static BENCH_TLS gate_t qft_gates[QFT_MAX_GATES];     /* H(0) H(1) QFT */
+static BENCH_TLS gate_t *shor_qft_gates;              /* QFT alone, qft_gates + 2 */
+static BENCH_TLS gate_t hadamard_layer[QUANTUM_MAX_QUBITS];
+static BENCH_TLS int num_qft_gates;
+static BENCH_TLS gate_run_t soa_runs[QFT_MAX_GATES];
+static BENCH_TLS run_plan_t soa_plan;
+static BENCH_TLS uint32_t gate_sums[QUANTUM_NUM_GATES];
 
 /* ============================================================================
  * Fixed-point Complex Arithmetic
@@ -120,9 +191,6 @@ INLINE int32_t qcomplex_prob(qcomplex_t a)
 /* Initialize register to |0...0> state */
 static void qreg_init(qreg_t *reg)
 {
-    reg->num_qubits = QUANTUM_NUM_QUBITS;
-    reg->num_states = QUANTUM_NUM_STATES;
-
     for (int i = 0; i < reg->num_states; i++) {
         reg->amplitude[i] = qcomplex_zero();
     }
@@ -365,17 +433,506 @@ static uint32_t shor_order_finding(uint32_t n, uint32_t a, uint32_t seed)
     return result;
 }
 
+/* ============================================================================
+ * Gate Lists
+ * The random circuit, the QFT and Shor's Hadamard layer as gate_t lists,
+ * in the order the reference applies them.
+ * ============================================================================ */
+
+static int qft_gate_list(gate_t *list, int num_qubits)
+{
+    int n = 0;
+
+    for (int q = num_qubits - 1; q >= 0; q--) {
+        list[n++] = (gate_t){ GATE_H, 1, { (int8_t)q } };
+        for (int j = q - 1; j >= 0; j--) {
+            list[n++] = (gate_t){ GATE_CNOT, 2, { (int8_t)j, (int8_t)q } };
+            list[n++] = (gate_t){ GATE_S, 1, { (int8_t)q } };
+            list[n++] = (gate_t){ GATE_CNOT, 2, { (int8_t)j, (int8_t)q } };
+        }
+    }
+    return n;
+}
+
+/* Reference: one sweep per gate */
+static void apply_gate_ref(qreg_t *reg, const gate_t *g)
+{
+    switch (g->type) {
+    case GATE_H:        gate_hadamard(reg, g->q[0]); break;
+    case GATE_X:        gate_pauli_x(reg, g->q[0]); break;
+    case GATE_Z:        gate_pauli_z(reg, g->q[0]); break;
+    case GATE_S:        gate_phase(reg, g->q[0]); break;
+    case GATE_CNOT:     gate_cnot(reg, g->q[0], g->q[1]); break;
+    case GATE_TOFFOLI:  gate_toffoli(reg, g->q[0], g->q[1], g->q[2]); break;
+    }
+}
+
+/* ============================================================================
+ * Gate Fusion
+ * Consecutive gates are grouped into runs touching at most `limit` qubits
+ * (the union Q). Every gate of a run pairs amplitudes whose indices differ
+ * only in Q bits, so the state splits into independent blocks of 2^|Q|
+ * amplitudes: one sweep loads each block, applies the whole run to it and
+ * stores it back, instead of one sweep per gate. limit = 1 gives one gate
+ * per run (the unfused SoA engine).
+ *
+ * Each run is compiled once into block ops. X, CNOT and Toffoli only
+ * permute amplitudes, so they are folded into a slot relabelling applied
+ * when the block is stored; H, Z and S become ops on fixed block slots.
+ * A permutation leaves the state's sum unchanged, so the per-gate sums the
+ * reference checksums are taken from the op count reached after each gate.
+ * ============================================================================ */
+
+INLINE uint32_t gate_qmask(const gate_t *g)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < g->num_q; i++) mask |= 1u << g->q[i];
+    return mask;
+}
+
+static int plan_runs(const gate_t *gates, int num_gates, int limit, gate_run_t *runs)
+{
+    int num_runs = 0;
+
+    for (int i = 0; i < num_gates;) {
+        gate_run_t *run = &runs[num_runs++];
+        run->first = i;
+        run->qmask = gate_qmask(&gates[i++]);
+
+        while (limit > 1 && i < num_gates && i - run->first < QUANTUM_MAX_RUN &&
+               __builtin_popcount(run->qmask | gate_qmask(&gates[i])) <= limit) {
+            run->qmask |= gate_qmask(&gates[i++]);
+        }
+        run->count = i - run->first;
+    }
+    return num_runs;
+}
+
+static void compile_run(const gate_t *gates, const gate_run_t *run, run_plan_t *plan)
+{
+    uint32_t qmask = run->qmask;
+
+    /* Block member offsets: local index bit b is the b-th qubit of Q */
+    plan->size = 1 << __builtin_popcount(qmask);
+    for (int l = 0; l < plan->size; l++) {
+        uint32_t o = 0, bits = qmask;
+        for (int b = 0; bits; b++) {
+            int q = __builtin_ctz(bits);
+            bits &= bits - 1;
+            if (l & (1 << b)) o |= 1u << q;
+        }
+        plan->off[l] = o;
+        plan->perm[l] = (uint8_t)l;
+    }
+
+    plan->num_ops = 0;
+    for (int g = 0; g < run->count; g++) {
+        const gate_t *src = &gates[run->first + g];
+        uint32_t m[3], controls = 0;
+
+        for (int i = 0; i < src->num_q; i++) {
+            m[i] = 1u << __builtin_popcount(qmask & ((1u << src->q[i]) - 1));
+            if (i < src->num_q - 1) controls |= m[i];
+        }
+        uint32_t t = m[src->num_q - 1];
+
+        if (src->type == GATE_H || src->type == GATE_Z || src->type == GATE_S) {
+            block_op_t *op = &plan->ops[plan->num_ops++];
+            op->type = src->type;
+            op->num = 0;
+            for (int l = 0; l < plan->size; l++) {
+                if (src->type == GATE_H && !(l & t)) {
+                    op->a[op->num] = plan->perm[l];
+                    op->b[op->num++] = plan->perm[l | t];
+                } else if (src->type != GATE_H && (l & t)) {
+                    op->a[op->num++] = plan->perm[l];
+                }
+            }
+        } else {
+            for (int l = 0; l < plan->size; l++) {
+                if ((l & controls) == controls && !(l & t)) {
+                    uint8_t tmp = plan->perm[l];
+                    plan->perm[l] = plan->perm[l | t];
+                    plan->perm[l | t] = tmp;
+                }
+            }
+        }
+        plan->after[g] = (uint8_t)plan->num_ops;
+    }
+}
+
+/* Next block base: count up over the index bits outside `fixed` */
+INLINE uint32_t next_base(uint32_t base, uint32_t fixed)
+{
+    return ((base | fixed) + 1) & ~fixed;
+}
+
+static void block_op_scalar(const block_op_t *op, int32_t *re, int32_t *im)
+{
+    switch (op->type) {
+    case GATE_H:
+        for (int p = 0; p < op->num; p++) {
+            int a = op->a[p], b = op->b[p];
+            qcomplex_t a0 = { re[a], im[a] }, a1 = { re[b], im[b] };
+            qcomplex_t sum = qcomplex_scale(qcomplex_add(a0, a1), QFIXED_SQRT2_INV);
+            qcomplex_t diff = qcomplex_scale(qcomplex_sub(a0, a1), QFIXED_SQRT2_INV);
+            re[a] = sum.real;
+            im[a] = sum.imag;
+            re[b] = diff.real;
+            im[b] = diff.imag;
+        }
+        break;
+    case GATE_Z:
+        for (int p = 0; p < op->num; p++) {
+            re[op->a[p]] = -re[op->a[p]];
+            im[op->a[p]] = -im[op->a[p]];
+        }
+        break;
+    case GATE_S:
+        for (int p = 0; p < op->num; p++) {
+            int32_t tmp = re[op->a[p]];
+            re[op->a[p]] = -im[op->a[p]];
+            im[op->a[p]] = tmp;
+        }
+        break;
+    }
+}
+
+/* Sweep for any run; sums[g] (if non-NULL) gets the sum of re + im after
+ * gate g of the run, what the reference's per-gate checksum loop adds */
+static void sweep_scalar(const run_plan_t *plan, uint32_t qmask, int count, uint32_t *sums)
+{
+    int32_t re[1 << QUANTUM_FUSE_QUBITS], im[1 << QUANTUM_FUSE_QUBITS];
+    uint32_t block_sum[QUANTUM_MAX_RUN + 1];
+    uint32_t num_states = (uint32_t)qreg.num_states;
+    int size = plan->size;
+
+    for (uint32_t base = 0; base < num_states; base = next_base(base, qmask)) {
+        for (int l = 0; l < size; l++) {
+            re[l] = soa_re[base + plan->off[l]];
+            im[l] = soa_im[base + plan->off[l]];
+        }
+        for (int o = 0; o <= plan->num_ops; o++) {
+            if (o > 0) block_op_scalar(&plan->ops[o - 1], re, im);
+            if (sums) {
+                uint32_t s = 0;
+                for (int l = 0; l < size; l++) s += (uint32_t)re[l] + (uint32_t)im[l];
+                block_sum[o] = s;
+            }
+        }
+        if (sums) {
+            for (int g = 0; g < count; g++) sums[g] += block_sum[plan->after[g]];
+        }
+        for (int l = 0; l < size; l++) {
+            soa_re[base + plan->off[l]] = re[plan->perm[l]];
+            soa_im[base + plan->off[l]] = im[plan->perm[l]];
+        }
+    }
+}
+
+#if defined(ARCH_X86_64)
+
+/* (x * QFIXED_SQRT2_INV) >> QFIXED_SHIFT per int32 lane: bits 16..47 of
+ * the 64-bit products, the same for logical and arithmetic shifts */
+__attribute__((target("sse4.1")))
+INLINE __m128i scale_sse41(__m128i x)
+{
+    const __m128i k = _mm_set1_epi32(QFIXED_SQRT2_INV);
+    __m128i even = _mm_srli_epi64(_mm_mul_epi32(x, k), QFIXED_SHIFT);
+    __m128i odd = _mm_slli_epi64(_mm_mul_epi32(_mm_srli_epi64(x, 32), k), 32 - QFIXED_SHIFT);
+    return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+__attribute__((target("sse4.1")))
+static void block_op_sse41(const block_op_t *op, __m128i *re, __m128i *im)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    switch (op->type) {
+    case GATE_H:
+        for (int p = 0; p < op->num; p++) {
+            int a = op->a[p], b = op->b[p];
+            __m128i r0 = re[a], i0 = im[a], r1 = re[b], i1 = im[b];
+            re[a] = scale_sse41(_mm_add_epi32(r0, r1));
+            im[a] = scale_sse41(_mm_add_epi32(i0, i1));
+            re[b] = scale_sse41(_mm_sub_epi32(r0, r1));
+            im[b] = scale_sse41(_mm_sub_epi32(i0, i1));
+        }
+        break;
+    case GATE_Z:
+        for (int p = 0; p < op->num; p++) {
+            re[op->a[p]] = _mm_sub_epi32(zero, re[op->a[p]]);
+            im[op->a[p]] = _mm_sub_epi32(zero, im[op->a[p]]);
+        }
+        break;
+    case GATE_S:
+        for (int p = 0; p < op->num; p++) {
+            __m128i tmp = re[op->a[p]];
+            re[op->a[p]] = _mm_sub_epi32(zero, im[op->a[p]]);
+            im[op->a[p]] = tmp;
+        }
+        break;
+    }
+}
+
+/* Lanes are 4 consecutive block bases; runs on qubits 0-1 go scalar */
+__attribute__((target("sse4.1")))
+static void sweep_sse41(const run_plan_t *plan, uint32_t qmask, int count, uint32_t *sums)
+{
+    if (qmask & 3) {
+        sweep_scalar(plan, qmask, count, sums);
+        return;
+    }
+
+    __m128i re[1 << QUANTUM_FUSE_QUBITS], im[1 << QUANTUM_FUSE_QUBITS];
+    __m128i acc[QUANTUM_MAX_RUN + 1];
+    uint32_t num_states = (uint32_t)qreg.num_states;
+    int size = plan->size;
+
+    for (int o = 0; o <= plan->num_ops; o++) acc[o] = _mm_setzero_si128();
+
+    for (uint32_t base = 0; base < num_states; base = next_base(base, qmask | 3)) {
+        for (int l = 0; l < size; l++) {
+            re[l] = _mm_load_si128((const __m128i *)&soa_re[base + plan->off[l]]);
+            im[l] = _mm_load_si128((const __m128i *)&soa_im[base + plan->off[l]]);
+        }
+        for (int o = 0; o <= plan->num_ops; o++) {
+            if (o > 0) block_op_sse41(&plan->ops[o - 1], re, im);
+            if (sums) {
+                for (int l = 0; l < size; l++) acc[o] = _mm_add_epi32(acc[o], _mm_add_epi32(re[l], im[l]));
+            }
+        }
+        for (int l = 0; l < size; l++) {
+            _mm_store_si128((__m128i *)&soa_re[base + plan->off[l]], re[plan->perm[l]]);
+            _mm_store_si128((__m128i *)&soa_im[base + plan->off[l]], im[plan->perm[l]]);
+        }
+    }
+
+    if (sums) {
+        for (int g = 0; g < count; g++) {
+            uint32_t lane[4];
+            _mm_storeu_si128((__m128i *)lane, acc[plan->after[g]]);
+            sums[g] += lane[0] + lane[1] + lane[2] + lane[3];
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+INLINE __m256i scale_avx2(__m256i x)
+{
+    const __m256i k = _mm256_set1_epi32(QFIXED_SQRT2_INV);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(x, k), QFIXED_SHIFT);
+    __m256i odd = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(x, 32), k), 32 - QFIXED_SHIFT);
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+__attribute__((target("avx2")))
+static void block_op_avx2(const block_op_t *op, __m256i *re, __m256i *im)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    switch (op->type) {
+    case GATE_H:
+        for (int p = 0; p < op->num; p++) {
+            int a = op->a[p], b = op->b[p];
+            __m256i r0 = re[a], i0 = im[a], r1 = re[b], i1 = im[b];
+            re[a] = scale_avx2(_mm256_add_epi32(r0, r1));
+            im[a] = scale_avx2(_mm256_add_epi32(i0, i1));
+            re[b] = scale_avx2(_mm256_sub_epi32(r0, r1));
+            im[b] = scale_avx2(_mm256_sub_epi32(i0, i1));
+        }
+        break;
+    case GATE_Z:
+        for (int p = 0; p < op->num; p++) {
+            re[op->a[p]] = _mm256_sub_epi32(zero, re[op->a[p]]);
+            im[op->a[p]] = _mm256_sub_epi32(zero, im[op->a[p]]);
+        }
+        break;
+    case GATE_S:
+        for (int p = 0; p < op->num; p++) {
+            __m256i tmp = re[op->a[p]];
+            re[op->a[p]] = _mm256_sub_epi32(zero, im[op->a[p]]);
+            im[op->a[p]] = tmp;
+        }
+        break;
+    }
+}
+
+/* Lanes are 8 consecutive block bases; runs on qubits 0-2 go scalar */
+__attribute__((target("avx2")))
+static void sweep_avx2(const run_plan_t *plan, uint32_t qmask, int count, uint32_t *sums)
+{
+    if (qmask & 7) {
+        sweep_scalar(plan, qmask, count, sums);
+        return;
+    }
+
+    __m256i re[1 << QUANTUM_FUSE_QUBITS], im[1 << QUANTUM_FUSE_QUBITS];
+    __m256i acc[QUANTUM_MAX_RUN + 1];
+    uint32_t num_states = (uint32_t)qreg.num_states;
+    int size = plan->size;
+
+    for (int o = 0; o <= plan->num_ops; o++) acc[o] = _mm256_setzero_si256();
+
+    for (uint32_t base = 0; base < num_states; base = next_base(base, qmask | 7)) {
+        for (int l = 0; l < size; l++) {
+            re[l] = _mm256_load_si256((const __m256i *)&soa_re[base + plan->off[l]]);
+            im[l] = _mm256_load_si256((const __m256i *)&soa_im[base + plan->off[l]]);
+        }
+        for (int o = 0; o <= plan->num_ops; o++) {
+            if (o > 0) block_op_avx2(&plan->ops[o - 1], re, im);
+            if (sums) {
+                for (int l = 0; l < size; l++) acc[o] = _mm256_add_epi32(acc[o], _mm256_add_epi32(re[l], im[l]));
+            }
+        }
+        for (int l = 0; l < size; l++) {
+            _mm256_store_si256((__m256i *)&soa_re[base + plan->off[l]], re[plan->perm[l]]);
+            _mm256_store_si256((__m256i *)&soa_im[base + plan->off[l]], im[plan->perm[l]]);
+        }
+    }
+
+    if (sums) {
+        for (int g = 0; g < count; g++) {
+            uint32_t lane[8];
+            _mm256_storeu_si256((__m256i *)lane, acc[plan->after[g]]);
+            uint32_t s = 0;
+            for (int i = 0; i < 8; i++) s += lane[i];
+            sums[g] += s;
+        }
+    }
+}
+
+#endif
+
+/* ============================================================================
+ * SoA Register Operations
+ * The non-gate steps of the kernel on the split re[]/im[] state: they are
+ * data-dependent (modular multiplication, sampling) and stay scalar.
+ * ============================================================================ */
+
+static void soa_init(void)
+{
+    memset(soa_re, 0, (size_t)qreg.num_states * sizeof(int32_t));
+    memset(soa_im, 0, (size_t)qreg.num_states * sizeof(int32_t));
+    soa_re[0] = QFIXED_ONE;
+}
+
+INLINE int32_t soa_prob(int i)
+{
+    qcomplex_t a = { soa_re[i], soa_im[i] };
+    return qcomplex_prob(a);
+}
+
+/* Gate list through the engine; sums[i] as in sweep_scalar, if non-NULL */
+static void soa_apply(const soa_engine_t *engine, const gate_t *gates, int num_gates, uint32_t *sums)
+{
+    int num_runs = plan_runs(gates, num_gates, engine->fuse ? QUANTUM_FUSE_QUBITS : 1, soa_runs);
+
+    for (int r = 0; r < num_runs; r++) {
+        const gate_run_t *run = &soa_runs[r];
+        compile_run(gates, run, &soa_plan);
+        engine->sweep(&soa_plan, run->qmask, run->count, sums ? sums + run->first : NULL);
+    }
+}
+
+static void soa_controlled_mod_mul(int ctrl, uint32_t a, uint32_t n)
+{
+    int cmask = 1 << ctrl;
+
+    for (int i = 0; i < qreg.num_states; i++) {
+        if (i & cmask) {
+            int value = i & ~cmask;
+            int new_value = (int)((uint64_t)value * a % n);
+
+            if (new_value != value && new_value < qreg.num_states) {
+                int j = new_value | cmask;
+                qcomplex_t sum = { soa_re[i] + soa_re[j], soa_im[i] + soa_im[j] };
+                sum = qcomplex_scale(sum, QFIXED_HALF);
+                soa_re[i] = soa_re[j] = sum.real;
+                soa_im[i] = soa_im[j] = sum.imag;
+            }
+        }
+    }
+}
+
+static int soa_measure(uint32_t rand_seed)
+{
+    int32_t max_prob = 0;
+    int max_state = 0;
+
+    for (int i = 0; i < qreg.num_states; i++) {
+        int32_t prob = soa_prob(i);
+        if (prob > max_prob) {
+            max_prob = prob;
+            max_state = i;
+        }
+    }
+
+    int32_t total_prob = 0;
+    for (int i = 0; i < qreg.num_states; i++) {
+        total_prob += soa_prob(i);
+    }
+
+    if (total_prob > 0) {
+        uint32_t x = rand_seed;
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        int32_t threshold = (int32_t)(x % (uint32_t)total_prob);
+
+        int32_t cumulative = 0;
+        for (int i = 0; i < qreg.num_states; i++) {
+            cumulative += soa_prob(i);
+            if (cumulative > threshold) {
+                return i;
+            }
+        }
+    }
+
+    return max_state;
+}
+
+static uint32_t soa_shor_order_finding(const soa_engine_t *engine, uint32_t n, uint32_t a,
+                                       uint32_t seed)
+{
+    soa_init();
+    soa_apply(engine, hadamard_layer, qreg.num_qubits, NULL);
+
+    for (int q = 0; q < qreg.num_qubits; q++) {
+        uint32_t exp = 1 << q;
+        uint32_t a_exp = mod_exp(a, exp, n);
+        soa_controlled_mod_mul(q, a_exp, n);
+    }
+
+    soa_apply(engine, shor_qft_gates, num_qft_gates - 2, NULL);
+
+    return soa_measure(seed);
+}
+
 /* ============================================================================
  * Test Sequence Generation
  * ============================================================================ */
 
-static void generate_gate_sequence(uint32_t seed)
+/* Random circuit over num_qubits qubits */
+static void generate_gate_sequence(gate_t *gates, int num_qubits, uint32_t seed)
 {
     uint32_t x = seed;
 
     for (int i = 0; i < QUANTUM_NUM_GATES; i++) {
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        measurement_results[i] = x;
+        int gate_type = x % 6;
+        int q1 = (x >> 8) % num_qubits;
+        int q2 = ((x >> 16) % (num_qubits - 1));
+        if (q2 >= q1) q2++;
+
+        if (gate_type == GATE_CNOT) {
+            gates[i] = (gate_t){ GATE_CNOT, 2, { (int8_t)q1, (int8_t)q2 } };
+        } else if (gate_type == GATE_TOFFOLI) {
+            int q3 = ((x >> 24) % (num_qubits - 2));
+            if (q3 >= q1) q3++;
+            if (q3 >= q2) q3++;
+            gates[i] = (gate_t){ GATE_TOFFOLI, 3, { (int8_t)q1, (int8_t)q2, (int8_t)q3 } };
+        } else {
+            gates[i] = (gate_t){ (uint8_t)gate_type, 1, { (int8_t)q1 } };
+        }
     }
 }
 
@@ -385,11 +942,26 @@ static void generate_gate_sequence(uint32_t seed)
 
 static void kernel_init_func(void)
 {
-    generate_gate_sequence(0xABCDEF01);
+    qreg.num_qubits = QUANTUM_NUM_QUBITS + 4 * (int)bench_tier;
+    if (qreg.num_qubits > QUANTUM_MAX_QUBITS) qreg.num_qubits = QUANTUM_MAX_QUBITS;
+    qreg.num_states = 1 << qreg.num_qubits;
+    qreg.amplitude = bench_alloc(qreg.num_states * sizeof(qcomplex_t));
+    soa_re = bench_alloc(qreg.num_states * sizeof(int32_t));
+    soa_im = bench_alloc(qreg.num_states * sizeof(int32_t));
+
+    generate_gate_sequence(circuit, qreg.num_qubits, 0x12345678);
+    qft_gates[0] = (gate_t){ GATE_H, 1, { 0 } };
+    qft_gates[1] = (gate_t){ GATE_H, 1, { 1 } };
+    num_qft_gates = 2 + qft_gate_list(qft_gates + 2, qreg.num_qubits);
+    shor_qft_gates = qft_gates + 2;
+    for (int q = 0; q < qreg.num_qubits; q++) {
+        hadamard_layer[q] = (gate_t){ GATE_H, 1, { (int8_t)q } };
+    }
     qreg_init(&qreg);
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; engine is NULL for the AoS reference, one sweep per gate */
+static bench_result_t quantum_run(const soa_engine_t *engine)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -397,71 +969,64 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Test 1: Random gate sequence */
-    qreg_init(&qreg);
-    uint32_t x = 0x12345678;
-
-    for (int i = 0; i < QUANTUM_NUM_GATES; i++) {
-        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        int gate_type = x % 6;
-        int q1 = (x >> 8) % qreg.num_qubits;
-        int q2 = ((x >> 16) % (qreg.num_qubits - 1));
-        if (q2 >= q1) q2++;
-
-        switch (gate_type) {
-            case 0:
-                gate_hadamard(&qreg, q1);
-                break;
-            case 1:
-                gate_pauli_x(&qreg, q1);
-                break;
-            case 2:
-                gate_pauli_z(&qreg, q1);
-                break;
-            case 3:
-                gate_phase(&qreg, q1);
-                break;
-            case 4:
-                gate_cnot(&qreg, q1, q2);
-                break;
-            case 5:
-                if (qreg.num_qubits >= 3) {
-                    int q3 = ((x >> 24) % (qreg.num_qubits - 2));
-                    if (q3 >= q1) q3++;
-                    if (q3 >= q2) q3++;
-                    gate_toffoli(&qreg, q1, q2, q3);
-                }
-                break;
+    BENCH_PHASE_BEGIN(PHASE_GATES);
+    int measure1;
+    if (engine) {
+        soa_init();
+        memset(gate_sums, 0, sizeof(gate_sums));
+        soa_apply(engine, circuit, QUANTUM_NUM_GATES, gate_sums);
+        for (int i = 0; i < QUANTUM_NUM_GATES; i++) {
+            csum = checksum_update(csum, gate_sums[i]);
         }
-
-        /* Checksum intermediate state */
-        int32_t sum = 0;
-        for (int j = 0; j < qreg.num_states; j++) {
-            sum += qreg.amplitude[j].real + qreg.amplitude[j].imag;
+        measure1 = soa_measure(0xDEADBEEF);
+    } else {
+        qreg_init(&qreg);
+        for (int i = 0; i < QUANTUM_NUM_GATES; i++) {
+            apply_gate_ref(&qreg, &circuit[i]);
+
+            /* Checksum intermediate state */
+            int32_t sum = 0;
+            for (int j = 0; j < qreg.num_states; j++) {
+                sum += qreg.amplitude[j].real + qreg.amplitude[j].imag;
+            }
+            csum = checksum_update(csum, (uint32_t)(int32_t)sum);
         }
-        csum = checksum_update(csum, (uint32_t)(int32_t)sum);
+        measure1 = qreg_measure(&qreg, 0xDEADBEEF);
     }
-
-    int measure1 = qreg_measure(&qreg, 0xDEADBEEF);
     csum = checksum_update(csum, (uint32_t)measure1);
+    BENCH_PHASE_END(PHASE_GATES);
 
     /* Test 2: QFT */
-    qreg_init(&qreg);
-    gate_hadamard(&qreg, 0);
-    gate_hadamard(&qreg, 1);
-    qft(&qreg);
-
-    int measure2 = qreg_measure(&qreg, 0xCAFEBABE);
+    BENCH_PHASE_BEGIN(PHASE_QFT);
+    int measure2;
+    if (engine) {
+        soa_init();
+        soa_apply(engine, qft_gates, num_qft_gates, NULL);
+        measure2 = soa_measure(0xCAFEBABE);
+    } else {
+        qreg_init(&qreg);
+        gate_hadamard(&qreg, 0);
+        gate_hadamard(&qreg, 1);
+        qft(&qreg);
+        measure2 = qreg_measure(&qreg, 0xCAFEBABE);
+    }
     csum = checksum_update(csum, (uint32_t)measure2);
+    BENCH_PHASE_END(PHASE_QFT);
 
     /* Test 3: Shor's order finding (simplified) */
-    uint32_t order_result = shor_order_finding(QUANTUM_FACTOR_N, 7, 0x13579BDF);
+    BENCH_PHASE_BEGIN(PHASE_SHOR);
+    uint32_t order_result = engine ? soa_shor_order_finding(engine, QUANTUM_FACTOR_N, 7, 0x13579BDF)
+                                   : shor_order_finding(QUANTUM_FACTOR_N, 7, 0x13579BDF);
+    BENCH_PHASE_END(PHASE_SHOR);
     csum = checksum_update(csum, order_result);
 
     /* Test 4: Full state probability calculation */
+    BENCH_PHASE_BEGIN(PHASE_PROB);
     int32_t total_prob = 0;
     for (int i = 0; i < qreg.num_states; i++) {
-        total_prob += qcomplex_prob(qreg.amplitude[i]);
+        total_prob += engine ? soa_prob(i) : qcomplex_prob(qreg.amplitude[i]);
     }
+    BENCH_PHASE_END(PHASE_PROB);
     csum = checksum_update(csum, (uint32_t)total_prob);
 
     BENCH_END();
@@ -477,6 +1042,37 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return quantum_run(NULL);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_avx2(void)
+{
+    static const soa_engine_t engine = { sweep_avx2, true };
+    return quantum_run(&engine);
+}
+
+static bench_result_t kernel_run_avx2_unfused(void)
+{
+    static const soa_engine_t engine = { sweep_avx2, false };
+    return quantum_run(&engine);
+}
+
+static bench_result_t kernel_run_sse41(void)
+{
+    static const soa_engine_t engine = { sweep_sse41, true };
+    return quantum_run(&engine);
+}
+#endif
+
+static bench_result_t kernel_run_fused(void)
+{
+    static const soa_engine_t engine = { sweep_scalar, true };
+    return quantum_run(&engine);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -486,7 +1082,18 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t quantum_variants[] = {
+#if defined(ARCH_X86_64)
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+    { "sse4.1", ISA_SSE41, kernel_run_sse41 },
+    { "avx2-unfused", ISA_AVX2, kernel_run_avx2_unfused },
+#endif
+    { "fused", 0, kernel_run_fused },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     quantum_sim,
     "Quantum gate simulation and Shor's algorithm",
     "462.libquantum",
@@ -494,7 +1101,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    QUANTUM_NUM_GATES
+    QUANTUM_NUM_GATES,
+    quantum_variants,
+    "random_gates", "qft", "shor", "probability"
 );
 
 KERNEL_REGISTER(quantum_sim)
@@ -0,0 +1,276 @@
+/*
+ * SPECInt2006-micro: rate.c
+ * SPECrate-style throughput mode: N concurrent copies of each kernel
+ *
+ * Native:      one pthread per extra copy, copy 0 on the main thread
+ *              (BENCH_RATE builds)
+ * nexus-am:    one MPE hart per copy (BENCH_MPE builds), copy 0 on hart 0
+ *
+ * Copies share nothing but the job slot below: kernel statics are BENCH_TLS
+ * and each copy allocates from its own arena (main.c).
+ */
+
+#include "bench.h"
+
+#if defined(NATIVE_BUILD)
+  #include <pthread.h>
+  #include <sched.h>
+  #include <time.h>
+#endif
+
+BENCH_TLS int bench_copy_id = 0;
+int bench_copies = 1;
+
+/* Current job, published to workers by bumping job_generation */
+static const kernel_desc_t *job_kernel;
+static const bench_config_t *job_config;
+static bench_stats_t copy_stats[BENCH_MAX_COPIES];
+static int job_generation = 0;
+static int job_done = 0;
+
+/* Copies taking part in rate_barrier() (1 outside rate_run) */
+static int barrier_copies = 1;
+static int barrier_count = 0;
+static int barrier_sense = 0;
+
+/* Spin-wait hint; natively the waiting thread gives up its CPU so that
+ * copies oversubscribing the host still make progress */
+INLINE void rate_relax(void)
+{
+#ifdef NATIVE_BUILD
+    sched_yield();
+#else
+    compiler_barrier();
+#endif
+}
+
+/* Idle wait between jobs; natively sleep so idle workers do not disturb
+ * the single-copy reference run on SMT siblings */
+INLINE void rate_idle(void)
+{
+#ifdef NATIVE_BUILD
+    struct timespec ts = { 0, 100 * 1000 };
+    nanosleep(&ts, NULL);
+#else
+    compiler_barrier();
+#endif
+}
+
+/*
+ * Line all copies up before a timed region (no-op outside rate_run)
+ * Sense-reversing barrier, uses only GCC atomics so it works on AM harts.
+ */
+void rate_barrier(void)
+{
+    static BENCH_TLS int local_sense = 0;
+    int copies = __atomic_load_n(&barrier_copies, __ATOMIC_ACQUIRE);
+
+    if (copies <= 1) return;
+
+    local_sense = !local_sense;
+    if (__atomic_add_fetch(&barrier_count, 1, __ATOMIC_ACQ_REL) == copies) {
+        __atomic_store_n(&barrier_count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&barrier_sense, local_sense, __ATOMIC_RELEASE);
+    } else {
+        while (__atomic_load_n(&barrier_sense, __ATOMIC_ACQUIRE) != local_sense) {
+            rate_relax();
+        }
+    }
+}
+
+/*
+ * Worker loop for copies 1..N-1: run each published job, exit on a NULL kernel
+ */
+static void rate_worker(int copy)
+{
+    int seen = 0;
+
+    bench_copy_id = copy;
+
+    for (;;) {
+        int gen;
+        while ((gen = __atomic_load_n(&job_generation, __ATOMIC_ACQUIRE)) == seen) {
+            rate_idle();
+        }
+        seen = gen;
+
+        if (!job_kernel) return;
+
+        copy_stats[copy] = bench_run(job_kernel, job_config);
+        __atomic_add_fetch(&job_done, 1, __ATOMIC_ACQ_REL);
+    }
+}
+
+/*
+ * Run one kernel on every copy at once; copy i's stats land in copy_stats_out[i]
+ */
+void rate_run(const kernel_desc_t *kernel, const bench_config_t *config,
+              bench_stats_t *copy_stats_out)
+{
+    job_kernel = kernel;
+    job_config = config;
+    __atomic_store_n(&job_done, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&barrier_copies, bench_copies, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&job_generation, 1, __ATOMIC_ACQ_REL);
+
+    copy_stats[0] = bench_run(kernel, config);
+
+    while (__atomic_load_n(&job_done, __ATOMIC_ACQUIRE) != bench_copies - 1) {
+        rate_relax();
+    }
+    __atomic_store_n(&barrier_copies, 1, __ATOMIC_RELEASE);
+
+    memcpy(copy_stats_out, copy_stats, bench_copies * sizeof(bench_stats_t));
+}
+
+/* ============================================================================
+ * Native: pthreads
+ * ============================================================================ */
+
+#if defined(NATIVE_BUILD) && defined(BENCH_RATE)
+
+static void *rate_thread(void *arg)
+{
+    rate_worker((int)(intptr_t)arg);
+    return NULL;
+}
+
+void rate_tls_init(void)
+{
+}
+
+/*
+ * Start copies-1 worker threads, run entry() as copy 0, then stop them
+ */
+bool rate_start(int copies, int (*entry)(void))
+{
+    pthread_t threads[BENCH_MAX_COPIES];
+    int started = 1;
+
+    bench_copies = copies;
+    while (started < copies) {
+        if (pthread_create(&threads[started], NULL, rate_thread, (void *)(intptr_t)started) != 0) {
+            printf("Failed to start rate copy %d\n", started);
+            break;
+        }
+        started++;
+    }
+
+    if (started == copies) {
+        entry();
+    }
+
+    /* A NULL job tells the workers to exit */
+    job_kernel = NULL;
+    __atomic_add_fetch(&job_generation, 1, __ATOMIC_ACQ_REL);
+    for (int i = 1; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    bench_copies = 1;
+
+    return started == copies;
+}
+
+/* ============================================================================
+ * nexus-am: MPE harts with per-hart TLS blocks
+ * ============================================================================ */
+
+#elif defined(BENCH_MPE)
+
+/*
+ * TLS image bounds, exported by the AM linker script:
+ *   .tdata : { _tdata_start = .; *(.tdata .tdata.*) _tdata_end = .; }
+ *   .tbss  : { *(.tbss .tbss.*) _tbss_end = .; }
+ */
+extern char _tdata_start[], _tdata_end[], _tbss_end[];
+
+#ifndef BENCH_TLS_SIZE
+#define BENCH_TLS_SIZE      (256 * 1024)    /* Per-hart TLS block */
+#endif
+
+static uint8_t tls_blocks[BENCH_MAX_COPIES][BENCH_TLS_SIZE] ALIGNED(64);
+static int (*rate_entry)(void);
+
+/*
+ * Point this hart's tp at a fresh copy of the TLS image
+ * Must run before the hart touches any BENCH_TLS variable.
+ */
+static void hart_tls_setup(int hart)
+{
+    size_t data_size = (size_t)(_tdata_end - _tdata_start);
+    size_t tls_size = (size_t)(_tbss_end - _tdata_start);
+
+    if (hart >= BENCH_MAX_COPIES || tls_size > BENCH_TLS_SIZE) {
+        halt(1);
+    }
+
+    uint8_t *block = tls_blocks[hart];
+    memcpy(block, _tdata_start, data_size);
+    memset(block + data_size, 0, tls_size - data_size);
+    __asm__ volatile ("mv tp, %0" :: "r"(block) : "memory");
+}
+
+void rate_tls_init(void)
+{
+    hart_tls_setup(0);
+}
+
+static void rate_hart_entry(void)
+{
+    int hart = cpu_current();
+
+    if (hart == 0) {
+        /* Hart 0 keeps the TLS block set up by rate_tls_init() */
+        halt(rate_entry());
+    }
+
+    hart_tls_setup(hart);
+    if (hart < bench_copies) {
+        rate_worker(hart);
+    }
+    for (;;) {
+        compiler_barrier();
+    }
+}
+
+/*
+ * Start one hart per copy and run entry() as copy 0; does not return
+ * when it succeeds (hart 0 halts once entry() finishes)
+ */
+bool rate_start(int copies, int (*entry)(void))
+{
+    if (copies > cpu_count()) {
+        printf("Rate mode: %d copies requested, %d harts available\n", copies, cpu_count());
+        return false;
+    }
+
+    bench_copies = copies;
+    rate_entry = entry;
+    mpe_init(rate_hart_entry);
+
+    return false;
+}
+
+/* ============================================================================
+ * Native without BENCH_RATE, nexus-am without BENCH_MPE: statics are
+ * shared, so no rate mode
+ * ============================================================================ */
+
+#else
+
+void rate_tls_init(void)
+{
+}
+
+bool rate_start(int copies, int (*entry)(void))
+{
+    UNUSED(entry);
+#ifdef NATIVE_BUILD
+    printf("Rate mode (%d copies) needs a BENCH_RATE=1 build\n", copies);
+#else
+    printf("Rate mode (%d copies) needs a BENCH_MPE=1 build\n", copies);
+#endif
+    return false;
+}
+
+#endif
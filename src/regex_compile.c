@@ -11,6 +11,8 @@
 
 /* ============================================================================
  * Configuration
+ * The match text is one copy of REGEX_SAMPLE_TEXT at tier S, and
+ * bench_scale(1) back-to-back copies at larger tiers.
  * ============================================================================ */
 
 #ifndef REGEX_MAX_STATES
@@ -29,10 +31,23 @@
 #define REGEX_MAX_PATTERN_LEN 32
 #endif
 
+#ifndef REGEX_DFA_STATES
+#define REGEX_DFA_STATES    32      /* Lazy DFA cache budget (states) */
+#endif
+
+#ifndef REGEX_DFA_MAX_FLUSHES
+#define REGEX_DFA_MAX_FLUSHES 8     /* Cache flushes per match before NFA fallback */
+#endif
+
+#define REGEX_SAMPLE_TEXT   "abctest123foo"
+
 /* ============================================================================
  * Data Structures (NFA representation)
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_COMPILE, PHASE_MATCH };
+
 /* Transition types */
 #define TRANS_EPSILON   0
 #define TRANS_CHAR      1
@@ -61,10 +76,36 @@ typedef struct {
     uint32_t char_classes[8];  /* Bitmask for character classes */
 } nfa_t;
 
+/* NFA state set, one bit per state */
+#define NFA_SET_WORDS   ((REGEX_MAX_STATES + 63) / 64)
+
+typedef struct {
+    uint64_t w[NFA_SET_WORDS];
+} nfa_set_t;
+
+/* Lazy DFA state: successors are DFA_NONE until first taken */
+#define DFA_NONE        (-1)
+#define DFA_HASH_SIZE   (2 * REGEX_DFA_STATES)    /* Power of two */
+
+typedef struct {
+    nfa_set_t set;
+    int16_t next[256];
+    uint8_t is_accept;
+    uint8_t is_dead;        /* Empty set */
+} dfa_state_t;
+
+/* Matcher entry point: 1 when the whole text is accepted */
+typedef int (*match_func_t)(const nfa_t *n, const char *text, int text_len);
+
 /* Static storage */
-static nfa_t nfa;
-static char patterns[REGEX_NUM_PATTERNS][REGEX_MAX_PATTERN_LEN];
-static int pattern_lengths[REGEX_NUM_PATTERNS];
+static BENCH_TLS nfa_t nfa;
+static BENCH_TLS char patterns[REGEX_NUM_PATTERNS][REGEX_MAX_PATTERN_LEN];
+static BENCH_TLS int pattern_lengths[REGEX_NUM_PATTERNS];
+static BENCH_TLS char *match_text;            /* Arena-allocated in init */
+static BENCH_TLS int match_len;
+static BENCH_TLS dfa_state_t *dfa_states;     /* Arena-allocated in init */
+static BENCH_TLS int16_t dfa_hash[DFA_HASH_SIZE];
+static BENCH_TLS int dfa_count;
 
 /* ============================================================================
  * NFA Construction (Thompson's construction)
@@ -315,6 +356,211 @@ static int nfa_match(const nfa_t *n, const char *text, int text_len)
     return 0;
 }
 
+/* ============================================================================
+ * Wide State Sets
+ * The same simulation as nfa_match on 64-bit words: active states are
+ * visited with ctz instead of testing every state, and sets are cleared
+ * and compared a word at a time.
+ * ============================================================================ */
+
+static void set_clear(nfa_set_t *s)
+{
+    for (int w = 0; w < NFA_SET_WORDS; w++) s->w[w] = 0;
+}
+
+static bool set_empty(const nfa_set_t *s)
+{
+    uint64_t any = 0;
+    for (int w = 0; w < NFA_SET_WORDS; w++) any |= s->w[w];
+    return any == 0;
+}
+
+static bool set_equal(const nfa_set_t *a, const nfa_set_t *b)
+{
+    uint64_t diff = 0;
+    for (int w = 0; w < NFA_SET_WORDS; w++) diff |= a->w[w] ^ b->w[w];
+    return diff == 0;
+}
+
+INLINE void set_add(nfa_set_t *s, int state)
+{
+    s->w[state >> 6] |= 1ULL << (state & 63);
+}
+
+INLINE bool set_has(const nfa_set_t *s, int state)
+{
+    return (s->w[state >> 6] >> (state & 63)) & 1;
+}
+
+/* Start state plus the single forward epsilon pass nfa_match makes */
+static void set_start(const nfa_t *n, nfa_set_t *s)
+{
+    set_clear(s);
+    set_add(s, n->start_state);
+
+    for (int i = 0; i < n->num_states; i++) {
+        if (!set_has(s, i)) continue;
+
+        int trans_start = n->states[i].trans_start;
+        int trans_end = trans_start + n->states[i].num_trans;
+        for (int t = trans_start; t < trans_end && t < n->num_trans; t++) {
+            if (n->transitions[t].type == TRANS_EPSILON) {
+                int16_t next = n->transitions[t].next_state;
+                if (next >= 0 && next < n->num_states) set_add(s, next);
+            }
+        }
+    }
+}
+
+/* One input character: next = states reached from cur on c */
+static void set_step(const nfa_t *n, const nfa_set_t *cur, char c, nfa_set_t *next)
+{
+    set_clear(next);
+
+    for (int w = 0; w < NFA_SET_WORDS; w++) {
+        uint64_t bits = cur->w[w];
+        while (bits) {
+            int i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            int trans_start = n->states[i].trans_start;
+            int trans_end = trans_start + n->states[i].num_trans;
+            for (int t = trans_start; t < trans_end && t < n->num_trans; t++) {
+                const nfa_trans_t *tr = &n->transitions[t];
+                int match = 0;
+
+                switch (tr->type) {
+                case TRANS_CHAR:
+                    match = (tr->ch == c);
+                    break;
+                case TRANS_ANY:
+                    match = (c != '\n');
+                    break;
+                case TRANS_CHARCLASS:
+                    match = (n->char_classes[tr->char_class] & (1U << (c & 31))) != 0;
+                    break;
+                }
+
+                if (match && tr->next_state >= 0 && tr->next_state < n->num_states) {
+                    set_add(next, tr->next_state);
+                }
+            }
+        }
+    }
+}
+
+static bool set_accepts(const nfa_t *n, const nfa_set_t *s)
+{
+    for (int w = 0; w < NFA_SET_WORDS; w++) {
+        uint64_t bits = s->w[w];
+        while (bits) {
+            int i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i < n->num_states && n->states[i].is_accept) return true;
+        }
+    }
+    return false;
+}
+
+/* Bitset NFA over text, starting from set cur (the DFA's fallback too) */
+static int nfa_run_bitset(const nfa_t *n, nfa_set_t cur, const char *text, int text_len)
+{
+    nfa_set_t next;
+
+    for (int pos = 0; pos < text_len; pos++) {
+        set_step(n, &cur, text[pos], &next);
+        cur = next;
+    }
+    return set_accepts(n, &cur);
+}
+
+static int nfa_match_bitset(const nfa_t *n, const char *text, int text_len)
+{
+    nfa_set_t start;
+    set_start(n, &start);
+    return nfa_run_bitset(n, start, text, text_len);
+}
+
+/* ============================================================================
+ * Lazy DFA (RE2-style subset construction on demand)
+ * A DFA state is an NFA state set; its 256 successors start unknown and are
+ * filled in by one set_step the first time each byte is seen. States live in
+ * a fixed cache of REGEX_DFA_STATES entries found through a hash of the set;
+ * a full cache is flushed and rebuilt from the current set, and after
+ * REGEX_DFA_MAX_FLUSHES flushes in one match the rest of the text runs on
+ * the bitset NFA (RE2 gives up on the DFA the same way).
+ * ============================================================================ */
+
+static void dfa_reset(void)
+{
+    dfa_count = 0;
+    for (int i = 0; i < DFA_HASH_SIZE; i++) dfa_hash[i] = DFA_NONE;
+}
+
+static uint32_t dfa_set_hash(const nfa_set_t *s)
+{
+    uint64_t h = 0;
+    for (int w = 0; w < NFA_SET_WORDS; w++) {
+        h = (h ^ s->w[w]) * 0x9E3779B97F4A7C15ULL;
+    }
+    return (uint32_t)(h >> 32) & (DFA_HASH_SIZE - 1);
+}
+
+/* Find or add the DFA state for set s; DFA_NONE when the cache is full */
+static int dfa_lookup(const nfa_t *n, const nfa_set_t *s)
+{
+    uint32_t h = dfa_set_hash(s);
+
+    while (dfa_hash[h] != DFA_NONE) {
+        if (set_equal(&dfa_states[dfa_hash[h]].set, s)) return dfa_hash[h];
+        h = (h + 1) & (DFA_HASH_SIZE - 1);
+    }
+    if (dfa_count >= REGEX_DFA_STATES) return DFA_NONE;
+
+    int id = dfa_count++;
+    dfa_state_t *d = &dfa_states[id];
+    d->set = *s;
+    d->is_accept = set_accepts(n, s);
+    d->is_dead = set_empty(s);
+    for (int c = 0; c < 256; c++) d->next[c] = DFA_NONE;
+    dfa_hash[h] = (int16_t)id;
+    return id;
+}
+
+static int dfa_match(const nfa_t *n, const char *text, int text_len)
+{
+    nfa_set_t set;
+    int flushes = 0;
+
+    dfa_reset();
+    set_start(n, &set);
+    int s = dfa_lookup(n, &set);
+
+    for (int pos = 0; pos < text_len; pos++) {
+        /* Empty set: nothing can accept any more */
+        if (dfa_states[s].is_dead) return 0;
+
+        uint8_t c = (uint8_t)text[pos];
+        int t = dfa_states[s].next[c];
+        if (t == DFA_NONE) {
+            set_step(n, &dfa_states[s].set, text[pos], &set);
+            t = dfa_lookup(n, &set);
+            if (t == DFA_NONE) {
+                if (++flushes > REGEX_DFA_MAX_FLUSHES) {
+                    return nfa_run_bitset(n, set, text + pos + 1, text_len - pos - 1);
+                }
+                dfa_reset();
+                t = dfa_lookup(n, &set);
+            } else {
+                dfa_states[s].next[c] = (int16_t)t;
+            }
+        }
+        s = t;
+    }
+
+    return dfa_states[s].is_accept;
+}
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -366,9 +612,21 @@ static void kernel_init_func(void)
 {
     generate_patterns(0x12345678);
     memset(&nfa, 0, sizeof(nfa));
+
+    /* Build the match text for the current tier */
+    int sample_len = (int)strlen(REGEX_SAMPLE_TEXT);
+    int copies = (int)bench_scale(1);
+    match_len = sample_len * copies;
+    match_text = bench_alloc(match_len + 1);
+    for (int i = 0; i < copies; i++) {
+        memcpy(match_text + i * sample_len, REGEX_SAMPLE_TEXT, sample_len);
+    }
+
+    dfa_states = bench_alloc(REGEX_DFA_STATES * sizeof(dfa_state_t));
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; match is nfa_match or one of the variants */
+static bench_result_t regex_run(match_func_t match)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -380,7 +638,9 @@ static bench_result_t kernel_run_func(void)
 
     /* Compile all patterns */
     for (int i = 0; i < REGEX_NUM_PATTERNS; i++) {
+        BENCH_PHASE_BEGIN(PHASE_COMPILE);
         regex_compile_pattern(&nfa, patterns[i], pattern_lengths[i]);
+        BENCH_PHASE_END(PHASE_COMPILE);
 
         total_states += nfa.num_states;
         total_trans += nfa.num_trans;
@@ -389,8 +649,9 @@ static bench_result_t kernel_run_func(void)
         csum = checksum_update(csum, (uint32_t)nfa.num_trans);
 
         /* Test match on sample text */
-        const char *test_text = "abctest123foo";
-        int matched = nfa_match(&nfa, test_text, strlen(test_text));
+        BENCH_PHASE_BEGIN(PHASE_MATCH);
+        int matched = match(&nfa, match_text, match_len);
+        BENCH_PHASE_END(PHASE_MATCH);
         csum = checksum_update(csum, (uint32_t)matched);
     }
 
@@ -408,6 +669,21 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return regex_run(nfa_match);
+}
+
+static bench_result_t kernel_run_dfa(void)
+{
+    return regex_run(dfa_match);
+}
+
+static bench_result_t kernel_run_bitset(void)
+{
+    return regex_run(nfa_match_bitset);
+}
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -416,7 +692,14 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t regex_variants[] = {
+    { "dfa", 0, kernel_run_dfa },
+    { "bitset", 0, kernel_run_bitset },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     regex_compile,
     "Regex NFA compilation",
     "400.perlbench",
@@ -424,7 +707,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    REGEX_NUM_PATTERNS
+    REGEX_NUM_PATTERNS,
+    regex_variants,
+    "compile", "nfa_match"
 );
 
 KERNEL_REGISTER(regex_compile)
@@ -0,0 +1,105 @@
+/*
+ * SPECInt2006-micro: roi.c
+ * Simulator region-of-interest markers around BENCH_START()/BENCH_END()
+ *
+ * nemu:    NEMU trap instruction (.insn r 0x6B) with a signal code in a0;
+ *          NEMU takes its checkpoint / starts profiling at NOTIFY_PROFILER
+ *          and stops at NOTIFY_PROFILE_EXIT
+ * none:    markers compile to nothing (native and plain AM builds)
+ */
+
+#include "bench.h"
+
+#if defined(BENCH_ROI_NEMU) && (defined(ARCH_RISCV64) || defined(ARCH_RISCV32)) && !defined(NATIVE_BUILD)
+  #define ROI_NEMU
+#endif
+
+/*
+ * Armed by the harness around the measured runs picked with --roi; only
+ * copy 0 arms it in rate mode so one hart drives the simulator.
+ */
+BENCH_TLS bool roi_armed = false;
+
+static int roi_count = 0;               /* Regions marked so far */
+
+/* ============================================================================
+ * NEMU backend
+ * ============================================================================ */
+
+#ifdef ROI_NEMU
+
+/* Signal codes understood by NEMU's nemu_trap handler (nexus-am nemu_signal) */
+#ifndef ROI_NEMU_BEGIN
+#define ROI_NEMU_BEGIN      0x101       /* NOTIFY_PROFILER */
+#endif
+
+#ifndef ROI_NEMU_END
+#define ROI_NEMU_END        0x102       /* NOTIFY_PROFILE_EXIT */
+#endif
+
+static void roi_signal(uintptr_t code)
+{
+    register uintptr_t a0 __asm__("a0") = code;
+    __asm__ volatile (".insn r 0x6B, 0, 0, x0, x0, x0" :: "r"(a0) : "memory");
+}
+
+static const char *const backend_name = "nemu";
+
+static void backend_begin(void)
+{
+    roi_signal(ROI_NEMU_BEGIN);
+}
+
+static void backend_end(void)
+{
+    roi_signal(ROI_NEMU_END);
+}
+
+/* ============================================================================
+ * No backend
+ * ============================================================================ */
+
+#else
+
+static const char *const backend_name = NULL;
+
+static void backend_begin(void)
+{
+}
+
+static void backend_end(void)
+{
+}
+
+#endif
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+bool roi_available(void)
+{
+    return backend_name != NULL;
+}
+
+const char *roi_backend_name(void)
+{
+    return backend_name ? backend_name : "none";
+}
+
+void roi_begin(void)
+{
+    roi_count++;
+    backend_begin();
+}
+
+void roi_end(void)
+{
+    backend_end();
+}
+
+/* Number of regions marked so far (all copies share copy 0's count) */
+int roi_regions(void)
+{
+    return roi_count;
+}
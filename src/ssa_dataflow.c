@@ -3,24 +3,29 @@
  * Captures SSA form and dataflow analysis from 403.gcc
  *
  * Pattern: Control flow graph, dominators, phi functions
- * Memory: Graph traversal with work lists
+ * Memory: Graph traversal with work lists, streaming bitset rows
  * Branch: Complex control flow patterns
+ *
+ * Variable and block sets are bitset rows of any width; variants run the
+ * set operations with SSE2/AVX2 or solve liveness by full sweeps.
  */
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+
 /* ============================================================================
  * Configuration
+ * CFG_MAX_BLOCKS and CFG_MAX_VARS are tier S sizes, scaled by
+ * bench_scale_dim() (blocks x vars sets grow x16 per tier).
  * ============================================================================ */
 
 #ifndef CFG_MAX_BLOCKS
 #define CFG_MAX_BLOCKS      64
 #endif
 
-#ifndef CFG_MAX_EDGES
-#define CFG_MAX_EDGES       128
-#endif
-
 #ifndef CFG_MAX_VARS
 #define CFG_MAX_VARS        32
 #endif
@@ -29,118 +34,294 @@
 #define CFG_NUM_CFGS        5
 #endif
 
+#define CFG_MAX_SUCCS       3       /* Fallthrough, branch, back edge */
+
+/* Bitset rows are padded to 256 bits so SIMD loops have no tail */
+#define BITSET_ROW_WORDS    4
+
 /* ============================================================================
  * Data Structures
  * ============================================================================ */
 
-/* Basic block */
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_GENERATE, PHASE_DOMINATORS, PHASE_FRONTIER, PHASE_PHI, PHASE_LIVENESS };
+
+/* Basic block; edges live in the CFG's CSR arrays */
 typedef struct {
-    int16_t id;
-    int16_t num_succs;
-    int16_t num_preds;
-    int16_t succs[4];       /* Successor blocks */
-    int16_t preds[4];       /* Predecessor blocks */
-    int16_t idom;           /* Immediate dominator */
-    int16_t dom_level;      /* Depth in dominator tree */
-    uint64_t def_vars;      /* Variables defined in this block */
-    uint64_t use_vars;      /* Variables used in this block */
-    uint64_t live_in;       /* Live-in variables */
-    uint64_t live_out;      /* Live-out variables */
-    uint8_t phi_funcs[CFG_MAX_VARS];  /* Phi function count per var */
+    int32_t idom;           /* Immediate dominator */
+    int32_t rpo;            /* Reverse postorder number */
+    int32_t phi_count;      /* Phi functions placed here */
 } basic_block_t;
 
-/* Control Flow Graph */
+/*
+ * Control Flow Graph
+ * Set families are row-major bitset matrices: row i of live_in is block
+ * i's live-in variables, row v of def_blocks is variable v's def sites.
+ */
 typedef struct {
-    basic_block_t blocks[CFG_MAX_BLOCKS];
-    int16_t num_blocks;
-    int16_t entry;
-    int16_t exit;
-    uint64_t dom_frontier[CFG_MAX_BLOCKS];  /* Dominance frontier sets */
+    basic_block_t *blocks;
+    int num_blocks;
+    int entry;
+    int exit;
+    int num_vars;
+    int var_words;          /* Row stride of variable sets */
+    int block_words;        /* Row stride of block sets */
+
+    int32_t *succ_start;    /* CSR: succs[succ_start[b] .. succ_start[b + 1]) */
+    int32_t *succs;
+    int32_t *pred_start;
+    int32_t *preds;
+    int32_t *order;         /* Blocks in reverse postorder */
+
+    uint64_t *def_vars;     /* Variables defined in each block */
+    uint64_t *use_vars;     /* Variables used in each block */
+    uint64_t *live_in;
+    uint64_t *live_out;
+    uint64_t *dom_frontier; /* Dominance frontier of each block */
+    uint64_t *def_blocks;   /* Blocks defining each variable */
+
+    /* Scratch */
+    int32_t *edge_src;
+    int32_t *edge_dst;
+    int32_t *stack;
+    int32_t *queue;
+    uint8_t *flags;
+    uint64_t *has_phi;
+    uint64_t *fresh;
 } cfg_t;
 
+/* Row operations; every variant reaches the same fixed points */
+typedef struct {
+    /* dst |= src */
+    void (*or_into)(uint64_t *dst, const uint64_t *src, int words);
+    /* in = use | (out & ~def); returns whether in changed */
+    bool (*transfer)(uint64_t *in, const uint64_t *out, const uint64_t *use,
+                     const uint64_t *def, int words);
+    /* fresh = df & ~has; has |= df */
+    void (*frontier_step)(uint64_t *fresh, uint64_t *has, const uint64_t *df, int words);
+    bool worklist;          /* Worklist liveness, else sweep to fixpoint */
+} bitset_engine_t;
+
 /* Static storage */
-static cfg_t cfg;
+static BENCH_TLS cfg_t cfg;
+static BENCH_TLS uint64_t transfer_count;     /* Liveness block visits */
+
+/* ============================================================================
+ * Bitset Rows
+ * ============================================================================ */
+
+INLINE int bitset_words(int bits)
+{
+    int words = (bits + 63) / 64;
+    return (words + BITSET_ROW_WORDS - 1) / BITSET_ROW_WORDS * BITSET_ROW_WORDS;
+}
+
+INLINE uint64_t *bitset_row(uint64_t *set, int row, int words)
+{
+    return set + (size_t)row * words;
+}
+
+INLINE void bitset_set(uint64_t *row, int bit)
+{
+    row[bit >> 6] |= 1ULL << (bit & 63);
+}
+
+INLINE bool bitset_test(const uint64_t *row, int bit)
+{
+    return (row[bit >> 6] >> (bit & 63)) & 1;
+}
+
+static int bitset_popcount(const uint64_t *row, int words)
+{
+    int count = 0;
+    for (int i = 0; i < words; i++) {
+        count += __builtin_popcountll(row[i]);
+    }
+    return count;
+}
+
+static void or_into_scalar(uint64_t *dst, const uint64_t *src, int words)
+{
+    for (int i = 0; i < words; i++) {
+        dst[i] |= src[i];
+    }
+}
+
+static bool transfer_scalar(uint64_t *in, const uint64_t *out, const uint64_t *use,
+                            const uint64_t *def, int words)
+{
+    uint64_t diff = 0;
+    for (int i = 0; i < words; i++) {
+        uint64_t w = use[i] | (out[i] & ~def[i]);
+        diff |= w ^ in[i];
+        in[i] = w;
+    }
+    return diff != 0;
+}
+
+static void frontier_step_scalar(uint64_t *fresh, uint64_t *has, const uint64_t *df, int words)
+{
+    for (int i = 0; i < words; i++) {
+        fresh[i] = df[i] & ~has[i];
+        has[i] |= df[i];
+    }
+}
+
+#if defined(ARCH_X86_64)
+
+__attribute__((target("sse2")))
+static void or_into_sse2(uint64_t *dst, const uint64_t *src, int words)
+{
+    for (int i = 0; i < words; i += 2) {
+        __m128i d = _mm_load_si128((const __m128i *)&dst[i]);
+        __m128i s = _mm_load_si128((const __m128i *)&src[i]);
+        _mm_store_si128((__m128i *)&dst[i], _mm_or_si128(d, s));
+    }
+}
+
+__attribute__((target("sse2")))
+static bool transfer_sse2(uint64_t *in, const uint64_t *out, const uint64_t *use,
+                          const uint64_t *def, int words)
+{
+    __m128i diff = _mm_setzero_si128();
+    for (int i = 0; i < words; i += 2) {
+        __m128i o = _mm_load_si128((const __m128i *)&out[i]);
+        __m128i u = _mm_load_si128((const __m128i *)&use[i]);
+        __m128i d = _mm_load_si128((const __m128i *)&def[i]);
+        __m128i old = _mm_load_si128((const __m128i *)&in[i]);
+        __m128i w = _mm_or_si128(u, _mm_andnot_si128(d, o));
+        diff = _mm_or_si128(diff, _mm_xor_si128(w, old));
+        _mm_store_si128((__m128i *)&in[i], w);
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF;
+}
+
+__attribute__((target("sse2")))
+static void frontier_step_sse2(uint64_t *fresh, uint64_t *has, const uint64_t *df, int words)
+{
+    for (int i = 0; i < words; i += 2) {
+        __m128i f = _mm_load_si128((const __m128i *)&df[i]);
+        __m128i h = _mm_load_si128((const __m128i *)&has[i]);
+        _mm_store_si128((__m128i *)&fresh[i], _mm_andnot_si128(h, f));
+        _mm_store_si128((__m128i *)&has[i], _mm_or_si128(h, f));
+    }
+}
+
+__attribute__((target("avx2")))
+static void or_into_avx2(uint64_t *dst, const uint64_t *src, int words)
+{
+    for (int i = 0; i < words; i += 4) {
+        __m256i d = _mm256_load_si256((const __m256i *)&dst[i]);
+        __m256i s = _mm256_load_si256((const __m256i *)&src[i]);
+        _mm256_store_si256((__m256i *)&dst[i], _mm256_or_si256(d, s));
+    }
+}
+
+__attribute__((target("avx2")))
+static bool transfer_avx2(uint64_t *in, const uint64_t *out, const uint64_t *use,
+                          const uint64_t *def, int words)
+{
+    __m256i diff = _mm256_setzero_si256();
+    for (int i = 0; i < words; i += 4) {
+        __m256i o = _mm256_load_si256((const __m256i *)&out[i]);
+        __m256i u = _mm256_load_si256((const __m256i *)&use[i]);
+        __m256i d = _mm256_load_si256((const __m256i *)&def[i]);
+        __m256i old = _mm256_load_si256((const __m256i *)&in[i]);
+        __m256i w = _mm256_or_si256(u, _mm256_andnot_si256(d, o));
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(w, old));
+        _mm256_store_si256((__m256i *)&in[i], w);
+    }
+    return !_mm256_testz_si256(diff, diff);
+}
+
+__attribute__((target("avx2")))
+static void frontier_step_avx2(uint64_t *fresh, uint64_t *has, const uint64_t *df, int words)
+{
+    for (int i = 0; i < words; i += 4) {
+        __m256i f = _mm256_load_si256((const __m256i *)&df[i]);
+        __m256i h = _mm256_load_si256((const __m256i *)&has[i]);
+        _mm256_store_si256((__m256i *)&fresh[i], _mm256_andnot_si256(h, f));
+        _mm256_store_si256((__m256i *)&has[i], _mm256_or_si256(h, f));
+    }
+}
+
+#endif /* ARCH_X86_64 */
 
 /* ============================================================================
  * Dominator Tree Construction (Cooper-Harvey-Kennedy algorithm)
  * ============================================================================ */
 
-/* Intersect function for dominator computation */
-static int16_t intersect(const cfg_t *g, int16_t b1, int16_t b2)
+/* Number blocks in reverse postorder of a DFS from the entry */
+static void compute_rpo(cfg_t *g)
 {
-    int16_t finger1 = b1;
-    int16_t finger2 = b2;
-    int max_iters = CFG_MAX_BLOCKS * 2;  /* Safety bound */
-
-    while (finger1 != finger2 && max_iters-- > 0) {
-        while (g->blocks[finger1].dom_level > g->blocks[finger2].dom_level && max_iters-- > 0) {
-            int16_t next = g->blocks[finger1].idom;
-            if (next < 0 || next >= g->num_blocks || next == finger1) break;
-            finger1 = next;
-        }
-        while (g->blocks[finger2].dom_level > g->blocks[finger1].dom_level && max_iters-- > 0) {
-            int16_t next = g->blocks[finger2].idom;
-            if (next < 0 || next >= g->num_blocks || next == finger2) break;
-            finger2 = next;
-        }
-        /* If dom_levels are equal but fingers differ, move both up */
-        if (finger1 != finger2 &&
-            g->blocks[finger1].dom_level == g->blocks[finger2].dom_level) {
-            int16_t next1 = g->blocks[finger1].idom;
-            int16_t next2 = g->blocks[finger2].idom;
-            if (next1 >= 0 && next1 < g->num_blocks && next1 != finger1) finger1 = next1;
-            if (next2 >= 0 && next2 < g->num_blocks && next2 != finger2) finger2 = next2;
+    int32_t *stack = g->stack;
+    int32_t *next_edge = g->queue;
+    int sp = 0;
+    int post = g->num_blocks;
+
+    memset(g->flags, 0, g->num_blocks);
+    stack[sp++] = g->entry;
+    next_edge[g->entry] = g->succ_start[g->entry];
+    g->flags[g->entry] = 1;
+
+    while (sp > 0) {
+        int b = stack[sp - 1];
+        if (next_edge[b] < g->succ_start[b + 1]) {
+            int s = g->succs[next_edge[b]++];
+            if (!g->flags[s]) {
+                g->flags[s] = 1;
+                next_edge[s] = g->succ_start[s];
+                stack[sp++] = s;
+            }
+        } else {
+            sp--;
+            g->order[--post] = b;
         }
     }
 
-    return finger1;
+    /* Every block is reachable through the fallthrough chain */
+    for (int i = 0; i < g->num_blocks; i++) {
+        g->blocks[g->order[i]].rpo = i;
+    }
+}
+
+/* Walk both fingers up the dominator tree until they meet */
+static int intersect(const cfg_t *g, int b1, int b2)
+{
+    while (b1 != b2) {
+        while (g->blocks[b1].rpo > g->blocks[b2].rpo) b1 = g->blocks[b1].idom;
+        while (g->blocks[b2].rpo > g->blocks[b1].rpo) b2 = g->blocks[b2].idom;
+    }
+    return b1;
 }
 
-/* Compute dominators using iterative algorithm */
+/* Compute dominators, iterating in reverse postorder */
 static void compute_dominators(cfg_t *g)
 {
-    /* Initialize */
+    compute_rpo(g);
+
     for (int i = 0; i < g->num_blocks; i++) {
         g->blocks[i].idom = -1;
-        g->blocks[i].dom_level = 0;
     }
     g->blocks[g->entry].idom = g->entry;
-    g->blocks[g->entry].dom_level = 0;
 
     /* Iterate until fixed point */
     int changed = 1;
     while (changed) {
         changed = 0;
 
-        for (int i = 0; i < g->num_blocks; i++) {
-            if (i == g->entry) continue;
-
-            basic_block_t *b = &g->blocks[i];
-            if (b->num_preds == 0) continue;
-
-            /* Find first processed predecessor */
-            int16_t new_idom = -1;
-            for (int p = 0; p < b->num_preds; p++) {
-                int16_t pred = b->preds[p];
-                if (g->blocks[pred].idom >= 0) {
-                    new_idom = pred;
-                    break;
-                }
-            }
-
-            if (new_idom < 0) continue;
+        for (int k = 1; k < g->num_blocks; k++) {
+            int b = g->order[k];
+            int new_idom = -1;
 
-            /* Intersect with other predecessors */
-            for (int p = 0; p < b->num_preds; p++) {
-                int16_t pred = b->preds[p];
-                if (pred != new_idom && g->blocks[pred].idom >= 0) {
-                    new_idom = intersect(g, pred, new_idom);
-                }
+            for (int e = g->pred_start[b]; e < g->pred_start[b + 1]; e++) {
+                int pred = g->preds[e];
+                if (g->blocks[pred].idom < 0) continue;
+                new_idom = new_idom < 0 ? pred : intersect(g, pred, new_idom);
             }
 
-            if (b->idom != new_idom) {
-                b->idom = new_idom;
-                b->dom_level = g->blocks[new_idom].dom_level + 1;
+            if (new_idom >= 0 && g->blocks[b].idom != new_idom) {
+                g->blocks[b].idom = new_idom;
                 changed = 1;
             }
         }
@@ -150,18 +331,17 @@ static void compute_dominators(cfg_t *g)
 /* Compute dominance frontiers */
 static void compute_dominance_frontier(cfg_t *g)
 {
-    for (int i = 0; i < g->num_blocks; i++) {
-        g->dom_frontier[i] = 0;
-    }
+    int bw = g->block_words;
+
+    memset(g->dom_frontier, 0, (size_t)g->num_blocks * bw * sizeof(uint64_t));
 
     for (int i = 0; i < g->num_blocks; i++) {
-        basic_block_t *b = &g->blocks[i];
-        if (b->num_preds < 2) continue;
+        if (g->pred_start[i + 1] - g->pred_start[i] < 2) continue;
 
-        for (int p = 0; p < b->num_preds; p++) {
-            int16_t runner = b->preds[p];
-            while (runner >= 0 && runner != b->idom) {
-                g->dom_frontier[runner] |= (1ULL << i);
+        for (int e = g->pred_start[i]; e < g->pred_start[i + 1]; e++) {
+            int runner = g->preds[e];
+            while (runner != g->blocks[i].idom) {
+                bitset_set(bitset_row(g->dom_frontier, runner, bw), i);
                 runner = g->blocks[runner].idom;
             }
         }
@@ -172,54 +352,42 @@ static void compute_dominance_frontier(cfg_t *g)
  * SSA Phi Function Placement
  * ============================================================================ */
 
-/* Place phi functions using dominance frontiers */
-static int place_phi_functions(cfg_t *g)
+/* Place phi functions at each variable's iterated dominance frontier */
+static int place_phi_functions(cfg_t *g, const bitset_engine_t *eng)
 {
+    int bw = g->block_words;
     int total_phi = 0;
 
-    /* Clear phi counts */
     for (int i = 0; i < g->num_blocks; i++) {
-        memset(g->blocks[i].phi_funcs, 0, CFG_MAX_VARS);
+        g->blocks[i].phi_count = 0;
     }
 
-    /* For each variable */
-    for (int v = 0; v < CFG_MAX_VARS; v++) {
-        uint64_t var_mask = 1ULL << v;
+    for (int v = 0; v < g->num_vars; v++) {
+        const uint64_t *defs = bitset_row(g->def_blocks, v, bw);
+        int sp = 0;
 
-        /* Find all blocks that define this variable */
-        uint64_t def_blocks = 0;
-        for (int i = 0; i < g->num_blocks; i++) {
-            if (g->blocks[i].def_vars & var_mask) {
-                def_blocks |= (1ULL << i);
+        /* Work list starts with the defining blocks */
+        for (int w = 0; w < bw; w++) {
+            for (uint64_t bits = defs[w]; bits; bits &= bits - 1) {
+                g->stack[sp++] = w * 64 + __builtin_ctzll(bits);
             }
         }
+        if (sp == 0) continue;
 
-        if (def_blocks == 0) continue;
-
-        /* Work list of blocks needing phi functions */
-        uint64_t worklist = def_blocks;
-        uint64_t has_phi = 0;
+        memset(g->has_phi, 0, bw * sizeof(uint64_t));
 
-        while (worklist) {
-            /* Get next block from worklist */
-            int b = 0;
-            while (!(worklist & (1ULL << b))) b++;
-            worklist &= ~(1ULL << b);
+        while (sp > 0) {
+            int b = g->stack[--sp];
 
-            /* Add phi to dominance frontier */
-            uint64_t df = g->dom_frontier[b];
-            while (df) {
-                int y = 0;
-                while (!(df & (1ULL << y))) y++;
-                df &= ~(1ULL << y);
-
-                if (!(has_phi & (1ULL << y))) {
-                    g->blocks[y].phi_funcs[v]++;
+            /* Blocks of DF(b) without a phi yet get one */
+            eng->frontier_step(g->fresh, g->has_phi, bitset_row(g->dom_frontier, b, bw), bw);
+            for (int w = 0; w < bw; w++) {
+                for (uint64_t bits = g->fresh[w]; bits; bits &= bits - 1) {
+                    int y = w * 64 + __builtin_ctzll(bits);
+                    g->blocks[y].phi_count++;
                     total_phi++;
-                    has_phi |= (1ULL << y);
-
-                    if (!(def_blocks & (1ULL << y))) {
-                        worklist |= (1ULL << y);
+                    if (!bitset_test(defs, y)) {
+                        g->stack[sp++] = y;
                     }
                 }
             }
@@ -233,36 +401,66 @@ static int place_phi_functions(cfg_t *g)
  * Liveness Analysis
  * ============================================================================ */
 
-/* Compute live-in and live-out sets */
-static void compute_liveness(cfg_t *g)
+/* live_out(b) = union of live_in of successors, then the transfer */
+INLINE bool liveness_visit(cfg_t *g, const bitset_engine_t *eng, int b)
 {
-    /* Initialize */
-    for (int i = 0; i < g->num_blocks; i++) {
-        g->blocks[i].live_in = 0;
-        g->blocks[i].live_out = 0;
-    }
+    int vw = g->var_words;
+    uint64_t *out = bitset_row(g->live_out, b, vw);
 
-    /* Iterate until fixed point (backward analysis) */
-    int changed = 1;
-    while (changed) {
-        changed = 0;
+    memset(out, 0, vw * sizeof(uint64_t));
+    for (int e = g->succ_start[b]; e < g->succ_start[b + 1]; e++) {
+        eng->or_into(out, bitset_row(g->live_in, g->succs[e], vw), vw);
+    }
 
-        for (int i = g->num_blocks - 1; i >= 0; i--) {
-            basic_block_t *b = &g->blocks[i];
+    transfer_count++;
+    return eng->transfer(bitset_row(g->live_in, b, vw), out,
+                         bitset_row(g->use_vars, b, vw),
+                         bitset_row(g->def_vars, b, vw), vw);
+}
 
-            /* live_out = union of live_in of successors */
-            uint64_t new_live_out = 0;
-            for (int s = 0; s < b->num_succs; s++) {
-                new_live_out |= g->blocks[b->succs[s]].live_in;
+/* Compute live-in and live-out sets */
+static void compute_liveness(cfg_t *g, const bitset_engine_t *eng)
+{
+    size_t set_words = (size_t)g->num_blocks * g->var_words;
+    int n = g->num_blocks;
+
+    memset(g->live_in, 0, set_words * sizeof(uint64_t));
+    memset(g->live_out, 0, set_words * sizeof(uint64_t));
+
+    if (!eng->worklist) {
+        /* Iterate until fixed point (backward analysis) */
+        int changed = 1;
+        while (changed) {
+            changed = 0;
+            for (int i = n - 1; i >= 0; i--) {
+                changed |= liveness_visit(g, eng, i);
             }
+        }
+        return;
+    }
 
-            /* live_in = use ∪ (live_out - def) */
-            uint64_t new_live_in = b->use_vars | (new_live_out & ~b->def_vars);
+    /* FIFO worklist seeded in postorder; a change requeues the preds */
+    int head = 0, count = n;
+    for (int i = 0; i < n; i++) {
+        g->queue[i] = g->order[n - 1 - i];
+        g->flags[i] = 1;
+    }
 
-            if (b->live_in != new_live_in || b->live_out != new_live_out) {
-                b->live_in = new_live_in;
-                b->live_out = new_live_out;
-                changed = 1;
+    while (count > 0) {
+        int b = g->queue[head];
+        head = head + 1 == n ? 0 : head + 1;
+        count--;
+        g->flags[b] = 0;
+
+        if (!liveness_visit(g, eng, b)) continue;
+
+        for (int e = g->pred_start[b]; e < g->pred_start[b + 1]; e++) {
+            int p = g->preds[e];
+            if (!g->flags[p]) {
+                int tail = head + count;
+                g->queue[tail >= n ? tail - n : tail] = p;
+                count++;
+                g->flags[p] = 1;
             }
         }
     }
@@ -272,103 +470,197 @@ static void compute_liveness(cfg_t *g)
  * Test CFG Generation
  * ============================================================================ */
 
-static void generate_cfg(cfg_t *g, uint32_t seed)
+INLINE uint32_t next_random(uint32_t *x)
+{
+    *x ^= *x << 13; *x ^= *x >> 17; *x ^= *x << 5;
+    return *x;
+}
+
+/* Random set of (about half of) num_vars variables */
+static void generate_vars(uint64_t *row, int num_vars, int words, uint32_t *x)
+{
+    for (int w = 0; w < words; w++) {
+        int bits = num_vars - w * 64;
+        if (bits <= 0) {
+            row[w] = 0;
+            continue;
+        }
+        uint64_t lo = next_random(x);
+        uint64_t word = bits > 32 ? lo | (uint64_t)next_random(x) << 32 : lo;
+        row[w] = bits >= 64 ? word : word & ((1ULL << bits) - 1);
+    }
+}
+
+static void generate_cfg(cfg_t *g, int max_blocks, uint32_t seed)
 {
     uint32_t x = seed;
+    int num_edges = 0;
 
     /* Generate random CFG with loops and branches */
-    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-    g->num_blocks = 8 + (x % (CFG_MAX_BLOCKS - 8));
+    g->num_blocks = 8 + (int)(next_random(&x) % (uint32_t)(max_blocks - 8));
     g->entry = 0;
     g->exit = g->num_blocks - 1;
-
-    /* Initialize blocks */
-    for (int i = 0; i < g->num_blocks; i++) {
-        g->blocks[i].id = i;
-        g->blocks[i].num_succs = 0;
-        g->blocks[i].num_preds = 0;
-        g->blocks[i].idom = -1;
-        g->blocks[i].dom_level = 0;
-
-        /* Generate random def/use sets */
-        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        g->blocks[i].def_vars = x & ((1ULL << CFG_MAX_VARS) - 1);
-        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        g->blocks[i].use_vars = x & ((1ULL << CFG_MAX_VARS) - 1);
+    g->block_words = bitset_words(g->num_blocks);
+
+    int n = g->num_blocks;
+    int vw = g->var_words;
+    int bw = g->block_words;
+
+    /* Random def/use sets, and each variable's def sites */
+    memset(g->def_blocks, 0, (size_t)g->num_vars * bw * sizeof(uint64_t));
+    for (int i = 0; i < n; i++) {
+        uint64_t *def = bitset_row(g->def_vars, i, vw);
+        generate_vars(def, g->num_vars, vw, &x);
+        generate_vars(bitset_row(g->use_vars, i, vw), g->num_vars, vw, &x);
+
+        for (int w = 0; w < vw; w++) {
+            for (uint64_t bits = def[w]; bits; bits &= bits - 1) {
+                bitset_set(bitset_row(g->def_blocks, w * 64 + __builtin_ctzll(bits), bw), i);
+            }
+        }
     }
 
-    /* Add edges (ensure connectivity) */
-    for (int i = 0; i < g->num_blocks - 1; i++) {
-        /* Add fallthrough edge */
-        int succ = i + 1;
-        g->blocks[i].succs[g->blocks[i].num_succs++] = succ;
-        g->blocks[succ].preds[g->blocks[succ].num_preds++] = i;
+    /* Add edges (fallthrough ensures connectivity) */
+    for (int i = 0; i < n - 1; i++) {
+        g->edge_src[num_edges] = i;
+        g->edge_dst[num_edges++] = i + 1;
 
         /* Maybe add branch edge */
-        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
-        if ((x % 3) == 0 && g->blocks[i].num_succs < 4) {
-            int target = (i + 2 + (x % (g->num_blocks - i - 1))) % g->num_blocks;
-            if (target > i && g->blocks[target].num_preds < 4) {
-                g->blocks[i].succs[g->blocks[i].num_succs++] = target;
-                g->blocks[target].preds[g->blocks[target].num_preds++] = i;
+        next_random(&x);
+        if ((x % 3) == 0) {
+            int target = (int)((i + 2 + (x % (uint32_t)(n - i - 1))) % (uint32_t)n);
+            if (target > i) {
+                g->edge_src[num_edges] = i;
+                g->edge_dst[num_edges++] = target;
             }
         }
 
         /* Maybe add back edge (loop) */
-        if ((x % 5) == 0 && i > 2 && g->blocks[i].num_succs < 4) {
-            int target = x % i;
-            if (g->blocks[target].num_preds < 4) {
-                g->blocks[i].succs[g->blocks[i].num_succs++] = target;
-                g->blocks[target].preds[g->blocks[target].num_preds++] = i;
-            }
+        if ((x % 5) == 0 && i > 2) {
+            g->edge_src[num_edges] = i;
+            g->edge_dst[num_edges++] = (int)(x % (uint32_t)i);
         }
     }
+
+    /* CSR successor and predecessor lists, in edge order */
+    memset(g->succ_start, 0, (n + 1) * sizeof(int32_t));
+    memset(g->pred_start, 0, (n + 1) * sizeof(int32_t));
+    for (int e = 0; e < num_edges; e++) {
+        g->succ_start[g->edge_src[e] + 1]++;
+        g->pred_start[g->edge_dst[e] + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        g->succ_start[i + 1] += g->succ_start[i];
+        g->pred_start[i + 1] += g->pred_start[i];
+    }
+    for (int e = 0; e < num_edges; e++) {
+        int s = g->edge_src[e], d = g->edge_dst[e];
+        g->succs[g->succ_start[s]++] = d;
+        g->preds[g->pred_start[d]++] = s;
+    }
+    for (int i = n; i > 0; i--) {
+        g->succ_start[i] = g->succ_start[i - 1];
+        g->pred_start[i] = g->pred_start[i - 1];
+    }
+    g->succ_start[0] = 0;
+    g->pred_start[0] = 0;
 }
 
 /* ============================================================================
  * Kernel Implementation
  * ============================================================================ */
 
+static BENCH_TLS int max_blocks;
+
 static void kernel_init_func(void)
 {
-    memset(&cfg, 0, sizeof(cfg));
+    cfg_t *g = &cfg;
+    max_blocks = (int)bench_scale_dim(CFG_MAX_BLOCKS);
+
+    memset(g, 0, sizeof(*g));
+    g->num_vars = (int)bench_scale_dim(CFG_MAX_VARS);
+    g->var_words = bitset_words(g->num_vars);
+
+    int n = max_blocks;
+    int max_edges = CFG_MAX_SUCCS * n;
+    size_t var_set = (size_t)n * g->var_words * sizeof(uint64_t);
+    int bw = bitset_words(n);
+
+    g->blocks = bench_alloc(n * sizeof(basic_block_t));
+    g->succ_start = bench_alloc((n + 1) * sizeof(int32_t));
+    g->pred_start = bench_alloc((n + 1) * sizeof(int32_t));
+    g->succs = bench_alloc(max_edges * sizeof(int32_t));
+    g->preds = bench_alloc(max_edges * sizeof(int32_t));
+    g->edge_src = bench_alloc(max_edges * sizeof(int32_t));
+    g->edge_dst = bench_alloc(max_edges * sizeof(int32_t));
+    g->order = bench_alloc(n * sizeof(int32_t));
+    g->stack = bench_alloc(n * sizeof(int32_t));
+    g->queue = bench_alloc(n * sizeof(int32_t));
+    g->flags = bench_alloc(n);
+
+    g->def_vars = bench_alloc(var_set);
+    g->use_vars = bench_alloc(var_set);
+    g->live_in = bench_alloc(var_set);
+    g->live_out = bench_alloc(var_set);
+    g->dom_frontier = bench_alloc((size_t)n * bw * sizeof(uint64_t));
+    g->def_blocks = bench_alloc((size_t)g->num_vars * bw * sizeof(uint64_t));
+    g->has_phi = bench_alloc(bw * sizeof(uint64_t));
+    g->fresh = bench_alloc(bw * sizeof(uint64_t));
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver for all engines */
+static bench_result_t ssa_run(const bitset_engine_t *eng)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
     int total_phi = 0;
     int total_live = 0;
 
+    transfer_count = 0;
+
     /* Start timing */
     BENCH_START();
 
     for (int c = 0; c < CFG_NUM_CFGS; c++) {
         /* Generate CFG */
-        generate_cfg(&cfg, 0x12345678 + c * 1000);
+        BENCH_PHASE_BEGIN(PHASE_GENERATE);
+        generate_cfg(&cfg, max_blocks, 0x12345678 + c * 1000);
+        BENCH_PHASE_END(PHASE_GENERATE);
 
         /* Compute dominators */
+        BENCH_PHASE_BEGIN(PHASE_DOMINATORS);
         compute_dominators(&cfg);
+        BENCH_PHASE_END(PHASE_DOMINATORS);
 
         /* Compute dominance frontiers */
+        BENCH_PHASE_BEGIN(PHASE_FRONTIER);
         compute_dominance_frontier(&cfg);
+        BENCH_PHASE_END(PHASE_FRONTIER);
 
         /* Place phi functions */
-        int phi_count = place_phi_functions(&cfg);
+        BENCH_PHASE_BEGIN(PHASE_PHI);
+        int phi_count = place_phi_functions(&cfg, eng);
+        BENCH_PHASE_END(PHASE_PHI);
         total_phi += phi_count;
 
         /* Compute liveness */
-        compute_liveness(&cfg);
+        BENCH_PHASE_BEGIN(PHASE_LIVENESS);
+        compute_liveness(&cfg, eng);
+        BENCH_PHASE_END(PHASE_LIVENESS);
 
         /* Count live variables */
         for (int i = 0; i < cfg.num_blocks; i++) {
-            total_live += __builtin_popcountll(cfg.blocks[i].live_in);
-            total_live += __builtin_popcountll(cfg.blocks[i].live_out);
+            const uint64_t *in = bitset_row(cfg.live_in, i, cfg.var_words);
+            const uint64_t *df = bitset_row(cfg.dom_frontier, i, cfg.block_words);
+
+            total_live += bitset_popcount(in, cfg.var_words);
+            total_live += bitset_popcount(bitset_row(cfg.live_out, i, cfg.var_words), cfg.var_words);
 
             csum = checksum_update(csum, (uint32_t)cfg.blocks[i].idom);
-            csum = checksum_update(csum, (uint32_t)(cfg.blocks[i].live_in & 0xFFFFFFFF));
-            csum = checksum_update(csum, (uint32_t)cfg.dom_frontier[i]);
+            csum = checksum_update(csum, (uint32_t)in[0]);
+            csum = checksum_update(csum, (uint32_t)df[0]);
+            csum = checksum_update(csum, (uint32_t)bitset_popcount(df, cfg.block_words));
+            csum = checksum_update(csum, (uint32_t)cfg.blocks[i].phi_count);
         }
 
         csum = checksum_update(csum, (uint32_t)phi_count);
@@ -384,10 +676,45 @@ static bench_result_t kernel_run_func(void)
 
     result.cycles = BENCH_CYCLES();
     result.checksum = csum;
+    result.work = transfer_count;
 
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    static const bitset_engine_t engine = {
+        or_into_scalar, transfer_scalar, frontier_step_scalar, true
+    };
+    return ssa_run(&engine);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_avx2(void)
+{
+    static const bitset_engine_t engine = {
+        or_into_avx2, transfer_avx2, frontier_step_avx2, true
+    };
+    return ssa_run(&engine);
+}
+
+static bench_result_t kernel_run_sse2(void)
+{
+    static const bitset_engine_t engine = {
+        or_into_sse2, transfer_sse2, frontier_step_sse2, true
+    };
+    return ssa_run(&engine);
+}
+#endif
+
+static bench_result_t kernel_run_sweep(void)
+{
+    static const bitset_engine_t engine = {
+        or_into_scalar, transfer_scalar, frontier_step_scalar, false
+    };
+    return ssa_run(&engine);
+}
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -396,7 +723,17 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t ssa_variants[] = {
+#if defined(ARCH_X86_64)
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+    { "sse2", ISA_SSE2, kernel_run_sse2 },
+#endif
+    { "sweep", 0, kernel_run_sweep },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     ssa_dataflow,
     "SSA form and dataflow analysis",
     "403.gcc",
@@ -404,7 +741,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    CFG_NUM_CFGS
+    CFG_NUM_CFGS,
+    ssa_variants,
+    "generate", "dominators", "frontier", "place_phi", "liveness"
 );
 
 KERNEL_REGISTER(ssa_dataflow)
@@ -9,9 +9,13 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+#include <immintrin.h>
+#endif
 
 /* ============================================================================
  * Configuration
+ * TEXT_SIZE is the tier S size, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef TEXT_SIZE
@@ -30,13 +34,52 @@
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_KMP, PHASE_BMH, PHASE_AC_BUILD, PHASE_AC_SCAN, PHASE_PREFILTER };
+
 typedef struct {
     char pattern[PATTERN_MAX_LEN];
     int len;
 } pattern_t;
 
-static char text[TEXT_SIZE];
-static pattern_t patterns[NUM_PATTERNS];
+/* Per-pattern result: overlapping (KMP) and non-overlapping (BMH) counts */
+typedef struct {
+    int all;
+    int disjoint;
+    int next_end;           /* First end position a disjoint match may use */
+} match_count_t;
+
+/* Search engine: fills counts[NUM_PATTERNS] for the whole text */
+typedef void (*search_func_t)(const char *text, int text_len, match_count_t *counts);
+
+/* Aho-Corasick trie node; children are edges[edge_start..+num_edges) */
+#define AC_MAX_NODES    (NUM_PATTERNS * (PATTERN_MAX_LEN - 1) + 1)
+#define AC_NONE         (-1)
+
+typedef struct {
+    int16_t first_child;    /* Build-time sibling list */
+    int16_t next_sibling;
+    int16_t fail;
+    int16_t out;            /* First pattern ending here, AC_NONE if none */
+    int16_t out_link;       /* Nearest failure ancestor with an output */
+    int16_t edge_start;
+    uint8_t num_edges;
+    uint8_t label;          /* Byte on the edge from the parent */
+} ac_node_t;
+
+typedef struct {
+    uint8_t label;
+    int16_t child;
+} ac_edge_t;
+
+static BENCH_TLS char *text;                  /* Arena-allocated in init */
+static BENCH_TLS int text_size;
+static BENCH_TLS pattern_t patterns[NUM_PATTERNS];
+static BENCH_TLS ac_node_t ac_nodes[AC_MAX_NODES];
+static BENCH_TLS ac_edge_t ac_edges[AC_MAX_NODES];
+static BENCH_TLS int16_t *ac_dense;           /* [AC_MAX_NODES][256], arena */
+static BENCH_TLS int16_t ac_pattern_next[NUM_PATTERNS];
+static BENCH_TLS int ac_num_nodes;
 
 /* ============================================================================
  * Simple Pattern Matcher (KMP-style with wildcards)
@@ -152,6 +195,273 @@ static bool wildcard_match(const char *text, const char *pattern)
     return *text == '\0';
 }
 
+/* ============================================================================
+ * Match Counting
+ * Every engine reports occurrences by end position, in increasing order.
+ * `all` is what kmp_search counts; `disjoint` is what bmh_search counts,
+ * since after a hit it resumes with the window ending len bytes later.
+ * ============================================================================ */
+
+INLINE void count_match(match_count_t *count, int end, int len)
+{
+    count->all++;
+    if (end >= count->next_end) {
+        count->disjoint++;
+        count->next_end = end + len;
+    }
+}
+
+/* Reference engine: KMP and BMH, one text pass each per pattern */
+static void search_ref(const char *text, int text_len, match_count_t *counts)
+{
+    for (int i = 0; i < NUM_PATTERNS; i++) {
+        BENCH_PHASE_BEGIN(PHASE_KMP);
+        counts[i].all = kmp_search(text, text_len,
+                                   patterns[i].pattern, patterns[i].len);
+        BENCH_PHASE_END(PHASE_KMP);
+
+        BENCH_PHASE_BEGIN(PHASE_BMH);
+        counts[i].disjoint = bmh_search(text, text_len,
+                                        patterns[i].pattern, patterns[i].len);
+        BENCH_PHASE_END(PHASE_BMH);
+    }
+}
+
+/* ============================================================================
+ * Aho-Corasick Automaton
+ * One trie over all patterns with failure links, so the text is scanned once
+ * whatever NUM_PATTERNS is. Two transition layouts:
+ *   dense:   full DFA, int16 next[256] per node (failure links folded in)
+ *   sparse:  per-node sorted (label, child) edges plus a dense root row;
+ *            misses follow failure links at scan time
+ * The dense table is AC_MAX_NODES * 512 bytes; the sparse one a few bytes
+ * per node, at the cost of a search and failure chain per byte.
+ * ============================================================================ */
+
+static void ac_build(void)
+{
+    int16_t queue[AC_MAX_NODES];
+    int head = 0, tail = 0;
+
+    /* Trie, with children as sibling lists while inserting */
+    ac_num_nodes = 1;
+    ac_nodes[0] = (ac_node_t){ .first_child = AC_NONE, .next_sibling = AC_NONE,
+                               .out = AC_NONE, .out_link = AC_NONE };
+
+    for (int p = 0; p < NUM_PATTERNS; p++) {
+        int u = 0;
+        for (int k = 0; k < patterns[p].len; k++) {
+            uint8_t c = (uint8_t)patterns[p].pattern[k];
+            int v = ac_nodes[u].first_child;
+            while (v != AC_NONE && ac_nodes[v].label != c) v = ac_nodes[v].next_sibling;
+
+            if (v == AC_NONE) {
+                v = ac_num_nodes++;
+                ac_nodes[v] = (ac_node_t){ .first_child = AC_NONE, .out = AC_NONE,
+                                           .out_link = AC_NONE, .label = c };
+                ac_nodes[v].next_sibling = ac_nodes[u].first_child;
+                ac_nodes[u].first_child = (int16_t)v;
+            }
+            u = v;
+        }
+        /* Duplicate patterns share a node */
+        ac_pattern_next[p] = ac_nodes[u].out;
+        ac_nodes[u].out = (int16_t)p;
+    }
+
+    /* Root row: child or back to the root */
+    for (int c = 0; c < 256; c++) ac_dense[c] = 0;
+    for (int v = ac_nodes[0].first_child; v != AC_NONE; v = ac_nodes[v].next_sibling) {
+        ac_dense[ac_nodes[v].label] = (int16_t)v;
+        ac_nodes[v].fail = 0;
+        queue[tail++] = (int16_t)v;
+    }
+
+    /* BFS: a node's failure target is the parent's failure target's move on
+     * the same byte, already complete in the dense row of that shallower node */
+    while (head < tail) {
+        int u = queue[head++];
+        int16_t *row = &ac_dense[u * 256];
+        const int16_t *fail_row = &ac_dense[ac_nodes[u].fail * 256];
+
+        for (int c = 0; c < 256; c++) row[c] = fail_row[c];
+
+        for (int v = ac_nodes[u].first_child; v != AC_NONE; v = ac_nodes[v].next_sibling) {
+            ac_nodes[v].fail = fail_row[ac_nodes[v].label];
+            row[ac_nodes[v].label] = (int16_t)v;
+            queue[tail++] = (int16_t)v;
+        }
+
+        int f = ac_nodes[u].fail;
+        ac_nodes[u].out_link = ac_nodes[f].out != AC_NONE ? (int16_t)f : ac_nodes[f].out_link;
+    }
+
+    /* Sparse edges: each node's children contiguous and sorted by label */
+    int num_edges = 0;
+    for (int u = 0; u < ac_num_nodes; u++) {
+        ac_nodes[u].edge_start = (int16_t)num_edges;
+        for (int v = ac_nodes[u].first_child; v != AC_NONE; v = ac_nodes[v].next_sibling) {
+            int k = num_edges++;
+            while (k > ac_nodes[u].edge_start && ac_edges[k - 1].label > ac_nodes[v].label) {
+                ac_edges[k] = ac_edges[k - 1];
+                k--;
+            }
+            ac_edges[k].label = ac_nodes[v].label;
+            ac_edges[k].child = (int16_t)v;
+        }
+        ac_nodes[u].num_edges = (uint8_t)(num_edges - ac_nodes[u].edge_start);
+    }
+}
+
+/* Report every pattern ending at node s (its own and via output links) */
+INLINE void ac_report(int s, int end, match_count_t *counts)
+{
+    if (ac_nodes[s].out == AC_NONE) s = ac_nodes[s].out_link;
+
+    for (; s != AC_NONE; s = ac_nodes[s].out_link) {
+        for (int p = ac_nodes[s].out; p != AC_NONE; p = ac_pattern_next[p]) {
+            count_match(&counts[p], end, patterns[p].len);
+        }
+    }
+}
+
+static void search_ac_dense(const char *text, int text_len, match_count_t *counts)
+{
+    BENCH_PHASE_BEGIN(PHASE_AC_BUILD);
+    ac_build();
+    BENCH_PHASE_END(PHASE_AC_BUILD);
+
+    BENCH_PHASE_BEGIN(PHASE_AC_SCAN);
+    int s = 0;
+    for (int i = 0; i < text_len; i++) {
+        s = ac_dense[s * 256 + (uint8_t)text[i]];
+        if (ac_nodes[s].out != AC_NONE || ac_nodes[s].out_link != AC_NONE) {
+            ac_report(s, i, counts);
+        }
+    }
+    BENCH_PHASE_END(PHASE_AC_SCAN);
+}
+
+/* Child of u on byte c, or AC_NONE */
+INLINE int ac_sparse_child(int u, uint8_t c)
+{
+    const ac_edge_t *e = &ac_edges[ac_nodes[u].edge_start];
+    for (int k = 0; k < ac_nodes[u].num_edges && e[k].label <= c; k++) {
+        if (e[k].label == c) return e[k].child;
+    }
+    return AC_NONE;
+}
+
+static void search_ac_sparse(const char *text, int text_len, match_count_t *counts)
+{
+    BENCH_PHASE_BEGIN(PHASE_AC_BUILD);
+    ac_build();
+    BENCH_PHASE_END(PHASE_AC_BUILD);
+
+    BENCH_PHASE_BEGIN(PHASE_AC_SCAN);
+    int s = 0;
+    for (int i = 0; i < text_len; i++) {
+        uint8_t c = (uint8_t)text[i];
+        int v;
+        while (s != 0 && (v = ac_sparse_child(s, c)) == AC_NONE) s = ac_nodes[s].fail;
+        s = s != 0 ? v : ac_dense[c];
+
+        if (ac_nodes[s].out != AC_NONE || ac_nodes[s].out_link != AC_NONE) {
+            ac_report(s, i, counts);
+        }
+    }
+    BENCH_PHASE_END(PHASE_AC_SCAN);
+}
+
+/* ============================================================================
+ * SIMD Pair Prefilter
+ * Per pattern, compare a vector of text against the first byte and the
+ * vector len-1 bytes further on against the last byte; only positions where
+ * both hit are verified. Text from generate_text rarely pairs the two bytes
+ * at the right distance, so most vectors are rejected with no scalar work,
+ * unlike BMH whose skip is bounded by len.
+ * ============================================================================ */
+
+/* Verify the inner bytes of a candidate starting at pos */
+INLINE bool pattern_at(const char *text, int pos, const pattern_t *pat)
+{
+    for (int k = 1; k < pat->len - 1; k++) {
+        if (text[pos + k] != pat->pattern[k]) return false;
+    }
+    return true;
+}
+
+/* Candidates from start..text_len-len, scalar (vector loop tails) */
+static void prefilter_tail(const char *text, int text_len, int start,
+                           const pattern_t *pat, match_count_t *count)
+{
+    char first = pat->pattern[0];
+    char last = pat->pattern[pat->len - 1];
+
+    for (int i = start; i + pat->len <= text_len; i++) {
+        if (text[i] == first && text[i + pat->len - 1] == last && pattern_at(text, i, pat)) {
+            count_match(count, i + pat->len - 1, pat->len);
+        }
+    }
+}
+
+#if defined(ARCH_X86_64)
+
+static void search_sse2(const char *text, int text_len, match_count_t *counts)
+{
+    for (int p = 0; p < NUM_PATTERNS; p++) {
+        const pattern_t *pat = &patterns[p];
+        const __m128i first = _mm_set1_epi8(pat->pattern[0]);
+        const __m128i last = _mm_set1_epi8(pat->pattern[pat->len - 1]);
+        int i = 0;
+
+        BENCH_PHASE_BEGIN(PHASE_PREFILTER);
+        for (; i + 16 + pat->len - 1 <= text_len; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(text + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(text + i + pat->len - 1));
+            uint32_t mask = (uint32_t)_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+
+            while (mask) {
+                int pos = i + __builtin_ctz(mask);
+                mask &= mask - 1;
+                if (pattern_at(text, pos, pat)) count_match(&counts[p], pos + pat->len - 1, pat->len);
+            }
+        }
+        prefilter_tail(text, text_len, i, pat, &counts[p]);
+        BENCH_PHASE_END(PHASE_PREFILTER);
+    }
+}
+
+__attribute__((target("avx2")))
+static void search_avx2(const char *text, int text_len, match_count_t *counts)
+{
+    for (int p = 0; p < NUM_PATTERNS; p++) {
+        const pattern_t *pat = &patterns[p];
+        const __m256i first = _mm256_set1_epi8(pat->pattern[0]);
+        const __m256i last = _mm256_set1_epi8(pat->pattern[pat->len - 1]);
+        int i = 0;
+
+        BENCH_PHASE_BEGIN(PHASE_PREFILTER);
+        for (; i + 32 + pat->len - 1 <= text_len; i += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(text + i));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(text + i + pat->len - 1));
+            uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+
+            while (mask) {
+                int pos = i + __builtin_ctz(mask);
+                mask &= mask - 1;
+                if (pattern_at(text, pos, pat)) count_match(&counts[p], pos + pat->len - 1, pat->len);
+            }
+        }
+        prefilter_tail(text, text_len, i, pat, &counts[p]);
+        BENCH_PHASE_END(PHASE_PREFILTER);
+    }
+}
+
+#endif
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -205,31 +515,40 @@ static void generate_patterns(pattern_t *patterns, int count, const char *text,
 
 static void kernel_init_func(void)
 {
-    generate_text(text, TEXT_SIZE, 0x12345678);
+    text_size = (int)bench_scale(TEXT_SIZE);
+    text = bench_alloc(text_size);
+
+    generate_text(text, text_size, 0x12345678);
     generate_patterns(patterns, NUM_PATTERNS, text, 0xABCDEF00);
+
+    ac_dense = bench_alloc(AC_MAX_NODES * 256 * sizeof(int16_t));
+
+    /* Static pattern and automaton tables for --cache=cold */
+    bench_cache_region(patterns, sizeof(patterns));
+    bench_cache_region(ac_nodes, sizeof(ac_nodes));
+    bench_cache_region(ac_edges, sizeof(ac_edges));
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; search is search_ref or one of the variants */
+static bench_result_t string_run(search_func_t search)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
     int total_matches = 0;
+    match_count_t counts[NUM_PATTERNS];
 
     int text_len = strlen(text);
+    memset(counts, 0, sizeof(counts));
 
     /* Start timing */
     BENCH_START();
 
-    /* Run both KMP and BMH for each pattern */
-    for (int i = 0; i < NUM_PATTERNS; i++) {
-        int kmp_count = kmp_search(text, text_len,
-                                   patterns[i].pattern, patterns[i].len);
-        int bmh_count = bmh_search(text, text_len,
-                                   patterns[i].pattern, patterns[i].len);
+    search(text, text_len, counts);
 
-        total_matches += kmp_count + bmh_count;
-        csum = checksum_update(csum, (uint32_t)kmp_count);
-        csum = checksum_update(csum, (uint32_t)bmh_count);
+    for (int i = 0; i < NUM_PATTERNS; i++) {
+        total_matches += counts[i].all + counts[i].disjoint;
+        csum = checksum_update(csum, (uint32_t)counts[i].all);
+        csum = checksum_update(csum, (uint32_t)counts[i].disjoint);
     }
 
     /* End timing */
@@ -246,6 +565,33 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return string_run(search_ref);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_avx2(void)
+{
+    return string_run(search_avx2);
+}
+
+static bench_result_t kernel_run_sse2(void)
+{
+    return string_run(search_sse2);
+}
+#endif
+
+static bench_result_t kernel_run_ac(void)
+{
+    return string_run(search_ac_dense);
+}
+
+static bench_result_t kernel_run_ac_sparse(void)
+{
+    return string_run(search_ac_sparse);
+}
+
 static void kernel_cleanup_func(void)
 {
 }
@@ -254,7 +600,18 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t string_variants[] = {
+#if defined(ARCH_X86_64)
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+    { "sse2", ISA_SSE2, kernel_run_sse2 },
+#endif
+    { "ac", 0, kernel_run_ac },
+    { "ac-sparse", 0, kernel_run_ac_sparse },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     string_match,
     "String pattern matching",
     "400.perlbench",
@@ -262,7 +619,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    NUM_PATTERNS
+    NUM_PATTERNS,
+    string_variants,
+    "kmp", "bmh", "ac_build", "ac_scan", "prefilter"
 );
 
 KERNEL_REGISTER(string_match)
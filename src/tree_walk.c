@@ -5,6 +5,9 @@
  * Pattern: Recursive tree traversal with node processing
  * Memory: Random pointer chasing through tree nodes
  * Branch: Data-dependent traversal decisions
+ *
+ * Variants walk a DFS-ordered copy with 16-bit offsets, or evaluate it
+ * as linear bytecode, so layout and recursion costs can be separated.
  */
 
 #include "bench.h"
@@ -12,6 +15,7 @@
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * The node pool and statement count are tier S sizes, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef TREE_NUM_NODES
@@ -22,6 +26,14 @@
 #define TREE_MAX_DEPTH      10      /* Maximum tree depth */
 #endif
 
+#ifndef TREE_NUM_STATEMENTS
+#define TREE_NUM_STATEMENTS 8       /* Statements in the top-level block */
+#endif
+
+#ifndef TREE_RANDOM_PLACEMENT
+#define TREE_RANDOM_PLACEMENT 0     /* 1: nodes take random pool slots, not build order */
+#endif
+
 /* Node types (like GCC's tree codes) */
 #define NODE_INTEGER        1
 #define NODE_PLUS           2
@@ -36,6 +48,9 @@
  * Data Structures
  * ============================================================================ */
 
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_EVAL, PHASE_COUNT, PHASE_DEPTH, PHASE_FOLD, PHASE_EVAL_FOLDED };
+
 /* Tree node (similar to GCC's tree structure) */
 typedef struct tree_node {
     uint8_t type;               /* Node type */
@@ -46,10 +61,50 @@ typedef struct tree_node {
     struct tree_node *next;     /* Next sibling / else branch */
 } tree_node_t;
 
+/*
+ * Relocated node: the reachable tree in DFS preorder, so a left child is
+ * always the next node and right/next are short forward offsets.
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t flags;              /* CNODE_LEFT: left child at +1 */
+    int16_t value;
+    uint16_t right;             /* Forward offset, 0 = none */
+    uint16_t next;              /* Forward offset, 0 = none */
+} cnode_t;
+
+#define CNODE_LEFT          0x01
+
+/* Bytecode: op in the low byte, signed operand above it */
+enum { OP_PUSH, OP_LOAD, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_JZ, OP_JMP, OP_POP, OP_HALT };
+
+#define BC_OP(ins)          ((ins) & 0xFF)
+#define BC_ARG(ins)         ((int32_t)(ins) >> 8)
+#define BC_MAKE(op, arg)    ((uint32_t)(op) | ((uint32_t)(arg) << 8))
+
+typedef struct {
+    uint32_t *code;
+    int size;
+    int depth;                  /* Stack depth while compiling */
+    int max_depth;
+} bytecode_t;
+
 /* Static storage */
-static tree_node_t nodes[TREE_NUM_NODES];
-static int32_t variables[16];       /* Variable values */
-static int nodes_used;
+static BENCH_TLS tree_node_t *nodes;          /* Node pool, arena-allocated in init */
+static BENCH_TLS tree_node_t *nodes_pristine; /* Pool as built, restored before each run */
+static BENCH_TLS uint32_t *slot_order;        /* Pool slot of each allocation */
+static BENCH_TLS int32_t variables[16];       /* Variable values */
+static BENCH_TLS int nodes_used;
+static BENCH_TLS int num_nodes;               /* Node pool size */
+
+static BENCH_TLS cnode_t *cnodes;             /* Relocated tree, arena-allocated in init */
+static BENCH_TLS cnode_t *cnodes_pristine;
+static BENCH_TLS int cnodes_used;
+static BENCH_TLS bool cnodes_fit;             /* Every offset fit in 16 bits */
+
+static BENCH_TLS bytecode_t code_tree;        /* Compiled from the unfolded tree */
+static BENCH_TLS bytecode_t code_folded;      /* Recompiled after folding, every run */
+static BENCH_TLS int32_t *bc_stack;
 
 /* ============================================================================
  * Tree Construction
@@ -57,10 +112,10 @@ static int nodes_used;
 
 static tree_node_t *alloc_node(uint8_t type)
 {
-    if (nodes_used >= TREE_NUM_NODES) {
+    if (nodes_used >= num_nodes) {
         return NULL;
     }
-    tree_node_t *node = &nodes[nodes_used++];
+    tree_node_t *node = &nodes[slot_order[nodes_used++]];
     node->type = type;
     node->flags = 0;
     node->value = 0;
@@ -77,7 +132,7 @@ static tree_node_t *build_expr(uint32_t *seed, int depth)
     x ^= x << 13; x ^= x >> 17; x ^= x << 5;
     *seed = x;
 
-    if (depth >= TREE_MAX_DEPTH - 2 || nodes_used >= TREE_NUM_NODES - 4) {
+    if (depth >= TREE_MAX_DEPTH - 2 || nodes_used >= num_nodes - 4) {
         /* Leaf node: integer or variable */
         tree_node_t *node = alloc_node((x % 2) ? NODE_INTEGER : NODE_VAR);
         if (node) {
@@ -136,7 +191,7 @@ static tree_node_t *build_block(uint32_t *seed, int num_statements, int depth)
     }
 
     tree_node_t *prev = NULL;
-    for (int i = 0; i < num_statements && nodes_used < TREE_NUM_NODES - 10; i++) {
+    for (int i = 0; i < num_statements && nodes_used < num_nodes - 10; i++) {
         tree_node_t *stmt = build_expr(seed, depth + 1);
         if (stmt) {
             if (prev) {
@@ -282,11 +337,302 @@ static tree_node_t *fold_constants(tree_node_t *node)
     return node;
 }
 
+/* ============================================================================
+ * DFS Relocation (16-bit offsets)
+ * ============================================================================ */
+
+/* Copy the reachable tree under node into cnodes in preorder */
+static int relocate(const tree_node_t *node)
+{
+    int idx = cnodes_used++;
+    cnode_t *c = &cnodes[idx];
+
+    c->type = node->type;
+    c->flags = 0;
+    c->value = node->value;
+    c->right = 0;
+    c->next = 0;
+
+    if (node->left) {
+        relocate(node->left);
+        c->flags |= CNODE_LEFT;
+    }
+    if (node->right) {
+        int off = relocate(node->right) - idx;
+        cnodes_fit &= off <= UINT16_MAX;
+        c->right = (uint16_t)off;
+    }
+    if (node->next) {
+        int off = relocate(node->next) - idx;
+        cnodes_fit &= off <= UINT16_MAX;
+        c->next = (uint16_t)off;
+    }
+
+    return idx;
+}
+
+INLINE const cnode_t *c_left(const cnode_t *c)
+{
+    return (c->flags & CNODE_LEFT) ? c + 1 : NULL;
+}
+
+INLINE const cnode_t *c_right(const cnode_t *c)
+{
+    return c->right ? c + c->right : NULL;
+}
+
+INLINE const cnode_t *c_next(const cnode_t *c)
+{
+    return c->next ? c + c->next : NULL;
+}
+
+/* eval_tree on the relocated tree */
+static int32_t c_eval(const cnode_t *c)
+{
+    if (!c) {
+        return 0;
+    }
+
+    switch (c->type) {
+        case NODE_INTEGER:
+            return c->value;
+
+        case NODE_VAR:
+            return variables[c->value & 15];
+
+        case NODE_PLUS:
+            return (int32_t)((uint32_t)c_eval(c_left(c)) + (uint32_t)c_eval(c_right(c)));
+
+        case NODE_MINUS:
+            return (int32_t)((uint32_t)c_eval(c_left(c)) - (uint32_t)c_eval(c_right(c)));
+
+        case NODE_MULT:
+            return (int32_t)((uint32_t)c_eval(c_left(c)) * (uint32_t)c_eval(c_right(c)));
+
+        case NODE_DIV: {
+            int32_t r = c_eval(c_right(c));
+            if (r == 0) return 0;
+            return c_eval(c_left(c)) / r;
+        }
+
+        case NODE_IF:
+            if (c_eval(c_left(c)) != 0) {
+                return c_eval(c_right(c));
+            } else {
+                return c_eval(c_next(c));
+            }
+
+        case NODE_BLOCK: {
+            int32_t result = 0;
+            for (const cnode_t *stmt = c_left(c); stmt; stmt = c_next(stmt)) {
+                result = c_eval(stmt);
+            }
+            return result;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+static void c_count_nodes(const cnode_t *c, int *counts)
+{
+    if (!c) return;
+
+    counts[c->type]++;
+
+    c_count_nodes(c_left(c), counts);
+    c_count_nodes(c_right(c), counts);
+    c_count_nodes(c_next(c), counts);
+}
+
+static int c_tree_depth(const cnode_t *c)
+{
+    if (!c) return 0;
+
+    int max = c_tree_depth(c_left(c));
+    int right_depth = c_tree_depth(c_right(c));
+    int next_depth = c_tree_depth(c_next(c));
+
+    if (right_depth > max) max = right_depth;
+    if (next_depth > max) max = next_depth;
+
+    return max + 1;
+}
+
+static bool c_is_constant(const cnode_t *c)
+{
+    if (!c) return true;
+
+    switch (c->type) {
+        case NODE_INTEGER:
+            return true;
+        case NODE_VAR:
+            return false;
+        case NODE_IF:
+            return c_is_constant(c_left(c)) &&
+                   c_is_constant(c_right(c)) &&
+                   c_is_constant(c_next(c));
+        default:
+            return c_is_constant(c_left(c)) && c_is_constant(c_right(c));
+    }
+}
+
+/* fold_constants in place; folded subtrees are just unlinked */
+static void c_fold_constants(cnode_t *c)
+{
+    if (c->flags & CNODE_LEFT) c_fold_constants(c + 1);
+    if (c->right) c_fold_constants(c + c->right);
+    if (c->next) c_fold_constants(c + c->next);
+
+    if (c->type != NODE_INTEGER && c->type != NODE_VAR &&
+        c->type != NODE_BLOCK && c_is_constant(c)) {
+        int32_t value = c_eval(c);
+        c->type = NODE_INTEGER;
+        c->value = (int16_t)value;
+        c->flags &= (uint8_t)~CNODE_LEFT;
+        c->right = 0;
+        c->next = 0;
+    }
+}
+
+/* ============================================================================
+ * Bytecode Compiler and Interpreter
+ * ============================================================================ */
+
+INLINE void bc_emit(bytecode_t *bc, int op, int32_t arg, int stack_delta)
+{
+    bc->code[bc->size++] = BC_MAKE(op, arg);
+    bc->depth += stack_delta;
+    if (bc->depth > bc->max_depth) bc->max_depth = bc->depth;
+}
+
+/* Emit code leaving the node's eval_tree value on the stack */
+static void bc_compile_node(bytecode_t *bc, const cnode_t *c)
+{
+    if (!c) {
+        bc_emit(bc, OP_PUSH, 0, 1);
+        return;
+    }
+
+    switch (c->type) {
+        case NODE_INTEGER:
+            bc_emit(bc, OP_PUSH, c->value, 1);
+            break;
+
+        case NODE_VAR:
+            bc_emit(bc, OP_LOAD, c->value & 15, 1);
+            break;
+
+        case NODE_PLUS:
+        case NODE_MINUS:
+        case NODE_MULT:
+        case NODE_DIV: {
+            static const uint8_t ops[] = { OP_ADD, OP_SUB, OP_MUL, OP_DIV };
+            bc_compile_node(bc, c_left(c));
+            bc_compile_node(bc, c_right(c));
+            bc_emit(bc, ops[c->type - NODE_PLUS], 0, -1);
+            break;
+        }
+
+        case NODE_IF: {
+            bc_compile_node(bc, c_left(c));
+            int jz = bc->size;
+            bc_emit(bc, OP_JZ, 0, -1);
+            bc_compile_node(bc, c_right(c));
+            int jmp = bc->size;
+            bc_emit(bc, OP_JMP, 0, 0);
+            bc->depth--;                /* Else starts from the condition's depth */
+            bc->code[jz] = BC_MAKE(OP_JZ, bc->size);
+            bc_compile_node(bc, c_next(c));
+            bc->code[jmp] = BC_MAKE(OP_JMP, bc->size);
+            break;
+        }
+
+        case NODE_BLOCK: {
+            const cnode_t *stmt = c_left(c);
+            if (!stmt) {
+                bc_emit(bc, OP_PUSH, 0, 1);
+                break;
+            }
+            for (; stmt; stmt = c_next(stmt)) {
+                bc_compile_node(bc, stmt);
+                if (c_next(stmt)) bc_emit(bc, OP_POP, 0, -1);
+            }
+            break;
+        }
+
+        default:
+            bc_emit(bc, OP_PUSH, 0, 1);
+            break;
+    }
+}
+
+static void bc_compile(bytecode_t *bc, const cnode_t *root_node)
+{
+    bc->size = 0;
+    bc->depth = 0;
+    bc->max_depth = 0;
+    bc_compile_node(bc, root_node);
+    bc_emit(bc, OP_HALT, 0, 0);
+}
+
+/* Stack machine over the linear code; no recursion, one dispatch per op */
+static int32_t bc_run(const bytecode_t *bc, int32_t *stack)
+{
+    const uint32_t *code = bc->code;
+    const uint32_t *pc = code;
+    int32_t *sp = stack;
+
+    for (;;) {
+        uint32_t ins = *pc++;
+
+        switch (BC_OP(ins)) {
+            case OP_PUSH:
+                *sp++ = BC_ARG(ins);
+                break;
+            case OP_LOAD:
+                *sp++ = variables[BC_ARG(ins)];
+                break;
+            case OP_ADD:
+                sp--;
+                sp[-1] = (int32_t)((uint32_t)sp[-1] + (uint32_t)sp[0]);
+                break;
+            case OP_SUB:
+                sp--;
+                sp[-1] = (int32_t)((uint32_t)sp[-1] - (uint32_t)sp[0]);
+                break;
+            case OP_MUL:
+                sp--;
+                sp[-1] = (int32_t)((uint32_t)sp[-1] * (uint32_t)sp[0]);
+                break;
+            case OP_DIV:
+                sp--;
+                sp[-1] = sp[0] == 0 ? 0 : sp[-1] / sp[0];
+                break;
+            case OP_JZ:
+                if (*--sp == 0) pc = code + BC_ARG(ins);
+                break;
+            case OP_JMP:
+                pc = code + BC_ARG(ins);
+                break;
+            case OP_POP:
+                sp--;
+                break;
+            default:
+                return sp[-1];
+        }
+    }
+}
+
 /* ============================================================================
  * Kernel Implementation
  * ============================================================================ */
 
-static tree_node_t *root;
+/* Tree representation a run works on */
+typedef enum { WALK_POINTER, WALK_DFS16, WALK_BYTECODE } walk_mode_t;
+
+static BENCH_TLS tree_node_t *root;
 
 static void kernel_init_func(void)
 {
@@ -297,38 +643,118 @@ static void kernel_init_func(void)
         variables[i] = (seed % 100) - 50;
     }
 
+    /* Pool slots in build order, or shuffled to scatter the tree */
+    num_nodes = (int)bench_scale(TREE_NUM_NODES);
+    nodes = bench_alloc(num_nodes * sizeof(tree_node_t));
+    nodes_pristine = bench_alloc(num_nodes * sizeof(tree_node_t));
+    slot_order = bench_alloc(num_nodes * sizeof(uint32_t));
+    for (int i = 0; i < num_nodes; i++) {
+        slot_order[i] = (uint32_t)i;
+    }
+#if TREE_RANDOM_PLACEMENT
+    uint32_t x = 0x9E3779B9;
+    for (int i = num_nodes - 1; i > 0; i--) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        int j = (int)(x % (uint32_t)(i + 1));
+        uint32_t t = slot_order[i];
+        slot_order[i] = slot_order[j];
+        slot_order[j] = t;
+    }
+#endif
+
     /* Build tree */
     nodes_used = 0;
     seed = 0x12345678;
-    root = build_block(&seed, 8, 0);  /* 8 statements in block */
+    root = build_block(&seed, (int)bench_scale(TREE_NUM_STATEMENTS), 0);
+    memcpy(nodes_pristine, nodes, num_nodes * sizeof(tree_node_t));
+
+    /* Relocated copy and its bytecode */
+    cnodes = bench_alloc(num_nodes * sizeof(cnode_t));
+    cnodes_pristine = bench_alloc(num_nodes * sizeof(cnode_t));
+    cnodes_used = 0;
+    cnodes_fit = true;
+    relocate(root);
+    memcpy(cnodes_pristine, cnodes, cnodes_used * sizeof(cnode_t));
+
+    code_tree.code = bench_alloc((4 * (size_t)cnodes_used + 4) * sizeof(uint32_t));
+    code_folded.code = bench_alloc((4 * (size_t)cnodes_used + 4) * sizeof(uint32_t));
+    bc_compile(&code_tree, cnodes);
+    bc_stack = bench_alloc((code_tree.max_depth + 1) * sizeof(int32_t));
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; every run starts from the unfolded tree */
+static bench_result_t tree_run(walk_mode_t mode)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
+    int32_t eval_result, folded_result;
+    int counts[16] = {0};
+    int depth;
+
+    if (mode == WALK_POINTER) {
+        memcpy(nodes, nodes_pristine, num_nodes * sizeof(tree_node_t));
+    } else {
+        if (!cnodes_fit) {
+            result.status = BENCH_ERR_INTERNAL;
+            return result;
+        }
+        memcpy(cnodes, cnodes_pristine, cnodes_used * sizeof(cnode_t));
+    }
 
     /* Start timing */
     BENCH_START();
 
     /* Evaluate tree */
-    int32_t eval_result = eval_tree(root);
+    BENCH_PHASE_BEGIN(PHASE_EVAL);
+    if (mode == WALK_POINTER) {
+        eval_result = eval_tree(root);
+    } else if (mode == WALK_DFS16) {
+        eval_result = c_eval(cnodes);
+    } else {
+        eval_result = bc_run(&code_tree, bc_stack);
+    }
+    BENCH_PHASE_END(PHASE_EVAL);
     csum = checksum_update(csum, (uint32_t)eval_result);
 
     /* Count nodes */
-    int counts[16] = {0};
-    count_nodes(root, counts);
+    BENCH_PHASE_BEGIN(PHASE_COUNT);
+    if (mode == WALK_POINTER) {
+        count_nodes(root, counts);
+    } else {
+        c_count_nodes(cnodes, counts);
+    }
+    BENCH_PHASE_END(PHASE_COUNT);
     for (int i = 0; i < 16; i++) {
         csum = checksum_update(csum, (uint32_t)counts[i]);
     }
 
     /* Compute depth */
-    int depth = tree_depth(root);
+    BENCH_PHASE_BEGIN(PHASE_DEPTH);
+    depth = mode == WALK_POINTER ? tree_depth(root) : c_tree_depth(cnodes);
+    BENCH_PHASE_END(PHASE_DEPTH);
     csum = checksum_update(csum, (uint32_t)depth);
 
-    /* Fold constants and re-evaluate */
-    fold_constants(root);
-    int32_t folded_result = eval_tree(root);
+    /* Fold constants (and recompile) and re-evaluate */
+    BENCH_PHASE_BEGIN(PHASE_FOLD);
+    if (mode == WALK_POINTER) {
+        fold_constants(root);
+    } else {
+        c_fold_constants(cnodes);
+        if (mode == WALK_BYTECODE) {
+            bc_compile(&code_folded, cnodes);
+        }
+    }
+    BENCH_PHASE_END(PHASE_FOLD);
+
+    BENCH_PHASE_BEGIN(PHASE_EVAL_FOLDED);
+    if (mode == WALK_POINTER) {
+        folded_result = eval_tree(root);
+    } else if (mode == WALK_DFS16) {
+        folded_result = c_eval(cnodes);
+    } else {
+        folded_result = bc_run(&code_folded, bc_stack);
+    }
+    BENCH_PHASE_END(PHASE_EVAL_FOLDED);
     csum = checksum_update(csum, (uint32_t)folded_result);
 
     /* End timing */
@@ -339,10 +765,26 @@ static bench_result_t kernel_run_func(void)
 
     result.cycles = BENCH_CYCLES();
     result.checksum = csum;
+    result.work = (uint64_t)cnodes_used;
 
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return tree_run(WALK_POINTER);
+}
+
+static bench_result_t kernel_run_dfs16(void)
+{
+    return tree_run(WALK_DFS16);
+}
+
+static bench_result_t kernel_run_bytecode(void)
+{
+    return tree_run(WALK_BYTECODE);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -352,7 +794,14 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t tree_variants[] = {
+    { "bytecode", 0, kernel_run_bytecode },
+    { "dfs16", 0, kernel_run_dfs16 },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     tree_walk,
     "AST tree traversal",
     "403.gcc",
@@ -360,7 +809,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    1
+    1,
+    tree_variants,
+    "eval", "count_nodes", "depth", "fold", "eval_folded"
 );
 
 KERNEL_REGISTER(tree_walk)
@@ -0,0 +1,128 @@
+/*
+ * SPECInt2006-micro: variant.c
+ * ISA feature detection for kernel implementation variants
+ *
+ * x86-64:      cpuid, with xgetbv for the OS-enabled AVX state
+ * RISC-V:      compile-time extensions; bare metal also checks misa for V
+ */
+
+#include "bench.h"
+
+static const char *const isa_names[ISA_NUM_FEATURES] = {
+    "sse2",
+    "sse4.1",
+    "avx2",
+    "avx512bw",
+    "rvv",
+    "zbb",
+};
+
+/* ============================================================================
+ * x86-64 backend
+ * ============================================================================ */
+
+#if defined(ARCH_X86_64)
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *regs)
+{
+    __asm__ volatile (
+        "cpuid"
+        : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+        : "a"(leaf), "c"(subleaf)
+    );
+}
+
+static uint32_t backend_detect(void)
+{
+    uint32_t regs[4];
+    uint32_t mask = 0;
+
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    if (regs[3] & (1u << 26)) mask |= ISA_SSE2;
+    if (regs[2] & (1u << 19)) mask |= ISA_SSE41;
+
+    /* AVX state must be enabled by the OS (OSXSAVE, XCR0 bits) */
+    if (!(regs[2] & (1u << 27)) || max_leaf < 7) return mask;
+
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__ volatile ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+
+    cpuid(7, 0, regs);
+    if ((xcr0_lo & 0x06) == 0x06 && (regs[1] & (1u << 5))) mask |= ISA_AVX2;
+    if ((xcr0_lo & 0xE6) == 0xE6 && (regs[1] & (1u << 30))) mask |= ISA_AVX512BW;
+
+    return mask;
+}
+
+/* ============================================================================
+ * RISC-V backend
+ * ============================================================================ */
+
+#elif defined(ARCH_RISCV64) || defined(ARCH_RISCV32)
+
+static uint32_t backend_detect(void)
+{
+    uint32_t mask = 0;
+
+#ifdef __riscv_vector
+  #ifdef NATIVE_BUILD
+    mask |= ISA_RVV;
+  #else
+    /* Bare metal runs in M-mode, where misa is readable */
+    unsigned long misa;
+    __asm__ volatile ("csrr %0, misa" : "=r"(misa));
+    if (misa & (1ul << ('V' - 'A'))) mask |= ISA_RVV;
+  #endif
+#endif
+#ifdef __riscv_zbb
+    mask |= ISA_ZBB;
+#endif
+
+    return mask;
+}
+
+/* ============================================================================
+ * No backend: only variants without ISA requirements run
+ * ============================================================================ */
+
+#else
+
+static uint32_t backend_detect(void)
+{
+    return 0;
+}
+
+#endif
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+/* Detected once; every copy sees the same host */
+uint32_t bench_isa(void)
+{
+    static bool detected = false;
+    static uint32_t mask = 0;
+
+    if (!detected) {
+        mask = backend_detect();
+        detected = true;
+    }
+    return mask;
+}
+
+const char *bench_isa_name(bench_isa_t feature)
+{
+    for (int i = 0; i < ISA_NUM_FEATURES; i++) {
+        if (feature == (1u << i)) return isa_names[i];
+    }
+    return "?";
+}
+
+bool variant_available(const kernel_variant_t *variant)
+{
+    return (variant->isa & ~bench_isa()) == 0;
+}
@@ -9,9 +9,16 @@
 
 #include "bench.h"
 
+#if defined(ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+#if defined(__riscv_vector)
+  #include <riscv_vector.h>
+#endif
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * HMM_MODEL_SIZE is the tier S model length, scaled by bench_scale().
  * ============================================================================ */
 
 #ifndef HMM_SEQ_LENGTH
@@ -19,7 +26,7 @@
 #endif
 
 #ifndef HMM_MODEL_SIZE
-#define HMM_MODEL_SIZE      32      /* Number of model states */
+#define HMM_MODEL_SIZE      300     /* Number of model states */
 #endif
 
 #ifndef HMM_ALPHABET_SIZE
@@ -34,33 +41,67 @@
  * Data Structures (similar to HMMER's plan7)
  * ============================================================================ */
 
-/* HMM parameters */
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_INIT, PHASE_RECURSION };
+
+/* HMM parameters (per-state arrays of hmm_model_t.size entries) */
 typedef struct {
-    int32_t match_emit[HMM_MODEL_SIZE][HMM_ALPHABET_SIZE];    /* Match emissions */
-    int32_t insert_emit[HMM_MODEL_SIZE][HMM_ALPHABET_SIZE];   /* Insert emissions */
-    int32_t trans_mm[HMM_MODEL_SIZE];    /* Match to Match */
-    int32_t trans_mi[HMM_MODEL_SIZE];    /* Match to Insert */
-    int32_t trans_md[HMM_MODEL_SIZE];    /* Match to Delete */
-    int32_t trans_im[HMM_MODEL_SIZE];    /* Insert to Match */
-    int32_t trans_ii[HMM_MODEL_SIZE];    /* Insert to Insert */
-    int32_t trans_dm[HMM_MODEL_SIZE];    /* Delete to Match */
-    int32_t trans_dd[HMM_MODEL_SIZE];    /* Delete to Delete */
-    int32_t begin[HMM_MODEL_SIZE];       /* Begin transition */
-    int32_t end[HMM_MODEL_SIZE];         /* End transition */
+    int32_t (*match_emit)[HMM_ALPHABET_SIZE];    /* Match emissions */
+    int32_t (*insert_emit)[HMM_ALPHABET_SIZE];   /* Insert emissions */
+    int32_t *trans_mm;      /* Match to Match */
+    int32_t *trans_mi;      /* Match to Insert */
+    int32_t *trans_md;      /* Match to Delete */
+    int32_t *trans_im;      /* Insert to Match */
+    int32_t *trans_ii;      /* Insert to Insert */
+    int32_t *trans_dm;      /* Delete to Match */
+    int32_t *trans_dd;      /* Delete to Delete */
+    int32_t *begin;         /* Begin transition */
+    int32_t *end;           /* End transition */
+    int size;               /* Number of model states */
 } hmm_model_t;
 
+/*
+ * Striped int16 profile for the SIMD filters (HMMER's P7_OPROFILE layout):
+ * state k = lane * Q + q lives in lane `lane` of vector q, so the k-1 -> k
+ * dependency crosses vectors except at segment boundaries. States past the
+ * model are -inf. Vectors are `lanes` int16 wide.
+ */
+enum { TSC_B, TSC_MM, TSC_IM, TSC_DM, TSC_MD, TSC_MI, TSC_II, TSC_E, TSC_NUM };
+
+typedef struct {
+    int lanes;
+    int Q;                  /* Vectors per row: ceil(size / lanes) */
+    int16_t *tsc;           /* Q x TSC_NUM vectors, in main-loop order */
+    int16_t *tdd;           /* Q vectors of D->D, read again by the lazy-F pass */
+    int16_t *msc;           /* HMM_ALPHABET_SIZE x Q match emission vectors */
+    int16_t *isc;           /* HMM_ALPHABET_SIZE x Q insert emission vectors */
+    int16_t *mmx;           /* One DP row, updated in place */
+    int16_t *imx;
+    int16_t *dmx;
+} striped_profile_t;
+
+/* Filter entry point: best score of seq against the model */
+typedef int32_t (*viterbi_func_t)(const uint8_t *seq, int seq_len);
+
 /* DP matrix row */
 typedef struct {
-    int32_t m[HMM_MODEL_SIZE];    /* Match scores */
-    int32_t i[HMM_MODEL_SIZE];    /* Insert scores */
-    int32_t d[HMM_MODEL_SIZE];    /* Delete scores */
+    int32_t *m;             /* Match scores */
+    int32_t *i;             /* Insert scores */
+    int32_t *d;             /* Delete scores */
 } dp_row_t;
 
-/* Static storage */
-static hmm_model_t model;
-static uint8_t sequence[HMM_SEQ_LENGTH];
-static dp_row_t dp_prev;
-static dp_row_t dp_curr;
+/* Static storage (model and rows point into the arena) */
+static BENCH_TLS hmm_model_t model;
+static BENCH_TLS uint8_t sequence[HMM_SEQ_LENGTH];
+static BENCH_TLS dp_row_t dp_prev;
+static BENCH_TLS dp_row_t dp_curr;
+#if defined(ARCH_X86_64)
+static BENCH_TLS striped_profile_t striped_sse2;
+static BENCH_TLS striped_profile_t striped_avx2;
+#endif
+#if defined(__riscv_vector)
+static BENCH_TLS striped_profile_t striped_rvv;
+#endif
 
 /* ============================================================================
  * Viterbi Algorithm
@@ -74,66 +115,65 @@ INLINE int32_t score_max3(int32_t a, int32_t b, int32_t c)
     return max;
 }
 
-/* Run Viterbi algorithm, return best score */
+/*
+ * Run Viterbi algorithm, return best score
+ * Plan7 recurrences with local entry from begin[k] at every position:
+ *   M[k] = max(M'[k-1] + mm, I'[k-1] + im, D'[k-1] + dm, begin[k]) + e_m
+ *   I[k] = max(M'[k] + mi, I'[k] + ii) + e_i
+ *   D[k] = max(M[k-1] + md, D[k-1] + dd)
+ * (' is the previous position). D chains along the current row, which is
+ * what the striped filters' lazy-F pass has to resolve.
+ */
 static int32_t viterbi_score(const hmm_model_t *hmm, const uint8_t *seq, int seq_len)
 {
     int32_t best_score = SCORE_MIN;
 
     /* Initialize first row */
-    for (int k = 0; k < HMM_MODEL_SIZE; k++) {
+    BENCH_PHASE_BEGIN(PHASE_INIT);
+    for (int k = 0; k < hmm->size; k++) {
         dp_prev.m[k] = SCORE_MIN;
         dp_prev.i[k] = SCORE_MIN;
         dp_prev.d[k] = SCORE_MIN;
     }
+    BENCH_PHASE_END(PHASE_INIT);
 
-    /* Process each position in sequence */
+    /* Process each position in sequence (rows are too short to time alone) */
+    BENCH_PHASE_BEGIN(PHASE_RECURSION);
     for (int i = 0; i < seq_len; i++) {
         int sym = seq[i] % HMM_ALPHABET_SIZE;
-
-        /* Initialize current row */
-        for (int k = 0; k < HMM_MODEL_SIZE; k++) {
-            dp_curr.m[k] = SCORE_MIN;
-            dp_curr.i[k] = SCORE_MIN;
-            dp_curr.d[k] = SCORE_MIN;
-        }
-
-        /* First state: only begin transition */
-        dp_curr.m[0] = hmm->begin[0] + hmm->match_emit[0][sym];
+        int32_t d_score = SCORE_MIN;    /* D[0]: no predecessor */
 
         /* Fill DP matrix */
-        for (int k = 1; k < HMM_MODEL_SIZE; k++) {
+        for (int k = 0; k < hmm->size; k++) {
             /* Match state: from M, I, D of previous position, or begin */
-            int32_t m_score = score_max3(
-                dp_prev.m[k-1] + hmm->trans_mm[k-1],
-                dp_prev.i[k-1] + hmm->trans_im[k-1],
-                dp_prev.d[k-1] + hmm->trans_dm[k-1]
-            );
-
-            /* Also consider begin transition */
-            if (hmm->begin[k] > m_score) {
-                m_score = hmm->begin[k];
+            int32_t m_score = hmm->begin[k];
+            if (k > 0) {
+                int32_t from = score_max3(
+                    dp_prev.m[k-1] + hmm->trans_mm[k-1],
+                    dp_prev.i[k-1] + hmm->trans_im[k-1],
+                    dp_prev.d[k-1] + hmm->trans_dm[k-1]
+                );
+                if (from > m_score) m_score = from;
             }
-
             dp_curr.m[k] = m_score + hmm->match_emit[k][sym];
 
-            /* Insert state: from M or I of current position */
+            /* Insert state: from M or I of previous position */
             int32_t i_score = score_max3(
-                dp_curr.m[k] + hmm->trans_mi[k],
-                dp_curr.i[k] + hmm->trans_ii[k],
+                dp_prev.m[k] + hmm->trans_mi[k],
+                dp_prev.i[k] + hmm->trans_ii[k],
                 SCORE_MIN
             );
             dp_curr.i[k] = i_score + hmm->insert_emit[k][sym];
 
-            /* Delete state: from M or D of previous position (no emission) */
-            dp_curr.d[k] = score_max3(
-                dp_prev.m[k] + hmm->trans_md[k],
-                dp_prev.d[k] + hmm->trans_dd[k],
+            /* Delete state: from M or D of the previous state (no emission) */
+            dp_curr.d[k] = d_score;
+            d_score = score_max3(
+                dp_curr.m[k] + hmm->trans_md[k],
+                d_score + hmm->trans_dd[k],
                 SCORE_MIN
             );
-        }
 
-        /* Check end transitions */
-        for (int k = 0; k < HMM_MODEL_SIZE; k++) {
+            /* End transition */
             int32_t end_score = dp_curr.m[k] + hmm->end[k];
             if (end_score > best_score) {
                 best_score = end_score;
@@ -145,10 +185,288 @@ static int32_t viterbi_score(const hmm_model_t *hmm, const uint8_t *seq, int seq
         dp_prev = dp_curr;
         dp_curr = tmp;
     }
+    BENCH_PHASE_END(PHASE_RECURSION);
 
     return best_score;
 }
 
+static int32_t viterbi_ref(const uint8_t *seq, int seq_len)
+{
+    return viterbi_score(&model, seq, seq_len);
+}
+
+/* ============================================================================
+ * Striped SIMD Filters (Farrar; HMMER3 p7_ViterbiFilter)
+ *
+ * Saturating int16 with -32768 as -inf. Every transition and emission score
+ * is <= 0, so a saturated cell is exactly the clamp of the int32 cell and
+ * the filter score equals the reference unless the reference is below
+ * -32768; that case (the filter returns -inf) is rescored in int32.
+ *
+ * Per position: one pass over the Q vectors computes M, I and a first D
+ * that ignores D chains crossing segment boundaries, then lazy-F passes
+ * shift the carried D one lane up and fold it in again until no lane
+ * improves (at most `lanes` passes).
+ * ============================================================================ */
+
+#define STRIPED_NEG_INF     INT16_MIN
+
+#if defined(ARCH_X86_64)
+
+/* Lanes move up one int16, -inf enters lane 0 */
+static inline __m128i shift_up_sse2(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_si128(v, 2), _mm_cvtsi32_si128(0x8000));
+}
+
+static int32_t viterbi_sse2(const uint8_t *seq, int seq_len)
+{
+    const striped_profile_t *sp = &striped_sse2;
+    const int Q = sp->Q;
+    __m128i *mmx = (__m128i *)sp->mmx;
+    __m128i *imx = (__m128i *)sp->imx;
+    __m128i *dmx = (__m128i *)sp->dmx;
+    const __m128i *tdd = (const __m128i *)sp->tdd;
+    const __m128i neg_inf = _mm_set1_epi16(STRIPED_NEG_INF);
+    __m128i xe = neg_inf;
+
+    BENCH_PHASE_BEGIN(PHASE_INIT);
+    for (int q = 0; q < Q; q++) {
+        mmx[q] = imx[q] = dmx[q] = neg_inf;
+    }
+    BENCH_PHASE_END(PHASE_INIT);
+
+    BENCH_PHASE_BEGIN(PHASE_RECURSION);
+    for (int i = 0; i < seq_len; i++) {
+        int sym = seq[i] % HMM_ALPHABET_SIZE;
+        const __m128i *msc = (const __m128i *)sp->msc + sym * Q;
+        const __m128i *isc = (const __m128i *)sp->isc + sym * Q;
+        const __m128i *tsc = (const __m128i *)sp->tsc;
+
+        /* k-1 of each lane's first state is the previous lane's last */
+        __m128i mpv = shift_up_sse2(mmx[Q - 1]);
+        __m128i ipv = shift_up_sse2(imx[Q - 1]);
+        __m128i dpv = shift_up_sse2(dmx[Q - 1]);
+        __m128i dcv = neg_inf;
+
+        for (int q = 0; q < Q; q++, tsc += TSC_NUM) {
+            __m128i sv = tsc[TSC_B];
+            sv = _mm_max_epi16(sv, _mm_adds_epi16(mpv, tsc[TSC_MM]));
+            sv = _mm_max_epi16(sv, _mm_adds_epi16(ipv, tsc[TSC_IM]));
+            sv = _mm_max_epi16(sv, _mm_adds_epi16(dpv, tsc[TSC_DM]));
+            sv = _mm_adds_epi16(sv, msc[q]);
+            xe = _mm_max_epi16(xe, _mm_adds_epi16(sv, tsc[TSC_E]));
+
+            /* Previous-row values of state k, needed by I and the next q */
+            mpv = mmx[q];
+            ipv = imx[q];
+            dpv = dmx[q];
+
+            mmx[q] = sv;
+            dmx[q] = dcv;
+            dcv = _mm_max_epi16(_mm_adds_epi16(sv, tsc[TSC_MD]), _mm_adds_epi16(dcv, tdd[q]));
+
+            __m128i iv = _mm_max_epi16(_mm_adds_epi16(mpv, tsc[TSC_MI]),
+                                       _mm_adds_epi16(ipv, tsc[TSC_II]));
+            imx[q] = _mm_adds_epi16(iv, isc[q]);
+        }
+
+        /* Lazy F: carry D across segment boundaries */
+        for (int pass = 0; pass < sp->lanes; pass++) {
+            __m128i improved = _mm_setzero_si128();
+            dcv = shift_up_sse2(dcv);
+            for (int q = 0; q < Q; q++) {
+                improved = _mm_or_si128(improved, _mm_cmpgt_epi16(dcv, dmx[q]));
+                dmx[q] = _mm_max_epi16(dcv, dmx[q]);
+                dcv = _mm_adds_epi16(dcv, tdd[q]);
+            }
+            if (!_mm_movemask_epi8(improved)) break;
+        }
+    }
+    BENCH_PHASE_END(PHASE_RECURSION);
+
+    xe = _mm_max_epi16(xe, _mm_srli_si128(xe, 8));
+    xe = _mm_max_epi16(xe, _mm_srli_si128(xe, 4));
+    xe = _mm_max_epi16(xe, _mm_srli_si128(xe, 2));
+    int32_t score = (int16_t)_mm_extract_epi16(xe, 0);
+
+    return score == STRIPED_NEG_INF ? viterbi_ref(seq, seq_len) : score;
+}
+
+/* vpslldq works per 128-bit half; alignr pulls the low half's top lane over */
+__attribute__((target("avx2")))
+static inline __m256i shift_up_avx2(__m256i v)
+{
+    __m256i lo_to_hi = _mm256_permute2x128_si256(v, v, 0x08);
+    __m256i shifted = _mm256_alignr_epi8(v, lo_to_hi, 14);
+    return _mm256_or_si256(shifted, _mm256_zextsi128_si256(_mm_cvtsi32_si128(0x8000)));
+}
+
+__attribute__((target("avx2")))
+static int32_t viterbi_avx2(const uint8_t *seq, int seq_len)
+{
+    const striped_profile_t *sp = &striped_avx2;
+    const int Q = sp->Q;
+    __m256i *mmx = (__m256i *)sp->mmx;
+    __m256i *imx = (__m256i *)sp->imx;
+    __m256i *dmx = (__m256i *)sp->dmx;
+    const __m256i *tdd = (const __m256i *)sp->tdd;
+    const __m256i neg_inf = _mm256_set1_epi16(STRIPED_NEG_INF);
+    __m256i xe = neg_inf;
+
+    BENCH_PHASE_BEGIN(PHASE_INIT);
+    for (int q = 0; q < Q; q++) {
+        mmx[q] = imx[q] = dmx[q] = neg_inf;
+    }
+    BENCH_PHASE_END(PHASE_INIT);
+
+    BENCH_PHASE_BEGIN(PHASE_RECURSION);
+    for (int i = 0; i < seq_len; i++) {
+        int sym = seq[i] % HMM_ALPHABET_SIZE;
+        const __m256i *msc = (const __m256i *)sp->msc + sym * Q;
+        const __m256i *isc = (const __m256i *)sp->isc + sym * Q;
+        const __m256i *tsc = (const __m256i *)sp->tsc;
+
+        __m256i mpv = shift_up_avx2(mmx[Q - 1]);
+        __m256i ipv = shift_up_avx2(imx[Q - 1]);
+        __m256i dpv = shift_up_avx2(dmx[Q - 1]);
+        __m256i dcv = neg_inf;
+
+        for (int q = 0; q < Q; q++, tsc += TSC_NUM) {
+            __m256i sv = tsc[TSC_B];
+            sv = _mm256_max_epi16(sv, _mm256_adds_epi16(mpv, tsc[TSC_MM]));
+            sv = _mm256_max_epi16(sv, _mm256_adds_epi16(ipv, tsc[TSC_IM]));
+            sv = _mm256_max_epi16(sv, _mm256_adds_epi16(dpv, tsc[TSC_DM]));
+            sv = _mm256_adds_epi16(sv, msc[q]);
+            xe = _mm256_max_epi16(xe, _mm256_adds_epi16(sv, tsc[TSC_E]));
+
+            mpv = mmx[q];
+            ipv = imx[q];
+            dpv = dmx[q];
+
+            mmx[q] = sv;
+            dmx[q] = dcv;
+            dcv = _mm256_max_epi16(_mm256_adds_epi16(sv, tsc[TSC_MD]),
+                                   _mm256_adds_epi16(dcv, tdd[q]));
+
+            __m256i iv = _mm256_max_epi16(_mm256_adds_epi16(mpv, tsc[TSC_MI]),
+                                          _mm256_adds_epi16(ipv, tsc[TSC_II]));
+            imx[q] = _mm256_adds_epi16(iv, isc[q]);
+        }
+
+        for (int pass = 0; pass < sp->lanes; pass++) {
+            __m256i improved = _mm256_setzero_si256();
+            dcv = shift_up_avx2(dcv);
+            for (int q = 0; q < Q; q++) {
+                improved = _mm256_or_si256(improved, _mm256_cmpgt_epi16(dcv, dmx[q]));
+                dmx[q] = _mm256_max_epi16(dcv, dmx[q]);
+                dcv = _mm256_adds_epi16(dcv, tdd[q]);
+            }
+            if (!_mm256_movemask_epi8(improved)) break;
+        }
+    }
+    BENCH_PHASE_END(PHASE_RECURSION);
+
+    __m128i x = _mm_max_epi16(_mm256_castsi256_si128(xe), _mm256_extracti128_si256(xe, 1));
+    x = _mm_max_epi16(x, _mm_srli_si128(x, 8));
+    x = _mm_max_epi16(x, _mm_srli_si128(x, 4));
+    x = _mm_max_epi16(x, _mm_srli_si128(x, 2));
+    int32_t score = (int16_t)_mm_extract_epi16(x, 0);
+
+    return score == STRIPED_NEG_INF ? viterbi_ref(seq, seq_len) : score;
+}
+
+#endif /* ARCH_X86_64 */
+
+#if defined(__riscv_vector)
+
+/* Striped over VLMAX e16 lanes; vslide1up does the lane shift */
+static int32_t viterbi_rvv(const uint8_t *seq, int seq_len)
+{
+    const striped_profile_t *sp = &striped_rvv;
+    const int Q = sp->Q;
+    const size_t vl = (size_t)sp->lanes;
+    int16_t *mmx = sp->mmx;
+    int16_t *imx = sp->imx;
+    int16_t *dmx = sp->dmx;
+    vint16m1_t neg_inf = __riscv_vmv_v_x_i16m1(STRIPED_NEG_INF, vl);
+    vint16m1_t xe = neg_inf;
+
+#define V_LD(p)         __riscv_vle16_v_i16m1((p), vl)
+#define V_ST(p, v)      __riscv_vse16_v_i16m1((p), (v), vl)
+#define V_ADDS(a, b)    __riscv_vsadd_vv_i16m1((a), (b), vl)
+#define V_MAX(a, b)     __riscv_vmax_vv_i16m1((a), (b), vl)
+#define V_SHIFT_UP(v)   __riscv_vslide1up_vx_i16m1((v), STRIPED_NEG_INF, vl)
+
+    BENCH_PHASE_BEGIN(PHASE_INIT);
+    for (int q = 0; q < Q; q++) {
+        V_ST(mmx + q * vl, neg_inf);
+        V_ST(imx + q * vl, neg_inf);
+        V_ST(dmx + q * vl, neg_inf);
+    }
+    BENCH_PHASE_END(PHASE_INIT);
+
+    BENCH_PHASE_BEGIN(PHASE_RECURSION);
+    for (int i = 0; i < seq_len; i++) {
+        int sym = seq[i] % HMM_ALPHABET_SIZE;
+        const int16_t *msc = sp->msc + (size_t)sym * Q * vl;
+        const int16_t *isc = sp->isc + (size_t)sym * Q * vl;
+        const int16_t *tsc = sp->tsc;
+
+        vint16m1_t mpv = V_SHIFT_UP(V_LD(mmx + (Q - 1) * vl));
+        vint16m1_t ipv = V_SHIFT_UP(V_LD(imx + (Q - 1) * vl));
+        vint16m1_t dpv = V_SHIFT_UP(V_LD(dmx + (Q - 1) * vl));
+        vint16m1_t dcv = neg_inf;
+
+        for (int q = 0; q < Q; q++, tsc += TSC_NUM * vl) {
+            vint16m1_t sv = V_LD(tsc + TSC_B * vl);
+            sv = V_MAX(sv, V_ADDS(mpv, V_LD(tsc + TSC_MM * vl)));
+            sv = V_MAX(sv, V_ADDS(ipv, V_LD(tsc + TSC_IM * vl)));
+            sv = V_MAX(sv, V_ADDS(dpv, V_LD(tsc + TSC_DM * vl)));
+            sv = V_ADDS(sv, V_LD(msc + q * vl));
+            xe = V_MAX(xe, V_ADDS(sv, V_LD(tsc + TSC_E * vl)));
+
+            mpv = V_LD(mmx + q * vl);
+            ipv = V_LD(imx + q * vl);
+            dpv = V_LD(dmx + q * vl);
+
+            V_ST(mmx + q * vl, sv);
+            V_ST(dmx + q * vl, dcv);
+            dcv = V_MAX(V_ADDS(sv, V_LD(tsc + TSC_MD * vl)), V_ADDS(dcv, V_LD(sp->tdd + q * vl)));
+
+            vint16m1_t iv = V_MAX(V_ADDS(mpv, V_LD(tsc + TSC_MI * vl)),
+                                  V_ADDS(ipv, V_LD(tsc + TSC_II * vl)));
+            V_ST(imx + q * vl, V_ADDS(iv, V_LD(isc + q * vl)));
+        }
+
+        for (int pass = 0; pass < sp->lanes; pass++) {
+            long improved = 0;
+            dcv = V_SHIFT_UP(dcv);
+            for (int q = 0; q < Q; q++) {
+                vint16m1_t dv = V_LD(dmx + q * vl);
+                improved |= __riscv_vcpop_m_b16(__riscv_vmsgt_vv_i16m1_b16(dcv, dv, vl), vl);
+                V_ST(dmx + q * vl, V_MAX(dcv, dv));
+                dcv = V_ADDS(dcv, V_LD(sp->tdd + q * vl));
+            }
+            if (!improved) break;
+        }
+    }
+    BENCH_PHASE_END(PHASE_RECURSION);
+
+#undef V_LD
+#undef V_ST
+#undef V_ADDS
+#undef V_MAX
+#undef V_SHIFT_UP
+
+    vint16m1_t red = __riscv_vredmax_vs_i16m1_i16m1(xe, __riscv_vmv_s_x_i16m1(STRIPED_NEG_INF, 1), vl);
+    int32_t score = __riscv_vmv_x_s_i16m1_i16(red);
+
+    return score == STRIPED_NEG_INF ? viterbi_ref(seq, seq_len) : score;
+}
+
+#endif /* __riscv_vector */
+
 /* ============================================================================
  * Test Data Generation
  * ============================================================================ */
@@ -161,7 +479,7 @@ static void generate_model(hmm_model_t *hmm, uint32_t seed)
     #define RAND_NEXT() (x ^= x << 13, x ^= x >> 17, x ^= x << 5, x)
 
     /* Generate emission scores */
-    for (int k = 0; k < HMM_MODEL_SIZE; k++) {
+    for (int k = 0; k < hmm->size; k++) {
         for (int a = 0; a < HMM_ALPHABET_SIZE; a++) {
             /* Log probabilities (negative, scaled) */
             hmm->match_emit[k][a] = -(int32_t)(RAND_NEXT() % 5000);
@@ -174,7 +492,7 @@ static void generate_model(hmm_model_t *hmm, uint32_t seed)
     }
 
     /* Generate transition scores */
-    for (int k = 0; k < HMM_MODEL_SIZE; k++) {
+    for (int k = 0; k < hmm->size; k++) {
         /* Prefer match-to-match */
         hmm->trans_mm[k] = -(int32_t)(RAND_NEXT() % 1000);
         hmm->trans_mi[k] = -(int32_t)(2000 + RAND_NEXT() % 2000);
@@ -184,9 +502,9 @@ static void generate_model(hmm_model_t *hmm, uint32_t seed)
         hmm->trans_dm[k] = -(int32_t)(1000 + RAND_NEXT() % 1000);
         hmm->trans_dd[k] = -(int32_t)(500 + RAND_NEXT() % 1000);
 
-        /* Begin/end transitions */
-        hmm->begin[k] = (k == 0) ? 0 : -(int32_t)(3000 + k * 100);
-        hmm->end[k] = (k == HMM_MODEL_SIZE - 1) ? 0 : -(int32_t)(3000 + (HMM_MODEL_SIZE - k) * 100);
+        /* Local begin/end transitions, kept within int16 for the filters */
+        hmm->begin[k] = (k == 0) ? 0 : -(int32_t)(3000 + RAND_NEXT() % 2000);
+        hmm->end[k] = (k == hmm->size - 1) ? 0 : -(int32_t)(3000 + RAND_NEXT() % 2000);
     }
 
     #undef RAND_NEXT
@@ -208,16 +526,106 @@ static void generate_sequence(uint8_t *seq, int len, uint32_t seed)
  * Kernel Implementation
  * ============================================================================ */
 
+static void alloc_model(hmm_model_t *hmm, int size)
+{
+    hmm->size = size;
+    hmm->match_emit = bench_alloc(size * sizeof(*hmm->match_emit));
+    hmm->insert_emit = bench_alloc(size * sizeof(*hmm->insert_emit));
+    hmm->trans_mm = bench_alloc(size * sizeof(int32_t));
+    hmm->trans_mi = bench_alloc(size * sizeof(int32_t));
+    hmm->trans_md = bench_alloc(size * sizeof(int32_t));
+    hmm->trans_im = bench_alloc(size * sizeof(int32_t));
+    hmm->trans_ii = bench_alloc(size * sizeof(int32_t));
+    hmm->trans_dm = bench_alloc(size * sizeof(int32_t));
+    hmm->trans_dd = bench_alloc(size * sizeof(int32_t));
+    hmm->begin = bench_alloc(size * sizeof(int32_t));
+    hmm->end = bench_alloc(size * sizeof(int32_t));
+}
+
+static void alloc_row(dp_row_t *row, int size)
+{
+    row->m = bench_alloc(size * sizeof(int32_t));
+    row->i = bench_alloc(size * sizeof(int32_t));
+    row->d = bench_alloc(size * sizeof(int32_t));
+}
+
+static int16_t striped_score(int32_t sc)
+{
+    return (int16_t)(sc < STRIPED_NEG_INF ? STRIPED_NEG_INF : sc);
+}
+
+/* Convert the model into a striped profile of the given width (p7_oprofile_Convert) */
+static void build_striped(striped_profile_t *sp, const hmm_model_t *hmm, int lanes)
+{
+    int Q = (hmm->size + lanes - 1) / lanes;
+    size_t row = (size_t)Q * lanes;
+
+    sp->lanes = lanes;
+    sp->Q = Q;
+    sp->tsc = bench_alloc(row * TSC_NUM * sizeof(int16_t));
+    sp->tdd = bench_alloc(row * sizeof(int16_t));
+    sp->msc = bench_alloc(row * HMM_ALPHABET_SIZE * sizeof(int16_t));
+    sp->isc = bench_alloc(row * HMM_ALPHABET_SIZE * sizeof(int16_t));
+    sp->mmx = bench_alloc(row * sizeof(int16_t));
+    sp->imx = bench_alloc(row * sizeof(int16_t));
+    sp->dmx = bench_alloc(row * sizeof(int16_t));
+
+    for (int q = 0; q < Q; q++) {
+        for (int l = 0; l < lanes; l++) {
+            int k = l * Q + q;
+            bool real = k < hmm->size;
+            bool pred = real && k > 0;      /* Has a k-1 */
+            int16_t *t = sp->tsc + (size_t)q * TSC_NUM * lanes + l;
+
+            t[TSC_B * lanes]  = real ? striped_score(hmm->begin[k]) : STRIPED_NEG_INF;
+            t[TSC_MM * lanes] = pred ? striped_score(hmm->trans_mm[k - 1]) : STRIPED_NEG_INF;
+            t[TSC_IM * lanes] = pred ? striped_score(hmm->trans_im[k - 1]) : STRIPED_NEG_INF;
+            t[TSC_DM * lanes] = pred ? striped_score(hmm->trans_dm[k - 1]) : STRIPED_NEG_INF;
+            t[TSC_MD * lanes] = real ? striped_score(hmm->trans_md[k]) : STRIPED_NEG_INF;
+            t[TSC_MI * lanes] = real ? striped_score(hmm->trans_mi[k]) : STRIPED_NEG_INF;
+            t[TSC_II * lanes] = real ? striped_score(hmm->trans_ii[k]) : STRIPED_NEG_INF;
+            t[TSC_E * lanes]  = real ? striped_score(hmm->end[k]) : STRIPED_NEG_INF;
+            sp->tdd[(size_t)q * lanes + l] = real ? striped_score(hmm->trans_dd[k]) : STRIPED_NEG_INF;
+
+            for (int a = 0; a < HMM_ALPHABET_SIZE; a++) {
+                size_t e = ((size_t)a * Q + q) * lanes + l;
+                sp->msc[e] = real ? striped_score(hmm->match_emit[k][a]) : STRIPED_NEG_INF;
+                sp->isc[e] = real ? striped_score(hmm->insert_emit[k][a]) : STRIPED_NEG_INF;
+            }
+        }
+    }
+}
+
 static void kernel_init_func(void)
 {
+    int size = (int)bench_scale(HMM_MODEL_SIZE);
+
+    alloc_model(&model, size);
+    alloc_row(&dp_prev, size);
+    alloc_row(&dp_curr, size);
+
     /* Generate HMM model */
     generate_model(&model, 0xABCDEF01);
 
     /* Generate test sequence */
     generate_sequence(sequence, HMM_SEQ_LENGTH, 0x13579BDF);
+
+    /* Striped profiles for the SIMD filters the host can run */
+#if defined(ARCH_X86_64)
+    build_striped(&striped_sse2, &model, 8);
+    if (bench_isa() & ISA_AVX2) {
+        build_striped(&striped_avx2, &model, 16);
+    }
+#endif
+#if defined(__riscv_vector)
+    if (bench_isa() & ISA_RVV) {
+        build_striped(&striped_rvv, &model, (int)__riscv_vsetvlmax_e16m1());
+    }
+#endif
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver; filter is the reference or one of the striped variants */
+static bench_result_t viterbi_run(viterbi_func_t filter)
 {
     bench_result_t result = { .status = BENCH_OK };
 
@@ -225,7 +633,7 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Run Viterbi algorithm */
-    int32_t score = viterbi_score(&model, sequence, HMM_SEQ_LENGTH);
+    int32_t score = filter(sequence, HMM_SEQ_LENGTH);
 
     /* End timing */
     BENCH_END();
@@ -237,7 +645,7 @@ static bench_result_t kernel_run_func(void)
     uint32_t csum = checksum_init();
     csum = checksum_update(csum, (uint32_t)score);
     csum = checksum_update(csum, HMM_SEQ_LENGTH);
-    csum = checksum_update(csum, HMM_MODEL_SIZE);
+    csum = checksum_update(csum, (uint32_t)model.size);
 
     result.cycles = BENCH_CYCLES();
     result.checksum = csum;
@@ -245,6 +653,30 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return viterbi_run(viterbi_ref);
+}
+
+#if defined(ARCH_X86_64)
+static bench_result_t kernel_run_sse2(void)
+{
+    return viterbi_run(viterbi_sse2);
+}
+
+static bench_result_t kernel_run_avx2(void)
+{
+    return viterbi_run(viterbi_avx2);
+}
+#endif
+
+#if defined(__riscv_vector)
+static bench_result_t kernel_run_rvv(void)
+{
+    return viterbi_run(viterbi_rvv);
+}
+#endif
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -254,7 +686,19 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t viterbi_variants[] = {
+#if defined(ARCH_X86_64)
+    { "avx2", ISA_AVX2, kernel_run_avx2 },
+    { "sse2", ISA_SSE2, kernel_run_sse2 },
+#endif
+#if defined(__riscv_vector)
+    { "rvv", ISA_RVV, kernel_run_rvv },
+#endif
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     viterbi_hmm,
     "Viterbi HMM scoring",
     "456.hmmer",
@@ -262,7 +706,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    1
+    1,
+    viterbi_variants,
+    "init_row", "recursion"
 );
 
 KERNEL_REGISTER(viterbi_hmm)
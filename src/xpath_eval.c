@@ -5,12 +5,18 @@
  * Pattern: Tree traversal, string matching, predicate evaluation
  * Memory: Pointer-heavy tree navigation
  * Branch: Data-dependent (node types, predicate results)
+ *
+ * The DOM is stored in document order. The reference walks it naively
+ * (recursive axes, string name tests, sort-based dedup); the indexed
+ * variant uses pre-order intervals, interned names and bitmap node sets.
  */
 
 #include "bench.h"
 
 /* ============================================================================
  * Configuration (tune for 10K-100K cycles)
+ * XPATH_NUM_NODES is the tier S DOM size, scaled by bench_scale(); the DOM
+ * may grow two levels deeper per tier to hold it.
  * ============================================================================ */
 
 #ifndef XPATH_NUM_NODES
@@ -33,6 +39,12 @@
 #define XPATH_NAME_LEN          16      /* Max node/attribute name length */
 #endif
 
+#define XPATH_MAX_NAMES         64      /* Distinct interned names */
+
+/* Interned node tests */
+#define NAME_ANY                (-1)    /* "*" */
+#define NAME_NONE               (-2)    /* Name absent from the document */
+
 /* Node types */
 #define NODE_ELEMENT            1
 #define NODE_TEXT               2
@@ -52,24 +64,36 @@
  * Data Structures
  * ============================================================================ */
 
-/* DOM node */
+/* Timed phases (names in KERNEL_DECLARE order) */
+enum { PHASE_QUERIES, PHASE_STATS, PHASE_DESCENDANT };
+
+/* DOM node: everything in one record, as the naive path sees it */
 typedef struct dom_node {
     uint8_t  type;                          /* Node type */
     uint8_t  depth;                         /* Depth in tree */
-    int16_t  index;                         /* Index in node array */
-    int16_t  parent_idx;                    /* Parent node index (-1 for root) */
-    int16_t  first_child_idx;               /* First child index (-1 if none) */
-    int16_t  next_sibling_idx;              /* Next sibling index (-1 if none) */
-    int16_t  num_children;                  /* Number of children */
+    int32_t  index;                         /* Index in node array (document order) */
+    int32_t  parent_idx;                    /* Parent node index (-1 for root) */
+    int32_t  first_child_idx;               /* First child index (-1 if none) */
+    int32_t  next_sibling_idx;              /* Next sibling index (-1 if none) */
+    int32_t  num_children;                  /* Number of children */
     char     name[XPATH_NAME_LEN];          /* Element/attribute name */
     char     value[XPATH_NAME_LEN];         /* Text/attribute value */
     int32_t  int_value;                     /* Numeric value for predicates */
 } dom_node_t;
 
+/* Structural fields the indexed axes touch, split from the payload */
+typedef struct {
+    int32_t  parent;
+    int32_t  first_child;
+    int32_t  next_sibling;
+    int32_t  end;                           /* One past the last descendant */
+} dom_hot_t;
+
 /* XPath step (simplified) */
 typedef struct {
     uint8_t  axis;                          /* Axis type */
     char     node_test[XPATH_NAME_LEN];     /* Node name to match ("*" for any) */
+    int32_t  name_id;                       /* Interned node_test */
     int32_t  predicate_type;                /* 0=none, 1=position, 2=attr_eq */
     int32_t  predicate_value;               /* Value for predicate */
 } xpath_step_t;
@@ -80,16 +104,37 @@ typedef struct {
     int num_steps;
 } xpath_query_t;
 
-/* Result set */
+/* Node set; evaluated sets are duplicate-free and in document order */
 typedef struct {
-    int16_t nodes[XPATH_NUM_NODES];
+    int32_t *nodes;
     int count;
 } node_set_t;
 
-/* DOM tree storage */
-static dom_node_t nodes[XPATH_NUM_NODES];
-static int num_nodes;
-static xpath_query_t queries[XPATH_NUM_QUERIES];
+/* Bitmap node set, remembering the range of words it touched */
+typedef struct {
+    uint64_t *words;
+    int lo, hi;                             /* Touched words [lo, hi), empty if lo >= hi */
+} node_bitmap_t;
+
+/* DOM tree storage, arena-allocated in init */
+static BENCH_TLS dom_node_t *nodes;
+static BENCH_TLS int num_nodes;
+static BENCH_TLS int max_nodes;
+static BENCH_TLS xpath_query_t queries[XPATH_NUM_QUERIES];
+
+/* Index built over the DOM */
+static BENCH_TLS dom_hot_t *hot;
+static BENCH_TLS uint8_t *name_ids;
+static BENCH_TLS uint8_t *depths;
+static BENCH_TLS int32_t *values;
+static BENCH_TLS char names[XPATH_MAX_NAMES][XPATH_NAME_LEN];
+static BENCH_TLS int num_names;
+static BENCH_TLS int32_t name_start[XPATH_MAX_NAMES + 1];   /* CSR per-name node lists */
+static BENCH_TLS int32_t *name_nodes;
+
+/* Evaluation scratch */
+static BENCH_TLS node_set_t set_a, set_b, set_axis;
+static BENCH_TLS node_bitmap_t out_bits, seen_bits;
 
 /* ============================================================================
  * String Utilities
@@ -151,8 +196,36 @@ static dom_node_t *get_next_sibling(dom_node_t *node)
     return get_node(node->next_sibling_idx);
 }
 
+INLINE void set_add(node_set_t *set, int idx)
+{
+    set->nodes[set->count++] = idx;
+}
+
+static int compare_index(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Sort into document order and drop duplicates */
+static void set_sort_unique(node_set_t *set)
+{
+    if (set->count < 2) return;
+
+    qsort(set->nodes, set->count, sizeof(int32_t), compare_index);
+
+    int n = 1;
+    for (int i = 1; i < set->count; i++) {
+        if (set->nodes[i] != set->nodes[n - 1]) {
+            set->nodes[n++] = set->nodes[i];
+        }
+    }
+    set->count = n;
+}
+
 /* ============================================================================
  * XPath Axis Navigation
+ * An axis appends at most num_nodes entries for one context node.
  * ============================================================================ */
 
 /* Get all children of a node */
@@ -160,9 +233,7 @@ static void axis_child(dom_node_t *context, node_set_t *result)
 {
     dom_node_t *child = get_first_child(context);
     while (child) {
-        if (result->count < XPATH_NUM_NODES) {
-            result->nodes[result->count++] = child->index;
-        }
+        set_add(result, child->index);
         child = get_next_sibling(child);
     }
 }
@@ -172,9 +243,7 @@ static void axis_descendant_helper(dom_node_t *node, node_set_t *result)
 {
     dom_node_t *child = get_first_child(node);
     while (child) {
-        if (result->count < XPATH_NUM_NODES) {
-            result->nodes[result->count++] = child->index;
-        }
+        set_add(result, child->index);
         axis_descendant_helper(child, result);
         child = get_next_sibling(child);
     }
@@ -189,8 +258,8 @@ static void axis_descendant(dom_node_t *context, node_set_t *result)
 static void axis_parent(dom_node_t *context, node_set_t *result)
 {
     dom_node_t *parent = get_parent(context);
-    if (parent && result->count < XPATH_NUM_NODES) {
-        result->nodes[result->count++] = parent->index;
+    if (parent) {
+        set_add(result, parent->index);
     }
 }
 
@@ -199,9 +268,7 @@ static void axis_ancestor(dom_node_t *context, node_set_t *result)
 {
     dom_node_t *ancestor = get_parent(context);
     while (ancestor) {
-        if (result->count < XPATH_NUM_NODES) {
-            result->nodes[result->count++] = ancestor->index;
-        }
+        set_add(result, ancestor->index);
         ancestor = get_parent(ancestor);
     }
 }
@@ -211,9 +278,7 @@ static void axis_following_sibling(dom_node_t *context, node_set_t *result)
 {
     dom_node_t *sibling = get_next_sibling(context);
     while (sibling) {
-        if (result->count < XPATH_NUM_NODES) {
-            result->nodes[result->count++] = sibling->index;
-        }
+        set_add(result, sibling->index);
         sibling = get_next_sibling(sibling);
     }
 }
@@ -226,9 +291,7 @@ static void axis_preceding_sibling(dom_node_t *context, node_set_t *result)
 
     dom_node_t *child = get_first_child(parent);
     while (child && child->index != context->index) {
-        if (result->count < XPATH_NUM_NODES) {
-            result->nodes[result->count++] = child->index;
-        }
+        set_add(result, child->index);
         child = get_next_sibling(child);
     }
 }
@@ -236,9 +299,7 @@ static void axis_preceding_sibling(dom_node_t *context, node_set_t *result)
 /* Self axis */
 static void axis_self(dom_node_t *context, node_set_t *result)
 {
-    if (result->count < XPATH_NUM_NODES) {
-        result->nodes[result->count++] = context->index;
-    }
+    set_add(result, context->index);
 }
 
 /* ============================================================================
@@ -273,17 +334,17 @@ static void apply_axis(uint8_t axis, dom_node_t *context, node_set_t *result)
     }
 }
 
-/* Apply node test (name matching) */
-static void apply_node_test(const char *test, node_set_t *input, node_set_t *output)
+/* Apply node test (name matching) to set entries from start on, in place */
+static void apply_node_test(const char *test, node_set_t *set, int start)
 {
-    for (int i = 0; i < input->count; i++) {
-        dom_node_t *node = get_node(input->nodes[i]);
+    int n = start;
+    for (int i = start; i < set->count; i++) {
+        dom_node_t *node = get_node(set->nodes[i]);
         if (node && str_match(test, node->name)) {
-            if (output->count < XPATH_NUM_NODES) {
-                output->nodes[output->count++] = node->index;
-            }
+            set->nodes[n++] = node->index;
         }
     }
+    set->count = n;
 }
 
 /* Apply predicate */
@@ -292,24 +353,20 @@ static void apply_predicate(const xpath_step_t *step, node_set_t *input, node_se
     if (step->predicate_type == 0) {
         /* No predicate - copy all */
         for (int i = 0; i < input->count; i++) {
-            if (output->count < XPATH_NUM_NODES) {
-                output->nodes[output->count++] = input->nodes[i];
-            }
+            set_add(output, input->nodes[i]);
         }
     } else if (step->predicate_type == 1) {
         /* Position predicate [n] */
         int pos = step->predicate_value - 1;  /* XPath is 1-indexed */
         if (pos >= 0 && pos < input->count) {
-            output->nodes[output->count++] = input->nodes[pos];
+            set_add(output, input->nodes[pos]);
         }
     } else if (step->predicate_type == 2) {
         /* Attribute value predicate [@attr = value] */
         for (int i = 0; i < input->count; i++) {
             dom_node_t *node = get_node(input->nodes[i]);
             if (node && node->int_value == step->predicate_value) {
-                if (output->count < XPATH_NUM_NODES) {
-                    output->nodes[output->count++] = node->index;
-                }
+                set_add(output, node->index);
             }
         }
     }
@@ -318,57 +375,256 @@ static void apply_predicate(const xpath_step_t *step, node_set_t *input, node_se
 /* Evaluate single XPath step */
 static void eval_step(const xpath_step_t *step, node_set_t *context_nodes, node_set_t *result)
 {
-    node_set_t axis_result = {.count = 0};
-    node_set_t test_result = {.count = 0};
+    node_set_t *axis_result = &set_axis;
+    axis_result->count = 0;
 
-    /* Apply axis to all context nodes */
+    /* Apply axis and node test to all context nodes; the scratch set holds
+     * 3 * num_nodes, so compact once it passes 2 * num_nodes */
     for (int i = 0; i < context_nodes->count; i++) {
         dom_node_t *ctx = get_node(context_nodes->nodes[i]);
         if (ctx) {
-            apply_axis(step->axis, ctx, &axis_result);
+            int start = axis_result->count;
+            apply_axis(step->axis, ctx, axis_result);
+            apply_node_test(step->node_test, axis_result, start);
+            if (axis_result->count > 2 * num_nodes) {
+                set_sort_unique(axis_result);
+            }
         }
     }
-
-    /* Apply node test */
-    apply_node_test(step->node_test, &axis_result, &test_result);
+    set_sort_unique(axis_result);
 
     /* Apply predicate */
-    apply_predicate(step, &test_result, result);
+    apply_predicate(step, axis_result, result);
+}
+
+/* ============================================================================
+ * Indexed Evaluation
+ * Node i's descendants are exactly [i + 1, hot[i].end) in document order.
+ * ============================================================================ */
+
+INLINE void bitmap_touch(node_bitmap_t *bm, int lo_word, int hi_word)
+{
+    if (lo_word < bm->lo) bm->lo = lo_word;
+    if (hi_word > bm->hi) bm->hi = hi_word;
+}
+
+INLINE void bitmap_mark(node_bitmap_t *bm, int idx)
+{
+    bm->words[idx >> 6] |= 1ULL << (idx & 63);
+    bitmap_touch(bm, idx >> 6, (idx >> 6) + 1);
+}
+
+INLINE bool bitmap_test(const node_bitmap_t *bm, int idx)
+{
+    return (bm->words[idx >> 6] >> (idx & 63)) & 1;
+}
+
+/* Mark [lo, hi) a word at a time */
+static void bitmap_mark_range(node_bitmap_t *bm, int lo, int hi)
+{
+    if (lo >= hi) return;
+
+    int wl = lo >> 6, wh = (hi - 1) >> 6;
+    uint64_t first = ~0ULL << (lo & 63);
+    uint64_t last = ~0ULL >> (63 - ((hi - 1) & 63));
+
+    if (wl == wh) {
+        bm->words[wl] |= first & last;
+    } else {
+        bm->words[wl] |= first;
+        for (int w = wl + 1; w < wh; w++) bm->words[w] = ~0ULL;
+        bm->words[wh] |= last;
+    }
+    bitmap_touch(bm, wl, wh + 1);
 }
 
-/* Evaluate complete XPath query */
-static int eval_xpath(const xpath_query_t *query, int start_node_idx, node_set_t *result)
+static void bitmap_clear(node_bitmap_t *bm)
 {
-    node_set_t current = {.count = 0};
-    node_set_t next = {.count = 0};
+    if (bm->lo < bm->hi) {
+        memset(&bm->words[bm->lo], 0, (size_t)(bm->hi - bm->lo) * sizeof(uint64_t));
+    }
+    bm->lo = INT32_MAX;
+    bm->hi = 0;
+}
+
+INLINE bool name_match(int name_id, int idx)
+{
+    return name_id == NAME_ANY || name_ids[idx] == name_id;
+}
+
+/* First entry of a sorted list that is >= key */
+static int lower_bound(const int32_t *list, int count, int key)
+{
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (list[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Axis and node test for a document-ordered context set into out_bits */
+static void indexed_axis(uint8_t axis, int name_id, const node_set_t *ctx)
+{
+    node_bitmap_t *out = &out_bits;
+
+    switch (axis) {
+        case AXIS_CHILD:
+            for (int i = 0; i < ctx->count; i++) {
+                for (int c = hot[ctx->nodes[i]].first_child; c >= 0; c = hot[c].next_sibling) {
+                    if (name_match(name_id, c)) bitmap_mark(out, c);
+                }
+            }
+            break;
+
+        case AXIS_DESCENDANT: {
+            /* Nested contexts add nothing; a name scans its own node list */
+            int covered = 0;
+            const int32_t *list = NULL;
+            int list_len = 0;
+            if (name_id >= 0) {
+                list = &name_nodes[name_start[name_id]];
+                list_len = name_start[name_id + 1] - name_start[name_id];
+            }
+            for (int i = 0; i < ctx->count; i++) {
+                int c = ctx->nodes[i];
+                int end = hot[c].end;
+                if (c < covered) continue;
+                covered = end;
+                if (!list) {
+                    bitmap_mark_range(out, c + 1, end);
+                } else {
+                    for (int k = lower_bound(list, list_len, c + 1); k < list_len && list[k] < end; k++) {
+                        bitmap_mark(out, list[k]);
+                    }
+                }
+            }
+            break;
+        }
+
+        case AXIS_PARENT:
+            for (int i = 0; i < ctx->count; i++) {
+                int p = hot[ctx->nodes[i]].parent;
+                if (p >= 0 && name_match(name_id, p)) bitmap_mark(out, p);
+            }
+            break;
+
+        case AXIS_ANCESTOR:
+            /* Stop at the first ancestor another context already climbed */
+            for (int i = 0; i < ctx->count; i++) {
+                for (int p = hot[ctx->nodes[i]].parent; p >= 0 && !bitmap_test(&seen_bits, p);
+                     p = hot[p].parent) {
+                    bitmap_mark(&seen_bits, p);
+                    if (name_match(name_id, p)) bitmap_mark(out, p);
+                }
+            }
+            bitmap_clear(&seen_bits);
+            break;
+
+        case AXIS_FOLLOWING_SIBLING:
+            for (int i = 0; i < ctx->count; i++) {
+                for (int s = hot[ctx->nodes[i]].next_sibling; s >= 0; s = hot[s].next_sibling) {
+                    if (name_match(name_id, s)) bitmap_mark(out, s);
+                }
+            }
+            break;
+
+        case AXIS_PRECEDING_SIBLING:
+            for (int i = 0; i < ctx->count; i++) {
+                int c = ctx->nodes[i];
+                int p = hot[c].parent;
+                if (p < 0) continue;
+                for (int s = hot[p].first_child; s != c; s = hot[s].next_sibling) {
+                    if (name_match(name_id, s)) bitmap_mark(out, s);
+                }
+            }
+            break;
+
+        case AXIS_SELF:
+            for (int i = 0; i < ctx->count; i++) {
+                if (name_match(name_id, ctx->nodes[i])) bitmap_mark(out, ctx->nodes[i]);
+            }
+            break;
+    }
+}
+
+/* Evaluate single XPath step; out_bits is clear on entry and exit */
+static void indexed_step(const xpath_step_t *step, const node_set_t *ctx, node_set_t *result)
+{
+    node_bitmap_t *out = &out_bits;
+
+    if (step->name_id == NAME_NONE) return;
+
+    indexed_axis(step->axis, step->name_id, ctx);
+
+    /* Predicate while reading the bitmap back in document order */
+    int pos = step->predicate_value - 1;
+    for (int w = out->lo; w < out->hi; w++) {
+        uint64_t bits = out->words[w];
+        if (step->predicate_type == 1) {
+            int n = __builtin_popcountll(bits);
+            if (pos >= n) {
+                pos -= n;
+                continue;
+            }
+            if (pos < 0) break;
+            for (; pos > 0; pos--) bits &= bits - 1;
+            set_add(result, w * 64 + __builtin_ctzll(bits));
+            break;
+        }
+        for (; bits; bits &= bits - 1) {
+            int idx = w * 64 + __builtin_ctzll(bits);
+            if (step->predicate_type == 0 || values[idx] == step->predicate_value) {
+                set_add(result, idx);
+            }
+        }
+    }
+
+    bitmap_clear(out);
+}
+
+/* Evaluate complete XPath query; result points at one of the scratch sets */
+static int eval_xpath(const xpath_query_t *query, int start_node_idx, bool indexed,
+                      node_set_t **result)
+{
+    node_set_t *current = &set_a;
+    node_set_t *next = &set_b;
 
     /* Start with root or specified node */
-    current.nodes[0] = start_node_idx;
-    current.count = 1;
+    current->nodes[0] = start_node_idx;
+    current->count = 1;
 
     /* Evaluate each step */
     for (int s = 0; s < query->num_steps; s++) {
-        next.count = 0;
-        eval_step(&query->steps[s], &current, &next);
+        next->count = 0;
+        if (indexed) {
+            indexed_step(&query->steps[s], current, next);
+        } else {
+            eval_step(&query->steps[s], current, next);
+        }
 
         /* Swap current and next */
+        node_set_t *tmp = current;
         current = next;
+        next = tmp;
 
-        if (current.count == 0) {
+        if (current->count == 0) {
             break;  /* No more nodes to process */
         }
     }
 
-    /* Copy to result */
     *result = current;
-    return current.count;
+    return current->count;
 }
 
 /* ============================================================================
  * DOM Tree Generation
  * ============================================================================ */
 
-static void generate_tree(uint32_t seed)
+/* Build breadth-first into tmp, then store in document order in nodes */
+static void generate_tree(dom_node_t *tmp, int32_t *queue, int32_t *order, int max_depth_dom,
+                          uint32_t seed)
 {
     uint32_t x = seed;
     num_nodes = 0;
@@ -380,7 +636,7 @@ static void generate_tree(uint32_t seed)
     static const int num_element_names = 8;
 
     /* Create root node */
-    dom_node_t *root = &nodes[num_nodes];
+    dom_node_t *root = &tmp[num_nodes];
     root->type = NODE_ELEMENT;
     root->depth = 0;
     root->index = num_nodes;
@@ -394,34 +650,34 @@ static void generate_tree(uint32_t seed)
     num_nodes++;
 
     /* Build tree using BFS-like approach */
-    int queue[XPATH_NUM_NODES];
     int head = 0, tail = 0;
 
     queue[tail++] = 0;  /* Start with root */
 
-    while (head < tail && num_nodes < XPATH_NUM_NODES) {
+    while (head < tail && num_nodes < max_nodes) {
         int parent_idx = queue[head++];
-        dom_node_t *parent = &nodes[parent_idx];
+        dom_node_t *parent = &tmp[parent_idx];
 
-        if (parent->depth >= XPATH_MAX_DEPTH - 1) {
+        if (parent->depth >= max_depth_dom - 1) {
             continue;  /* Max depth reached */
         }
 
         /* Determine number of children */
         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
         int num_children = 1 + (x % XPATH_MAX_CHILDREN);
-        if (num_nodes + num_children > XPATH_NUM_NODES) {
-            num_children = XPATH_NUM_NODES - num_nodes;
+        if (num_nodes + num_children > max_nodes) {
+            num_children = max_nodes - num_nodes;
         }
 
         int prev_child_idx = -1;
-        for (int c = 0; c < num_children && num_nodes < XPATH_NUM_NODES; c++) {
-            dom_node_t *child = &nodes[num_nodes];
+        for (int c = 0; c < num_children && num_nodes < max_nodes; c++) {
+            dom_node_t *child = &tmp[num_nodes];
 
-            /* Determine node type */
+            /* Determine node type; a first child element keeps the build
+             * from dying out before the node budget */
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             int type_choice = x % 10;
-            if (type_choice < 7) {
+            if (type_choice < 7 || c == 0) {
                 child->type = NODE_ELEMENT;
             } else if (type_choice < 9) {
                 child->type = NODE_TEXT;
@@ -440,6 +696,7 @@ static void generate_tree(uint32_t seed)
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             int name_idx = x % num_element_names;
             str_copy(child->name, element_names[name_idx], XPATH_NAME_LEN);
+            child->value[0] = '\0';
 
             /* Set value */
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
@@ -450,19 +707,97 @@ static void generate_tree(uint32_t seed)
                 parent->first_child_idx = num_nodes;
             }
             if (prev_child_idx >= 0) {
-                nodes[prev_child_idx].next_sibling_idx = num_nodes;
+                tmp[prev_child_idx].next_sibling_idx = num_nodes;
             }
             prev_child_idx = num_nodes;
             parent->num_children++;
 
             /* Add element nodes to queue for further expansion */
-            if (child->type == NODE_ELEMENT && tail < XPATH_NUM_NODES) {
+            if (child->type == NODE_ELEMENT) {
                 queue[tail++] = num_nodes;
             }
 
             num_nodes++;
         }
     }
+
+    /* Pre-order numbering: order[bfs index] = document position */
+    int sp = 0, pos = 0;
+    queue[sp++] = 0;
+    while (sp > 0) {
+        int i = queue[--sp];
+        order[i] = pos++;
+        /* Push children last-first so the first child pops next */
+        int first = sp;
+        for (int c = tmp[i].first_child_idx; c >= 0; c = tmp[c].next_sibling_idx) {
+            queue[sp++] = c;
+        }
+        for (int a = first, b = sp - 1; a < b; a++, b--) {
+            int32_t t = queue[a];
+            queue[a] = queue[b];
+            queue[b] = t;
+        }
+    }
+
+    for (int i = 0; i < num_nodes; i++) {
+        dom_node_t *node = &nodes[order[i]];
+        *node = tmp[i];
+        node->index = order[i];
+        node->parent_idx = tmp[i].parent_idx >= 0 ? order[tmp[i].parent_idx] : -1;
+        node->first_child_idx = tmp[i].first_child_idx >= 0 ? order[tmp[i].first_child_idx] : -1;
+        node->next_sibling_idx = tmp[i].next_sibling_idx >= 0 ? order[tmp[i].next_sibling_idx] : -1;
+    }
+}
+
+/* Interned id of a name, NAME_NONE if no node has it */
+static int lookup_name(const char *name)
+{
+    if (str_match(name, "*") && name[0] == '*') return NAME_ANY;
+    for (int i = 0; i < num_names; i++) {
+        if (str_equal(names[i], name)) return i;
+    }
+    return NAME_NONE;
+}
+
+/* Hot/cold split, interned names with per-name node lists, intervals */
+static void build_index(void)
+{
+    num_names = 0;
+    memset(name_start, 0, sizeof(name_start));
+
+    for (int i = 0; i < num_nodes; i++) {
+        const dom_node_t *node = &nodes[i];
+        int id = lookup_name(node->name);
+        if (id == NAME_NONE) {
+            str_copy(names[num_names], node->name, XPATH_NAME_LEN);
+            id = num_names++;
+        }
+        name_ids[i] = (uint8_t)id;
+        depths[i] = node->depth;
+        values[i] = node->int_value;
+        hot[i].parent = node->parent_idx;
+        hot[i].first_child = node->first_child_idx;
+        hot[i].next_sibling = node->next_sibling_idx;
+        hot[i].end = i + 1;
+        name_start[id + 1]++;
+    }
+
+    /* Children come after their parent, so a reverse sweep sees whole subtrees */
+    for (int i = num_nodes - 1; i > 0; i--) {
+        int p = hot[i].parent;
+        if (hot[i].end > hot[p].end) hot[p].end = hot[i].end;
+    }
+
+    for (int id = 0; id < num_names; id++) {
+        name_start[id + 1] += name_start[id];
+    }
+    for (int i = 0; i < num_nodes; i++) {
+        name_nodes[name_start[name_ids[i]]++] = i;
+    }
+    for (int id = num_names; id > 0; id--) {
+        name_start[id] = name_start[id - 1];
+    }
+    name_start[0] = 0;
 }
 
 static void generate_queries(uint32_t seed)
@@ -490,6 +825,7 @@ static void generate_queries(uint32_t seed)
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
             int test_idx = x % num_test_names;
             str_copy(step->node_test, test_names[test_idx], XPATH_NAME_LEN);
+            step->name_id = lookup_name(step->node_test);
 
             /* Choose predicate */
             x ^= x << 13; x ^= x >> 17; x ^= x << 5;
@@ -538,17 +874,67 @@ static int32_t sum_values(void)
     return sum;
 }
 
+/* The same over the split arrays */
+static int indexed_count_by_name(const char *name)
+{
+    int id = lookup_name(name);
+    if (id == NAME_ANY) return num_nodes;
+    if (id == NAME_NONE) return 0;
+    return name_start[id + 1] - name_start[id];
+}
+
+static int indexed_max_depth(void)
+{
+    int max_d = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        if (depths[i] > max_d) max_d = depths[i];
+    }
+    return max_d;
+}
+
+static int32_t indexed_sum_values(void)
+{
+    int32_t sum = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
 /* ============================================================================
  * Kernel Implementation
  * ============================================================================ */
 
 static void kernel_init_func(void)
 {
-    generate_tree(0xBADCAFE0);
+    max_nodes = (int)bench_scale(XPATH_NUM_NODES);
+    int words = (max_nodes + 63) / 64;
+
+    nodes = bench_alloc(max_nodes * sizeof(dom_node_t));
+    hot = bench_alloc(max_nodes * sizeof(dom_hot_t));
+    name_ids = bench_alloc(max_nodes);
+    depths = bench_alloc(max_nodes);
+    values = bench_alloc(max_nodes * sizeof(int32_t));
+    name_nodes = bench_alloc(max_nodes * sizeof(int32_t));
+
+    set_a.nodes = bench_alloc(max_nodes * sizeof(int32_t));
+    set_b.nodes = bench_alloc(max_nodes * sizeof(int32_t));
+    set_axis.nodes = bench_alloc(3 * (size_t)max_nodes * sizeof(int32_t));
+    out_bits.words = bench_alloc(words * sizeof(uint64_t));
+    seen_bits.words = bench_alloc(words * sizeof(uint64_t));
+    out_bits.lo = seen_bits.lo = INT32_MAX;
+    out_bits.hi = seen_bits.hi = 0;
+
+    /* Generation scratch doubles as the qsort-free temporaries above */
+    dom_node_t *tmp = bench_alloc(max_nodes * sizeof(dom_node_t));
+    generate_tree(tmp, set_axis.nodes, set_a.nodes, XPATH_MAX_DEPTH + 2 * (int)bench_tier,
+                  0xBADCAFE0);
+    build_index();
     generate_queries(0xDEADC0DE);
 }
 
-static bench_result_t kernel_run_func(void)
+/* Shared driver for the naive and indexed paths */
+static bench_result_t xpath_run(bool indexed)
 {
     bench_result_t result = { .status = BENCH_OK };
     uint32_t csum = checksum_init();
@@ -559,37 +945,52 @@ static bench_result_t kernel_run_func(void)
     BENCH_START();
 
     /* Execute XPath queries */
+    BENCH_PHASE_BEGIN(PHASE_QUERIES);
     for (int q = 0; q < XPATH_NUM_QUERIES; q++) {
-        node_set_t result_set = {.count = 0};
-        int count = eval_xpath(&queries[q], 0, &result_set);
+        node_set_t *result_set;
+        int count = eval_xpath(&queries[q], 0, indexed, &result_set);
 
         total_results += count;
         total_steps += queries[q].num_steps;
         csum = checksum_update(csum, (uint32_t)count);
 
         /* Checksum result node indices */
-        for (int i = 0; i < result_set.count && i < 10; i++) {
-            csum = checksum_update(csum, (uint32_t)result_set.nodes[i]);
+        for (int i = 0; i < result_set->count && i < 10; i++) {
+            csum = checksum_update(csum, (uint32_t)result_set->nodes[i]);
         }
     }
+    BENCH_PHASE_END(PHASE_QUERIES);
 
     /* Tree statistics */
-    int depth = max_depth();
+    BENCH_PHASE_BEGIN(PHASE_STATS);
+    int depth = indexed ? indexed_max_depth() : max_depth();
     csum = checksum_update(csum, (uint32_t)depth);
 
-    int32_t value_sum = sum_values();
+    int32_t value_sum = indexed ? indexed_sum_values() : sum_values();
     csum = checksum_update(csum, (uint32_t)value_sum);
 
-    int item_count = count_by_name("item");
+    int item_count = indexed ? indexed_count_by_name("item") : count_by_name("item");
     csum = checksum_update(csum, (uint32_t)item_count);
 
-    int data_count = count_by_name("data");
+    int data_count = indexed ? indexed_count_by_name("data") : count_by_name("data");
     csum = checksum_update(csum, (uint32_t)data_count);
 
     /* Descendant count from root */
-    node_set_t descendants = {.count = 0};
-    axis_descendant(&nodes[0], &descendants);
-    csum = checksum_update(csum, (uint32_t)descendants.count);
+    int descendant_count;
+    BENCH_PHASE_BEGIN(PHASE_DESCENDANT);
+    set_b.count = 0;
+    if (indexed) {
+        static const xpath_step_t all_descendants = { .axis = AXIS_DESCENDANT, .name_id = NAME_ANY };
+        set_a.nodes[0] = 0;
+        set_a.count = 1;
+        indexed_step(&all_descendants, &set_a, &set_b);
+    } else {
+        axis_descendant(&nodes[0], &set_b);
+    }
+    descendant_count = set_b.count;
+    BENCH_PHASE_END(PHASE_DESCENDANT);
+    csum = checksum_update(csum, (uint32_t)descendant_count);
+    BENCH_PHASE_END(PHASE_STATS);
 
     BENCH_END();
 
@@ -609,6 +1010,16 @@ static bench_result_t kernel_run_func(void)
     return result;
 }
 
+static bench_result_t kernel_run_func(void)
+{
+    return xpath_run(false);
+}
+
+static bench_result_t kernel_run_indexed(void)
+{
+    return xpath_run(true);
+}
+
 static void kernel_cleanup_func(void)
 {
     /* Nothing to clean up */
@@ -618,7 +1029,13 @@ static void kernel_cleanup_func(void)
  * Kernel Registration
  * ============================================================================ */
 
-KERNEL_DECLARE(
+/* Best first: --variant=auto takes the first one the host supports */
+static const kernel_variant_t xpath_variants[] = {
+    { "indexed", 0, kernel_run_indexed },
+    { NULL, 0, NULL }
+};
+
+KERNEL_DECLARE_VARIANTS(
     xpath_eval,
     "XPath query evaluation on DOM tree",
     "483.xalancbmk",
@@ -626,7 +1043,9 @@ KERNEL_DECLARE(
     kernel_run_func,
     kernel_cleanup_func,
     0,
-    XPATH_NUM_QUERIES
+    XPATH_NUM_QUERIES,
+    xpath_variants,
+    "queries", "tree_stats", "descendant_axis"
 );
 
 KERNEL_REGISTER(xpath_eval)